@@ -338,7 +338,7 @@ namespace Helpers
 
     const wchar_t* GetErrorDesc(HRESULT hr)
     {
-        static wchar_t desc[1024] = {};
+        static thread_local wchar_t desc[1024] = {};
 
         LPWSTR errorText = nullptr;
 
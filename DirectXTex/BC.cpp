@@ -17,6 +17,11 @@
 
 #include "BC.h"
 
+// Batched BC1/BC3 encoding runs one block per SIMD lane, so it needs DirectXMath intrinsics
+#if !defined(_XM_NO_INTRINSICS_) && !defined(COLOR_WEIGHTS)
+#define BC_BATCH_SIMD
+#endif
+
 using namespace DirectX;
 using namespace DirectX::PackedVector;
 
@@ -717,6 +722,689 @@ namespace
         pBC->bitmap = 0x00000000;
     }
 #endif // COLOR_WEIGHTS
+
+    //-------------------------------------------------------------------------------------
+    void EncodeBC3Alpha(
+        _Out_ D3DX_BC3 *pBC3,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *Color,
+        uint32_t flags) noexcept
+    {
+        assert(pBC3 && Color);
+
+        // Quantize block to A8, using Floyd Stienberg error diffusion.  This
+        // increases the chance that colors will map directly to the quantized
+        // axis endpoints.
+        float fAlpha[NUM_PIXELS_PER_BLOCK] = {};
+        float fError[NUM_PIXELS_PER_BLOCK] = {};
+
+        float fMinAlpha = Color[0].a;
+        float fMaxAlpha = Color[0].a;
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            float fAlph = Color[i].a;
+            if (flags & BC_FLAGS_DITHER_A)
+                fAlph += fError[i];
+
+            fAlpha[i] = static_cast<float>(static_cast<int32_t>(fAlph * 255.0f + 0.5f)) * (1.0f / 255.0f);
+
+            if (fAlpha[i] < fMinAlpha)
+                fMinAlpha = fAlpha[i];
+            else if (fAlpha[i] > fMaxAlpha)
+                fMaxAlpha = fAlpha[i];
+
+            if (flags & BC_FLAGS_DITHER_A)
+            {
+                const float fDiff = fAlph - fAlpha[i];
+
+                if (3 != (i & 3))
+                {
+                    assert(i < 15);
+                    _Analysis_assume_(i < 15);
+                    fError[i + 1] += fDiff * (7.0f / 16.0f);
+                }
+
+                if (i < 12)
+                {
+                    if (i & 3)
+                        fError[i + 3] += fDiff * (3.0f / 16.0f);
+
+                    fError[i + 4] += fDiff * (5.0f / 16.0f);
+
+                    if (3 != (i & 3))
+                    {
+                        assert(i < 11);
+                        _Analysis_assume_(i < 11);
+                        fError[i + 5] += fDiff * (1.0f / 16.0f);
+                    }
+                }
+            }
+        }
+
+#ifdef COLOR_WEIGHTS
+        if (0.0f == fMaxAlpha)
+        {
+            EncodeSolidBC1(&pBC3->dxt1, Color);
+            pBC3->alpha[0] = 0x00;
+            pBC3->alpha[1] = 0x00;
+            memset(pBC3->bitmap, 0x00, 6);
+        }
+#endif
+
+        if (1.0f == fMinAlpha)
+        {
+            pBC3->alpha[0] = 0xff;
+            pBC3->alpha[1] = 0xff;
+            memset(pBC3->bitmap, 0x00, 6);
+            return;
+        }
+
+        // Optimize and Quantize Min and Max values
+        const uint32_t uSteps = ((0.0f == fMinAlpha) || (1.0f == fMaxAlpha)) ? 6u : 8u;
+
+        float fAlphaA, fAlphaB;
+        OptimizeAlpha<false>(&fAlphaA, &fAlphaB, fAlpha, uSteps);
+
+        const auto bAlphaA = static_cast<uint8_t>(static_cast<int32_t>(fAlphaA * 255.0f + 0.5f));
+        const auto bAlphaB = static_cast<uint8_t>(static_cast<int32_t>(fAlphaB * 255.0f + 0.5f));
+
+        fAlphaA = static_cast<float>(bAlphaA) * (1.0f / 255.0f);
+        fAlphaB = static_cast<float>(bAlphaB) * (1.0f / 255.0f);
+
+        // Setup block
+        if ((8 == uSteps) && (bAlphaA == bAlphaB))
+        {
+            pBC3->alpha[0] = bAlphaA;
+            pBC3->alpha[1] = bAlphaB;
+            memset(pBC3->bitmap, 0x00, 6);
+            return;
+        }
+
+        static const size_t pSteps6[] = { 0, 2, 3, 4, 5, 1 };
+        static const size_t pSteps8[] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+        const size_t *pSteps;
+        float fStep[8] = {};
+
+        if (6 == uSteps)
+        {
+            pBC3->alpha[0] = bAlphaA;
+            pBC3->alpha[1] = bAlphaB;
+
+            fStep[0] = fAlphaA;
+            fStep[1] = fAlphaB;
+
+            for (size_t i = 1; i < 5; ++i)
+                fStep[i + 1] = (fStep[0] * float(5u - i) + fStep[1] * float(i)) * (1.0f / 5.0f);
+
+            fStep[6] = 0.0f;
+            fStep[7] = 1.0f;
+
+            pSteps = pSteps6;
+        }
+        else
+        {
+            pBC3->alpha[0] = bAlphaB;
+            pBC3->alpha[1] = bAlphaA;
+
+            fStep[0] = fAlphaB;
+            fStep[1] = fAlphaA;
+
+            for (size_t i = 1; i < 7; ++i)
+                fStep[i + 1] = (fStep[0] * float(7u - i) + fStep[1] * float(i)) * (1.0f / 7.0f);
+
+            pSteps = pSteps8;
+        }
+
+        // Encode alpha bitmap
+        const auto fSteps = static_cast<float>(uSteps - 1);
+        const float fScale = (fStep[0] != fStep[1]) ? (fSteps / (fStep[1] - fStep[0])) : 0.0f;
+
+        if (flags & BC_FLAGS_DITHER_A)
+            memset(fError, 0x00, NUM_PIXELS_PER_BLOCK * sizeof(float));
+
+        for (size_t iSet = 0; iSet < 2; iSet++)
+        {
+            uint32_t dw = 0;
+
+            const size_t iMin = iSet * 8;
+            const size_t iLim = iMin + 8;
+
+            for (size_t i = iMin; i < iLim; ++i)
+            {
+                float fAlph = Color[i].a;
+                if (flags & BC_FLAGS_DITHER_A)
+                    fAlph += fError[i];
+                const float fDot = (fAlph - fStep[0]) * fScale;
+
+                uint32_t iStep;
+                if (fDot <= 0.0f)
+                    iStep = ((6 == uSteps) && (fAlph <= fStep[0] * 0.5f)) ? 6u : 0u;
+                else if (fDot >= fSteps)
+                    iStep = ((6 == uSteps) && (fAlph >= (fStep[1] + 1.0f) * 0.5f)) ? 7u : 1u;
+                else
+                    iStep = uint32_t(pSteps[uint32_t(fDot + 0.5f)]);
+
+                dw = (iStep << 21) | (dw >> 3);
+
+                if (flags & BC_FLAGS_DITHER_A)
+                {
+                    const float fDiff = (fAlph - fStep[iStep]);
+
+                    if (3 != (i & 3))
+                        fError[i + 1] += fDiff * (7.0f / 16.0f);
+
+                    if (i < 12)
+                    {
+                        if (i & 3)
+                            fError[i + 3] += fDiff * (3.0f / 16.0f);
+
+                        fError[i + 4] += fDiff * (5.0f / 16.0f);
+
+                        if (3 != (i & 3))
+                            fError[i + 5] += fDiff * (1.0f / 16.0f);
+                    }
+                }
+            }
+
+            pBC3->bitmap[0 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[0];
+            pBC3->bitmap[1 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[1];
+            pBC3->bitmap[2 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[2];
+        }
+    }
+
+#ifdef BC_BATCH_SIMD
+    //-------------------------------------------------------------------------------------
+    // Batched BC1 color encoding
+    //
+    // Processes BC_BATCH_BLOCKS blocks at once with one block per SIMD lane, so the
+    // per-pixel loops of the endpoint search and index selection run on all blocks
+    // together. Follows EncodeBC1 step by step (without dithering), with per-lane masks
+    // standing in for its early-outs.
+    //-------------------------------------------------------------------------------------
+    inline bool UseBatchEncoder(uint32_t flags) noexcept
+    {
+        // The lane instructions are fixed when DirectXMath is compiled (SSE2, SSE4.1, AVX2, ...);
+        // this only guards against running on a CPU without them, which uses the per-block encoder
+        static const bool s_supported = XMVerifyCPUSupport();
+        return (flags & BC_FLAGS_BATCH) && s_supported;
+    }
+
+    void OptimizeRGBBatch(
+        _Out_writes_(3) XMVECTOR *pX,
+        _Out_writes_(3) XMVECTOR *pY,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pR,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pG,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pB,
+        FXMVECTOR v3Steps,
+        uint32_t flags) noexcept
+    {
+        static const float pC3[] = { 2.0f / 2.0f, 1.0f / 2.0f, 0.0f / 2.0f, 0.0f };
+        static const float pD3[] = { 0.0f / 2.0f, 1.0f / 2.0f, 2.0f / 2.0f, 0.0f };
+        static const float pC4[] = { 3.0f / 3.0f, 2.0f / 3.0f, 1.0f / 3.0f, 0.0f / 3.0f };
+        static const float pD4[] = { 0.0f / 3.0f, 1.0f / 3.0f, 2.0f / 3.0f, 3.0f / 3.0f };
+
+        static const XMVECTORF32 s_Epsilon = { { { (0.25f / 64.0f) * (0.25f / 64.0f), (0.25f / 64.0f) * (0.25f / 64.0f), (0.25f / 64.0f) * (0.25f / 64.0f), (0.25f / 64.0f) * (0.25f / 64.0f) } } };
+        static const XMVECTORF32 s_MinLen = { { { 1.0f / 4096.0f, 1.0f / 4096.0f, 1.0f / 4096.0f, 1.0f / 4096.0f } } };
+        static const XMVECTORF32 s_FltMin = { { { FLT_MIN, FLT_MIN, FLT_MIN, FLT_MIN } } };
+        static const XMVECTORF32 s_Eighth = { { { 1.0f / 8.0f, 1.0f / 8.0f, 1.0f / 8.0f, 1.0f / 8.0f } } };
+        static const XMVECTORF32 s_Two = { { { 2.0f, 2.0f, 2.0f, 2.0f } } };
+        static const XMVECTORF32 s_Three = { { { 3.0f, 3.0f, 3.0f, 3.0f } } };
+
+        // Find Min and Max points, as starting point
+        XMVECTOR Xr, Xg, Xb;
+        if (flags & BC_FLAGS_UNIFORM)
+        {
+            Xr = Xg = Xb = g_XMOne;
+        }
+        else
+        {
+            Xr = XMVectorReplicate(g_Luminance.r);
+            Xg = XMVectorReplicate(g_Luminance.g);
+            Xb = XMVectorReplicate(g_Luminance.b);
+        }
+
+        XMVECTOR Yr = XMVectorZero();
+        XMVECTOR Yg = XMVectorZero();
+        XMVECTOR Yb = XMVectorZero();
+
+        for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+        {
+            Xr = XMVectorMin(Xr, pR[iPoint]);
+            Xg = XMVectorMin(Xg, pG[iPoint]);
+            Xb = XMVectorMin(Xb, pB[iPoint]);
+
+            Yr = XMVectorMax(Yr, pR[iPoint]);
+            Yg = XMVectorMax(Yg, pG[iPoint]);
+            Yb = XMVectorMax(Yb, pB[iPoint]);
+        }
+
+        // Diagonal axis
+        const XMVECTOR ABr = XMVectorSubtract(Yr, Xr);
+        const XMVECTOR ABg = XMVectorSubtract(Yg, Xg);
+        const XMVECTOR ABb = XMVectorSubtract(Yb, Xb);
+
+        const XMVECTOR fAB = XMVectorAdd(XMVectorAdd(XMVectorMultiply(ABr, ABr), XMVectorMultiply(ABg, ABg)), XMVectorMultiply(ABb, ABb));
+
+        // Single color blocks keep the min/max as-is
+        const XMVECTOR vSingle = XMVectorLess(fAB, s_FltMin);
+
+        // Try all four axis directions, to determine which diagonal best fits data
+        const XMVECTOR fABInv = XMVectorReciprocal(fAB);
+
+        const XMVECTOR Dr = XMVectorMultiply(ABr, fABInv);
+        const XMVECTOR Dg = XMVectorMultiply(ABg, fABInv);
+        const XMVECTOR Db = XMVectorMultiply(ABb, fABInv);
+
+        const XMVECTOR Mr = XMVectorMultiply(XMVectorAdd(Xr, Yr), g_XMOneHalf);
+        const XMVECTOR Mg = XMVectorMultiply(XMVectorAdd(Xg, Yg), g_XMOneHalf);
+        const XMVECTOR Mb = XMVectorMultiply(XMVectorAdd(Xb, Yb), g_XMOneHalf);
+
+        XMVECTOR fDir[4] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+
+        for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+        {
+            const XMVECTOR Ptr = XMVectorMultiply(XMVectorSubtract(pR[iPoint], Mr), Dr);
+            const XMVECTOR Ptg = XMVectorMultiply(XMVectorSubtract(pG[iPoint], Mg), Dg);
+            const XMVECTOR Ptb = XMVectorMultiply(XMVectorSubtract(pB[iPoint], Mb), Db);
+
+            const XMVECTOR RpG = XMVectorAdd(Ptr, Ptg);
+            const XMVECTOR RmG = XMVectorSubtract(Ptr, Ptg);
+
+            XMVECTOR f = XMVectorAdd(RpG, Ptb);
+            fDir[0] = XMVectorAdd(fDir[0], XMVectorMultiply(f, f));
+
+            f = XMVectorSubtract(RpG, Ptb);
+            fDir[1] = XMVectorAdd(fDir[1], XMVectorMultiply(f, f));
+
+            f = XMVectorAdd(RmG, Ptb);
+            fDir[2] = XMVectorAdd(fDir[2], XMVectorMultiply(f, f));
+
+            f = XMVectorSubtract(RmG, Ptb);
+            fDir[3] = XMVectorAdd(fDir[3], XMVectorMultiply(f, f));
+        }
+
+        // Direction index bit 1 swaps green, bit 0 swaps blue; first maximum wins
+        XMVECTOR fDirMax = fDir[0];
+        XMVECTOR vSwapG = XMVectorFalseInt();
+        XMVECTOR vSwapB = XMVectorFalseInt();
+
+        for (size_t iDir = 1; iDir < 4; iDir++)
+        {
+            const XMVECTOR vBetter = XMVectorGreater(fDir[iDir], fDirMax);
+            fDirMax = XMVectorSelect(fDirMax, fDir[iDir], vBetter);
+            vSwapG = (iDir & 2) ? XMVectorOrInt(vSwapG, vBetter) : XMVectorAndCInt(vSwapG, vBetter);
+            vSwapB = (iDir & 1) ? XMVectorOrInt(vSwapB, vBetter) : XMVectorAndCInt(vSwapB, vBetter);
+        }
+
+        vSwapG = XMVectorAndCInt(vSwapG, vSingle);
+        vSwapB = XMVectorAndCInt(vSwapB, vSingle);
+
+        {
+            const XMVECTOR g = Xg;
+            Xg = XMVectorSelect(Xg, Yg, vSwapG);
+            Yg = XMVectorSelect(Yg, g, vSwapG);
+
+            const XMVECTOR b = Xb;
+            Xb = XMVectorSelect(Xb, Yb, vSwapB);
+            Yb = XMVectorSelect(Yb, b, vSwapB);
+        }
+
+        // Single and two color blocks don't need to root-find
+        XMVECTOR vActive = XMVectorGreaterOrEqual(fAB, s_MinLen);
+
+        // Use Newton's Method to find local minima of sum-of-squares error.
+        const XMVECTOR fSteps = XMVectorSelect(s_Three, s_Two, v3Steps);
+
+        XMVECTOR vC[4], vD[4];
+        for (size_t iStep = 0; iStep < 4; iStep++)
+        {
+            vC[iStep] = XMVectorSelect(XMVectorReplicate(pC4[iStep]), XMVectorReplicate(pC3[iStep]), v3Steps);
+            vD[iStep] = XMVectorSelect(XMVectorReplicate(pD4[iStep]), XMVectorReplicate(pD3[iStep]), v3Steps);
+        }
+
+        for (size_t iIteration = 0; iIteration < 8; iIteration++)
+        {
+            // Calculate color direction
+            XMVECTOR Dir_r = XMVectorSubtract(Yr, Xr);
+            XMVECTOR Dir_g = XMVectorSubtract(Yg, Xg);
+            XMVECTOR Dir_b = XMVectorSubtract(Yb, Xb);
+
+            const XMVECTOR fLen = XMVectorAdd(XMVectorAdd(XMVectorMultiply(Dir_r, Dir_r), XMVectorMultiply(Dir_g, Dir_g)), XMVectorMultiply(Dir_b, Dir_b));
+
+            vActive = XMVectorAndCInt(vActive, XMVectorLess(fLen, s_MinLen));
+            if (XMVector4EqualInt(vActive, XMVectorFalseInt()))
+                break;
+
+            const XMVECTOR fScale = XMVectorDivide(fSteps, fLen);
+
+            Dir_r = XMVectorMultiply(Dir_r, fScale);
+            Dir_g = XMVectorMultiply(Dir_g, fScale);
+            Dir_b = XMVectorMultiply(Dir_b, fScale);
+
+            // Calculate new steps
+            XMVECTOR Sr[4], Sg[4], Sb[4];
+            for (size_t iStep = 0; iStep < 4; iStep++)
+            {
+                Sr[iStep] = XMVectorAdd(XMVectorMultiply(Xr, vC[iStep]), XMVectorMultiply(Yr, vD[iStep]));
+                Sg[iStep] = XMVectorAdd(XMVectorMultiply(Xg, vC[iStep]), XMVectorMultiply(Yg, vD[iStep]));
+                Sb[iStep] = XMVectorAdd(XMVectorMultiply(Xb, vC[iStep]), XMVectorMultiply(Yb, vD[iStep]));
+            }
+
+            // Evaluate function, and derivatives
+            XMVECTOR d2X = XMVectorZero();
+            XMVECTOR d2Y = XMVectorZero();
+            XMVECTOR dXr = XMVectorZero();
+            XMVECTOR dXg = XMVectorZero();
+            XMVECTOR dXb = XMVectorZero();
+            XMVECTOR dYr = XMVectorZero();
+            XMVECTOR dYg = XMVectorZero();
+            XMVECTOR dYb = XMVectorZero();
+
+            for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+            {
+                const XMVECTOR fDot = XMVectorAdd(XMVectorAdd(
+                    XMVectorMultiply(XMVectorSubtract(pR[iPoint], Xr), Dir_r),
+                    XMVectorMultiply(XMVectorSubtract(pG[iPoint], Xg), Dir_g)),
+                    XMVectorMultiply(XMVectorSubtract(pB[iPoint], Xb), Dir_b));
+
+                XMVECTOR iStep = XMVectorTruncate(XMVectorAdd(fDot, g_XMOneHalf));
+                iStep = XMVectorSelect(iStep, fSteps, XMVectorGreaterOrEqual(fDot, fSteps));
+                iStep = XMVectorSelect(iStep, XMVectorZero(), XMVectorLessOrEqual(fDot, XMVectorZero()));
+
+                const XMVECTOR vIs1 = XMVectorEqual(iStep, g_XMOne);
+                const XMVECTOR vIs2 = XMVectorEqual(iStep, s_Two);
+                const XMVECTOR vIs3 = XMVectorEqual(iStep, s_Three);
+
+                XMVECTOR C = XMVectorSelect(XMVectorSelect(XMVectorSelect(vC[0], vC[1], vIs1), vC[2], vIs2), vC[3], vIs3);
+                XMVECTOR D = XMVectorSelect(XMVectorSelect(XMVectorSelect(vD[0], vD[1], vIs1), vD[2], vIs2), vD[3], vIs3);
+
+                const XMVECTOR Diffr = XMVectorSubtract(XMVectorSelect(XMVectorSelect(XMVectorSelect(Sr[0], Sr[1], vIs1), Sr[2], vIs2), Sr[3], vIs3), pR[iPoint]);
+                const XMVECTOR Diffg = XMVectorSubtract(XMVectorSelect(XMVectorSelect(XMVectorSelect(Sg[0], Sg[1], vIs1), Sg[2], vIs2), Sg[3], vIs3), pG[iPoint]);
+                const XMVECTOR Diffb = XMVectorSubtract(XMVectorSelect(XMVectorSelect(XMVectorSelect(Sb[0], Sb[1], vIs1), Sb[2], vIs2), Sb[3], vIs3), pB[iPoint]);
+
+                const XMVECTOR fC = XMVectorMultiply(C, s_Eighth);
+                const XMVECTOR fD = XMVectorMultiply(D, s_Eighth);
+
+                d2X = XMVectorAdd(d2X, XMVectorMultiply(fC, C));
+                dXr = XMVectorAdd(dXr, XMVectorMultiply(fC, Diffr));
+                dXg = XMVectorAdd(dXg, XMVectorMultiply(fC, Diffg));
+                dXb = XMVectorAdd(dXb, XMVectorMultiply(fC, Diffb));
+
+                d2Y = XMVectorAdd(d2Y, XMVectorMultiply(fD, D));
+                dYr = XMVectorAdd(dYr, XMVectorMultiply(fD, Diffr));
+                dYg = XMVectorAdd(dYg, XMVectorMultiply(fD, Diffg));
+                dYb = XMVectorAdd(dYb, XMVectorMultiply(fD, Diffb));
+            }
+
+            // Move endpoints
+            const XMVECTOR vMoveX = XMVectorAndInt(vActive, XMVectorGreater(d2X, XMVectorZero()));
+            const XMVECTOR fX = XMVectorNegate(XMVectorReciprocal(d2X));
+
+            Xr = XMVectorSelect(Xr, XMVectorAdd(Xr, XMVectorMultiply(dXr, fX)), vMoveX);
+            Xg = XMVectorSelect(Xg, XMVectorAdd(Xg, XMVectorMultiply(dXg, fX)), vMoveX);
+            Xb = XMVectorSelect(Xb, XMVectorAdd(Xb, XMVectorMultiply(dXb, fX)), vMoveX);
+
+            const XMVECTOR vMoveY = XMVectorAndInt(vActive, XMVectorGreater(d2Y, XMVectorZero()));
+            const XMVECTOR fY = XMVectorNegate(XMVectorReciprocal(d2Y));
+
+            Yr = XMVectorSelect(Yr, XMVectorAdd(Yr, XMVectorMultiply(dYr, fY)), vMoveY);
+            Yg = XMVectorSelect(Yg, XMVectorAdd(Yg, XMVectorMultiply(dYg, fY)), vMoveY);
+            Yb = XMVectorSelect(Yb, XMVectorAdd(Yb, XMVectorMultiply(dYb, fY)), vMoveY);
+
+            XMVECTOR vConverged = XMVectorLess(XMVectorMultiply(dXr, dXr), s_Epsilon);
+            vConverged = XMVectorAndInt(vConverged, XMVectorLess(XMVectorMultiply(dXg, dXg), s_Epsilon));
+            vConverged = XMVectorAndInt(vConverged, XMVectorLess(XMVectorMultiply(dXb, dXb), s_Epsilon));
+            vConverged = XMVectorAndInt(vConverged, XMVectorLess(XMVectorMultiply(dYr, dYr), s_Epsilon));
+            vConverged = XMVectorAndInt(vConverged, XMVectorLess(XMVectorMultiply(dYg, dYg), s_Epsilon));
+            vConverged = XMVectorAndInt(vConverged, XMVectorLess(XMVectorMultiply(dYb, dYb), s_Epsilon));
+
+            vActive = XMVectorAndCInt(vActive, vConverged);
+        }
+
+        pX[0] = Xr; pX[1] = Xg; pX[2] = Xb;
+        pY[0] = Yr; pY[1] = Yg; pY[2] = Yb;
+    }
+
+    //-------------------------------------------------------------------------------------
+    void EncodeBC1Batch(
+        _Out_writes_(BC_BATCH_BLOCKS) D3DX_BC1 *pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK * count) const XMVECTOR *pColor,
+        size_t count,
+        bool bColorKey,
+        float threshold,
+        uint32_t flags) noexcept
+    {
+        assert(pBC && pColor && count > 0 && count <= BC_BATCH_BLOCKS);
+        assert(!(flags & BC_FLAGS_DITHER_RGB));
+
+        static const XMVECTORF32 s_Scale565 = { { { 31.0f, 63.0f, 31.0f, 0.0f } } };
+        static const XMVECTORF32 s_Sixteen = { { { 16.0f, 16.0f, 16.0f, 16.0f } } };
+        static const XMVECTORF32 s_Two = { { { 2.0f, 2.0f, 2.0f, 2.0f } } };
+        static const XMVECTORF32 s_Three = { { { 3.0f, 3.0f, 3.0f, 3.0f } } };
+
+        // Transpose to one block per lane; a short batch repeats its last block
+        const XMVECTOR *pBlock[BC_BATCH_BLOCKS];
+        for (size_t j = 0; j < BC_BATCH_BLOCKS; ++j)
+        {
+            pBlock[j] = pColor + std::min(j, count - 1) * NUM_PIXELS_PER_BLOCK;
+        }
+
+        XMVECTOR R[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR G[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR B[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR A[NUM_PIXELS_PER_BLOCK];
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const XMMATRIX M = XMMatrixTranspose(XMMATRIX(pBlock[0][i], pBlock[1][i], pBlock[2][i], pBlock[3][i]));
+            R[i] = M.r[0];
+            G[i] = M.r[1];
+            B[i] = M.r[2];
+            A[i] = M.r[3];
+        }
+
+        // Determine if we need to colorkey these blocks
+        const XMVECTOR vThreshold = XMVectorReplicate(threshold);
+
+        XMVECTOR vColorKey = XMVectorZero();
+        if (bColorKey)
+        {
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                vColorKey = XMVectorAdd(vColorKey, XMVectorAndInt(XMVectorLess(A[i], vThreshold), g_XMOne));
+            }
+        }
+
+        const XMVECTOR vAllKey = XMVectorEqual(vColorKey, s_Sixteen);
+        const XMVECTOR v3Steps = XMVectorGreater(vColorKey, XMVectorZero());
+
+        // Quantize blocks to R5G6B5
+        const bool uniform = (flags & BC_FLAGS_UNIFORM) != 0;
+        const float lum[3] = {
+            uniform ? 1.0f : g_Luminance.r,
+            uniform ? 1.0f : g_Luminance.g,
+            uniform ? 1.0f : g_Luminance.b };
+        const float lumInv[3] = {
+            uniform ? 1.0f : g_LuminanceInv.r,
+            uniform ? 1.0f : g_LuminanceInv.g,
+            uniform ? 1.0f : g_LuminanceInv.b };
+
+        const XMVECTOR vLumR = XMVectorReplicate(lum[0]);
+        const XMVECTOR vLumG = XMVectorReplicate(lum[1]);
+        const XMVECTOR vLumB = XMVectorReplicate(lum[2]);
+
+        const XMVECTOR vScaleR = XMVectorSplatX(s_Scale565);
+        const XMVECTOR vScaleG = XMVectorSplatY(s_Scale565);
+        const XMVECTOR vInvScaleR = XMVectorReplicate(1.0f / 31.0f);
+        const XMVECTOR vInvScaleG = XMVectorReplicate(1.0f / 63.0f);
+
+        XMVECTOR Color_r[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR Color_g[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR Color_b[NUM_PIXELS_PER_BLOCK];
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            Color_r[i] = XMVectorMultiply(XMVectorTruncate(XMVectorAdd(XMVectorMultiply(R[i], vScaleR), g_XMOneHalf)), vInvScaleR);
+            Color_g[i] = XMVectorMultiply(XMVectorTruncate(XMVectorAdd(XMVectorMultiply(G[i], vScaleG), g_XMOneHalf)), vInvScaleG);
+            Color_b[i] = XMVectorMultiply(XMVectorTruncate(XMVectorAdd(XMVectorMultiply(B[i], vScaleR), g_XMOneHalf)), vInvScaleR);
+
+            Color_r[i] = XMVectorMultiply(Color_r[i], vLumR);
+            Color_g[i] = XMVectorMultiply(Color_g[i], vLumG);
+            Color_b[i] = XMVectorMultiply(Color_b[i], vLumB);
+        }
+
+        // Perform 6D root finding function to find two endpoints of color axis.
+        XMVECTOR ColorA[3], ColorB[3];
+        OptimizeRGBBatch(ColorA, ColorB, Color_r, Color_g, Color_b, v3Steps, flags);
+
+        // Quantize and sort the endpoints of each block
+        XM_ALIGNED_DATA(16) float fColorA[3][4];
+        XM_ALIGNED_DATA(16) float fColorB[3][4];
+        XM_ALIGNED_DATA(16) uint32_t uAllKey[4];
+        XM_ALIGNED_DATA(16) uint32_t u3Steps[4];
+
+        for (size_t c = 0; c < 3; ++c)
+        {
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(fColorA[c]), ColorA[c]);
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(fColorB[c]), ColorB[c]);
+        }
+
+        XMStoreInt4A(uAllKey, vAllKey);
+        XMStoreInt4A(u3Steps, v3Steps);
+
+        XM_ALIGNED_DATA(16) float fStep0[3][4] = {};
+        XM_ALIGNED_DATA(16) float fDir[3][4] = {};
+        bool bDone[BC_BATCH_BLOCKS] = {};
+
+        for (size_t j = 0; j < BC_BATCH_BLOCKS; ++j)
+        {
+            if (uAllKey[j])
+            {
+                pBC[j].rgb[0] = 0x0000;
+                pBC[j].rgb[1] = 0xffff;
+                pBC[j].bitmap = 0xffffffff;
+                bDone[j] = true;
+                continue;
+            }
+
+            const uint32_t uSteps = (u3Steps[j]) ? 3u : 4u;
+
+            HDRColorA ColorC(fColorA[0][j] * lumInv[0], fColorA[1][j] * lumInv[1], fColorA[2][j] * lumInv[2], 1.0f);
+            HDRColorA ColorD(fColorB[0][j] * lumInv[0], fColorB[1][j] * lumInv[1], fColorB[2][j] * lumInv[2], 1.0f);
+
+            const uint16_t wColorA = Encode565(&ColorC);
+            const uint16_t wColorB = Encode565(&ColorD);
+
+            if ((uSteps == 4) && (wColorA == wColorB))
+            {
+                pBC[j].rgb[0] = wColorA;
+                pBC[j].rgb[1] = wColorB;
+                pBC[j].bitmap = 0x00000000;
+                bDone[j] = true;
+                continue;
+            }
+
+            Decode565(&ColorC, wColorA);
+            Decode565(&ColorD, wColorB);
+
+            const HDRColorA EndA(ColorC.r * lum[0], ColorC.g * lum[1], ColorC.b * lum[2], 1.0f);
+            const HDRColorA EndB(ColorD.r * lum[0], ColorD.g * lum[1], ColorD.b * lum[2], 1.0f);
+
+            HDRColorA Step[2];
+            if ((3 == uSteps) == (wColorA <= wColorB))
+            {
+                pBC[j].rgb[0] = wColorA;
+                pBC[j].rgb[1] = wColorB;
+
+                Step[0] = EndA;
+                Step[1] = EndB;
+            }
+            else
+            {
+                pBC[j].rgb[0] = wColorB;
+                pBC[j].rgb[1] = wColorA;
+
+                Step[0] = EndB;
+                Step[1] = EndA;
+            }
+
+            // Calculate color direction
+            HDRColorA Dir;
+            Dir.r = Step[1].r - Step[0].r;
+            Dir.g = Step[1].g - Step[0].g;
+            Dir.b = Step[1].b - Step[0].b;
+
+            const auto fSteps = static_cast<float>(uSteps - 1);
+            const float fScale = (wColorA != wColorB) ? (fSteps / (Dir.r * Dir.r + Dir.g * Dir.g + Dir.b * Dir.b)) : 0.0f;
+
+            fStep0[0][j] = Step[0].r;
+            fStep0[1][j] = Step[0].g;
+            fStep0[2][j] = Step[0].b;
+
+            fDir[0][j] = Dir.r * fScale;
+            fDir[1][j] = Dir.g * fScale;
+            fDir[2][j] = Dir.b * fScale;
+        }
+
+        // Encode colors
+        const XMVECTOR S0r = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fStep0[0]));
+        const XMVECTOR S0g = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fStep0[1]));
+        const XMVECTOR S0b = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fStep0[2]));
+
+        const XMVECTOR Dir_r = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fDir[0]));
+        const XMVECTOR Dir_g = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fDir[1]));
+        const XMVECTOR Dir_b = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fDir[2]));
+
+        const XMVECTOR fSteps = XMVectorSelect(s_Three, s_Two, v3Steps);
+
+        // Palette order for the 'middle' indices: { 0, 2, 3, 1 } for 4 steps, { 0, 2, 1 } for 3 steps
+        const XMVECTOR vMid2 = XMVectorSelect(s_Three, g_XMOne, v3Steps);
+
+        XM_ALIGNED_DATA(16) uint32_t uIndex[NUM_PIXELS_PER_BLOCK][4];
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const XMVECTOR Clr_r = XMVectorMultiply(R[i], vLumR);
+            const XMVECTOR Clr_g = XMVectorMultiply(G[i], vLumG);
+            const XMVECTOR Clr_b = XMVectorMultiply(B[i], vLumB);
+
+            const XMVECTOR fDot = XMVectorAdd(XMVectorAdd(
+                XMVectorMultiply(XMVectorSubtract(Clr_r, S0r), Dir_r),
+                XMVectorMultiply(XMVectorSubtract(Clr_g, S0g), Dir_g)),
+                XMVectorMultiply(XMVectorSubtract(Clr_b, S0b), Dir_b));
+
+            const XMVECTOR k = XMVectorTruncate(XMVectorAdd(fDot, g_XMOneHalf));
+
+            XMVECTOR iStep = XMVectorSelect(XMVectorZero(), s_Two, XMVectorEqual(k, g_XMOne));
+            iStep = XMVectorSelect(iStep, vMid2, XMVectorEqual(k, s_Two));
+            iStep = XMVectorSelect(iStep, g_XMOne, XMVectorEqual(k, s_Three));
+            iStep = XMVectorSelect(iStep, g_XMOne, XMVectorGreaterOrEqual(fDot, fSteps));
+            iStep = XMVectorSelect(iStep, XMVectorZero(), XMVectorLessOrEqual(fDot, XMVectorZero()));
+
+            if (bColorKey)
+            {
+                iStep = XMVectorSelect(iStep, s_Three, XMVectorAndInt(v3Steps, XMVectorLess(A[i], vThreshold)));
+            }
+
+            XMStoreInt4A(uIndex[i], XMConvertVectorFloatToUInt(iStep, 0));
+        }
+
+        for (size_t j = 0; j < BC_BATCH_BLOCKS; ++j)
+        {
+            if (bDone[j])
+                continue;
+
+            uint32_t dw = 0;
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                dw = (uIndex[i][j] << 30) | (dw >> 2);
+            }
+
+            pBC[j].bitmap = dw;
+        }
+    }
+#endif // BC_BATCH_SIMD
 }
 
 
@@ -794,6 +1482,38 @@ void DirectX::D3DXEncodeBC1(uint8_t *pBC, const XMVECTOR *pColor, float threshol
     EncodeBC1(pBC1, Color, true, threshold, flags);
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC1Batch(uint8_t *pBC, const XMVECTOR *pColor, size_t count, float threshold, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+
+#ifdef BC_BATCH_SIMD
+    if (!(flags & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A)) && UseBatchEncoder(flags))
+    {
+        auto pBC1 = reinterpret_cast<D3DX_BC1 *>(pBC);
+
+        while (count > 0)
+        {
+            const size_t batch = std::min<size_t>(count, BC_BATCH_BLOCKS);
+
+            D3DX_BC1 blocks[BC_BATCH_BLOCKS];
+            EncodeBC1Batch(blocks, pColor, batch, true, threshold, flags);
+            memcpy(pBC1, blocks, batch * sizeof(D3DX_BC1));
+
+            pBC1 += batch;
+            pColor += batch * NUM_PIXELS_PER_BLOCK;
+            count -= batch;
+        }
+        return;
+    }
+#endif // BC_BATCH_SIMD
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        D3DXEncodeBC1(pBC + j * sizeof(D3DX_BC1), pColor + j * NUM_PIXELS_PER_BLOCK, threshold, flags);
+    }
+}
+
 
 //-------------------------------------------------------------------------------------
 // BC2 Compression
@@ -954,188 +1674,133 @@ void DirectX::D3DXEncodeBC3(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags
 
     auto pBC3 = reinterpret_cast<D3DX_BC3 *>(pBC);
 
-    // Quantize block to A8, using Floyd Stienberg error diffusion.  This
-    // increases the chance that colors will map directly to the quantized
-    // axis endpoints.
-    float fAlpha[NUM_PIXELS_PER_BLOCK] = {};
-    float fError[NUM_PIXELS_PER_BLOCK] = {};
-
-    float fMinAlpha = Color[0].a;
-    float fMaxAlpha = Color[0].a;
+    // RGB part
+    EncodeBC1(&pBC3->bc1, Color, false, 0.f, flags);
 
-    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
-    {
-        float fAlph = Color[i].a;
-        if (flags & BC_FLAGS_DITHER_A)
-            fAlph += fError[i];
+    // Alpha part
+    EncodeBC3Alpha(pBC3, Color, flags);
+}
 
-        fAlpha[i] = static_cast<float>(static_cast<int32_t>(fAlph * 255.0f + 0.5f)) * (1.0f / 255.0f);
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC3Batch(uint8_t *pBC, const XMVECTOR *pColor, size_t count, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
 
-        if (fAlpha[i] < fMinAlpha)
-            fMinAlpha = fAlpha[i];
-        else if (fAlpha[i] > fMaxAlpha)
-            fMaxAlpha = fAlpha[i];
+#ifdef BC_BATCH_SIMD
+    if (!(flags & BC_FLAGS_DITHER_RGB) && UseBatchEncoder(flags))
+    {
+        auto pBC3 = reinterpret_cast<D3DX_BC3 *>(pBC);
 
-        if (flags & BC_FLAGS_DITHER_A)
+        while (count > 0)
         {
-            const float fDiff = fAlph - fAlpha[i];
+            const size_t batch = std::min<size_t>(count, BC_BATCH_BLOCKS);
 
-            if (3 != (i & 3))
-            {
-                assert(i < 15);
-                _Analysis_assume_(i < 15);
-                fError[i + 1] += fDiff * (7.0f / 16.0f);
-            }
+            // RGB part
+            D3DX_BC1 blocks[BC_BATCH_BLOCKS];
+            EncodeBC1Batch(blocks, pColor, batch, false, 0.f, flags);
 
-            if (i < 12)
+            // Alpha part
+            for (size_t j = 0; j < batch; ++j)
             {
-                if (i & 3)
-                    fError[i + 3] += fDiff * (3.0f / 16.0f);
-
-                fError[i + 4] += fDiff * (5.0f / 16.0f);
-
-                if (3 != (i & 3))
+                HDRColorA Color[NUM_PIXELS_PER_BLOCK];
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
                 {
-                    assert(i < 11);
-                    _Analysis_assume_(i < 11);
-                    fError[i + 5] += fDiff * (1.0f / 16.0f);
+                    XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&Color[i]), pColor[j * NUM_PIXELS_PER_BLOCK + i]);
                 }
+
+                pBC3[j].bc1 = blocks[j];
+                EncodeBC3Alpha(&pBC3[j], Color, flags);
             }
-        }
-    }
 
-#ifdef COLOR_WEIGHTS
-    if (0.0f == fMaxAlpha)
-    {
-        EncodeSolidBC1(&pBC3->dxt1, Color);
-        pBC3->alpha[0] = 0x00;
-        pBC3->alpha[1] = 0x00;
-        memset(pBC3->bitmap, 0x00, 6);
+            pBC3 += batch;
+            pColor += batch * NUM_PIXELS_PER_BLOCK;
+            count -= batch;
+        }
+        return;
     }
-#endif
-
-    // RGB part
-    EncodeBC1(&pBC3->bc1, Color, false, 0.f, flags);
+#endif // BC_BATCH_SIMD
 
-    // Alpha part
-    if (1.0f == fMinAlpha)
+    for (size_t j = 0; j < count; ++j)
     {
-        pBC3->alpha[0] = 0xff;
-        pBC3->alpha[1] = 0xff;
-        memset(pBC3->bitmap, 0x00, 6);
-        return;
+        D3DXEncodeBC3(pBC + j * sizeof(D3DX_BC3), pColor + j * NUM_PIXELS_PER_BLOCK, flags);
     }
+}
 
-    // Optimize and Quantize Min and Max values
-    const uint32_t uSteps = ((0.0f == fMinAlpha) || (1.0f == fMaxAlpha)) ? 6u : 8u;
 
-    float fAlphaA, fAlphaB;
-    OptimizeAlpha<false>(&fAlphaA, &fAlphaB, fAlpha, uSteps);
+//-------------------------------------------------------------------------------------
+// Block permutation
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::D3DXPermuteBC1(uint8_t *pBC, const uint8_t *pSrc, const uint8_t *pRemap) noexcept
+{
+    assert(pBC && pSrc && pRemap && pBC != pSrc);
+    static_assert(sizeof(D3DX_BC1) == 8, "D3DX_BC1 should be 8 bytes");
 
-    const auto bAlphaA = static_cast<uint8_t>(static_cast<int32_t>(fAlphaA * 255.0f + 0.5f));
-    const auto bAlphaB = static_cast<uint8_t>(static_cast<int32_t>(fAlphaB * 255.0f + 0.5f));
+    auto pSrcBC1 = reinterpret_cast<const D3DX_BC1 *>(pSrc);
+    auto pBC1 = reinterpret_cast<D3DX_BC1 *>(pBC);
 
-    fAlphaA = static_cast<float>(bAlphaA) * (1.0f / 255.0f);
-    fAlphaB = static_cast<float>(bAlphaB) * (1.0f / 255.0f);
+    pBC1->rgb[0] = pSrcBC1->rgb[0];
+    pBC1->rgb[1] = pSrcBC1->rgb[1];
 
-    // Setup block
-    if ((8 == uSteps) && (bAlphaA == bAlphaB))
+    // 2-bit color indices
+    uint32_t dw = 0;
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
     {
-        pBC3->alpha[0] = bAlphaA;
-        pBC3->alpha[1] = bAlphaB;
-        memset(pBC3->bitmap, 0x00, 6);
-        return;
+        assert(pRemap[i] < NUM_PIXELS_PER_BLOCK);
+        dw |= ((pSrcBC1->bitmap >> (2 * pRemap[i])) & 0x3) << (2 * i);
     }
 
-    static const size_t pSteps6[] = { 0, 2, 3, 4, 5, 1 };
-    static const size_t pSteps8[] = { 0, 2, 3, 4, 5, 6, 7, 1 };
-
-    const size_t *pSteps;
-    float fStep[8] = {};
-
-    if (6 == uSteps)
-    {
-        pBC3->alpha[0] = bAlphaA;
-        pBC3->alpha[1] = bAlphaB;
+    pBC1->bitmap = dw;
+}
 
-        fStep[0] = fAlphaA;
-        fStep[1] = fAlphaB;
+_Use_decl_annotations_
+void DirectX::D3DXPermuteBC2(uint8_t *pBC, const uint8_t *pSrc, const uint8_t *pRemap) noexcept
+{
+    assert(pBC && pSrc && pRemap && pBC != pSrc);
+    static_assert(sizeof(D3DX_BC2) == 16, "D3DX_BC2 should be 16 bytes");
 
-        for (size_t i = 1; i < 5; ++i)
-            fStep[i + 1] = (fStep[0] * float(5u - i) + fStep[1] * float(i)) * (1.0f / 5.0f);
+    auto pSrcBC2 = reinterpret_cast<const D3DX_BC2 *>(pSrc);
+    auto pBC2 = reinterpret_cast<D3DX_BC2 *>(pBC);
 
-        fStep[6] = 0.0f;
-        fStep[7] = 1.0f;
+    // RGB part
+    D3DXPermuteBC1(reinterpret_cast<uint8_t*>(&pBC2->bc1), reinterpret_cast<const uint8_t*>(&pSrcBC2->bc1), pRemap);
 
-        pSteps = pSteps6;
-    }
-    else
+    // 4-bit alpha part
+    uint32_t dw[2] = {};
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
     {
-        pBC3->alpha[0] = bAlphaB;
-        pBC3->alpha[1] = bAlphaA;
-
-        fStep[0] = fAlphaB;
-        fStep[1] = fAlphaA;
-
-        for (size_t i = 1; i < 7; ++i)
-            fStep[i + 1] = (fStep[0] * float(7u - i) + fStep[1] * float(i)) * (1.0f / 7.0f);
-
-        pSteps = pSteps8;
+        const size_t j = pRemap[i];
+        dw[i >> 3] |= ((pSrcBC2->bitmap[j >> 3] >> (4 * (j & 7))) & 0xf) << (4 * (i & 7));
     }
 
-    // Encode alpha bitmap
-    const auto fSteps = static_cast<float>(uSteps - 1);
-    const float fScale = (fStep[0] != fStep[1]) ? (fSteps / (fStep[1] - fStep[0])) : 0.0f;
-
-    if (flags & BC_FLAGS_DITHER_A)
-        memset(fError, 0x00, NUM_PIXELS_PER_BLOCK * sizeof(float));
-
-    for (size_t iSet = 0; iSet < 2; iSet++)
-    {
-        uint32_t dw = 0;
-
-        const size_t iMin = iSet * 8;
-        const size_t iLim = iMin + 8;
-
-        for (size_t i = iMin; i < iLim; ++i)
-        {
-            float fAlph = Color[i].a;
-            if (flags & BC_FLAGS_DITHER_A)
-                fAlph += fError[i];
-            const float fDot = (fAlph - fStep[0]) * fScale;
-
-            uint32_t iStep;
-            if (fDot <= 0.0f)
-                iStep = ((6 == uSteps) && (fAlph <= fStep[0] * 0.5f)) ? 6u : 0u;
-            else if (fDot >= fSteps)
-                iStep = ((6 == uSteps) && (fAlph >= (fStep[1] + 1.0f) * 0.5f)) ? 7u : 1u;
-            else
-                iStep = uint32_t(pSteps[uint32_t(fDot + 0.5f)]);
+    pBC2->bitmap[0] = dw[0];
+    pBC2->bitmap[1] = dw[1];
+}
 
-            dw = (iStep << 21) | (dw >> 3);
+_Use_decl_annotations_
+void DirectX::D3DXPermuteBC3(uint8_t *pBC, const uint8_t *pSrc, const uint8_t *pRemap) noexcept
+{
+    assert(pBC && pSrc && pRemap && pBC != pSrc);
+    static_assert(sizeof(D3DX_BC3) == 16, "D3DX_BC3 should be 16 bytes");
 
-            if (flags & BC_FLAGS_DITHER_A)
-            {
-                const float fDiff = (fAlph - fStep[iStep]);
+    auto pSrcBC3 = reinterpret_cast<const D3DX_BC3 *>(pSrc);
+    auto pBC3 = reinterpret_cast<D3DX_BC3 *>(pBC);
 
-                if (3 != (i & 3))
-                    fError[i + 1] += fDiff * (7.0f / 16.0f);
+    // RGB part
+    D3DXPermuteBC1(reinterpret_cast<uint8_t*>(&pBC3->bc1), reinterpret_cast<const uint8_t*>(&pSrcBC3->bc1), pRemap);
 
-                if (i < 12)
-                {
-                    if (i & 3)
-                        fError[i + 3] += fDiff * (3.0f / 16.0f);
+    // Adaptive 3-bit alpha part
+    pBC3->alpha[0] = pSrcBC3->alpha[0];
+    pBC3->alpha[1] = pSrcBC3->alpha[1];
 
-                    fError[i + 4] += fDiff * (5.0f / 16.0f);
+    uint64_t src = 0;
+    for (size_t i = 0; i < 6; ++i)
+        src |= uint64_t(pSrcBC3->bitmap[i]) << (8 * i);
 
-                    if (3 != (i & 3))
-                        fError[i + 5] += fDiff * (1.0f / 16.0f);
-                }
-            }
-        }
+    uint64_t dw = 0;
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        dw |= ((src >> (3 * pRemap[i])) & 0x7) << (3 * i);
 
-        pBC3->bitmap[0 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[0];
-        pBC3->bitmap[1 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[1];
-        pBC3->bitmap[2 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[2];
-    }
+    for (size_t i = 0; i < 6; ++i, dw >>= 8)
+        pBC3->bitmap[i] = static_cast<uint8_t>(dw & 0xff);
 }
@@ -45,8 +45,29 @@ namespace DirectX
 
         BC_FLAGS_FORCE_BC7_MODE6 = 0x100000,
         // BC7 should only use mode 6; skip other modes
+
+        BC_FLAGS_BATCH = 0x200000,
+        // BC1 and BC3 batch encoders should encode blocks in SIMD lanes rather than one at a time
+
+        BC_FLAGS_BC7_FULL_SEARCH = 0x400000,
+        // BC7 should search every enabled mode even for solid and two color blocks (used to verify the block classifier)
+
+        BC_FLAGS_BC6H_RANK_PER_MODE = 0x800000,
+        // BC6H should rank the shapes again for every mode rather than once per region count (used to verify the shared ranking)
+
+        BC_FLAGS_BC6H_SHAPES_MASK = 0x3F,
+        // Number of BC6H two region shapes to refine per mode; 0 uses the default of 8
+
+        BC_FLAGS_BC7_QUALITY_MASK = 0x700,
+        // BC7 quality level + 1; 0 picks the level implied by the flags above
     };
 
+    constexpr uint32_t BC_FLAGS_BC6H_SHAPES_SHIFT = 0;
+    constexpr uint32_t BC_FLAGS_BC7_QUALITY_SHIFT = 8;
+
+    // Number of blocks the batched BC1/BC3 encoders process together
+    constexpr size_t BC_BATCH_BLOCKS = 4;
+
     //-------------------------------------------------------------------------------------
     // Structures
     //-------------------------------------------------------------------------------------
@@ -317,6 +338,7 @@ namespace DirectX
 
     typedef void (*BC_DECODE)(XMVECTOR *pColor, const uint8_t *pBC);
     typedef void (*BC_ENCODE)(uint8_t *pDXT, const XMVECTOR *pColor, uint32_t flags);
+    typedef void (*BC_PERMUTE)(uint8_t *pBC, const uint8_t *pSrc, const uint8_t *pRemap);
 
     void D3DXDecodeBC1(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor, _In_reads_(8) const uint8_t *pBC) noexcept;
     void D3DXDecodeBC2(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
@@ -342,4 +364,17 @@ namespace DirectX
     void D3DXEncodeBC6HS(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC7(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
 
+    void D3DXEncodeBC1Batch(_Out_writes_(8 * count) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK * count) const XMVECTOR *pColor, _In_ size_t count, _In_ float threshold, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeBC3Batch(_Out_writes_(16 * count) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK * count) const XMVECTOR *pColor, _In_ size_t count, _In_ uint32_t flags) noexcept;
+        // Encodes 'count' consecutive blocks; with BC_FLAGS_BATCH they are encoded BC_BATCH_BLOCKS at a time in SIMD lanes,
+        // otherwise (and for dithered RGB, or BC1 dithered alpha) each block goes through the per-block encoder
+
+    void D3DXPermuteBC1(_Out_writes_(8) uint8_t *pBC, _In_reads_(8) const uint8_t *pSrc, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t *pRemap) noexcept;
+    void D3DXPermuteBC2(_Out_writes_(16) uint8_t *pBC, _In_reads_(16) const uint8_t *pSrc, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t *pRemap) noexcept;
+    void D3DXPermuteBC3(_Out_writes_(16) uint8_t *pBC, _In_reads_(16) const uint8_t *pSrc, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t *pRemap) noexcept;
+    void D3DXPermuteBC4(_Out_writes_(8) uint8_t *pBC, _In_reads_(8) const uint8_t *pSrc, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t *pRemap) noexcept;
+    void D3DXPermuteBC5(_Out_writes_(16) uint8_t *pBC, _In_reads_(16) const uint8_t *pSrc, _In_reads_(NUM_PIXELS_PER_BLOCK) const uint8_t *pRemap) noexcept;
+        // Copies a block with texel i taking the index of source texel pRemap[i]; endpoints are unchanged,
+        // so flips and 90 degree rotations are lossless. BC4/BC5 cover both UNORM and SNORM layouts.
+
 } // namespace
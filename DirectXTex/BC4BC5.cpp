@@ -560,3 +560,34 @@ void DirectX::D3DXEncodeBC5S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
     FindClosestSNORM(pBCR, theTexelsU);
     FindClosestSNORM(pBCG, theTexelsV);
 }
+
+
+//-------------------------------------------------------------------------------------
+// Block permutation
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::D3DXPermuteBC4(uint8_t *pBC, const uint8_t *pSrc, const uint8_t *pRemap) noexcept
+{
+    assert(pBC && pSrc && pRemap && pBC != pSrc);
+    static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
+    static_assert(sizeof(BC4_SNORM) == sizeof(BC4_UNORM), "BC4_SNORM and BC4_UNORM share a layout");
+
+    // Index bits are laid out identically for UNORM and SNORM
+    auto pSrcBC4 = reinterpret_cast<const BC4_UNORM*>(pSrc);
+    auto pBC4 = reinterpret_cast<BC4_UNORM*>(pBC);
+
+    pBC4->data = pSrcBC4->data & 0xffff;
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        assert(pRemap[i] < NUM_PIXELS_PER_BLOCK);
+        pBC4->SetIndex(i, pSrcBC4->GetIndex(pRemap[i]));
+    }
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXPermuteBC5(uint8_t *pBC, const uint8_t *pSrc, const uint8_t *pRemap) noexcept
+{
+    D3DXPermuteBC4(pBC, pSrc, pRemap);
+    D3DXPermuteBC4(pBC + sizeof(BC4_UNORM), pSrc + sizeof(BC4_UNORM), pRemap);
+}
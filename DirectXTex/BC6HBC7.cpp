@@ -13,6 +13,9 @@
 
 #include "BC.h"
 
+#include <atomic>
+#include <chrono>
+
 using namespace DirectX;
 using namespace DirectX::PackedVector;
 
@@ -327,6 +330,159 @@ namespace
     const int g_aWeights2[] = { 0, 21, 43, 64 };
     const int g_aWeights3[] = { 0, 9, 18, 27, 37, 46, 55, 64 };
     const int g_aWeights4[] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // BC7 mode 5 endpoint pairs (7-bit) that reproduce each 8-bit value exactly at color index 1
+    const uint8_t g_aBC7SolidEndpoints[256][2] =
+    {
+        {   0,   0 }, {   0,   1 }, {   1,   1 }, {   1,   2 }, {   2,   2 }, {   2,   3 }, {   3,   3 }, {   3,   4 },
+        {   4,   4 }, {   4,   5 }, {   5,   5 }, {   5,   6 }, {   6,   6 }, {   6,   7 }, {   7,   7 }, {   7,   8 },
+        {   8,   8 }, {   8,   9 }, {   9,   9 }, {   9,  10 }, {  10,  10 }, {  10,  11 }, {  11,  11 }, {  11,  12 },
+        {  12,  12 }, {  12,  13 }, {  13,  13 }, {  13,  14 }, {  14,  14 }, {  14,  15 }, {  15,  15 }, {  15,  16 },
+        {  16,  16 }, {  16,  17 }, {  17,  17 }, {  17,  18 }, {  18,  18 }, {  18,  19 }, {  19,  19 }, {  19,  20 },
+        {  20,  20 }, {  20,  21 }, {  21,  21 }, {  21,  22 }, {  22,  22 }, {  22,  23 }, {  23,  23 }, {  23,  24 },
+        {  24,  24 }, {  24,  25 }, {  25,  25 }, {  25,  26 }, {  26,  26 }, {  26,  27 }, {  27,  27 }, {  27,  28 },
+        {  28,  28 }, {  28,  29 }, {  29,  29 }, {  29,  30 }, {  30,  30 }, {  30,  31 }, {  31,  31 }, {  31,  32 },
+        {  32,  32 }, {  32,  33 }, {  33,  33 }, {  33,  34 }, {  34,  34 }, {  34,  35 }, {  35,  35 }, {  35,  36 },
+        {  36,  36 }, {  36,  37 }, {  37,  37 }, {  37,  38 }, {  38,  38 }, {  38,  39 }, {  39,  39 }, {  39,  40 },
+        {  40,  40 }, {  40,  41 }, {  41,  41 }, {  41,  42 }, {  42,  42 }, {  42,  43 }, {  43,  43 }, {  43,  44 },
+        {  44,  44 }, {  44,  45 }, {  45,  45 }, {  45,  46 }, {  46,  46 }, {  46,  47 }, {  47,  47 }, {  47,  48 },
+        {  48,  48 }, {  48,  49 }, {  49,  49 }, {  49,  50 }, {  50,  50 }, {  50,  51 }, {  51,  51 }, {  51,  52 },
+        {  52,  52 }, {  52,  53 }, {  53,  53 }, {  53,  54 }, {  54,  54 }, {  54,  55 }, {  55,  55 }, {  55,  56 },
+        {  56,  56 }, {  56,  57 }, {  57,  57 }, {  57,  58 }, {  58,  58 }, {  58,  59 }, {  59,  59 }, {  59,  60 },
+        {  60,  60 }, {  60,  61 }, {  61,  61 }, {  61,  62 }, {  62,  62 }, {  62,  63 }, {  63,  63 }, {  63,  64 },
+        {  64,  63 }, {  64,  64 }, {  64,  65 }, {  65,  65 }, {  65,  66 }, {  66,  66 }, {  66,  67 }, {  67,  67 },
+        {  67,  68 }, {  68,  68 }, {  68,  69 }, {  69,  69 }, {  69,  70 }, {  70,  70 }, {  70,  71 }, {  71,  71 },
+        {  71,  72 }, {  72,  72 }, {  72,  73 }, {  73,  73 }, {  73,  74 }, {  74,  74 }, {  74,  75 }, {  75,  75 },
+        {  75,  76 }, {  76,  76 }, {  76,  77 }, {  77,  77 }, {  77,  78 }, {  78,  78 }, {  78,  79 }, {  79,  79 },
+        {  79,  80 }, {  80,  80 }, {  80,  81 }, {  81,  81 }, {  81,  82 }, {  82,  82 }, {  82,  83 }, {  83,  83 },
+        {  83,  84 }, {  84,  84 }, {  84,  85 }, {  85,  85 }, {  85,  86 }, {  86,  86 }, {  86,  87 }, {  87,  87 },
+        {  87,  88 }, {  88,  88 }, {  88,  89 }, {  89,  89 }, {  89,  90 }, {  90,  90 }, {  90,  91 }, {  91,  91 },
+        {  91,  92 }, {  92,  92 }, {  92,  93 }, {  93,  93 }, {  93,  94 }, {  94,  94 }, {  94,  95 }, {  95,  95 },
+        {  95,  96 }, {  96,  96 }, {  96,  97 }, {  97,  97 }, {  97,  98 }, {  98,  98 }, {  98,  99 }, {  99,  99 },
+        {  99, 100 }, { 100, 100 }, { 100, 101 }, { 101, 101 }, { 101, 102 }, { 102, 102 }, { 102, 103 }, { 103, 103 },
+        { 103, 104 }, { 104, 104 }, { 104, 105 }, { 105, 105 }, { 105, 106 }, { 106, 106 }, { 106, 107 }, { 107, 107 },
+        { 107, 108 }, { 108, 108 }, { 108, 109 }, { 109, 109 }, { 109, 110 }, { 110, 110 }, { 110, 111 }, { 111, 111 },
+        { 111, 112 }, { 112, 112 }, { 112, 113 }, { 113, 113 }, { 113, 114 }, { 114, 114 }, { 114, 115 }, { 115, 115 },
+        { 115, 116 }, { 116, 116 }, { 116, 117 }, { 117, 117 }, { 117, 118 }, { 118, 118 }, { 118, 119 }, { 119, 119 },
+        { 119, 120 }, { 120, 120 }, { 120, 121 }, { 121, 121 }, { 121, 122 }, { 122, 122 }, { 122, 123 }, { 123, 123 },
+        { 123, 124 }, { 124, 124 }, { 124, 125 }, { 125, 125 }, { 125, 126 }, { 126, 126 }, { 126, 127 }, { 127, 127 },
+    };
+
+    // BC7 encoder settings for each quality level; 'DirectXTexBench -filter BC7/LEVEL' reports the
+    // ms/MPixel and PSNR of each level on its synthetic blocks and on any fixture images
+    struct BC7Quality
+    {
+        bool    bModeSixOnly;       // only try mode 6
+        bool    bThreeSubsets;      // try the 3 subset modes 0 and 2
+        uint8_t uShapeShift;        // refine the best (shapes >> uShapeShift) rough candidates of each mode
+        uint8_t uExhaustiveDelta;   // endpoint range of the final exhaustive search (0 skips it)
+        bool    bOptimize;          // optimize the endpoints after the initial fit
+    };
+
+    const BC7Quality g_aBC7Quality[] =
+    {
+        { true,  false, 2, 0, false },  // Level 0: mode 6 only, initial fit only
+        { true,  false, 2, 5, true },   // Level 1: mode 6 only (TEX_COMPRESS_BC7_QUICK)
+        { false, false, 6, 3, true },   // Level 2: best rough shape of each mode, narrow exhaustive search
+        { false, false, 2, 5, true },   // Level 3: default
+        { false, true,  2, 5, true },   // Level 4: adds modes 0 and 2 (TEX_COMPRESS_BC7_USE_3SUBSETS)
+        { false, true,  1, 8, true },   // Level 5: twice the shapes, wider exhaustive search
+    };
+
+    inline const BC7Quality& GetBC7Quality(uint32_t flags) noexcept
+    {
+        const uint32_t level = (flags & BC_FLAGS_BC7_QUALITY_MASK) >> BC_FLAGS_BC7_QUALITY_SHIFT;
+        if (level > 0 && level <= std::size(g_aBC7Quality))
+            return g_aBC7Quality[level - 1];
+
+        if (flags & BC_FLAGS_FORCE_BC7_MODE6)
+            return g_aBC7Quality[1];
+
+        return g_aBC7Quality[(flags & BC_FLAGS_USE_3SUBSETS) ? 4 : 3];
+    }
+
+#ifdef DIRECTX_TEX_INSTRUMENTATION
+    // BC7 block classifier counters
+    std::atomic<uint64_t> g_BC7Blocks(0);
+    std::atomic<uint64_t> g_BC7SolidBlocks(0);
+    std::atomic<uint64_t> g_BC7TwoColorBlocks(0);
+    std::atomic<uint64_t> g_BC7OpaqueBlocks(0);
+
+#define BC7_COUNT_BLOCK(counter) counter.fetch_add(1, std::memory_order_relaxed)
+#else
+#define BC7_COUNT_BLOCK(counter)
+#endif
+
+    // BC6H/BC7 mode statistics (see EnableBCModeStats)
+    constexpr size_t BC_STATS_MAX_MODES = 14;
+    constexpr size_t BC_STATS_MAX_SHAPES = 64;
+
+    static_assert(sizeof(BCModeStats::modeBlocks) == sizeof(uint64_t) * BC_STATS_MAX_MODES, "BCModeStats mismatch");
+    static_assert(sizeof(BCModeStats::shapeBlocks) == sizeof(uint64_t) * BC_STATS_MAX_MODES * BC_STATS_MAX_SHAPES, "BCModeStats mismatch");
+
+    std::atomic<bool> g_BCModeStatsEnabled(false);
+
+    struct BCModeCounters
+    {
+        std::atomic<uint64_t> blocks;
+        std::atomic<uint64_t> modeBlocks[BC_STATS_MAX_MODES];
+        std::atomic<uint64_t> shapeBlocks[BC_STATS_MAX_MODES][BC_STATS_MAX_SHAPES];
+        std::atomic<uint64_t> modeTime[BC_STATS_MAX_MODES];
+        std::atomic<double> totalError;
+        std::atomic<float> maxError;
+
+        void AddTime(size_t mode, std::chrono::steady_clock::time_point start) noexcept
+        {
+            assert(mode < BC_STATS_MAX_MODES);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            modeTime[mode].fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+        }
+
+        void Record(size_t mode, size_t shape, float error) noexcept
+        {
+            assert(mode < BC_STATS_MAX_MODES && shape < BC_STATS_MAX_SHAPES);
+            blocks.fetch_add(1, std::memory_order_relaxed);
+            modeBlocks[mode].fetch_add(1, std::memory_order_relaxed);
+            shapeBlocks[mode][shape].fetch_add(1, std::memory_order_relaxed);
+
+            double total = totalError.load(std::memory_order_relaxed);
+            while (!totalError.compare_exchange_weak(total, total + double(error), std::memory_order_relaxed)) {}
+
+            float largest = maxError.load(std::memory_order_relaxed);
+            while (error > largest && !maxError.compare_exchange_weak(largest, error, std::memory_order_relaxed)) {}
+        }
+
+        void Get(BCModeStats& stats) const noexcept
+        {
+            stats.blocks = blocks.load(std::memory_order_relaxed);
+            for (size_t m = 0; m < BC_STATS_MAX_MODES; ++m)
+            {
+                stats.modeBlocks[m] = modeBlocks[m].load(std::memory_order_relaxed);
+                stats.modeTime[m] = modeTime[m].load(std::memory_order_relaxed);
+                for (size_t s = 0; s < BC_STATS_MAX_SHAPES; ++s)
+                    stats.shapeBlocks[m][s] = shapeBlocks[m][s].load(std::memory_order_relaxed);
+            }
+            stats.totalError = totalError.load(std::memory_order_relaxed);
+            stats.maxError = maxError.load(std::memory_order_relaxed);
+        }
+
+        void Reset() noexcept
+        {
+            blocks.store(0, std::memory_order_relaxed);
+            for (size_t m = 0; m < BC_STATS_MAX_MODES; ++m)
+            {
+                modeBlocks[m].store(0, std::memory_order_relaxed);
+                modeTime[m].store(0, std::memory_order_relaxed);
+                for (size_t s = 0; s < BC_STATS_MAX_SHAPES; ++s)
+                    shapeBlocks[m][s].store(0, std::memory_order_relaxed);
+            }
+            totalError.store(0.0, std::memory_order_relaxed);
+            maxError.store(0.0f, std::memory_order_relaxed);
+        }
+    };
+
+    BCModeCounters g_BC6HModeStats;
+    BCModeCounters g_BC7ModeStats;
 }
 
 namespace DirectX
@@ -667,7 +823,7 @@ namespace
     {
     public:
         void Decode(_In_ bool bSigned, _Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const noexcept;
-        void Encode(_In_ bool bSigned, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        void Encode(_In_ bool bSigned, uint32_t flags, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
 
     private:
     #pragma warning(push)
@@ -798,8 +954,10 @@ namespace
             LDREndPntPair aEndPts[BC7_MAX_SHAPES][BC7_MAX_REGIONS];
             LDRColorA aLDRPixels[NUM_PIXELS_PER_BLOCK];
             const HDRColorA* const aHDRPixels;
+            int iExhaustiveDelta;
+            bool bOptimize;
 
-            EncodeParams(const HDRColorA* const aOriginal) noexcept : uMode(0), aEndPts{}, aLDRPixels{}, aHDRPixels(aOriginal) {}
+            EncodeParams(const HDRColorA* const aOriginal) noexcept : uMode(0), aEndPts{}, aLDRPixels{}, aHDRPixels(aOriginal), iExhaustiveDelta(5), bOptimize(true) {}
         };
     #pragma warning(pop)
 
@@ -863,6 +1021,7 @@ namespace
             _In_reads_(NUM_PIXELS_PER_BLOCK) const size_t aIndex2[]) noexcept;
         void FixEndpointPBits(_In_ const EncodeParams* pEP, _In_reads_(BC7_MAX_REGIONS) const LDREndPntPair *pOrigEndpoints, _Out_writes_(BC7_MAX_REGIONS) LDREndPntPair *pFixedEndpoints) noexcept;
         float Refine(_In_ const EncodeParams* pEP, _In_ size_t uShape, _In_ size_t uRotation, _In_ size_t uIndexMode) noexcept;
+        void EncodeSolid(_Inout_ EncodeParams* pEP) noexcept;
 
         float MapColors(_In_ const EncodeParams* pEP, _In_reads_(np) const LDRColorA aColors[], _In_ size_t np, _In_ size_t uIndexMode,
             _In_ const LDREndPntPair& endPts, _In_ float fMinErr) const noexcept;
@@ -1814,48 +1973,87 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
 
 
 _Use_decl_annotations_
-void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn) noexcept
+void D3DX_BC6H::Encode(bool bSigned, uint32_t flags, const HDRColorA* const pIn) noexcept
 {
     assert(pIn);
 
     EncodeParams EP(pIn, bSigned);
 
+    // The rough error of a shape only depends on the region count and index precision, which all modes
+    // with the same region count share, so the shapes are ranked once per region count rather than per mode.
+    // This relies on the modes being visited grouped by region count, since the one and two region rankings
+    // share the unquantized endpoints of shape 0. BC_FLAGS_BC6H_RANK_PER_MODE restores the per mode ranking.
+    float afRoughMSE[BC6H_MAX_REGIONS][BC6H_MAX_SHAPES];
+    uint8_t auShape[BC6H_MAX_REGIONS][BC6H_MAX_SHAPES];
+    bool abRanked[BC6H_MAX_REGIONS] = {};
+    const bool bRankPerMode = (flags & BC_FLAGS_BC6H_RANK_PER_MODE) != 0;
+
+    const bool bStats = g_BCModeStatsEnabled.load(std::memory_order_relaxed);
+    size_t uBestMode = 0;
+    size_t uBestShape = 0;
+
     for (EP.uMode = 0; EP.uMode < c_NumModes && EP.fBestErr > 0; ++EP.uMode)
     {
-        const uint8_t uShapes = ms_aInfo[EP.uMode].uPartitions ? 32u : 1u;
+        const auto tStart = bStats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+        const uint8_t uPartitions = ms_aInfo[EP.uMode].uPartitions;
+        assert(uPartitions < BC6H_MAX_REGIONS);
+        _Analysis_assume_(uPartitions < BC6H_MAX_REGIONS);
+        assert(ms_aInfo[EP.uMode].uIndexPrec == (uPartitions ? 3u : 4u));
+
+        const uint8_t uShapes = uPartitions ? 32u : 1u;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
-        const size_t uItems = std::max<size_t>(1u, size_t(uShapes >> 2));
-        float afRoughMSE[BC6H_MAX_SHAPES];
-        uint8_t auShape[BC6H_MAX_SHAPES];
+        const size_t uTopShapes = (flags & BC_FLAGS_BC6H_SHAPES_MASK) >> BC_FLAGS_BC6H_SHAPES_SHIFT;
+        const size_t uItems = std::min<size_t>(uShapes, uTopShapes ? uTopShapes : std::max<size_t>(1u, size_t(uShapes >> 2)));
 
-        // pick the best uItems shapes and refine these.
-        for (EP.uShape = 0; EP.uShape < uShapes; ++EP.uShape)
+        float* pRoughMSE = afRoughMSE[uPartitions];
+        uint8_t* pShape = auShape[uPartitions];
+        if (!abRanked[uPartitions] || bRankPerMode)
         {
-            size_t uShape = EP.uShape;
-            afRoughMSE[uShape] = RoughMSE(&EP);
-            auShape[uShape] = static_cast<uint8_t>(uShape);
-        }
+            // pick the best uItems shapes and refine these.
+            for (EP.uShape = 0; EP.uShape < uShapes; ++EP.uShape)
+            {
+                size_t uShape = EP.uShape;
+                pRoughMSE[uShape] = RoughMSE(&EP);
+                pShape[uShape] = static_cast<uint8_t>(uShape);
+            }
 
-        // Bubble up the first uItems items
-        for (size_t i = 0; i < uItems; i++)
-        {
-            for (size_t j = i + 1; j < uShapes; j++)
+            // Bubble up the first uItems items
+            for (size_t i = 0; i < uItems; i++)
             {
-                if (afRoughMSE[i] > afRoughMSE[j])
+                for (size_t j = i + 1; j < uShapes; j++)
                 {
-                    std::swap(afRoughMSE[i], afRoughMSE[j]);
-                    std::swap(auShape[i], auShape[j]);
+                    if (pRoughMSE[i] > pRoughMSE[j])
+                    {
+                        std::swap(pRoughMSE[i], pRoughMSE[j]);
+                        std::swap(pShape[i], pShape[j]);
+                    }
                 }
             }
+
+            abRanked[uPartitions] = true;
         }
 
         for (size_t i = 0; i < uItems && EP.fBestErr > 0; i++)
         {
-            EP.uShape = auShape[i];
+            EP.uShape = pShape[i];
+
+            const float fPrevErr = EP.fBestErr;
             Refine(&EP);
+            if (EP.fBestErr < fPrevErr)
+            {
+                uBestMode = EP.uMode;
+                uBestShape = EP.uShape;
+            }
         }
+
+        if (bStats)
+            g_BC6HModeStats.AddTime(EP.uMode, tStart);
     }
+
+    if (bStats && EP.fBestErr < FLT_MAX)
+        g_BC6HModeStats.Record(uBestMode, uBestShape, EP.fBestErr);
 }
 
 
@@ -2800,15 +2998,69 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
 
     const bool bHasAlpha = (alphaMask != 0xFF);
 
-    for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > 0; ++EP.uMode)
+    // Classify the block: solid blocks are emitted directly, and two color blocks try the single subset modes first
+    const LDRColorA& c0 = EP.aLDRPixels[0];
+    const LDRColorA* pc1 = nullptr;
+    bool bMultiColor = (flags & BC_FLAGS_BC7_FULL_SEARCH) != 0;
+    for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK && !bMultiColor; ++i)
+    {
+        const LDRColorA& c = EP.aLDRPixels[i];
+        if (c.r == c0.r && c.g == c0.g && c.b == c0.b && c.a == c0.a)
+            continue;
+
+        if (!pc1)
+            pc1 = &c;
+        else if (c.r != pc1->r || c.g != pc1->g || c.b != pc1->b || c.a != pc1->a)
+            bMultiColor = true;
+    }
+
+    BC7_COUNT_BLOCK(g_BC7Blocks);
+
+    const bool bStats = g_BCModeStatsEnabled.load(std::memory_order_relaxed);
+
+    const BC7Quality& quality = GetBC7Quality(flags);
+    const bool bThreeSubsets = quality.bThreeSubsets || (flags & BC_FLAGS_USE_3SUBSETS);
+    const bool bModeSixOnly = quality.bModeSixOnly || (flags & BC_FLAGS_FORCE_BC7_MODE6);
+
+    // The solid encoding uses mode 5, so mode 6 only encodes search solid blocks like any other
+    if (!pc1 && !bMultiColor && !bModeSixOnly)
+    {
+        BC7_COUNT_BLOCK(g_BC7SolidBlocks);
+        EncodeSolid(&EP);
+        if (bStats)
+            g_BC7ModeStats.Record(5, 0, 0.0f);
+        return;
+    }
+
+    EP.iExhaustiveDelta = quality.uExhaustiveDelta;
+    EP.bOptimize = quality.bOptimize;
+
+    const bool bTwoColor = !bMultiColor && pc1;
+    size_t uBestMode = 0;
+    size_t uBestShape = 0;
+    if (!bTwoColor && !bHasAlpha)
     {
-        if (!(flags & BC_FLAGS_USE_3SUBSETS) && (EP.uMode == 0 || EP.uMode == 2))
+        BC7_COUNT_BLOCK(g_BC7OpaqueBlocks);
+    }
+
+    // Any two colors lie on a line, so the single subset modes can often place them exactly at the endpoints. Two color
+    // blocks try those modes first, and a zero error result ends the search; otherwise every mode is still searched, so
+    // the best error is the same as with the usual order.
+    static const uint8_t s_aModeOrder[c_NumModes] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    static const uint8_t s_aTwoColorModeOrder[c_NumModes] = { 4, 5, 6, 0, 1, 2, 3, 7 };
+    const uint8_t* pModeOrder = (bTwoColor) ? s_aTwoColorModeOrder : s_aModeOrder;
+
+    for (size_t iMode = 0; iMode < c_NumModes && fMSEBest > 0; ++iMode)
+    {
+        EP.uMode = pModeOrder[iMode];
+
+        if (!bThreeSubsets && (EP.uMode == 0 || EP.uMode == 2))
         {
             // 3 subset modes tend to be used rarely and add significant compression time
             continue;
         }
 
-        if ((flags & TEX_COMPRESS_BC7_QUICK) && (EP.uMode != 6))
+        if (bModeSixOnly && (EP.uMode != 6))
         {
             // Use only mode 6
             continue;
@@ -2820,6 +3072,8 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
             continue;
         }
 
+        const auto tStart = bStats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
         const size_t uShapes = size_t(1) << ms_aInfo[EP.uMode].uPartitionBits;
         assert(uShapes <= BC7_MAX_SHAPES);
         _Analysis_assume_(uShapes <= BC7_MAX_SHAPES);
@@ -2828,7 +3082,7 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
         const size_t uNumIdxMode = size_t(1) << ms_aInfo[EP.uMode].uIndexModeBits;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
-        const size_t uItems = std::max<size_t>(1, uShapes >> 2);
+        const size_t uItems = std::max<size_t>(1, uShapes >> quality.uShapeShift);
         float afRoughMSE[BC7_MAX_SHAPES];
         size_t auShape[BC7_MAX_SHAPES];
 
@@ -2871,6 +3125,8 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
                     {
                         final = *this;
                         fMSEBest = fMSE;
+                        uBestMode = EP.uMode;
+                        uBestShape = auShape[i];
                     }
                 }
             }
@@ -2883,9 +3139,48 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
             default: break;
             }
         }
+
+        if (bStats)
+            g_BC7ModeStats.AddTime(EP.uMode, tStart);
     }
 
     *this = final;
+
+    if (bTwoColor && fMSEBest <= 0 && ms_aInfo[uBestMode].uPartitions == 0)
+    {
+        BC7_COUNT_BLOCK(g_BC7TwoColorBlocks);
+    }
+
+    if (bStats && fMSEBest < FLT_MAX)
+        g_BC7ModeStats.Record(uBestMode, uBestShape, fMSEBest);
+}
+
+
+//-------------------------------------------------------------------------------------
+// Emits a single color block as mode 5: RGB comes from a 7-bit endpoint pair that hits the
+// color exactly at index 1, and the 8-bit alpha endpoints are stored as-is
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void D3DX_BC7::EncodeSolid(EncodeParams* pEP) noexcept
+{
+    assert(pEP);
+
+    const LDRColorA& c = pEP->aLDRPixels[0];
+
+    LDREndPntPair aEndPts[BC7_MAX_REGIONS] = {};
+    aEndPts[0].A = LDRColorA(g_aBC7SolidEndpoints[c.r][0], g_aBC7SolidEndpoints[c.g][0], g_aBC7SolidEndpoints[c.b][0], c.a);
+    aEndPts[0].B = LDRColorA(g_aBC7SolidEndpoints[c.r][1], g_aBC7SolidEndpoints[c.g][1], g_aBC7SolidEndpoints[c.b][1], c.a);
+
+    size_t aIndex[NUM_PIXELS_PER_BLOCK];
+    size_t aIndex2[NUM_PIXELS_PER_BLOCK];
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        aIndex[i] = 1;
+        aIndex2[i] = 0;
+    }
+
+    pEP->uMode = 5;
+    EmitBlock(pEP, 0, 0, 0, aEndPts, aIndex, aIndex2);
 }
 
 
@@ -2980,7 +3275,9 @@ void D3DX_BC7::Exhaustive(const EncodeParams* pEP, const LDRColorA aColors[], si
     if (fOrgErr == 0)
         return;
 
-    constexpr int delta = 5;
+    const int delta = pEP->iExhaustiveDelta;
+    if (delta <= 0)
+        return;
 
     // ok figure out the range of A and B
     tmpEndPt = optEndPt;
@@ -3437,6 +3734,16 @@ float D3DX_BC7::Refine(const EncodeParams* pEP, size_t uShape, size_t uRotation,
 
     AssignIndices(pEP, uShape, uIndexMode, newEndPts1, aOrgIdx, aOrgIdx2, aOrgErr);
 
+    if (!pEP->bOptimize)
+    {
+        float fOrgTotErr = 0;
+        for (size_t p = 0; p <= uPartitions; p++)
+            fOrgTotErr += aOrgErr[p];
+
+        EmitBlock(pEP, uShape, uRotation, uIndexMode, newEndPts1, aOrgIdx, aOrgIdx2);
+        return fOrgTotErr;
+    }
+
     OptimizeEndPoints(pEP, uShape, uIndexMode, aOrgErr, newEndPts1, aOptEndPts);
 
     LDREndPntPair newEndPts2[BC7_MAX_REGIONS];
@@ -3623,19 +3930,17 @@ void DirectX::D3DXDecodeBC6HS(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HU(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HS(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 
@@ -3657,3 +3962,54 @@ void DirectX::D3DXEncodeBC7(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags
     static_assert(sizeof(D3DX_BC7) == 16, "D3DX_BC7 should be 16 bytes");
     reinterpret_cast<D3DX_BC7*>(pBC)->Encode(flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
+
+
+#ifdef DIRECTX_TEX_INSTRUMENTATION
+//-------------------------------------------------------------------------------------
+// BC7 encoder statistics
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::GetBC7EncodeStats(BC7EncodeStats& stats) noexcept
+{
+    stats.blocks = g_BC7Blocks.load(std::memory_order_relaxed);
+    stats.solidBlocks = g_BC7SolidBlocks.load(std::memory_order_relaxed);
+    stats.twoColorBlocks = g_BC7TwoColorBlocks.load(std::memory_order_relaxed);
+    stats.opaqueBlocks = g_BC7OpaqueBlocks.load(std::memory_order_relaxed);
+}
+
+void DirectX::ResetBC7EncodeStats() noexcept
+{
+    g_BC7Blocks.store(0, std::memory_order_relaxed);
+    g_BC7SolidBlocks.store(0, std::memory_order_relaxed);
+    g_BC7TwoColorBlocks.store(0, std::memory_order_relaxed);
+    g_BC7OpaqueBlocks.store(0, std::memory_order_relaxed);
+}
+#endif // DIRECTX_TEX_INSTRUMENTATION
+
+
+//-------------------------------------------------------------------------------------
+// BC6H/BC7 mode statistics
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::EnableBCModeStats(bool enable) noexcept
+{
+    g_BCModeStatsEnabled.store(enable, std::memory_order_relaxed);
+}
+
+_Use_decl_annotations_
+void DirectX::GetBC6HModeStats(BCModeStats& stats) noexcept
+{
+    g_BC6HModeStats.Get(stats);
+}
+
+_Use_decl_annotations_
+void DirectX::GetBC7ModeStats(BCModeStats& stats) noexcept
+{
+    g_BC7ModeStats.Get(stats);
+}
+
+void DirectX::ResetBCModeStats() noexcept
+{
+    g_BC6HModeStats.Reset();
+    g_BC7ModeStats.Reset();
+}
@@ -256,6 +256,12 @@ namespace DirectX
         DDS_FLAGS_IGNORE_MIPS = 0x100,
         // Allow some files to be read that have incorrect mipcount values in the header by only reading the top-level mip
 
+        DDS_FLAGS_MEMORY_MAPPED = 0x200,
+        // Loads from file by mapping it into memory rather than reading a copy when no conversion is required (non-Windows only)
+        // The resulting ScratchImage references a private copy-on-write file mapping for its lifetime, so writes to the pixels never reach the file
+        // Pixel data starts right after the header, so it is not 16-byte aligned for files with the 'DX10' header extension
+        // Truncating the file while it is mapped raises SIGBUS on access to the missing pages
+
         DDS_FLAGS_FORCE_DX10_EXT = 0x10000,
         // Always use the 'DX10' header extension for DDS writer (i.e. don't try to write DX9 compatible DDS files)
 
@@ -441,9 +447,9 @@ namespace DirectX
     {
     public:
         ScratchImage() noexcept
-            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr) {}
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr), m_mapping(nullptr), m_mappingSize(0) {}
         ScratchImage(ScratchImage&& moveFrom) noexcept
-            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr) { *this = std::move(moveFrom); }
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr), m_mapping(nullptr), m_mappingSize(0) { *this = std::move(moveFrom); }
         ~ScratchImage() { Release(); }
 
         ScratchImage& __cdecl operator= (ScratchImage&& moveFrom) noexcept;
@@ -463,6 +469,12 @@ namespace DirectX
         HRESULT __cdecl InitializeCubeFromImages(_In_reads_(nImages) const Image* images, _In_ size_t nImages, _In_ CP_FLAGS flags = CP_FLAGS_NONE) noexcept;
         HRESULT __cdecl Initialize3DFromImages(_In_reads_(depth) const Image* images, _In_ size_t depth, _In_ CP_FLAGS flags = CP_FLAGS_NONE) noexcept;
 
+    #ifndef _WIN32
+        HRESULT __cdecl InitializeFromMappedView(_In_ const TexMetadata& mdata, _In_ void* view, _In_ size_t viewSize, _In_ size_t offset) noexcept;
+            // Uses pixel data at 'offset' within a view created by mmap without copying it
+            // On success the ScratchImage takes ownership of the view and unmaps it on Release
+    #endif
+
         void __cdecl Release() noexcept;
 
         bool __cdecl OverrideFormat(_In_ DXGI_FORMAT f) noexcept;
@@ -478,12 +490,16 @@ namespace DirectX
 
         bool __cdecl IsAlphaAllOpaque() const noexcept;
 
+        bool __cdecl IsMemoryMapped() const noexcept { return m_mapping != nullptr; }
+
     private:
         size_t      m_nimages;
         size_t      m_size;
         TexMetadata m_metadata;
         Image*      m_image;
         uint8_t*    m_memory;
+        void*       m_mapping;
+        size_t      m_mappingSize;
     };
 
     //---------------------------------------------------------------------------------
@@ -636,6 +652,62 @@ namespace DirectX
         _In_ TGA_FLAGS flags,
         _In_z_ const wchar_t* szFile, _In_opt_ const TexMetadata* metadata = nullptr) noexcept;
 
+    // Streaming reader
+    class DIRECTX_TEX_API ImageReader
+    {
+        // Pulls rows from a DDS, HDR, or TGA file one band at a time without loading the whole file into memory
+    public:
+        struct Source;
+
+        ImageReader() noexcept
+            : m_source(nullptr), m_metadata{}, m_image{}, m_row(0), m_rowCount(0) {}
+        ImageReader(ImageReader&& moveFrom) noexcept
+            : m_source(nullptr), m_metadata{}, m_image{}, m_row(0), m_rowCount(0) { *this = std::move(moveFrom); }
+        ~ImageReader() { Close(); }
+
+        ImageReader& __cdecl operator= (ImageReader&& moveFrom) noexcept;
+
+        ImageReader(const ImageReader&) = delete;
+        ImageReader& operator=(const ImageReader&) = delete;
+
+        HRESULT __cdecl OpenDDSFile(_In_z_ const wchar_t* szFile, _In_ DDS_FLAGS flags = DDS_FLAGS_NONE) noexcept;
+        HRESULT __cdecl OpenHDRFile(_In_z_ const wchar_t* szFile) noexcept;
+        HRESULT __cdecl OpenTGAFile(_In_z_ const wchar_t* szFile, _In_ TGA_FLAGS flags = TGA_FLAGS_NONE) noexcept;
+            // On success the reader is positioned at the first row of image (0,0,0)
+
+        void __cdecl Close() noexcept;
+
+        HRESULT __cdecl SelectImage(_In_ size_t mip, _In_ size_t item, _In_ size_t slice) noexcept;
+            // Restarts reading at the first row of the given subresource
+
+        HRESULT __cdecl ReadRows(
+            _Out_writes_bytes_(rowPitch * maxRows) uint8_t* pDest, _In_ size_t rowPitch, _In_ size_t maxRows,
+            _Out_ size_t& rowsRead) noexcept;
+            // Returns up to maxRows rows in the format given by GetImage(); for block-compressed formats a row is a row of blocks
+            // Returns S_FALSE once the last row of the current image has been read
+
+        HRESULT __cdecl ReadRows(
+            _Out_writes_(maxRows * m_image.width) XMVECTOR* pDest, _In_ size_t maxRows,
+            _Out_ size_t& rowsRead) noexcept;
+            // Returns up to maxRows rows expanded with LoadScanline; not supported for compressed, planar, or palettized formats
+
+        const TexMetadata& __cdecl GetMetadata() const noexcept { return m_metadata; }
+        const Image& __cdecl GetImage() const noexcept { return m_image; }
+            // Layout of the current image; pixels is always nullptr
+
+        size_t __cdecl GetRowCount() const noexcept { return m_rowCount; }
+        size_t __cdecl GetCurrentRow() const noexcept { return m_row; }
+
+    private:
+        Source*     m_source;
+        TexMetadata m_metadata;
+        Image       m_image;
+        size_t      m_row;
+        size_t      m_rowCount;
+
+        HRESULT __cdecl Attach(_In_ Source* source, _In_ const TexMetadata& mdata) noexcept;
+    };
+
     // WIC operations
 #ifdef _WIN32
     DIRECTX_TEX_API HRESULT __cdecl LoadFromWICMemory(
@@ -721,13 +793,13 @@ namespace DirectX
         TEX_FR_FLIP_VERTICAL = 0x10,
     };
 
-#ifdef _WIN32
     DIRECTX_TEX_API HRESULT __cdecl FlipRotate(_In_ const Image& srcImage, _In_ TEX_FR_FLAGS flags, _Out_ ScratchImage& image) noexcept;
     DIRECTX_TEX_API HRESULT __cdecl FlipRotate(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ TEX_FR_FLAGS flags, _Out_ ScratchImage& result) noexcept;
         // Flip and/or rotate image
-#endif
+        // BC1 - BC5 are transformed losslessly in the compressed domain; this requires flipped dimensions
+        // to be a multiple of 4 (or at most 4). Other compressed formats are not supported.
 
     enum TEX_FILTER_FLAGS : uint32_t
     {
@@ -767,7 +839,11 @@ namespace DirectX
         TEX_FILTER_BOX = 0x400000,
         TEX_FILTER_FANT = 0x400000, // Equiv to Box filtering for mipmap generation
         TEX_FILTER_TRIANGLE = 0x500000,
+        TEX_FILTER_LANCZOS = 0x600000, // Lanczos3 windowed sinc
+        TEX_FILTER_MITCHELL = 0x700000, // Mitchell-Netravali cubic (B = C = 1/3)
+        TEX_FILTER_KAISER = 0x800000, // Kaiser-windowed sinc
         // Filtering mode to use for any required image resizing
+        // LANCZOS, MITCHELL, and KAISER use a separable resampler available on all platforms (not supported for volume mipmaps)
 
         TEX_FILTER_SRGB_IN = 0x1000000,
         TEX_FILTER_SRGB_OUT = 0x2000000,
@@ -781,6 +857,10 @@ namespace DirectX
 
         TEX_FILTER_FORCE_WIC = 0x20000000,
         // Forces use of the WIC path even when logic would have picked a non-WIC path when both are an option
+
+        TEX_FILTER_PARALLEL = 0x40000000,
+        // Mipmap generation and resizing are free to use multithreading to improve performance (by default they do not use multithreading)
+        // Implies the non-WIC path; results are identical to the single-threaded custom filters
     };
 
     constexpr uint32_t TEX_FILTER_DITHER_MASK = 0xF0000;
@@ -797,6 +877,52 @@ namespace DirectX
         // Resize the image to width x height. Defaults to Fant filtering.
         // Note for a complex resize, the result will always have mipLevels == 1
 
+    class DIRECTX_TEX_API ResizePlan
+    {
+        // Caches the filter tables for one source/destination size pair so repeated resizes skip the setup
+    public:
+        struct Kernels;
+
+        ResizePlan() noexcept
+            : m_kernels(nullptr), m_srcWidth(0), m_srcHeight(0), m_destWidth(0), m_destHeight(0), m_filter(TEX_FILTER_DEFAULT) {}
+        ResizePlan(ResizePlan&& moveFrom) noexcept
+            : m_kernels(nullptr), m_srcWidth(0), m_srcHeight(0), m_destWidth(0), m_destHeight(0), m_filter(TEX_FILTER_DEFAULT) { *this = std::move(moveFrom); }
+        ~ResizePlan() { Release(); }
+
+        ResizePlan& __cdecl operator= (ResizePlan&& moveFrom) noexcept;
+
+        ResizePlan(const ResizePlan&) = delete;
+        ResizePlan& operator=(const ResizePlan&) = delete;
+
+        HRESULT __cdecl Initialize(
+            _In_ size_t srcWidth, _In_ size_t srcHeight, _In_ size_t destWidth, _In_ size_t destHeight,
+            _In_ TEX_FILTER_FLAGS filter) noexcept;
+            // Always uses the non-WIC custom filters; TEX_FILTER_PARALLEL splits the destination into row bands
+            // TEX_FILTER_BOX requires each dimension to halve, or to stay at 1 as at the bottom of a mip chain
+
+        HRESULT __cdecl Execute(_In_ const Image& srcImage, _In_ const Image& destImage) const noexcept;
+        HRESULT __cdecl Execute(_In_ const Image& srcImage, _In_ const Image& destImage, _In_ size_t rowStart, _In_ size_t rowEnd) const noexcept;
+            // Images must match the planned sizes; destImage must already be allocated but may use a different uncompressed format
+            // The row range overload writes only destination rows [rowStart, rowEnd), with the same results as a full Execute
+            // (TEX_FILTER_TRIANGLE only supports the whole image)
+
+        void __cdecl Release() noexcept;
+
+        size_t __cdecl GetSourceWidth() const noexcept { return m_srcWidth; }
+        size_t __cdecl GetSourceHeight() const noexcept { return m_srcHeight; }
+        size_t __cdecl GetDestWidth() const noexcept { return m_destWidth; }
+        size_t __cdecl GetDestHeight() const noexcept { return m_destHeight; }
+        TEX_FILTER_FLAGS __cdecl GetFilter() const noexcept { return m_filter; }
+
+    private:
+        Kernels*            m_kernels;
+        size_t              m_srcWidth;
+        size_t              m_srcHeight;
+        size_t              m_destWidth;
+        size_t              m_destHeight;
+        TEX_FILTER_FLAGS    m_filter;
+    };
+
     constexpr float TEX_THRESHOLD_DEFAULT = 0.5f;
         // Default value for alpha threshold used when converting to 1-bit alpha
 
@@ -897,6 +1023,9 @@ namespace DirectX
         TEX_COMPRESS_BC7_QUICK = 0x100000,
         // Minimal modes (usually mode 6) for BC7 compression
 
+        TEX_COMPRESS_BC_BATCH = 0x200000,
+        // Encodes BC1 and BC3 four blocks at a time, one block per SIMD lane; results can differ slightly from the per-block encoder
+
         TEX_COMPRESS_SRGB_IN = 0x1000000,
         TEX_COMPRESS_SRGB_OUT = 0x2000000,
         TEX_COMPRESS_SRGB = (TEX_COMPRESS_SRGB_IN | TEX_COMPRESS_SRGB_OUT),
@@ -910,11 +1039,39 @@ namespace DirectX
     constexpr float TEX_ALPHA_WEIGHT_DEFAULT = 1.0f;
         // Default value for alpha weight used for GPU BC7 compression
 
+    enum TEX_BC7_QUALITY : uint32_t
+    {
+        TEX_BC7_QUALITY_DEFAULT = 0,
+        // Level implied by the TEX_COMPRESS_BC7_* flags (1 for QUICK, 4 for USE_3SUBSETS, otherwise 3)
+
+        TEX_BC7_QUALITY_LEVEL0 = 1,
+        // Mode 6 only without endpoint optimization (fastest)
+
+        TEX_BC7_QUALITY_LEVEL1 = 2,
+        // Mode 6 only (same as TEX_COMPRESS_BC7_QUICK)
+
+        TEX_BC7_QUALITY_LEVEL2 = 3,
+        // Modes 1 and 3-7, refining only the best shape candidate of each mode
+
+        TEX_BC7_QUALITY_LEVEL3 = 4,
+        // Modes 1 and 3-7 (same as the default settings)
+
+        TEX_BC7_QUALITY_LEVEL4 = 5,
+        // All modes (same as TEX_COMPRESS_BC7_USE_3SUBSETS)
+
+        TEX_BC7_QUALITY_LEVEL5 = 6,
+        // All modes, refining twice as many shape candidates with a wider endpoint search (slowest)
+    };
+
     struct CompressOptions
     {
         TEX_COMPRESS_FLAGS flags;
         float              threshold;
         float              alphaWeight;
+        TEX_BC7_QUALITY    bc7Quality;
+            // Only used by the CPU BC7 encoder; TEX_COMPRESS_BC7_QUICK and TEX_COMPRESS_BC7_USE_3SUBSETS still apply
+        uint32_t           bc6hShapes;
+            // Number of best-ranked partition shapes the CPU BC6H encoder refines per two region mode (1-32, 0 for the default of 8)
     };
 
     DIRECTX_TEX_API HRESULT __cdecl Compress(
@@ -934,6 +1091,97 @@ namespace DirectX
         _In_ DXGI_FORMAT format, _In_ const CompressOptions& options, _Out_ ScratchImage& cImages,
         _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
 
+    DIRECTX_TEX_API HRESULT __cdecl CompressEx(
+        _In_ size_t width, _In_ size_t height, _In_ DXGI_FORMAT srcFormat,
+        _In_ DXGI_FORMAT format, _In_ const CompressOptions& options,
+        _In_ std::function<HRESULT __cdecl(uint8_t* pRows, size_t rowPitch, size_t y, size_t rowCount)> readRows,
+        _In_ std::function<HRESULT __cdecl(const uint8_t* pBlocks, size_t size, size_t blockRow)> writeBlocks,
+        _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
+    DIRECTX_TEX_API HRESULT __cdecl CompressEx(
+        _Inout_ ImageReader& reader, _In_ DXGI_FORMAT format, _In_ const CompressOptions& options,
+        _In_ std::function<HRESULT __cdecl(const uint8_t* pBlocks, size_t size, size_t blockRow)> writeBlocks,
+        _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
+        // Streaming compression: source rows are requested in order a strip at a time and each row of blocks
+        // is handed to writeBlocks as soon as it is encoded, so neither image is ever fully resident
+        // An exception thrown by a callback is caught and returned as E_OUTOFMEMORY (std::bad_alloc) or E_FAIL
+
+    DIRECTX_TEX_API HRESULT __cdecl GenerateMipMapsAndCompress(
+        _In_ const Image& baseImage, _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels,
+        _In_ DXGI_FORMAT format, _In_ const CompressOptions& options, _Out_ ScratchImage& cImages,
+        _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
+    DIRECTX_TEX_API HRESULT __cdecl GenerateMipMapsAndCompress(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels,
+        _In_ DXGI_FORMAT format, _In_ const CompressOptions& options, _Out_ ScratchImage& cImages,
+        _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
+        // Generates each level from the previous one a row of blocks at a time and compresses every band as it is made,
+        // so only two uncompressed levels are ever stored (levels of '0' is a full chain). Filters are chosen as in
+        // GenerateMipMaps and levels are kept in the source format, so the result matches GenerateMipMaps with
+        // TEX_FILTER_FORCE_NON_WIC followed by CompressEx. TEX_FILTER_TRIANGLE generates whole levels before compressing them
+        // Supports 1D/2D textures, arrays, and cubemaps; volume textures are not supported
+
+    enum TEX_QUALITY_METRIC : uint32_t
+    {
+        TEX_QUALITY_PSNR = 0,
+        // Peak signal-to-noise ratio of the RGB channels in dB, as texdiag compare reports it
+
+        TEX_QUALITY_SSIM,
+        // Structural similarity of the luminance (1.0 is identical)
+    };
+
+    DIRECTX_TEX_API HRESULT __cdecl CompressToQuality(
+        _In_ const Image& srcImage, _In_ DXGI_FORMAT format, _In_ const CompressOptions& options,
+        _In_ TEX_QUALITY_METRIC metric, _In_ float target, _In_ size_t regionRows, _Out_ ScratchImage& cImage) noexcept;
+    DIRECTX_TEX_API HRESULT __cdecl CompressToQuality(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ DXGI_FORMAT format, _In_ const CompressOptions& options,
+        _In_ TEX_QUALITY_METRIC metric, _In_ float target, _In_ size_t regionRows, _Out_ ScratchImage& cImages) noexcept;
+        // Tries progressively slower encoder settings (BC7 quick, default, then 3 subsets; BC6H with 2, 8, then 32 shapes;
+        // BC1-3 without then with dithering, weighted uniformly for PSNR) and keeps the first that meets target, or else
+        // the best one. Settings are chosen for each band of regionRows rows (rounded up to whole blocks), or for the whole
+        // image if regionRows is 0
+
+    struct CompressionAnalysis
+    {
+        DXGI_FORMAT format;     // Cheapest BC format expected to meet the target
+        float    bc1PSNR;       // Estimated BC1 RGB PSNR in dB, from how closely each block's colors fit a line
+        uint32_t channels;      // Leading RGB channels in use (1 for R only, 2 for RG, otherwise 3)
+        bool     alphaOpaque;   // Alpha is opaque everywhere, as with ScratchImage::IsAlphaAllOpaque
+        bool     alphaBinary;   // Alpha is only fully transparent or opaque, so BC1 alpha suffices
+        bool     alphaDropped;  // Alpha is not opaque but format has no alpha channel (HDR or signed color with alpha)
+        bool     normalMap;     // RGB holds unit length vectors facing +Z
+        bool     highDynamicRange;  // Color values above 1.0
+        bool     negativeValues;    // Color values below 0.0
+    };
+
+    DIRECTX_TEX_API HRESULT __cdecl AnalyzeForCompression(
+        _In_ const Image& image, _In_ TEX_COMPRESS_FLAGS compress, _In_ float targetPSNR,
+        _Out_ CompressionAnalysis& analysis) noexcept;
+    DIRECTX_TEX_API HRESULT __cdecl AnalyzeForCompression(
+        _In_reads_(nimages) const Image* images, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ TEX_COMPRESS_FLAGS compress, _In_ float targetPSNR, _Out_ CompressionAnalysis& analysis) noexcept;
+        // Recommends BC6H for HDR or signed color, BC5 for opaque normal maps (Z must be reconstructed), BC4/BC5 for opaque R and RG data,
+        // BC1 or BC3 when the estimated BC1 PSNR meets targetPSNR (as with TEX_QUALITY_PSNR), and otherwise BC7. Only the PARALLEL
+        // and SRGB_OUT compress flags are used, and the image data is read once without any trial encodes
+
+    struct BCModeStats
+    {
+        uint64_t blocks;                // Blocks encoded on the CPU while mode statistics were enabled
+        uint64_t modeBlocks[14];        // Blocks that selected each mode (BC7 uses modes 0-7, BC6H uses 0-13)
+        uint64_t shapeBlocks[14][64];   // Blocks that selected each partition shape, by mode
+        uint64_t modeTime[14];          // Nanoseconds spent searching each mode, whether or not it was selected
+        double   totalError;            // Sum of the squared error of each selected encoding, as measured by the encoder
+        float    maxError;              // Largest squared error of a single block
+    };
+
+    DIRECTX_TEX_API void __cdecl EnableBCModeStats(_In_ bool enable) noexcept;
+    DIRECTX_TEX_API void __cdecl GetBC6HModeStats(_Out_ BCModeStats& stats) noexcept;
+    DIRECTX_TEX_API void __cdecl GetBC7ModeStats(_Out_ BCModeStats& stats) noexcept;
+    DIRECTX_TEX_API void __cdecl ResetBCModeStats() noexcept;
+        // Process-wide mode, shape, error, and timing histograms for the CPU BC6H and BC7 encoders; collection is off by default
+        // as it adds clock reads to every mode search. Errors are in the encoder's own units (BC7 is 8-bit RGBA, BC6H is
+        // quantized half-float), so compare them only between runs of the same codec
+
 #if defined(__d3d11_h__) || defined(__d3d11_x_h__)
     DIRECTX_TEX_API HRESULT __cdecl Compress(
         _In_ ID3D11Device* pDevice, _In_ const Image& srcImage, _In_ DXGI_FORMAT format, _In_ TEX_COMPRESS_FLAGS compress,
@@ -958,6 +1206,70 @@ namespace DirectX
         _In_reads_(nimages) const Image* cImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ DXGI_FORMAT format, _Out_ ScratchImage& images) noexcept;
 
+    //---------------------------------------------------------------------------------
+    // Multithreading control
+    DIRECTX_TEX_API void __cdecl SetMaxThreadCount(_In_ size_t count) noexcept;
+    DIRECTX_TEX_API size_t __cdecl GetMaxThreadCount() noexcept;
+        // Limits the number of worker threads used by the *_PARALLEL code paths (0 is no limit)
+
+#ifdef DIRECTX_TEX_INSTRUMENTATION
+    //---------------------------------------------------------------------------------
+    // Instrumentation (library must be built with DIRECTX_TEX_INSTRUMENTATION defined)
+    enum TEX_STAGE : uint32_t
+    {
+        TEX_STAGE_LOAD_SCANLINE = 0,
+        TEX_STAGE_STORE_SCANLINE,
+        TEX_STAGE_CONVERT,
+        TEX_STAGE_RESIZE,
+        TEX_STAGE_MIPMAPS,
+        TEX_STAGE_COMPRESS,
+        TEX_STAGE_DECOMPRESS,
+        TEX_STAGE_FILE_READ,
+        TEX_STAGE_FILE_WRITE,
+        TEX_STAGE_COUNT
+    };
+
+    enum TEX_BC_CODEC : uint32_t
+    {
+        TEX_BC_CODEC_BC1 = 0,
+        TEX_BC_CODEC_BC2,
+        TEX_BC_CODEC_BC3,
+        TEX_BC_CODEC_BC4,
+        TEX_BC_CODEC_BC5,
+        TEX_BC_CODEC_BC6H,
+        TEX_BC_CODEC_BC7,
+        TEX_BC_CODEC_COUNT
+    };
+
+    struct TexInstrumentation
+    {
+        uint64_t stageCalls[TEX_STAGE_COUNT];
+        uint64_t stageTime[TEX_STAGE_COUNT];        // Nanoseconds, including any nested stages (e.g. Convert includes its scanline work)
+        uint64_t encodeBlocks[TEX_BC_CODEC_COUNT];  // Blocks encoded on the CPU
+        uint64_t encodeTime[TEX_BC_CODEC_COUNT];    // Nanoseconds spent loading and encoding those blocks
+        uint64_t bytesRead;                         // File bytes consumed by the DDS, HDR, and TGA readers
+        uint64_t bytesWritten;                      // File bytes produced by the DDS, HDR, and TGA writers
+        uint64_t allocations;                       // ScratchImage and Blob pixel allocations
+        uint64_t allocatedBytes;
+    };
+
+    DIRECTX_TEX_API void __cdecl GetInstrumentation(_Out_ TexInstrumentation& stats) noexcept;
+    DIRECTX_TEX_API void __cdecl ResetInstrumentation() noexcept;
+        // Process-wide totals kept with relaxed atomics; totals from concurrent calls are summed together
+
+    struct BC7EncodeStats
+    {
+        uint64_t blocks;            // BC7 blocks encoded on the CPU
+        uint64_t solidBlocks;       // Single color blocks emitted directly without a mode search
+        uint64_t twoColorBlocks;    // Two color blocks that reached zero error with the single subset modes alone
+        uint64_t opaqueBlocks;      // Other opaque blocks, which skip mode 7
+    };
+
+    DIRECTX_TEX_API void __cdecl GetBC7EncodeStats(_Out_ BC7EncodeStats& stats) noexcept;
+    DIRECTX_TEX_API void __cdecl ResetBC7EncodeStats() noexcept;
+        // Process-wide counts of the shortcuts taken by the CPU BC7 encoder's block classifier
+#endif
+
     //---------------------------------------------------------------------------------
     // Normal map operations
 
@@ -1027,10 +1339,29 @@ namespace DirectX
         CMSE_IMAGE1_X2_BIAS = 0x100,
         CMSE_IMAGE2_X2_BIAS = 0x200,
         // Indicates that image should be scaled and biased before comparison (i.e. UNORM -> SNORM)
+
+        CMSE_PARALLEL = 0x10000000,
+        // Use multi-threaded reduction over bands of scanlines (if enabled); bands are summed in order, so results
+        // are deterministic but may differ from the serial path in the last bits
     };
 
     DIRECTX_TEX_API HRESULT __cdecl ComputeMSE(_In_ const Image& image1, _In_ const Image& image2, _Out_ float& mse, _Out_writes_opt_(4) float* mseV, _In_ CMSE_FLAGS flags = CMSE_DEFAULT) noexcept;
 
+    struct ImageQuality
+    {
+        float ssim[4];          // Structural similarity of each channel (RGBA), where 1.0 is identical
+        float ssimLuminance;
+        float msssim[4];        // Multi-scale SSIM of each channel over up to five scales
+        float msssimLuminance;
+        float psnrHVS;          // PSNR-HVS of the luminance in dB (0 if the image is smaller than 8x8)
+    };
+
+    DIRECTX_TEX_API HRESULT __cdecl ComputeImageQuality(
+        _In_ const Image& image1, _In_ const Image& image2, _Out_ ImageQuality& quality,
+        _In_ CMSE_FLAGS flags = CMSE_DEFAULT) noexcept;
+        // SSIM uses an 11x11 Gaussian window (sigma 1.5) with constants for a range of 1.0, and PSNR-HVS weights the 8x8 DCT error
+        // by contrast sensitivity. The sRGB, X2_BIAS, and PARALLEL flags apply as they do for ComputeMSE; the IGNORE flags do not
+
     DIRECTX_TEX_API HRESULT __cdecl EvaluateImage(
         _In_ const Image& image,
         _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc);
@@ -1038,6 +1369,22 @@ namespace DirectX
         _In_reads_(nimages) const Image* images, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc);
 
+    DIRECTX_TEX_API HRESULT __cdecl EvaluateImage(
+        _In_ const Image& image, _In_ size_t bands,
+        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t band)> pixelFunc,
+        _In_ std::function<void __cdecl(size_t band)> combineFunc);
+    DIRECTX_TEX_API HRESULT __cdecl EvaluateImage(
+        _In_reads_(nimages) const Image* images, _In_ size_t nimages, _In_ const TexMetadata& metadata, _In_ size_t bands,
+        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t band)> pixelFunc,
+        _In_ std::function<void __cdecl(size_t band)> combineFunc);
+    DIRECTX_TEX_API HRESULT __cdecl EvaluateImage(
+        _In_ const Image& image, _In_ size_t y0, _In_ size_t y1, _In_ size_t bands,
+        _In_ std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t band)> pixelFunc,
+        _In_ std::function<void __cdecl(size_t band)> combineFunc);
+        // Splits the rows of each image (or only the rows [y0, y1)) into 'bands' contiguous ranges that are evaluated in parallel.
+        // pixelFunc gets the band index so it can accumulate into per-band state without locking, and then combineFunc is called
+        // once for each band in order
+
     DIRECTX_TEX_API HRESULT __cdecl TransformImage(
         _In_ const Image& image,
         _In_ std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels,
@@ -1049,6 +1396,24 @@ namespace DirectX
             _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
         ScratchImage& result);
 
+    DIRECTX_TEX_API HRESULT __cdecl TransformImage(
+        _In_ const Image& image, _In_ size_t bands,
+        _In_ std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels,
+            _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+        ScratchImage& result);
+    DIRECTX_TEX_API HRESULT __cdecl TransformImage(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata, _In_ size_t bands,
+        _In_ std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels,
+            _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+        ScratchImage& result);
+    DIRECTX_TEX_API HRESULT __cdecl TransformImage(
+        _In_ const Image& srcImage, _In_ size_t y0, _In_ size_t y1, _In_ size_t bands,
+        _In_ std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels,
+            _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+        _In_ const Image& destImage);
+        // Transforms 'bands' contiguous ranges of rows in parallel, so pixelFunc must be safe to call from multiple threads
+        // The row range overload writes only the rows [y0, y1) into destImage, which must match the source size and format
+
     //---------------------------------------------------------------------------------
     // WIC utility code
 #ifdef _WIN32
@@ -18,6 +18,9 @@
 
 #include "BC.h"
 
+#include <cmath>
+#include <limits>
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 
@@ -31,7 +34,16 @@ namespace
         static_assert(static_cast<int>(TEX_COMPRESS_UNIFORM) == static_cast<int>(BC_FLAGS_UNIFORM), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
         static_assert(static_cast<int>(TEX_COMPRESS_BC7_USE_3SUBSETS) == static_cast<int>(BC_FLAGS_USE_3SUBSETS), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
         static_assert(static_cast<int>(TEX_COMPRESS_BC7_QUICK) == static_cast<int>(BC_FLAGS_FORCE_BC7_MODE6), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
-        return (compress & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_UNIFORM | BC_FLAGS_USE_3SUBSETS | BC_FLAGS_FORCE_BC7_MODE6));
+        static_assert(static_cast<int>(TEX_COMPRESS_BC_BATCH) == static_cast<int>(BC_FLAGS_BATCH), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        return (compress & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_UNIFORM | BC_FLAGS_USE_3SUBSETS | BC_FLAGS_FORCE_BC7_MODE6 | BC_FLAGS_BATCH));
+    }
+
+    constexpr uint32_t GetBCFlags(_In_ const CompressOptions& options) noexcept
+    {
+        static_assert(((TEX_BC7_QUALITY_LEVEL5 << BC_FLAGS_BC7_QUALITY_SHIFT) & ~BC_FLAGS_BC7_QUALITY_MASK) == 0, "TEX_BC7_QUALITY_* should fit in BC_FLAGS_BC7_QUALITY_MASK");
+        return GetBCFlags(options.flags)
+            | (static_cast<uint32_t>(std::min(options.bc7Quality, TEX_BC7_QUALITY_LEVEL5)) << BC_FLAGS_BC7_QUALITY_SHIFT)
+            | (std::min<uint32_t>(options.bc6hShapes, BC_FLAGS_BC6H_SHAPES_MASK) << BC_FLAGS_BC6H_SHAPES_SHIFT);
     }
 
     constexpr TEX_FILTER_FLAGS GetSRGBFlags(_In_ TEX_COMPRESS_FLAGS compress) noexcept
@@ -68,6 +80,121 @@ namespace
     }
 
 
+    //-------------------------------------------------------------------------------------
+    // Loads a block of up to 4x4 pixels, replicating edges of partial blocks
+    //-------------------------------------------------------------------------------------
+    bool LoadBlock(
+        _In_reads_bytes_(bytesLeft) const uint8_t* pSrc,
+        size_t rowPitch,
+        size_t bytesLeft,
+        size_t pw,
+        size_t ph,
+        DXGI_FORMAT format,
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR* temp) noexcept
+    {
+        assert(pw > 0 && pw <= 4 && ph > 0 && ph <= 4);
+
+        for (size_t t = 0; t < ph; ++t)
+        {
+            const size_t bytesToRead = std::min<size_t>(rowPitch, bytesLeft - rowPitch * t);
+            if (!LoadScanline(&temp[t << 2], pw, pSrc + rowPitch * t, bytesToRead, format))
+                return false;
+        }
+
+        if (pw != 4 || ph != 4)
+        {
+            // Replicate pixels for partial block
+            static const size_t uSrc[] = { 0, 0, 0, 1 };
+
+            if (pw < 4)
+            {
+                for (size_t t = 0; t < ph && t < 4; ++t)
+                {
+                    for (size_t s = pw; s < 4; ++s)
+                    {
+                    #pragma prefast(suppress: 26000, "PREFAST false positive")
+                        temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
+                    }
+                }
+            }
+
+            if (ph < 4)
+            {
+                for (size_t t = ph; t < 4; ++t)
+                {
+                    for (size_t s = 0; s < 4; ++s)
+                    {
+                    #pragma prefast(suppress: 26000, "PREFAST false positive")
+                        temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Loads and encodes a run of up to BC_BATCH_BLOCKS horizontally adjacent blocks
+    //-------------------------------------------------------------------------------------
+    bool EncodeBlocks(
+        _In_reads_bytes_(bytesLeft) const uint8_t* pSrc,
+        size_t rowPitch,
+        size_t bytesLeft,
+        size_t sbpp,
+        size_t width,
+        size_t ph,
+        DXGI_FORMAT format,
+        _Out_ uint8_t* pDest,
+        DXGI_FORMAT cformat,
+        BC_ENCODE pfEncode,
+        size_t blocksize,
+        TEX_FILTER_FLAGS cflags,
+        uint32_t bcflags,
+        float threshold) noexcept
+    {
+        assert(width > 0);
+
+        const size_t count = std::min<size_t>(BC_BATCH_BLOCKS, (width + 3) / 4);
+
+        TEX_INSTRUMENT_ENCODE(cformat, count);
+
+        XM_ALIGNED_DATA(16) XMVECTOR temp[NUM_PIXELS_PER_BLOCK * BC_BATCH_BLOCKS];
+        for (size_t j = 0; j < count; ++j)
+        {
+            const size_t offset = j * 4 * sbpp;
+            const size_t pw = std::min<size_t>(4, width - j * 4);
+            if (!LoadBlock(pSrc + offset, rowPitch, bytesLeft - offset, pw, ph, format, &temp[j * NUM_PIXELS_PER_BLOCK]))
+                return false;
+        }
+
+        ConvertScanline(temp, count * NUM_PIXELS_PER_BLOCK, cformat, format, cflags);
+
+        switch (cformat)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            D3DXEncodeBC1Batch(pDest, temp, count, threshold, bcflags);
+            break;
+
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            D3DXEncodeBC3Batch(pDest, temp, count, bcflags);
+            break;
+
+        default:
+            for (size_t j = 0; j < count; ++j)
+            {
+                pfEncode(pDest + j * blocksize, &temp[j * NUM_PIXELS_PER_BLOCK], bcflags);
+            }
+            break;
+        }
+
+        return true;
+    }
+
+
     //-------------------------------------------------------------------------------------
     HRESULT CompressBC(
         const Image& image,
@@ -106,7 +233,6 @@ namespace
         if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
             return HRESULT_E_NOT_SUPPORTED;
 
-        XM_ALIGNED_DATA(16) XMVECTOR temp[16];
         const uint8_t *pSrc = image.pixels;
         const uint8_t *pEnd = image.pixels + image.slicePitch;
         const size_t rowPitch = image.rowPitch;
@@ -124,77 +250,16 @@ namespace
             uint8_t* dptr = pDest;
             const size_t ph = std::min<size_t>(4, image.height - h);
             size_t w = 0;
-            for (size_t count = 0; (count < result.rowPitch) && (w < image.width); count += blocksize, w += 4)
+            for (size_t count = 0; (count < result.rowPitch) && (w < image.width); count += blocksize * BC_BATCH_BLOCKS, w += 4 * BC_BATCH_BLOCKS)
             {
-                const size_t pw = std::min<size_t>(4, image.width - w);
-                assert(pw > 0 && ph > 0);
-
                 const ptrdiff_t bytesLeft = pEnd - sptr;
                 assert(bytesLeft > 0);
-                size_t bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft));
-                if (!LoadScanline(&temp[0], pw, sptr, bytesToRead, format))
+                if (!EncodeBlocks(sptr, rowPitch, static_cast<size_t>(bytesLeft), sbpp, image.width - w, ph, format,
+                    dptr, result.format, pfEncode, blocksize, cflags | srgb, bcflags, threshold))
                     return E_FAIL;
 
-                if (ph > 1)
-                {
-                    bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch);
-                    if (!LoadScanline(&temp[4], pw, sptr + rowPitch, bytesToRead, format))
-                        return E_FAIL;
-
-                    if (ph > 2)
-                    {
-                        bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch * 2);
-                        if (!LoadScanline(&temp[8], pw, sptr + rowPitch * 2, bytesToRead, format))
-                            return E_FAIL;
-
-                        if (ph > 3)
-                        {
-                            bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch * 3);
-                            if (!LoadScanline(&temp[12], pw, sptr + rowPitch * 3, bytesToRead, format))
-                                return E_FAIL;
-                        }
-                    }
-                }
-
-                if (pw != 4 || ph != 4)
-                {
-                    // Replicate pixels for partial block
-                    static const size_t uSrc[] = { 0, 0, 0, 1 };
-
-                    if (pw < 4)
-                    {
-                        for (size_t t = 0; t < ph && t < 4; ++t)
-                        {
-                            for (size_t s = pw; s < 4; ++s)
-                            {
-                            #pragma prefast(suppress: 26000, "PREFAST false positive")
-                                temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
-                            }
-                        }
-                    }
-
-                    if (ph < 4)
-                    {
-                        for (size_t t = ph; t < 4; ++t)
-                        {
-                            for (size_t s = 0; s < 4; ++s)
-                            {
-                            #pragma prefast(suppress: 26000, "PREFAST false positive")
-                                temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
-                            }
-                        }
-                    }
-                }
-
-                ConvertScanline(temp, 16, result.format, format, cflags | srgb);
-
-                if (pfEncode)
-                    pfEncode(dptr, temp, bcflags);
-                else
-                    D3DXEncodeBC1(dptr, temp, threshold, bcflags);
-
-                sptr += sbpp * 4;
-                dptr += blocksize;
+                sptr += sbpp * 4 * BC_BATCH_BLOCKS;
+                dptr += blocksize * BC_BATCH_BLOCKS;
             }
 
             pSrc += rowPitch * 4;
@@ -244,8 +309,10 @@ namespace
         if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
             return HRESULT_E_NOT_SUPPORTED;
 
-        // Refactored version of loop to support parallel independance
-        const size_t nBlocks = std::max<size_t>(1, (image.width + 3) / 4) * std::max<size_t>(1, (image.height + 3) / 4);
+        // Refactored version of loop to support parallel independance; each work item is a run of blocks along a row
+        const size_t nbWidth = std::max<size_t>(1, (image.width + 3) / 4);
+        const size_t nrWidth = (nbWidth + BC_BATCH_BLOCKS - 1) / BC_BATCH_BLOCKS;
+        const size_t nRuns = nrWidth * std::max<size_t>(1, (image.height + 3) / 4);
 
         bool fail = false;
 
@@ -254,8 +321,10 @@ namespace
 
         const size_t progressTotal = std::max<size_t>(1, (image.height + 3) / 4);
 
-#pragma omp parallel for shared(progress)
-        for (int nb = 0; nb < static_cast<int>(nBlocks); ++nb)
+        const int nthreads = GetWorkerThreadCount(nRuns);
+
+#pragma omp parallel for shared(progress) num_threads(nthreads)
+        for (int nr = 0; nr < static_cast<int>(nRuns); ++nr)
         {
 #pragma omp flush (abort)
             if (abort)
@@ -265,11 +334,10 @@ namespace
                 continue;
             }
 
-            const int nbWidth = std::max<int>(1, int((image.width + 3) / 4));
-
-            int y = nb / nbWidth;
-            const int x = (nb - (y*nbWidth)) * 4;
-            y *= 4;
+            const size_t by = size_t(nr) / nrWidth;
+            const size_t bx = (size_t(nr) - (by*nrWidth)) * BC_BATCH_BLOCKS;
+            const int x = int(bx * 4);
+            const int y = int(by * 4);
 
             assert((x >= 0) && (x < int(image.width)));
             assert((y >= 0) && (y < int(image.height)));
@@ -277,100 +345,517 @@ namespace
             const size_t rowPitch = image.rowPitch;
             const uint8_t *pSrc = image.pixels + (size_t(y)*rowPitch) + (size_t(x)*sbpp);
 
-            uint8_t *pDest = result.pixels + (size_t(nb)*blocksize);
+            uint8_t *pDest = result.pixels + ((by*nbWidth + bx)*blocksize);
 
             const size_t ph = std::min<size_t>(4, image.height - size_t(y));
-            const size_t pw = std::min<size_t>(4, image.width - size_t(x));
-            assert(pw > 0 && ph > 0);
 
             const ptrdiff_t bytesLeft = pEnd - pSrc;
             assert(bytesLeft > 0);
-            size_t bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft));
-
-            XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-            if (!LoadScanline(&temp[0], pw, pSrc, bytesToRead, format))
+            if (!EncodeBlocks(pSrc, rowPitch, size_t(bytesLeft), sbpp, image.width - size_t(x), ph, format,
+                pDest, result.format, pfEncode, blocksize, cflags | srgb, bcflags, threshold))
                 fail = true;
 
-            if (ph > 1)
+            // Report progress when a new row is reached.
+            if (x == 0 && statusCallback)
             {
-                bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch);
-                if (!LoadScanline(&temp[4], pw, pSrc + rowPitch, bytesToRead, format))
-                    fail = true;
+#pragma omp atomic
+                progress += 4;
 
-                if (ph > 2)
+                if (!statusCallback(progress, progressTotal))
                 {
-                    bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch * 2);
-                    if (!LoadScanline(&temp[8], pw, pSrc + rowPitch * 2, bytesToRead, format))
+                    abort = true;
+#pragma omp flush (abort)
+                }
+            }
+        }
+
+        if (abort)
+        {
+            return E_ABORT;
+        }
+        else
+        {
+            return (fail) ? E_FAIL : S_OK;
+        }
+    }
+#endif // _OPENMP
+
+
+    //-------------------------------------------------------------------------------------
+    // Compresses from a row producer to a block-row consumer holding only a few strips
+    //-------------------------------------------------------------------------------------
+    constexpr size_t STREAM_BAND_BLOCK_ROWS = 8;
+
+    // The callbacks are caller code and may throw, which must not escape a noexcept function
+    template<typename Fn>
+    HRESULT InvokeStreamCallback(const Fn& fn) noexcept
+    {
+        try
+        {
+            return fn();
+        }
+        catch (const std::bad_alloc&)
+        {
+            return E_OUTOFMEMORY;
+        }
+        catch (...)
+        {
+            return E_FAIL;
+        }
+    }
+
+    HRESULT CompressBC_Stream(
+        size_t width,
+        size_t height,
+        DXGI_FORMAT srcFormat,
+        DXGI_FORMAT format,
+        const CompressOptions& options,
+        const std::function<HRESULT __cdecl(uint8_t*, size_t, size_t, size_t)>& readRows,
+        const std::function<HRESULT __cdecl(const uint8_t*, size_t, size_t)>& writeBlocks,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        size_t sbpp = BitsPerPixel(srcFormat);
+        if (!sbpp)
+            return E_FAIL;
+
+        if (sbpp < 8)
+        {
+            // We don't support compressing from monochrome (DXGI_FORMAT_R1_UNORM)
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+
+        // Round to bytes
+        sbpp = (sbpp + 7) / 8;
+
+        // Determine BC format encoder
+        BC_ENCODE pfEncode;
+        size_t blocksize;
+        TEX_FILTER_FLAGS cflags;
+        if (!DetermineEncoderSettings(format, pfEncode, blocksize, cflags))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        cflags |= GetSRGBFlags(options.flags);
+        const uint32_t bcflags = GetBCFlags(options);
+
+        size_t rowPitch, slicePitch;
+        HRESULT hr = ComputePitch(srcFormat, width, 1, rowPitch, slicePitch, CP_FLAGS_NONE);
+        if (FAILED(hr))
+            return hr;
+
+        size_t blockPitch;
+        hr = ComputePitch(format, width, 4, blockPitch, slicePitch, CP_FLAGS_NONE);
+        if (FAILED(hr))
+            return hr;
+
+        const size_t nbWidth = std::max<size_t>(1, (width + 3) / 4);
+        const size_t nbHeight = std::max<size_t>(1, (height + 3) / 4);
+        const size_t nrWidth = (nbWidth + BC_BATCH_BLOCKS - 1) / BC_BATCH_BLOCKS;
+
+        // Multithreading needs several strips in flight to keep all threads busy
+        const bool parallel = (options.flags & TEX_COMPRESS_PARALLEL) != 0;
+        const size_t bandBlockRows = parallel ? std::min(STREAM_BAND_BLOCK_ROWS, nbHeight) : 1;
+
+        const uint64_t srcBandBytes = uint64_t(rowPitch) * 4u * bandBlockRows;
+        const uint64_t destBandBytes = uint64_t(blockPitch) * bandBlockRows;
+        if (srcBandBytes > SIZE_MAX || destBandBytes > SIZE_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        std::unique_ptr<uint8_t[]> srcBand(new (std::nothrow) uint8_t[static_cast<size_t>(srcBandBytes)]);
+        std::unique_ptr<uint8_t[]> destBand(new (std::nothrow) uint8_t[static_cast<size_t>(destBandBytes)]);
+        if (!srcBand || !destBand)
+            return E_OUTOFMEMORY;
+
+        for (size_t by = 0; by < nbHeight; by += bandBlockRows)
+        {
+            if (statusCallback)
+            {
+                hr = InvokeStreamCallback([&]() { return statusCallback(by * 4, height) ? S_OK : E_ABORT; });
+                if (FAILED(hr))
+                    return hr;
+            }
+
+            const size_t y = by * 4;
+            const size_t blockRows = std::min(bandBlockRows, nbHeight - by);
+            const size_t rows = std::min(blockRows * 4, height - y);
+
+            hr = InvokeStreamCallback([&]() { return readRows(srcBand.get(), rowPitch, y, rows); });
+            if (FAILED(hr))
+                return hr;
+
+            const size_t bytesInBand = rowPitch * rows;
+            const size_t nRuns = nrWidth * blockRows;
+
+            if (parallel)
+            {
+            #ifdef _OPENMP
+                bool fail = false;
+
+                const int nthreads = GetWorkerThreadCount(nRuns);
+
+#pragma omp parallel for num_threads(nthreads)
+                for (int nr = 0; nr < static_cast<int>(nRuns); ++nr)
+                {
+                    const size_t row = size_t(nr) / nrWidth;
+                    const size_t x = (size_t(nr) - row * nrWidth) * 4 * BC_BATCH_BLOCKS;
+                    const size_t srcOffset = row * 4 * rowPitch + x * sbpp;
+
+                    const size_t ph = std::min<size_t>(4, rows - row * 4);
+
+                    if (!EncodeBlocks(srcBand.get() + srcOffset, rowPitch, bytesInBand - srcOffset, sbpp, width - x, ph, srcFormat,
+                        destBand.get() + row * blockPitch + (x / 4) * blocksize, format, pfEncode, blocksize, cflags, bcflags, options.threshold))
                         fail = true;
+                }
 
-                    if (ph > 3)
-                    {
-                        bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch * 3);
-                        if (!LoadScanline(&temp[12], pw, pSrc + rowPitch * 3, bytesToRead, format))
-                            fail = true;
-                    }
+                if (fail)
+                    return E_FAIL;
+            #else
+                return E_NOTIMPL;
+            #endif
+            }
+            else
+            {
+                for (size_t nr = 0; nr < nRuns; ++nr)
+                {
+                    const size_t row = nr / nrWidth;
+                    const size_t x = (nr - row * nrWidth) * 4 * BC_BATCH_BLOCKS;
+                    const size_t srcOffset = row * 4 * rowPitch + x * sbpp;
+
+                    const size_t ph = std::min<size_t>(4, rows - row * 4);
+
+                    if (!EncodeBlocks(srcBand.get() + srcOffset, rowPitch, bytesInBand - srcOffset, sbpp, width - x, ph, srcFormat,
+                        destBand.get() + row * blockPitch + (x / 4) * blocksize, format, pfEncode, blocksize, cflags, bcflags, options.threshold))
+                        return E_FAIL;
                 }
             }
 
-            if (pw != 4 || ph != 4)
+            // Emit the finished strips in order
+            for (size_t row = 0; row < blockRows; ++row)
             {
-                // Replicate pixels for partial block
-                static const size_t uSrc[] = { 0, 0, 0, 1 };
+                hr = InvokeStreamCallback([&]() { return writeBlocks(destBand.get() + row * blockPitch, blockPitch, by + row); });
+                if (FAILED(hr))
+                    return hr;
+            }
+        }
 
-                if (pw < 4)
+        return S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Fused mipmap generation and compression
+    //-------------------------------------------------------------------------------------
+    HRESULT CompressLevel(
+        const Image& image,
+        const Image& result,
+        const CompressOptions& options) noexcept
+    {
+        if (options.flags & TEX_COMPRESS_PARALLEL)
+        {
+        #ifndef _OPENMP
+            return E_NOTIMPL;
+        #else
+            return CompressBC_Parallel(image, result, GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, nullptr);
+        #endif // _OPENMP
+        }
+
+        return CompressBC(image, result, GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, nullptr);
+    }
+
+    HRESULT GenerateAndCompressMips(
+        const Image& baseImage,
+        TEX_FILTER_FLAGS filter,
+        const CompressOptions& options,
+        const ScratchImage& cImages,
+        size_t item) noexcept
+    {
+        if (!baseImage.pixels)
+            return E_POINTER;
+
+        const size_t levels = cImages.GetMetadata().mipLevels;
+
+        // Level 0 is compressed straight from the source image
+        const Image* dest = cImages.GetImage(0, item, 0);
+        if (!dest)
+            return E_POINTER;
+
+        if (dest->width != baseImage.width || dest->height != baseImage.height)
+            return E_FAIL;
+
+        HRESULT hr = CompressLevel(baseImage, *dest, options);
+        if (FAILED(hr))
+            return hr;
+
+        // Same filter choice as GenerateMipMaps, made once from the base image
+        uint32_t filterSelect = filter & TEX_FILTER_MODE_MASK;
+        const bool pow2 = !(baseImage.width & (baseImage.width - 1)) && !(baseImage.height & (baseImage.height - 1));
+        if (!filterSelect)
+        {
+            // Default filter choice
+            filterSelect = (pow2) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+        }
+        else if (filterSelect == TEX_FILTER_BOX && !pow2)
+        {
+            return E_FAIL;
+        }
+
+        // Bands are only a few rows, so they are generated on this thread; compression still honors TEX_COMPRESS_PARALLEL
+        const auto mipFilter = static_cast<TEX_FILTER_FLAGS>((filter & ~(TEX_FILTER_MODE_MASK | TEX_FILTER_PARALLEL)) | filterSelect);
+
+        // Each level is stored in the source format like GenerateMipMaps does, and only while the next one is generated
+        // from it; the triangle filter scatters source rows over several destination rows, so it generates whole levels
+        const bool wholeLevel = (filterSelect == TEX_FILTER_TRIANGLE);
+
+        ScratchImage mips[2];
+        const Image* prev = &baseImage;
+
+        ResizePlan plan;
+        for (size_t level = 1; level < levels; ++level)
+        {
+            dest = cImages.GetImage(level, item, 0);
+            if (!dest)
+                return E_POINTER;
+
+            ScratchImage& current = mips[level & 1];
+            hr = current.Initialize2D(baseImage.format, dest->width, dest->height, 1, 1);
+            if (FAILED(hr))
+                return hr;
+
+            const Image* img = current.GetImage(0, 0, 0);
+            if (!img)
+                return E_POINTER;
+
+            hr = plan.Initialize(prev->width, prev->height, img->width, img->height, mipFilter);
+            if (FAILED(hr))
+                return hr;
+
+            // Generate a row of blocks at a time and compress it while it is still in cache
+            for (size_t y = 0; y < img->height; y += 4)
+            {
+                const size_t rows = std::min<size_t>(4, img->height - y);
+
+                if (!wholeLevel)
                 {
-                    for (size_t t = 0; t < ph && t < 4; ++t)
-                    {
-                        for (size_t s = pw; s < 4; ++s)
-                        {
-                            temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
-                        }
-                    }
+                    hr = plan.Execute(*prev, *img, y, y + rows);
                 }
-
-                if (ph < 4)
+                else if (!y)
                 {
-                    for (size_t t = ph; t < 4; ++t)
-                    {
-                        for (size_t s = 0; s < 4; ++s)
-                        {
-                            temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
-                        }
-                    }
+                    hr = plan.Execute(*prev, *img);
                 }
+                if (FAILED(hr))
+                    return hr;
+
+                Image src = *img;
+                src.height = rows;
+                src.slicePitch = img->rowPitch * rows;
+                src.pixels = img->pixels + img->rowPitch * y;
+
+                Image band = *dest;
+                band.height = rows;
+                band.slicePitch = dest->rowPitch;
+                band.pixels = dest->pixels + dest->rowPitch * (y >> 2);
+
+                hr = CompressLevel(src, band, options);
+                if (FAILED(hr))
+                    return hr;
             }
 
-            ConvertScanline(temp, 16, result.format, format, cflags | srgb);
+            // The level before this one is no longer needed
+            mips[(level & 1) ^ 1].Release();
+            prev = img;
+        }
 
-            if (pfEncode)
-                pfEncode(pDest, temp, bcflags);
-            else
-                D3DXEncodeBC1(pDest, temp, threshold, bcflags);
+        return S_OK;
+    }
 
-            // Report progress when a new row is reached.
-            if (x == 0 && statusCallback)
+
+    //-------------------------------------------------------------------------------------
+    // Quality-targeted compression
+    //-------------------------------------------------------------------------------------
+    constexpr size_t MAX_QUALITY_STEPS = 3;
+
+    // Encoder settings to try, in order of increasing cost
+    size_t GetQualitySteps(
+        _In_ DXGI_FORMAT format,
+        _In_ const CompressOptions& options,
+        TEX_QUALITY_METRIC metric,
+        _Out_writes_(MAX_QUALITY_STEPS) CompressOptions* steps) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
             {
-#pragma omp atomic
-                progress += 4;
+                static const TEX_BC7_QUALITY s_levels[MAX_QUALITY_STEPS] = { TEX_BC7_QUALITY_LEVEL1, TEX_BC7_QUALITY_LEVEL3, TEX_BC7_QUALITY_LEVEL4 };
+                for (size_t j = 0; j < MAX_QUALITY_STEPS; ++j)
+                {
+                    steps[j] = options;
+                    steps[j].flags &= ~(TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS);
+                    steps[j].bc7Quality = s_levels[j];
+                }
+            }
+            return MAX_QUALITY_STEPS;
 
-                if (!statusCallback(progress, progressTotal))
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+            {
+                static const uint32_t s_shapes[MAX_QUALITY_STEPS] = { 2, 8, 32 };
+                for (size_t j = 0; j < MAX_QUALITY_STEPS; ++j)
                 {
-                    abort = true;
-#pragma omp flush (abort)
+                    steps[j] = options;
+                    steps[j].bc6hShapes = s_shapes[j];
                 }
             }
+            return MAX_QUALITY_STEPS;
+
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            // PSNR weighs the channels equally, so every step uses uniform weighting for it; the slower step
+            // dithers, spreading the endpoint quantization error across each block
+            steps[0] = options;
+            if (metric == TEX_QUALITY_PSNR)
+                steps[0].flags |= TEX_COMPRESS_UNIFORM;
+
+            if ((options.flags & TEX_COMPRESS_DITHER) == TEX_COMPRESS_DITHER)
+                return 1;
+
+            steps[1] = steps[0];
+            steps[1].flags |= TEX_COMPRESS_DITHER;
+            return 2;
+
+        default:
+            steps[0] = options;
+            return 1;
         }
+    }
 
-        if (abort)
+    HRESULT MeasureQuality(
+        _In_ const Image& srcImage,
+        _In_ const Image& cImage,
+        TEX_QUALITY_METRIC metric,
+        CMSE_FLAGS flags,
+        _Out_ float& score) noexcept
+    {
+        score = 0.f;
+
+        switch (metric)
         {
-            return E_ABORT;
+        case TEX_QUALITY_PSNR:
+            {
+                float mse = 0.f;
+                float mseV[4] = {};
+                HRESULT hr = ComputeMSE(srcImage, cImage, mse, mseV, flags);
+                if (FAILED(hr))
+                    return hr;
+
+                const float rgb = mseV[0] + mseV[1] + mseV[2];
+                score = (rgb > 0.f) ? 10.f * std::log10(3.f / rgb) : std::numeric_limits<float>::infinity();
+            }
+            return S_OK;
+
+        case TEX_QUALITY_SSIM:
+            {
+                ImageQuality quality;
+                HRESULT hr = ComputeImageQuality(srcImage, cImage, quality, flags);
+                if (FAILED(hr))
+                    return hr;
+
+                score = quality.ssimLuminance;
+            }
+            return S_OK;
+
+        default:
+            return E_INVALIDARG;
         }
-        else
+    }
+
+    HRESULT CompressToQuality_(
+        const Image& srcImage,
+        const Image& destImage,
+        _In_reads_(nsteps) const CompressOptions* steps,
+        size_t nsteps,
+        TEX_QUALITY_METRIC metric,
+        float target,
+        size_t regionRows) noexcept
+    {
+        if (!srcImage.pixels || !destImage.pixels)
+            return E_POINTER;
+
+        assert(nsteps > 0 && nsteps <= MAX_QUALITY_STEPS);
+        assert(srcImage.width == destImage.width && srcImage.height == destImage.height);
+
+        const size_t height = srcImage.height;
+        size_t rows = (regionRows > 0) ? std::min(regionRows, height) : height;
+        rows = (rows + 3) & ~size_t(3);
+
+        // The source and compressed data are compared the same way the encoder treats them
+        CMSE_FLAGS cmse = (steps[0].flags & TEX_COMPRESS_PARALLEL) ? CMSE_PARALLEL : CMSE_DEFAULT;
+        if (steps[0].flags & TEX_COMPRESS_SRGB_IN)
+            cmse |= CMSE_IMAGE1_SRGB;
+        if ((steps[0].flags & TEX_COMPRESS_SRGB_OUT) && !IsSRGB(destImage.format))
+            cmse |= CMSE_IMAGE2_SRGB;
+
+        // Later settings are encoded into a scratch copy of the region and only kept if they are better
+        std::unique_ptr<uint8_t[]> temp;
+        if (nsteps > 1)
         {
-            return (fail) ? E_FAIL : S_OK;
+            temp.reset(new (std::nothrow) uint8_t[destImage.rowPitch * (rows >> 2)]);
+            if (!temp)
+                return E_OUTOFMEMORY;
+        }
+
+        for (size_t y = 0; y < height; y += rows)
+        {
+            const size_t h = std::min(rows, height - y);
+            const size_t blockRows = (h + 3) >> 2;
+
+            Image src = srcImage;
+            src.height = h;
+            src.slicePitch = srcImage.rowPitch * h;
+            src.pixels = srcImage.pixels + srcImage.rowPitch * y;
+
+            Image dest = destImage;
+            dest.height = h;
+            dest.slicePitch = destImage.rowPitch * blockRows;
+            dest.pixels = destImage.pixels + destImage.rowPitch * (y >> 2);
+
+            Image candidate = dest;
+            candidate.pixels = temp.get();
+
+            float best = 0.f;
+            for (size_t j = 0; j < nsteps; ++j)
+            {
+                const Image& result = (j > 0) ? candidate : dest;
+
+                HRESULT hr = CompressLevel(src, result, steps[j]);
+                if (FAILED(hr))
+                    return hr;
+
+                float score;
+                hr = MeasureQuality(src, result, metric, cmse, score);
+                if (FAILED(hr))
+                    return hr;
+
+                if (j == 0 || score > best)
+                {
+                    if (j > 0)
+                    {
+                        memcpy(dest.pixels, candidate.pixels, dest.slicePitch);
+                    }
+
+                    best = score;
+                }
+
+                if (best >= target)
+                    break;
+            }
         }
+
+        return S_OK;
     }
-#endif // _OPENMP
 
 
     //-------------------------------------------------------------------------------------
@@ -431,7 +916,7 @@ namespace
         assert(cImage.height == result.height);
 
         const DXGI_FORMAT format = result.format;
-        size_t dbpp = BitsPerPixel(format);
+        const size_t dbpp = BitsPerPixel(format);
         if (!dbpp)
             return E_FAIL;
 
@@ -441,93 +926,24 @@ namespace
             return HRESULT_E_NOT_SUPPORTED;
         }
 
-        // Round to bytes
-        dbpp = (dbpp + 7) / 8;
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(cImage.width) * 4);
+        if (!scanline)
+            return E_OUTOFMEMORY;
 
         uint8_t *pDest = result.pixels;
-        if (!pDest)
-            return E_POINTER;
-
-        // Promote "typeless" BC formats
-        DXGI_FORMAT cformat;
-        switch (cImage.format)
-        {
-        case DXGI_FORMAT_BC1_TYPELESS:  cformat = DXGI_FORMAT_BC1_UNORM; break;
-        case DXGI_FORMAT_BC2_TYPELESS:  cformat = DXGI_FORMAT_BC2_UNORM; break;
-        case DXGI_FORMAT_BC3_TYPELESS:  cformat = DXGI_FORMAT_BC3_UNORM; break;
-        case DXGI_FORMAT_BC4_TYPELESS:  cformat = DXGI_FORMAT_BC4_UNORM; break;
-        case DXGI_FORMAT_BC5_TYPELESS:  cformat = DXGI_FORMAT_BC5_UNORM; break;
-        case DXGI_FORMAT_BC6H_TYPELESS: cformat = DXGI_FORMAT_BC6H_UF16; break;
-        case DXGI_FORMAT_BC7_TYPELESS:  cformat = DXGI_FORMAT_BC7_UNORM; break;
-        default:                        cformat = cImage.format;         break;
-        }
-
-        // Determine BC format decoder
-        BC_DECODE pfDecode;
-        size_t sbpp;
-        switch (cformat)
-        {
-        case DXGI_FORMAT_BC1_UNORM:
-        case DXGI_FORMAT_BC1_UNORM_SRGB:    pfDecode = D3DXDecodeBC1;   sbpp = 8;   break;
-        case DXGI_FORMAT_BC2_UNORM:
-        case DXGI_FORMAT_BC2_UNORM_SRGB:    pfDecode = D3DXDecodeBC2;   sbpp = 16;  break;
-        case DXGI_FORMAT_BC3_UNORM:
-        case DXGI_FORMAT_BC3_UNORM_SRGB:    pfDecode = D3DXDecodeBC3;   sbpp = 16;  break;
-        case DXGI_FORMAT_BC4_UNORM:         pfDecode = D3DXDecodeBC4U;  sbpp = 8;   break;
-        case DXGI_FORMAT_BC4_SNORM:         pfDecode = D3DXDecodeBC4S;  sbpp = 8;   break;
-        case DXGI_FORMAT_BC5_UNORM:         pfDecode = D3DXDecodeBC5U;  sbpp = 16;  break;
-        case DXGI_FORMAT_BC5_SNORM:         pfDecode = D3DXDecodeBC5S;  sbpp = 16;  break;
-        case DXGI_FORMAT_BC6H_UF16:         pfDecode = D3DXDecodeBC6HU; sbpp = 16;  break;
-        case DXGI_FORMAT_BC6H_SF16:         pfDecode = D3DXDecodeBC6HS; sbpp = 16;  break;
-        case DXGI_FORMAT_BC7_UNORM:
-        case DXGI_FORMAT_BC7_UNORM_SRGB:    pfDecode = D3DXDecodeBC7;   sbpp = 16;  break;
-        default:
-            return HRESULT_E_NOT_SUPPORTED;
-        }
-
-        XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-        const uint8_t *pSrc = cImage.pixels;
         const size_t rowPitch = result.rowPitch;
         for (size_t h = 0; h < cImage.height; h += 4)
         {
-            const uint8_t *sptr = pSrc;
-            uint8_t* dptr = pDest;
+            if (!DecompressBlockRow(cImage, h, scanline.get(), format))
+                return HRESULT_E_NOT_SUPPORTED;
+
             const size_t ph = std::min<size_t>(4, cImage.height - h);
-            size_t w = 0;
-            for (size_t count = 0; (count < cImage.rowPitch) && (w < cImage.width); count += sbpp, w += 4)
+            for (size_t row = 0; row < ph; ++row)
             {
-                pfDecode(temp, sptr);
-                ConvertScanline(temp, 16, format, cformat, TEX_FILTER_DEFAULT);
-
-                const size_t pw = std::min<size_t>(4, cImage.width - w);
-                assert(pw > 0 && ph > 0);
-
-                if (!StoreScanline(dptr, rowPitch, format, &temp[0], pw))
+                if (!StoreScanline(pDest + rowPitch * row, rowPitch, format, scanline.get() + cImage.width * row, cImage.width))
                     return E_FAIL;
-
-                if (ph > 1)
-                {
-                    if (!StoreScanline(dptr + rowPitch, rowPitch, format, &temp[4], pw))
-                        return E_FAIL;
-
-                    if (ph > 2)
-                    {
-                        if (!StoreScanline(dptr + rowPitch * 2, rowPitch, format, &temp[8], pw))
-                            return E_FAIL;
-
-                        if (ph > 3)
-                        {
-                            if (!StoreScanline(dptr + rowPitch * 3, rowPitch, format, &temp[12], pw))
-                                return E_FAIL;
-                        }
-                    }
-                }
-
-                sptr += sbpp;
-                dptr += dbpp * 4;
             }
 
-            pSrc += cImage.rowPitch;
             pDest += rowPitch * 4;
         }
 
@@ -611,10 +1027,80 @@ bool DirectX::Internal::IsAlphaAllOpaqueBC(_In_ const Image& cImage) noexcept
                 }
             }
 
-            ptr += sbpp;
+            ptr += sbpp;
+        }
+
+        pPixels += cImage.rowPitch;
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Decodes the row of blocks that starts at scanline y into up to four scanlines (pDest is
+// width pixels per scanline), converted for storing as format as DecompressBC does
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+bool DirectX::Internal::DecompressBlockRow(const Image& cImage, size_t y, XMVECTOR* pDest, DXGI_FORMAT format) noexcept
+{
+    if (!cImage.pixels || !pDest || (y % 4) != 0 || y >= cImage.height)
+        return false;
+
+    // Promote "typeless" BC formats
+    DXGI_FORMAT cformat;
+    switch (cImage.format)
+    {
+    case DXGI_FORMAT_BC1_TYPELESS:  cformat = DXGI_FORMAT_BC1_UNORM; break;
+    case DXGI_FORMAT_BC2_TYPELESS:  cformat = DXGI_FORMAT_BC2_UNORM; break;
+    case DXGI_FORMAT_BC3_TYPELESS:  cformat = DXGI_FORMAT_BC3_UNORM; break;
+    case DXGI_FORMAT_BC4_TYPELESS:  cformat = DXGI_FORMAT_BC4_UNORM; break;
+    case DXGI_FORMAT_BC5_TYPELESS:  cformat = DXGI_FORMAT_BC5_UNORM; break;
+    case DXGI_FORMAT_BC6H_TYPELESS: cformat = DXGI_FORMAT_BC6H_UF16; break;
+    case DXGI_FORMAT_BC7_TYPELESS:  cformat = DXGI_FORMAT_BC7_UNORM; break;
+    default:                        cformat = cImage.format;         break;
+    }
+
+    // Determine BC format decoder
+    BC_DECODE pfDecode;
+    size_t sbpp;
+    switch (cformat)
+    {
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:    pfDecode = D3DXDecodeBC1;   sbpp = 8;   break;
+    case DXGI_FORMAT_BC2_UNORM:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:    pfDecode = D3DXDecodeBC2;   sbpp = 16;  break;
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:    pfDecode = D3DXDecodeBC3;   sbpp = 16;  break;
+    case DXGI_FORMAT_BC4_UNORM:         pfDecode = D3DXDecodeBC4U;  sbpp = 8;   break;
+    case DXGI_FORMAT_BC4_SNORM:         pfDecode = D3DXDecodeBC4S;  sbpp = 8;   break;
+    case DXGI_FORMAT_BC5_UNORM:         pfDecode = D3DXDecodeBC5U;  sbpp = 16;  break;
+    case DXGI_FORMAT_BC5_SNORM:         pfDecode = D3DXDecodeBC5S;  sbpp = 16;  break;
+    case DXGI_FORMAT_BC6H_UF16:         pfDecode = D3DXDecodeBC6HU; sbpp = 16;  break;
+    case DXGI_FORMAT_BC6H_SF16:         pfDecode = D3DXDecodeBC6HS; sbpp = 16;  break;
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:    pfDecode = D3DXDecodeBC7;   sbpp = 16;  break;
+    default:
+        return false;
+    }
+
+    XM_ALIGNED_DATA(16) XMVECTOR temp[16];
+    const uint8_t* sptr = cImage.pixels + (y / 4) * cImage.rowPitch;
+    const size_t width = cImage.width;
+    const size_t ph = std::min<size_t>(4, cImage.height - y);
+    size_t w = 0;
+    for (size_t count = 0; (count < cImage.rowPitch) && (w < width); count += sbpp, w += 4)
+    {
+        pfDecode(temp, sptr);
+        ConvertScanline(temp, 16, format, cformat, TEX_FILTER_DEFAULT);
+
+        const size_t pw = std::min<size_t>(4, width - w);
+        for (size_t row = 0; row < ph; ++row)
+        {
+            memcpy(pDest + row * width + w, &temp[row * 4], pw * sizeof(XMVECTOR));
         }
 
-        pPixels += cImage.rowPitch;
+        sptr += sbpp;
     }
 
     return true;
@@ -668,6 +1154,8 @@ HRESULT DirectX::CompressEx(
     ScratchImage& image,
     std::function<bool __cdecl(size_t, size_t)> statusCallback)
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_COMPRESS);
+
     if (IsCompressed(srcImage.format) || !IsCompressed(format))
         return E_INVALIDARG;
 
@@ -702,12 +1190,12 @@ HRESULT DirectX::CompressEx(
     #ifndef _OPENMP
         hr = E_NOTIMPL;
     #else
-        hr = CompressBC_Parallel(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, statusCallback);
+        hr = CompressBC_Parallel(srcImage, *img, GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, statusCallback);
     #endif // _OPENMP
     }
     else
     {
-        hr = CompressBC(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, statusCallback);
+        hr = CompressBC(srcImage, *img, GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, statusCallback);
     }
 
     if (FAILED(hr))
@@ -763,6 +1251,8 @@ HRESULT DirectX::CompressEx(
         return CompressEx(srcImages[0], format, options, cImages, statusCallback);
     }
 
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_COMPRESS);
+
     TexMetadata mdata2 = metadata;
     mdata2.format = format;
     HRESULT hr = cImages.Initialize(mdata2);
@@ -808,12 +1298,12 @@ HRESULT DirectX::CompressEx(
         #ifndef _OPENMP
             hr = E_NOTIMPL;
         #else
-            hr = CompressBC_Parallel(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, nullptr);
+            hr = CompressBC_Parallel(src, dest[index], GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, nullptr);
         #endif // _OPENMP
         }
         else
         {
-            hr = CompressBC(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, nullptr);
+            hr = CompressBC(src, dest[index], GetBCFlags(options), GetSRGBFlags(options.flags), options.threshold, nullptr);
         }
 
         if (FAILED(hr))
@@ -845,6 +1335,326 @@ HRESULT DirectX::CompressEx(
 }
 
 
+//-------------------------------------------------------------------------------------
+// Streaming compression
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::CompressEx(
+    size_t width,
+    size_t height,
+    DXGI_FORMAT srcFormat,
+    DXGI_FORMAT format,
+    const CompressOptions& options,
+    std::function<HRESULT __cdecl(uint8_t*, size_t, size_t, size_t)> readRows,
+    std::function<HRESULT __cdecl(const uint8_t*, size_t, size_t)> writeBlocks,
+    std::function<bool __cdecl(size_t, size_t)> statusCallback)
+{
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_COMPRESS);
+
+    if (!width || !height || !readRows || !writeBlocks)
+        return E_INVALIDARG;
+
+    if (IsCompressed(srcFormat) || !IsCompressed(format))
+        return E_INVALIDARG;
+
+    if (IsTypeless(format)
+        || IsTypeless(srcFormat) || IsPlanar(srcFormat) || IsPalettized(srcFormat))
+        return HRESULT_E_NOT_SUPPORTED;
+
+#ifndef _OPENMP
+    if (options.flags & TEX_COMPRESS_PARALLEL)
+        return E_NOTIMPL;
+#endif
+
+    HRESULT hr = S_OK;
+    if (statusCallback)
+    {
+        hr = InvokeStreamCallback([&]() { return statusCallback(0, height) ? S_OK : E_ABORT; });
+        if (FAILED(hr))
+            return hr;
+    }
+
+    hr = CompressBC_Stream(width, height, srcFormat, format, options, readRows, writeBlocks, statusCallback);
+    if (FAILED(hr))
+        return hr;
+
+    if (statusCallback)
+    {
+        hr = InvokeStreamCallback([&]() { return statusCallback(height, height) ? S_OK : E_ABORT; });
+        if (FAILED(hr))
+            return hr;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::CompressEx(
+    ImageReader& reader,
+    DXGI_FORMAT format,
+    const CompressOptions& options,
+    std::function<HRESULT __cdecl(const uint8_t*, size_t, size_t)> writeBlocks,
+    std::function<bool __cdecl(size_t, size_t)> statusCallback)
+{
+    // Reader must be positioned at the first row of the selected image
+    if (!reader.GetRowCount() || reader.GetCurrentRow() != 0)
+        return E_UNEXPECTED;
+
+    const Image& layout = reader.GetImage();
+
+    auto readRows = [&reader](uint8_t* pRows, size_t rowPitch, size_t y, size_t rowCount) -> HRESULT
+    {
+        if (reader.GetCurrentRow() != y)
+            return E_UNEXPECTED;
+
+        size_t rowsRead = 0;
+        const HRESULT hr = reader.ReadRows(pRows, rowPitch, rowCount, rowsRead);
+        if (FAILED(hr))
+            return hr;
+
+        return (rowsRead == rowCount) ? S_OK : HRESULT_E_HANDLE_EOF;
+    };
+
+    return CompressEx(layout.width, layout.height, layout.format, format, options, readRows, writeBlocks, statusCallback);
+}
+
+
+//-------------------------------------------------------------------------------------
+// Fused mipmap generation and compression
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMapsAndCompress(
+    const Image& baseImage,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    DXGI_FORMAT format,
+    const CompressOptions& options,
+    ScratchImage& cImages,
+    std::function<bool __cdecl(size_t, size_t)> statusCallback)
+{
+    TexMetadata mdata = {};
+    mdata.width = baseImage.width;
+    mdata.height = baseImage.height;
+    mdata.depth = mdata.arraySize = mdata.mipLevels = 1;
+    mdata.format = baseImage.format;
+    mdata.dimension = TEX_DIMENSION_TEXTURE2D;
+
+    return GenerateMipMapsAndCompress(&baseImage, 1, mdata, filter, levels, format, options, cImages, statusCallback);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMapsAndCompress(
+    const Image* srcImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    DXGI_FORMAT format,
+    const CompressOptions& options,
+    ScratchImage& cImages,
+    std::function<bool __cdecl(size_t, size_t)> statusCallback)
+{
+    if (!srcImages || !nimages || !IsValid(metadata.format))
+        return E_INVALIDARG;
+
+    if (metadata.IsVolumemap())
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (IsCompressed(metadata.format) || !IsCompressed(format))
+        return E_INVALIDARG;
+
+    if (IsTypeless(format)
+        || IsTypeless(metadata.format) || IsPlanar(metadata.format) || IsPalettized(metadata.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (!CalculateMipLevels(metadata.width, metadata.height, levels))
+        return E_INVALIDARG;
+
+#ifndef _OPENMP
+    if ((options.flags & TEX_COMPRESS_PARALLEL) || (filter & TEX_FILTER_PARALLEL))
+        return E_NOTIMPL;
+#endif
+
+    cImages.Release();
+
+    TexMetadata mdata2 = metadata;
+    mdata2.mipLevels = levels;
+    mdata2.format = format;
+    HRESULT hr = cImages.Initialize(mdata2);
+    if (FAILED(hr))
+        return hr;
+
+    if (statusCallback)
+    {
+        if (!statusCallback(0, metadata.arraySize))
+        {
+            cImages.Release();
+            return E_ABORT;
+        }
+    }
+
+    for (size_t item = 0; item < metadata.arraySize; ++item)
+    {
+        const size_t index = metadata.ComputeIndex(0, item, 0);
+        if (index >= nimages)
+        {
+            cImages.Release();
+            return E_FAIL;
+        }
+
+        const Image& src = srcImages[index];
+        if (src.format != metadata.format)
+        {
+            cImages.Release();
+            return E_FAIL;
+        }
+
+        hr = GenerateAndCompressMips(src, filter, options, cImages, item);
+        if (FAILED(hr))
+        {
+            cImages.Release();
+            return hr;
+        }
+
+        if (statusCallback)
+        {
+            if (!statusCallback(item + 1, metadata.arraySize))
+            {
+                cImages.Release();
+                return E_ABORT;
+            }
+        }
+    }
+
+    return S_OK;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Quality-targeted compression
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::CompressToQuality(
+    const Image& srcImage,
+    DXGI_FORMAT format,
+    const CompressOptions& options,
+    TEX_QUALITY_METRIC metric,
+    float target,
+    size_t regionRows,
+    ScratchImage& image) noexcept
+{
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_COMPRESS);
+
+    if (IsCompressed(srcImage.format) || !IsCompressed(format))
+        return E_INVALIDARG;
+
+    if (metric > TEX_QUALITY_SSIM)
+        return E_INVALIDARG;
+
+    if (IsTypeless(format)
+        || IsTypeless(srcImage.format) || IsPlanar(srcImage.format) || IsPalettized(srcImage.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    CompressOptions steps[MAX_QUALITY_STEPS];
+    const size_t nsteps = GetQualitySteps(format, options, metric, steps);
+
+    // Create compressed image
+    HRESULT hr = image.Initialize2D(format, srcImage.width, srcImage.height, 1, 1);
+    if (FAILED(hr))
+        return hr;
+
+    const Image *img = image.GetImage(0, 0, 0);
+    if (!img)
+    {
+        image.Release();
+        return E_POINTER;
+    }
+
+    hr = CompressToQuality_(srcImage, *img, steps, nsteps, metric, target, regionRows);
+    if (FAILED(hr))
+    {
+        image.Release();
+        return hr;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::CompressToQuality(
+    const Image* srcImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    DXGI_FORMAT format,
+    const CompressOptions& options,
+    TEX_QUALITY_METRIC metric,
+    float target,
+    size_t regionRows,
+    ScratchImage& cImages) noexcept
+{
+    if (!srcImages || !nimages)
+        return E_INVALIDARG;
+
+    if (IsCompressed(metadata.format) || !IsCompressed(format))
+        return E_INVALIDARG;
+
+    if (metric > TEX_QUALITY_SSIM)
+        return E_INVALIDARG;
+
+    if (IsTypeless(format)
+        || IsTypeless(metadata.format) || IsPlanar(metadata.format) || IsPalettized(metadata.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_COMPRESS);
+
+    CompressOptions steps[MAX_QUALITY_STEPS];
+    const size_t nsteps = GetQualitySteps(format, options, metric, steps);
+
+    cImages.Release();
+
+    TexMetadata mdata2 = metadata;
+    mdata2.format = format;
+    HRESULT hr = cImages.Initialize(mdata2);
+    if (FAILED(hr))
+        return hr;
+
+    if (nimages != cImages.GetImageCount())
+    {
+        cImages.Release();
+        return E_FAIL;
+    }
+
+    const Image* dest = cImages.GetImages();
+    if (!dest)
+    {
+        cImages.Release();
+        return E_POINTER;
+    }
+
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        assert(dest[index].format == format);
+
+        const Image& src = srcImages[index];
+
+        if (src.width != dest[index].width || src.height != dest[index].height)
+        {
+            cImages.Release();
+            return E_FAIL;
+        }
+
+        hr = CompressToQuality_(src, dest[index], steps, nsteps, metric, target, regionRows);
+        if (FAILED(hr))
+        {
+            cImages.Release();
+            return hr;
+        }
+    }
+
+    return S_OK;
+}
+
+
 //-------------------------------------------------------------------------------------
 // Decompression
 //-------------------------------------------------------------------------------------
@@ -854,6 +1664,8 @@ HRESULT DirectX::Decompress(
     DXGI_FORMAT format,
     ScratchImage& image) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_DECOMPRESS);
+
     if (!IsCompressed(cImage.format) || IsCompressed(format))
         return E_INVALIDARG;
 
@@ -904,6 +1716,8 @@ HRESULT DirectX::Decompress(
     DXGI_FORMAT format,
     ScratchImage& images) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_DECOMPRESS);
+
     if (!cImages || !nimages)
         return E_INVALIDARG;
 
@@ -254,6 +254,8 @@ HRESULT DirectX::CompressEx(
     ScratchImage& image,
     std::function<bool __cdecl(size_t, size_t)> statusCallback)
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_COMPRESS);
+
     if (!pDevice || IsCompressed(srcImage.format) || !IsCompressed(format))
         return E_INVALIDARG;
 
@@ -329,6 +331,8 @@ HRESULT DirectX::CompressEx(
     ScratchImage& cImages,
     std::function<bool __cdecl(size_t, size_t)> statusCallback)
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_COMPRESS);
+
     if (!pDevice || !srcImages || !nimages)
         return E_INVALIDARG;
 
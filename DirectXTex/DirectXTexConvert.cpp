@@ -11,6 +11,30 @@
 
 #include "DirectXTexP.h"
 
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+#define DIRECTX_TEX_SCANLINE_SSE
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(_XM_ARM_NEON_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_) && (defined(_M_ARM64) || defined(__aarch64__))
+#define DIRECTX_TEX_SCANLINE_NEON
+#endif
+
+#if defined(DIRECTX_TEX_SCANLINE_SSE) || defined(DIRECTX_TEX_SCANLINE_NEON)
+#define DIRECTX_TEX_SCANLINE_SIMD
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DIRECTX_TEX_TARGET_AVX2 __attribute__((target("avx2")))
+#define DIRECTX_TEX_TARGET_F16C __attribute__((target("avx,f16c")))
+#else
+#define DIRECTX_TEX_TARGET_AVX2
+#define DIRECTX_TEX_TARGET_F16C
+#endif
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 using namespace DirectX::PackedVector;
@@ -195,6 +219,366 @@ namespace
     const XMVECTORF32 g_HalfMin = { { { -65504.f, -65504.f, -65504.f, -65504.f } } };
     const XMVECTORF32 g_HalfMax = { { { 65504.f, 65504.f, 65504.f, 65504.f } } };
     const XMVECTORF32 g_8BitBias = { { { 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f } } };
+
+#ifdef DIRECTX_TEX_SCANLINE_SIMD
+    //-------------------------------------------------------------------------------------
+    // Vectorized scanline conversion for the most common formats. These convert several
+    // pixels per iteration using the same arithmetic as the DirectXMath per-pixel
+    // functions used by LoadScanline/StoreScanline, so the results are identical.
+    //-------------------------------------------------------------------------------------
+    const XMVECTORF32 g_UByteNScale = { { { 1.f / 255.f, 1.f / 255.f, 1.f / 255.f, 1.f / 255.f } } };
+
+#ifdef DIRECTX_TEX_SCANLINE_SSE
+    struct CPUFeatures
+    {
+        bool avx2;
+        bool f16c;
+    };
+
+    void CPUID(uint32_t info[4], uint32_t leaf, uint32_t subleaf) noexcept
+    {
+    #ifdef _MSC_VER
+        int regs[4] = {};
+        __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+        memcpy(info, regs, sizeof(regs));
+    #else
+        __cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+    #endif
+    }
+
+    uint64_t ReadXCR0() noexcept
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+    #else
+        uint32_t eax, edx;
+        __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (uint64_t(edx) << 32) | eax;
+    #endif
+    }
+
+    CPUFeatures DetectCPUFeatures() noexcept
+    {
+        CPUFeatures features = {};
+
+        uint32_t info[4] = {};
+        CPUID(info, 0, 0);
+        const uint32_t maxLeaf = info[0];
+
+        CPUID(info, 1, 0);
+        const bool osxsave = (info[2] & (1u << 27)) != 0;
+        const bool avx = (info[2] & (1u << 28)) != 0;
+        const bool f16c = (info[2] & (1u << 29)) != 0;
+
+        // The OS must preserve the YMM registers for any VEX encoded instructions
+        if (!osxsave || !avx || (ReadXCR0() & 0x6) != 0x6)
+            return features;
+
+        features.f16c = f16c;
+
+        if (maxLeaf >= 7)
+        {
+            CPUID(info, 7, 0);
+            features.avx2 = (info[1] & (1u << 5)) != 0;
+        }
+
+        return features;
+    }
+
+    const CPUFeatures& GetCPUFeatures() noexcept
+    {
+        static const CPUFeatures s_features = DetectCPUFeatures();
+        return s_features;
+    }
+
+    void LoadUByteN4_SSE2(XMVECTOR* __restrict dPtr, const uint8_t* __restrict sPtr, size_t count, bool bgr) noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; (i + 4) <= count; i += 4, sPtr += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sPtr));
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            const __m128i pixels[4] =
+            {
+                _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)
+            };
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                const XMVECTOR c = _mm_mul_ps(_mm_cvtepi32_ps(pixels[j]), g_UByteNScale);
+                dPtr[i + j] = (bgr) ? XMVectorSwizzle<2, 1, 0, 3>(c) : c;
+            }
+        }
+
+        for (; i < count; ++i, sPtr += 4)
+        {
+            const XMVECTOR c = XMLoadUByteN4(reinterpret_cast<const XMUBYTEN4*>(sPtr));
+            dPtr[i] = (bgr) ? XMVectorSwizzle<2, 1, 0, 3>(c) : c;
+        }
+    }
+
+    DIRECTX_TEX_TARGET_AVX2
+    void LoadUByteN4_AVX2(XMVECTOR* __restrict dPtr, const uint8_t* __restrict sPtr, size_t count, bool bgr) noexcept
+    {
+        const __m256 scale = _mm256_set1_ps(1.f / 255.f);
+
+        size_t i = 0;
+        for (; (i + 2) <= count; i += 2, sPtr += 8)
+        {
+            const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(sPtr)));
+            __m256 c = _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale);
+            if (bgr)
+            {
+                c = _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 1, 2));
+            }
+            _mm256_storeu_ps(reinterpret_cast<float*>(dPtr + i), c);
+        }
+
+        for (; i < count; ++i, sPtr += 4)
+        {
+            const XMVECTOR c = XMLoadUByteN4(reinterpret_cast<const XMUBYTEN4*>(sPtr));
+            dPtr[i] = (bgr) ? XMVectorSwizzle<2, 1, 0, 3>(c) : c;
+        }
+    }
+
+    void StoreUByteN4_SSE2(uint8_t* __restrict dPtr, const XMVECTOR* __restrict sPtr, size_t count, bool bgr) noexcept
+    {
+        size_t i = 0;
+        for (; (i + 4) <= count; i += 4, dPtr += 16)
+        {
+            __m128i pixels[4];
+            for (size_t j = 0; j < 4; ++j)
+            {
+                XMVECTOR c = (bgr) ? XMVectorSwizzle<2, 1, 0, 3>(sPtr[i + j]) : sPtr[i + j];
+                c = _mm_add_ps(c, g_8BitBias);
+                c = _mm_max_ps(c, g_XMZero);
+                c = _mm_min_ps(c, g_XMOne);
+                c = _mm_mul_ps(c, g_UByteMax);
+                pixels[j] = _mm_cvttps_epi32(c);
+            }
+
+            const __m128i v = _mm_packus_epi16(_mm_packs_epi32(pixels[0], pixels[1]), _mm_packs_epi32(pixels[2], pixels[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dPtr), v);
+        }
+
+        for (; i < count; ++i, dPtr += 4)
+        {
+            XMVECTOR c = (bgr) ? XMVectorSwizzle<2, 1, 0, 3>(sPtr[i]) : sPtr[i];
+            c = XMVectorAdd(c, g_8BitBias);
+            XMStoreUByteN4(reinterpret_cast<XMUBYTEN4*>(dPtr), c);
+        }
+    }
+
+    void LoadUDecN4_SSE2(XMVECTOR* __restrict dPtr, const uint32_t* __restrict sPtr, size_t count) noexcept
+    {
+        const __m128i mask = _mm_set1_epi32(0x3FF);
+        const __m128 scale = _mm_set1_ps(1.f / 1023.f);
+        const __m128 alphaScale = _mm_set1_ps(1.f / 3.f);
+
+        size_t i = 0;
+        for (; (i + 4) <= count; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sPtr + i));
+            __m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(v, mask)), scale);
+            __m128 g = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 10), mask)), scale);
+            __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 20), mask)), scale);
+            __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(v, 30)), alphaScale);
+            _MM_TRANSPOSE4_PS(r, g, b, a);
+            dPtr[i] = r;
+            dPtr[i + 1] = g;
+            dPtr[i + 2] = b;
+            dPtr[i + 3] = a;
+        }
+
+        for (; i < count; ++i)
+        {
+            dPtr[i] = XMLoadUDecN4(reinterpret_cast<const XMUDECN4*>(sPtr + i));
+        }
+    }
+
+    // F16C quiets signaling NaNs on load and keeps NaN payloads on store, where the DirectXMath conversions may not,
+    // so pixels holding a NaN go through XMLoadHalf4/XMStoreHalf4 to stay bit-exact with the scalar path
+    inline bool HasHalfNaN(__m128i v) noexcept
+    {
+        const __m128i nan = _mm_cmpgt_epi16(_mm_and_si128(v, _mm_set1_epi16(0x7FFF)), _mm_set1_epi16(0x7C00));
+        return _mm_movemask_epi8(nan) != 0;
+    }
+
+    DIRECTX_TEX_TARGET_F16C
+    void LoadHalf4_F16C(XMVECTOR* __restrict dPtr, const XMHALF4* __restrict sPtr, size_t count) noexcept
+    {
+        size_t i = 0;
+        for (; (i + 2) <= count; i += 2)
+        {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sPtr + i));
+            if (HasHalfNaN(h))
+            {
+                dPtr[i] = XMLoadHalf4(sPtr + i);
+                dPtr[i + 1] = XMLoadHalf4(sPtr + i + 1);
+                continue;
+            }
+
+            _mm256_storeu_ps(reinterpret_cast<float*>(dPtr + i), _mm256_cvtph_ps(h));
+        }
+
+        if (i < count)
+        {
+            const __m128i h = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(sPtr + i));
+            dPtr[i] = HasHalfNaN(h) ? XMLoadHalf4(sPtr + i) : _mm_cvtph_ps(h);
+        }
+    }
+
+    DIRECTX_TEX_TARGET_F16C
+    void StoreHalf4_F16C(XMHALF4* __restrict dPtr, const XMVECTOR* __restrict sPtr, size_t count) noexcept
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const XMVECTOR v = XMVectorClamp(sPtr[i], g_HalfMin, g_HalfMax);
+            if (_mm_movemask_ps(_mm_cmpunord_ps(v, v)))
+            {
+                XMStoreHalf4(dPtr + i, v);
+                continue;
+            }
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dPtr + i), _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+        }
+    }
+#endif // DIRECTX_TEX_SCANLINE_SSE
+
+#ifdef DIRECTX_TEX_SCANLINE_NEON
+    void LoadUByteN4_NEON(XMVECTOR* __restrict dPtr, const uint8_t* __restrict sPtr, size_t count, bool bgr) noexcept
+    {
+        size_t i = 0;
+        for (; (i + 4) <= count; i += 4, sPtr += 16)
+        {
+            const uint8x16_t v = vld1q_u8(sPtr);
+            const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+            const uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+            const uint32x4_t pixels[4] =
+            {
+                vmovl_u16(vget_low_u16(lo)), vmovl_u16(vget_high_u16(lo)),
+                vmovl_u16(vget_low_u16(hi)), vmovl_u16(vget_high_u16(hi))
+            };
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                const XMVECTOR c = vmulq_f32(vcvtq_f32_u32(pixels[j]), g_UByteNScale);
+                dPtr[i + j] = (bgr) ? XMVectorSwizzle<2, 1, 0, 3>(c) : c;
+            }
+        }
+
+        for (; i < count; ++i, sPtr += 4)
+        {
+            const XMVECTOR c = XMLoadUByteN4(reinterpret_cast<const XMUBYTEN4*>(sPtr));
+            dPtr[i] = (bgr) ? XMVectorSwizzle<2, 1, 0, 3>(c) : c;
+        }
+    }
+#endif // DIRECTX_TEX_SCANLINE_NEON
+
+    // Returns false if the format has no vectorized path, leaving it to the per-pixel conversion
+    bool LoadScanlineSIMD(
+        _Out_writes_(count) XMVECTOR* pDestination,
+        size_t count,
+        _In_reads_bytes_(size) const void* pSource,
+        size_t size,
+        DXGI_FORMAT format) noexcept
+    {
+        switch (static_cast<int>(format))
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            if (size >= sizeof(uint32_t))
+            {
+                const bool bgr = (format == DXGI_FORMAT_B8G8R8A8_UNORM || format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+                const size_t n = std::min(count, size / sizeof(uint32_t));
+            #ifdef DIRECTX_TEX_SCANLINE_SSE
+                if (GetCPUFeatures().avx2)
+                {
+                    LoadUByteN4_AVX2(pDestination, static_cast<const uint8_t*>(pSource), n, bgr);
+                }
+                else
+                {
+                    LoadUByteN4_SSE2(pDestination, static_cast<const uint8_t*>(pSource), n, bgr);
+                }
+            #else
+                LoadUByteN4_NEON(pDestination, static_cast<const uint8_t*>(pSource), n, bgr);
+            #endif
+                return true;
+            }
+            return false;
+
+    #ifdef DIRECTX_TEX_SCANLINE_SSE
+        case DXGI_FORMAT_R10G10B10A2_UNORM:
+            if (size >= sizeof(uint32_t))
+            {
+                LoadUDecN4_SSE2(pDestination, static_cast<const uint32_t*>(pSource), std::min(count, size / sizeof(uint32_t)));
+                return true;
+            }
+            return false;
+
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            if (size >= sizeof(XMHALF4) && GetCPUFeatures().f16c)
+            {
+                LoadHalf4_F16C(pDestination, static_cast<const XMHALF4*>(pSource), std::min(count, size / sizeof(XMHALF4)));
+                return true;
+            }
+            return false;
+    #endif
+
+        default:
+            return false;
+        }
+    }
+
+    bool StoreScanlineSIMD(
+        _Out_writes_bytes_(size) void* pDestination,
+        size_t size,
+        DXGI_FORMAT format,
+        _In_reads_(count) const XMVECTOR* pSource,
+        size_t count) noexcept
+    {
+    #ifdef DIRECTX_TEX_SCANLINE_SSE
+        switch (static_cast<int>(format))
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            if (size >= sizeof(uint32_t))
+            {
+                const bool bgr = (format == DXGI_FORMAT_B8G8R8A8_UNORM || format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+                StoreUByteN4_SSE2(static_cast<uint8_t*>(pDestination), pSource, std::min(count, size / sizeof(uint32_t)), bgr);
+                return true;
+            }
+            return false;
+
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            if (size >= sizeof(XMHALF4) && GetCPUFeatures().f16c)
+            {
+                StoreHalf4_F16C(static_cast<XMHALF4*>(pDestination), pSource, std::min(count, size / sizeof(XMHALF4)));
+                return true;
+            }
+            return false;
+
+        default:
+            return false;
+        }
+    #else
+        UNREFERENCED_PARAMETER(pDestination);
+        UNREFERENCED_PARAMETER(size);
+        UNREFERENCED_PARAMETER(format);
+        UNREFERENCED_PARAMETER(pSource);
+        UNREFERENCED_PARAMETER(count);
+        return false;
+    #endif
+    }
+#endif // DIRECTX_TEX_SCANLINE_SIMD
 }
 
 //-------------------------------------------------------------------------------------
@@ -774,7 +1158,7 @@ bool DirectX::Internal::ExpandScanline(
         return false;
 
 #pragma warning(suppress: 6101)
-_Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
+_Use_decl_annotations_ bool DirectX::Internal::LoadScanlineScalar(
     XMVECTOR* pDestination,
     size_t count,
     const void* pSource,
@@ -1616,6 +2000,26 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
     }
 }
 
+_Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
+    XMVECTOR* pDestination,
+    size_t count,
+    const void* pSource,
+    size_t size,
+    DXGI_FORMAT format) noexcept
+{
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_LOAD_SCANLINE);
+
+#ifdef DIRECTX_TEX_SCANLINE_SIMD
+    assert(pDestination && count > 0 && ((reinterpret_cast<uintptr_t>(pDestination) & 0xF) == 0));
+    assert(pSource && size > 0);
+
+    if (pDestination && LoadScanlineSIMD(pDestination, count, pSource, size, format))
+        return true;
+#endif
+
+    return LoadScanlineScalar(pDestination, count, pSource, size, format);
+}
+
 #undef LOAD_SCANLINE
 #undef LOAD_SCANLINE3
 #undef LOAD_SCANLINE2
@@ -1638,7 +2042,7 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         return false;
 
 _Use_decl_annotations_
-bool DirectX::Internal::StoreScanline(
+bool DirectX::Internal::StoreScanlineScalar(
     void* pDestination,
     size_t size,
     DXGI_FORMAT format,
@@ -1667,7 +2071,13 @@ bool DirectX::Internal::StoreScanline(
     switch (static_cast<int>(format))
     {
     case DXGI_FORMAT_R32G32B32A32_FLOAT:
-        STORE_SCANLINE(XMFLOAT4, XMStoreFloat4)
+        if (size >= sizeof(XMFLOAT4))
+        {
+            const size_t msize = std::min(size / sizeof(XMFLOAT4), count) * sizeof(XMFLOAT4);
+            memcpy(pDestination, sPtr, msize);
+            return true;
+        }
+        return false;
 
     case DXGI_FORMAT_R32G32B32A32_UINT:
         STORE_SCANLINE(XMUINT4, XMStoreUInt4)
@@ -2524,6 +2934,32 @@ bool DirectX::Internal::StoreScanline(
     }
 }
 
+_Use_decl_annotations_
+bool DirectX::Internal::StoreScanline(
+    void* pDestination,
+    size_t size,
+    DXGI_FORMAT format,
+    const XMVECTOR* pSource,
+    size_t count,
+    float threshold) noexcept
+{
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_STORE_SCANLINE);
+
+#ifdef DIRECTX_TEX_SCANLINE_SIMD
+    assert(pDestination != nullptr);
+
+    if (size && count && pSource)
+    {
+        assert((reinterpret_cast<uintptr_t>(pSource) & 0xF) == 0);
+
+        if (StoreScanlineSIMD(pDestination, size, format, pSource, count))
+            return true;
+    }
+#endif
+
+    return StoreScanlineScalar(pDestination, size, format, pSource, count, threshold);
+}
+
 #undef STORE_SCANLINE
 
 
@@ -4910,6 +5346,185 @@ namespace
         return S_OK;
     }
 
+    //-------------------------------------------------------------------------------------
+    // Direct conversions for format pairs that are exact integer or bit manipulation,
+    // bypassing the Load/Convert/StoreScanline round trip through XMVECTOR
+    //-------------------------------------------------------------------------------------
+    typedef void (*DirectConvertFunc)(_Out_ uint8_t* pDest, _In_ const uint8_t* pSrc, size_t width);
+
+    void DirectCopy32(uint8_t* pDest, const uint8_t* pSrc, size_t width) noexcept
+    {
+        memcpy(pDest, pSrc, width * sizeof(uint32_t));
+    }
+
+    // BGRX8 stores its unused channel as 0xFF
+    void DirectCopySetAlpha32(uint8_t* pDest, const uint8_t* pSrc, size_t width) noexcept
+    {
+        for (size_t i = 0; i < width; ++i)
+        {
+            uint32_t t;
+            memcpy(&t, pSrc + i * sizeof(uint32_t), sizeof(uint32_t));
+
+            t |= 0xFF000000;
+
+            memcpy(pDest + i * sizeof(uint32_t), &t, sizeof(uint32_t));
+        }
+    }
+
+    // RGBA8 <-> BGRA8
+    void DirectSwapRB(uint8_t* pDest, const uint8_t* pSrc, size_t width) noexcept
+    {
+        for (size_t i = 0; i < width; ++i)
+        {
+            uint32_t t;
+            memcpy(&t, pSrc + i * sizeof(uint32_t), sizeof(uint32_t));
+
+            t = ((t & 0x00FF0000) >> 16) | ((t & 0x000000FF) << 16) | (t & 0xFF00FF00);
+
+            memcpy(pDest + i * sizeof(uint32_t), &t, sizeof(uint32_t));
+        }
+    }
+
+    // BGRX8 -> RGBA8
+    void DirectSwapRBSetAlpha(uint8_t* pDest, const uint8_t* pSrc, size_t width) noexcept
+    {
+        for (size_t i = 0; i < width; ++i)
+        {
+            uint32_t t;
+            memcpy(&t, pSrc + i * sizeof(uint32_t), sizeof(uint32_t));
+
+            t = ((t & 0x00FF0000) >> 16) | ((t & 0x000000FF) << 16) | (t & 0x0000FF00) | 0xFF000000;
+
+            memcpy(pDest + i * sizeof(uint32_t), &t, sizeof(uint32_t));
+        }
+    }
+
+    // RGBA8 / BGRA8 -> R8 for TEX_FILTER_RGB_COPY_*
+    template<size_t channel>
+    void DirectExtract8(uint8_t* pDest, const uint8_t* pSrc, size_t width) noexcept
+    {
+        for (size_t i = 0; i < width; ++i)
+        {
+            pDest[i] = pSrc[i * sizeof(uint32_t) + channel];
+        }
+    }
+
+    // RGBA16F -> RGBA32F
+    void DirectHalfToFloat(uint8_t* pDest, const uint8_t* pSrc, size_t width) noexcept
+    {
+        XMConvertHalfToFloatStream(
+            reinterpret_cast<float*>(pDest), sizeof(float),
+            reinterpret_cast<const HALF*>(pSrc), sizeof(HALF),
+            width * 4);
+    }
+
+    struct DirectConversion
+    {
+        DXGI_FORMAT         srcFormat;
+        DXGI_FORMAT         destFormat;
+        uint32_t            rgbCopy;    // TEX_FILTER_RGB_COPY_* selection this applies to
+        DirectConvertFunc   pfConvert;
+    };
+
+    constexpr uint32_t RGB_COPY_ANY = 0xFFFFFFFF;
+
+    const DirectConversion g_DirectConversions[] =
+    {
+        { DXGI_FORMAT_R16G16B16A16_FLOAT,   DXGI_FORMAT_R32G32B32A32_FLOAT, RGB_COPY_ANY,               DirectHalfToFloat },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R8_UNORM,           TEX_FILTER_RGB_COPY_RED,    DirectExtract8<0> },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R8_UNORM,           TEX_FILTER_RGB_COPY_GREEN,  DirectExtract8<1> },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R8_UNORM,           TEX_FILTER_RGB_COPY_BLUE,   DirectExtract8<2> },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R8_UNORM,           TEX_FILTER_RGB_COPY_ALPHA,  DirectExtract8<3> },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_B8G8R8A8_UNORM,     RGB_COPY_ANY,               DirectSwapRB },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R8G8B8A8_UNORM,     RGB_COPY_ANY,               DirectSwapRB },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R8_UNORM,           TEX_FILTER_RGB_COPY_RED,    DirectExtract8<2> },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R8_UNORM,           TEX_FILTER_RGB_COPY_GREEN,  DirectExtract8<1> },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R8_UNORM,           TEX_FILTER_RGB_COPY_BLUE,   DirectExtract8<0> },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R8_UNORM,           TEX_FILTER_RGB_COPY_ALPHA,  DirectExtract8<3> },
+        { DXGI_FORMAT_B8G8R8X8_UNORM,       DXGI_FORMAT_R8G8B8A8_UNORM,     RGB_COPY_ANY,               DirectSwapRBSetAlpha },
+    };
+
+    DirectConvertFunc GetDirectConversion(
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ DXGI_FORMAT sformat,
+        _In_ DXGI_FORMAT tformat) noexcept
+    {
+        if (filter & (TEX_FILTER_FORCE_WIC | TEX_FILTER_DITHER | TEX_FILTER_DITHER_DIFFUSION))
+            return nullptr;
+
+        // Only exact when ConvertScanline would not apply a color space conversion
+        const bool srgbIn = IsSRGB(sformat) || (filter & TEX_FILTER_SRGB_IN);
+        const bool srgbOut = IsSRGB(tformat) || (filter & TEX_FILTER_SRGB_OUT);
+        if (srgbIn != srgbOut)
+            return nullptr;
+
+        sformat = MakeLinear(sformat);
+        tformat = MakeLinear(tformat);
+
+        if (sformat == tformat)
+        {
+            // UNORM <-> UNORM_SRGB retagging
+            switch (sformat)
+            {
+            case DXGI_FORMAT_R8G8B8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+                return DirectCopy32;
+
+            case DXGI_FORMAT_B8G8R8X8_UNORM:
+                return DirectCopySetAlpha32;
+
+            default:
+                return nullptr;
+            }
+        }
+
+        const uint32_t rgbCopy = filter & (TEX_FILTER_RGB_COPY_RED | TEX_FILTER_RGB_COPY_GREEN | TEX_FILTER_RGB_COPY_BLUE | TEX_FILTER_RGB_COPY_ALPHA);
+        for (const auto& it : g_DirectConversions)
+        {
+            if (it.srcFormat == sformat && it.destFormat == tformat
+                && (it.rgbCopy == RGB_COPY_ANY || it.rgbCopy == rgbCopy))
+            {
+                return it.pfConvert;
+            }
+        }
+
+        return nullptr;
+    }
+
+    HRESULT ConvertDirect(
+        _In_ const Image& srcImage,
+        _In_ DirectConvertFunc pfConvert,
+        _In_ const Image& destImage,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        assert(srcImage.width == destImage.width);
+        assert(srcImage.height == destImage.height);
+        assert(pfConvert != nullptr);
+
+        const uint8_t *pSrc = srcImage.pixels;
+        uint8_t *pDest = destImage.pixels;
+        if (!pSrc || !pDest)
+            return E_POINTER;
+
+        for (size_t h = 0; h < srcImage.height; ++h)
+        {
+            if (statusCallback)
+            {
+                if (!statusCallback(h, srcImage.height))
+                {
+                    return E_ABORT;
+                }
+            }
+
+            pfConvert(pDest, pSrc, srcImage.width);
+
+            pSrc += srcImage.rowPitch;
+            pDest += destImage.rowPitch;
+        }
+
+        return S_OK;
+    }
+
     //-------------------------------------------------------------------------------------
     DXGI_FORMAT PlanarToSingle(_In_ DXGI_FORMAT format) noexcept
     {
@@ -5108,6 +5723,8 @@ HRESULT DirectX::ConvertEx(
     ScratchImage& image,
     std::function<bool __cdecl(size_t, size_t)> statusCallback)
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_CONVERT);
+
     if ((srcImage.format == format) || !IsValid(format))
         return E_INVALIDARG;
 
@@ -5144,7 +5761,12 @@ HRESULT DirectX::ConvertEx(
     }
 
     WICPixelFormatGUID pfGUID, targetGUID;
-    if (UseWICConversion(options.filter, srcImage.format, format, pfGUID, targetGUID))
+    const DirectConvertFunc pfDirect = GetDirectConversion(options.filter, srcImage.format, format);
+    if (pfDirect)
+    {
+        hr = ConvertDirect(srcImage, pfDirect, *rimage, statusCallback);
+    }
+    else if (UseWICConversion(options.filter, srcImage.format, format, pfGUID, targetGUID))
     {
         hr = ConvertUsingWIC(srcImage, pfGUID, targetGUID, options.filter, options.threshold, *rimage);
     }
@@ -5202,6 +5824,8 @@ HRESULT DirectX::ConvertEx(
     ScratchImage& result,
     std::function<bool __cdecl(size_t, size_t)> statusCallback)
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_CONVERT);
+
     if (!srcImages || !nimages || (metadata.format == format) || !IsValid(format))
         return E_INVALIDARG;
 
@@ -5256,7 +5880,8 @@ HRESULT DirectX::ConvertEx(
     }
 
     WICPixelFormatGUID pfGUID, targetGUID;
-    const bool usewic = !metadata.IsPMAlpha() && UseWICConversion(options.filter, metadata.format, format, pfGUID, targetGUID);
+    const DirectConvertFunc pfDirect = GetDirectConversion(options.filter, metadata.format, format);
+    const bool usewic = !pfDirect && !metadata.IsPMAlpha() && UseWICConversion(options.filter, metadata.format, format, pfGUID, targetGUID);
 
     switch (metadata.dimension)
     {
@@ -5286,7 +5911,11 @@ HRESULT DirectX::ConvertEx(
                 return E_FAIL;
             }
 
-            if (usewic)
+            if (pfDirect)
+            {
+                hr = ConvertDirect(src, pfDirect, dst, nullptr);
+            }
+            else if (usewic)
             {
                 hr = ConvertUsingWIC(src, pfGUID, targetGUID, options.filter, options.threshold, dst);
             }
@@ -5348,7 +5977,11 @@ HRESULT DirectX::ConvertEx(
                         return E_FAIL;
                     }
 
-                    if (usewic)
+                    if (pfDirect)
+                    {
+                        hr = ConvertDirect(src, pfDirect, dst, nullptr);
+                    }
+                    else if (usewic)
                     {
                         hr = ConvertUsingWIC(src, pfGUID, targetGUID, options.filter, options.threshold, dst);
                     }
@@ -13,6 +13,13 @@
 
 #include "DDS.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 
@@ -1469,6 +1476,87 @@ namespace
         }
     }
 
+    //-------------------------------------------------------------------------------------
+    // Pitch flags describing the legacy pixel layout stored in the file
+    //-------------------------------------------------------------------------------------
+    CP_FLAGS GetSourcePitchFlags(uint32_t convFlags, CP_FLAGS cpFlags) noexcept
+    {
+        if (convFlags & CONV_FLAGS_EXPAND)
+        {
+            if (convFlags & CONV_FLAGS_888)
+                cpFlags |= CP_FLAGS_24BPP;
+            else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551 | CONV_FLAGS_4444 | CONV_FLAGS_8332 | CONV_FLAGS_A8P8 | CONV_FLAGS_L16 | CONV_FLAGS_A8L8 | CONV_FLAGS_L6V5U5))
+                cpFlags |= CP_FLAGS_16BPP;
+            else if (convFlags & (CONV_FLAGS_44 | CONV_FLAGS_332 | CONV_FLAGS_PAL8 | CONV_FLAGS_L8))
+                cpFlags |= CP_FLAGS_8BPP;
+        }
+
+        return cpFlags;
+    }
+
+    inline uint32_t GetScanlineFlags(uint32_t convFlags) noexcept
+    {
+        uint32_t tflags = (convFlags & CONV_FLAGS_NOALPHA) ? TEXP_SCANLINE_SETALPHA : 0u;
+        if (convFlags & CONV_FLAGS_SWIZZLE)
+            tflags |= TEXP_SCANLINE_LEGACY;
+        return tflags;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Converts or copies a single scanline of non-compressed, non-planar pixel data
+    //-------------------------------------------------------------------------------------
+    bool ConvertDDSScanline(
+        _Out_writes_bytes_(outSize) void* pDest,
+        size_t outSize,
+        DXGI_FORMAT format,
+        _In_reads_bytes_(inSize) const void* pSrc,
+        size_t inSize,
+        uint32_t convFlags,
+        _In_reads_opt_(256) const uint32_t* pal8,
+        uint32_t tflags) noexcept
+    {
+        if (convFlags & CONV_FLAGS_EXPAND)
+        {
+            if (convFlags & CONV_FLAGS_4444)
+            {
+                return ExpandScanline(pDest, outSize, DXGI_FORMAT_R8G8B8A8_UNORM,
+                    pSrc, inSize,
+                    (convFlags & CONF_FLAGS_11ON12) ? WIN11_DXGI_FORMAT_A4B4G4R4_UNORM : DXGI_FORMAT_B4G4R4A4_UNORM,
+                    tflags);
+            }
+            else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551))
+            {
+                return ExpandScanline(pDest, outSize, DXGI_FORMAT_R8G8B8A8_UNORM,
+                    pSrc, inSize,
+                    (convFlags & CONV_FLAGS_565) ? DXGI_FORMAT_B5G6R5_UNORM : DXGI_FORMAT_B5G5R5A1_UNORM,
+                    tflags);
+            }
+            else
+            {
+                const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
+                return LegacyExpandScanline(pDest, outSize, format,
+                    pSrc, inSize, lformat, pal8,
+                    tflags);
+            }
+        }
+        else if (convFlags & CONV_FLAGS_SWIZZLE)
+        {
+            SwizzleScanline(pDest, outSize, pSrc, inSize, format, tflags);
+        }
+        else if (convFlags & (CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
+        {
+            const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
+            return LegacyConvertScanline(pDest, outSize, format,
+                pSrc, inSize, lformat, tflags);
+        }
+        else
+        {
+            CopyScanline(pDest, outSize, pSrc, inSize, format, tflags);
+        }
+
+        return true;
+    }
+
     //-------------------------------------------------------------------------------------
     // Converts or copies image data from pPixels into scratch image data
     //-------------------------------------------------------------------------------------
@@ -1487,15 +1575,7 @@ namespace
         if (!size)
             return E_FAIL;
 
-        if (convFlags & CONV_FLAGS_EXPAND)
-        {
-            if (convFlags & CONV_FLAGS_888)
-                cpFlags |= CP_FLAGS_24BPP;
-            else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551 | CONV_FLAGS_4444 | CONV_FLAGS_8332 | CONV_FLAGS_A8P8 | CONV_FLAGS_L16 | CONV_FLAGS_A8L8 | CONV_FLAGS_L6V5U5))
-                cpFlags |= CP_FLAGS_16BPP;
-            else if (convFlags & (CONV_FLAGS_44 | CONV_FLAGS_332 | CONV_FLAGS_PAL8 | CONV_FLAGS_L8))
-                cpFlags |= CP_FLAGS_8BPP;
-        }
+        cpFlags = GetSourcePitchFlags(convFlags, cpFlags);
 
         size_t pixelSize, nimages;
         HRESULT hr = DetermineImageArray(metadata, cpFlags, nimages, pixelSize);
@@ -1540,9 +1620,7 @@ namespace
             return E_FAIL;
         }
 
-        uint32_t tflags = (convFlags & CONV_FLAGS_NOALPHA) ? TEXP_SCANLINE_SETALPHA : 0u;
-        if (convFlags & CONV_FLAGS_SWIZZLE)
-            tflags |= TEXP_SCANLINE_LEGACY;
+        const uint32_t tflags = GetScanlineFlags(convFlags);
 
         switch (metadata.dimension)
         {
@@ -1608,48 +1686,8 @@ namespace
                         {
                             for (size_t h = 0; h < images[index].height; ++h)
                             {
-                                if (convFlags & CONV_FLAGS_EXPAND)
-                                {
-                                    if (convFlags & CONV_FLAGS_4444)
-                                    {
-                                        if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
-                                            pSrc, spitch,
-                                            (convFlags & CONF_FLAGS_11ON12) ? WIN11_DXGI_FORMAT_A4B4G4R4_UNORM : DXGI_FORMAT_B4G4R4A4_UNORM,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                    else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551))
-                                    {
-                                        if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
-                                            pSrc, spitch,
-                                            (convFlags & CONV_FLAGS_565) ? DXGI_FORMAT_B5G6R5_UNORM : DXGI_FORMAT_B5G5R5A1_UNORM,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                    else
-                                    {
-                                        const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
-                                        if (!LegacyExpandScanline(pDest, dpitch, metadata.format,
-                                            pSrc, spitch, lformat, pal8,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                }
-                                else if (convFlags & CONV_FLAGS_SWIZZLE)
-                                {
-                                    SwizzleScanline(pDest, dpitch, pSrc, spitch, metadata.format, tflags);
-                                }
-                                else if (convFlags & (CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
-                                {
-                                    const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
-                                    if (!LegacyConvertScanline(pDest, dpitch, metadata.format,
-                                        pSrc, spitch, lformat, tflags))
-                                        return E_FAIL;
-                                }
-                                else
-                                {
-                                    CopyScanline(pDest, dpitch, pSrc, spitch, metadata.format, tflags);
-                                }
+                                if (!ConvertDDSScanline(pDest, dpitch, metadata.format, pSrc, spitch, convFlags, pal8, tflags))
+                                    return E_FAIL;
 
                                 pSrc += spitch;
                                 pDest += dpitch;
@@ -1714,48 +1752,8 @@ namespace
                         {
                             for (size_t h = 0; h < images[index].height; ++h)
                             {
-                                if (convFlags & CONV_FLAGS_EXPAND)
-                                {
-                                    if (convFlags & CONV_FLAGS_4444)
-                                    {
-                                        if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
-                                            pSrc, spitch,
-                                            (convFlags & CONF_FLAGS_11ON12) ? WIN11_DXGI_FORMAT_A4B4G4R4_UNORM : DXGI_FORMAT_B4G4R4A4_UNORM,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                    else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551))
-                                    {
-                                        if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
-                                            pSrc, spitch,
-                                            (convFlags & CONV_FLAGS_565) ? DXGI_FORMAT_B5G6R5_UNORM : DXGI_FORMAT_B5G5R5A1_UNORM,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                    else
-                                    {
-                                        const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
-                                        if (!LegacyExpandScanline(pDest, dpitch, metadata.format,
-                                            pSrc, spitch, lformat, pal8,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                }
-                                else if (convFlags & CONV_FLAGS_SWIZZLE)
-                                {
-                                    SwizzleScanline(pDest, dpitch, pSrc, spitch, metadata.format, tflags);
-                                }
-                                else if (convFlags & (CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
-                                {
-                                    const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
-                                    if (!LegacyConvertScanline(pDest, dpitch, metadata.format,
-                                        pSrc, spitch, lformat, tflags))
-                                        return E_FAIL;
-                                }
-                                else
-                                {
-                                    CopyScanline(pDest, dpitch, pSrc, spitch, metadata.format, tflags);
-                                }
+                                if (!ConvertDDSScanline(pDest, dpitch, metadata.format, pSrc, spitch, convFlags, pal8, tflags))
+                                    return E_FAIL;
 
                                 pSrc += spitch;
                                 pDest += dpitch;
@@ -1790,9 +1788,7 @@ namespace
         if (IsPlanar(metadata.format))
             return HRESULT_E_NOT_SUPPORTED;
 
-        uint32_t tflags = (convFlags & CONV_FLAGS_NOALPHA) ? TEXP_SCANLINE_SETALPHA : 0u;
-        if (convFlags & CONV_FLAGS_SWIZZLE)
-            tflags |= TEXP_SCANLINE_LEGACY;
+        const uint32_t tflags = GetScanlineFlags(convFlags);
 
         for (size_t i = 0; i < image.GetImageCount(); ++i)
         {
@@ -1828,6 +1824,245 @@ namespace
 
         return S_OK;
     }
+
+    //-------------------------------------------------------------------------------------
+    // Row source for ImageReader
+    //-------------------------------------------------------------------------------------
+    class DDSSource : public ImageReader::Source
+    {
+    public:
+        DDSSource() noexcept :
+            mdata{}, convFlags(0), cpFlags(CP_FLAGS_NONE), pixelOffset(0),
+            srcPitch(0), rawSize(0), pal8{} {}
+
+        HRESULT __cdecl Seek(size_t mip, size_t item, size_t slice, Image& image) noexcept override
+        {
+            image = {};
+
+            // Locate the subresource using the pitch of the data as stored in the file
+            uint64_t offset = pixelOffset;
+            size_t width = mdata.width;
+            size_t height = mdata.height;
+            size_t rowPitch, slicePitch;
+            HRESULT hr;
+
+            if (mdata.dimension == TEX_DIMENSION_TEXTURE3D)
+            {
+                if (IsPlanar(mdata.format))
+                {
+                    // Direct3D does not support any planar formats for Texture3D
+                    return HRESULT_E_NOT_SUPPORTED;
+                }
+
+                size_t depth = mdata.depth;
+                for (size_t level = 0; level < mip; ++level)
+                {
+                    hr = ComputePitch(mdata.format, width, height, rowPitch, slicePitch, cpFlags);
+                    if (FAILED(hr))
+                        return hr;
+
+                    offset += uint64_t(slicePitch) * depth;
+
+                    if (width > 1)
+                        width >>= 1;
+
+                    if (height > 1)
+                        height >>= 1;
+
+                    if (depth > 1)
+                        depth >>= 1;
+                }
+
+                hr = ComputePitch(mdata.format, width, height, rowPitch, slicePitch, cpFlags);
+                if (FAILED(hr))
+                    return hr;
+
+                offset += uint64_t(slicePitch) * slice;
+            }
+            else
+            {
+                uint64_t itemSize = 0;
+                size_t w = mdata.width;
+                size_t h = mdata.height;
+                for (size_t level = 0; level < mdata.mipLevels; ++level)
+                {
+                    hr = ComputePitch(mdata.format, w, h, rowPitch, slicePitch, cpFlags);
+                    if (FAILED(hr))
+                        return hr;
+
+                    if (level < mip)
+                    {
+                        offset += slicePitch;
+                    }
+                    else if (level == mip)
+                    {
+                        width = w;
+                        height = h;
+                    }
+
+                    itemSize += slicePitch;
+
+                    if (w > 1)
+                        w >>= 1;
+
+                    if (h > 1)
+                        h >>= 1;
+                }
+
+                offset += itemSize * item;
+
+                hr = ComputePitch(mdata.format, width, height, rowPitch, slicePitch, cpFlags);
+                if (FAILED(hr))
+                    return hr;
+            }
+
+            srcPitch = rowPitch;
+
+            if (rawSize < srcPitch)
+            {
+                raw.reset(new (std::nothrow) uint8_t[srcPitch]);
+                if (!raw)
+                {
+                    rawSize = 0;
+                    return E_OUTOFMEMORY;
+                }
+                rawSize = srcPitch;
+            }
+
+            hr = file.Seek(offset);
+            if (FAILED(hr))
+                return hr;
+
+            image.width = width;
+            image.height = height;
+            image.format = mdata.format;
+            return ComputePitch(mdata.format, width, height, image.rowPitch, image.slicePitch, CP_FLAGS_NONE);
+        }
+
+        HRESULT __cdecl ReadRow(uint8_t* pDest, size_t rowPitch) noexcept override
+        {
+            const bool convert = (convFlags & (CONV_FLAGS_EXPAND | CONV_FLAGS_SWIZZLE | CONV_FLAGS_NOALPHA | CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10)) != 0
+                && !IsCompressed(mdata.format) && !IsPlanar(mdata.format);
+
+            if (!convert && srcPitch == rowPitch)
+            {
+                // No conversion needed, so read directly into the destination
+                return file.Read(pDest, rowPitch);
+            }
+
+            HRESULT hr = file.Read(raw.get(), srcPitch);
+            if (FAILED(hr))
+                return hr;
+
+            if (!convert)
+            {
+                memcpy(pDest, raw.get(), std::min(srcPitch, rowPitch));
+                return S_OK;
+            }
+
+            if (!ConvertDDSScanline(pDest, rowPitch, mdata.format, raw.get(), srcPitch,
+                convFlags, (convFlags & CONV_FLAGS_PAL8) ? pal8 : nullptr, GetScanlineFlags(convFlags)))
+                return E_FAIL;
+
+            return S_OK;
+        }
+
+        ImageReaderFile file;
+        std::unique_ptr<uint8_t[]> raw;
+        TexMetadata mdata;
+        uint32_t convFlags;
+        CP_FLAGS cpFlags;
+        uint64_t pixelOffset;
+        size_t srcPitch;
+        size_t rawSize;
+        uint32_t pal8[256];
+    };
+
+#ifndef _WIN32
+    //-------------------------------------------------------------------------------------
+    // Maps the pixel data of a DDS file into memory rather than reading a copy
+    //-------------------------------------------------------------------------------------
+    HRESULT MapDDSFile(
+        _In_z_ const wchar_t* szFile,
+        size_t offset,
+        DDS_FLAGS flags,
+        uint32_t convFlags,
+        TexMetadata& mdata,
+        ScratchImage& image) noexcept
+    {
+        const int fd = open(std::filesystem::path(szFile).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return E_FAIL;
+
+        struct stat fileStat = {};
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size < 0)
+        {
+            close(fd);
+            return E_FAIL;
+        }
+
+        const auto len = static_cast<uint64_t>(fileStat.st_size);
+        if (len <= offset)
+        {
+            close(fd);
+            return E_FAIL;
+        }
+
+        const uint64_t remaining = len - offset;
+
+        size_t nimages = 0;
+        size_t pixelSize = 0;
+        HRESULT hr = DetermineImageArray(mdata, CP_FLAGS_NONE, nimages, pixelSize);
+        if (FAILED(hr))
+        {
+            close(fd);
+            return hr;
+        }
+
+        if (flags & DDS_FLAGS_PERMISSIVE)
+        {
+            // For cubemaps, DDS_HEADER_DXT10.arraySize is supposed to be 'number of cubes'.
+            // This handles cases where the value is incorrectly written as the original 6*numCubes value.
+            if ((mdata.miscFlags & TEX_MISC_TEXTURECUBE)
+                && (convFlags & CONV_FLAGS_DX10)
+                && (pixelSize > remaining)
+                && ((mdata.arraySize % 6) == 0))
+            {
+                mdata.arraySize = mdata.arraySize / 6;
+                hr = DetermineImageArray(mdata, CP_FLAGS_NONE, nimages, pixelSize);
+                if (FAILED(hr))
+                {
+                    close(fd);
+                    return hr;
+                }
+            }
+        }
+
+        if (pixelSize > remaining)
+        {
+            close(fd);
+            return HRESULT_E_HANDLE_EOF;
+        }
+
+        // Only the header and pixel data are mapped; the mapping stays valid after the descriptor is closed.
+        // The private mapping is writable so changes to the image pixels are copy-on-write and never reach the file.
+        const size_t viewSize = offset + pixelSize;
+        void* view = mmap(nullptr, viewSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (view == MAP_FAILED)
+            return E_FAIL;
+
+        hr = image.InitializeFromMappedView(mdata, view, viewSize, offset);
+        if (FAILED(hr))
+        {
+            munmap(view, viewSize);
+            return hr;
+        }
+
+        return S_OK;
+    }
+#endif // !WIN32
 }
 
 
@@ -1916,7 +2151,8 @@ HRESULT DirectX::GetMetadataFromDDSFileEx(
     if (!inFile)
         return E_FAIL;
 
-    if (fileLen > UINT32_MAX)
+    // Memory-mapped loads are not limited by the size of a single read
+    if (fileLen > UINT32_MAX && !(flags & DDS_FLAGS_MEMORY_MAPPED))
         return HRESULT_E_FILE_TOO_LARGE;
 
     inFile.seekg(0, std::ios::beg);
@@ -2088,6 +2324,8 @@ HRESULT DirectX::LoadFromDDSFileEx(
     DDSMetaData* ddPixelFormat,
     ScratchImage& image) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_FILE_READ);
+
     if (!szFile)
         return E_INVALIDARG;
 
@@ -2124,7 +2362,8 @@ HRESULT DirectX::LoadFromDDSFileEx(
     if (!inFile)
         return E_FAIL;
 
-    if (fileLen > UINT32_MAX)
+    // Memory-mapped loads are not limited by the size of a single read
+    if (fileLen > UINT32_MAX && !(flags & DDS_FLAGS_MEMORY_MAPPED))
         return HRESULT_E_FILE_TOO_LARGE;
 
     inFile.seekg(0, std::ios::beg);
@@ -2134,6 +2373,8 @@ HRESULT DirectX::LoadFromDDSFileEx(
     const size_t len = fileLen;
 #endif
 
+    TEX_INSTRUMENT_BYTES_READ(len);
+
     // Need at least enough data to fill the standard header and magic number to be a valid DDS
     if (len < DDS_MIN_HEADER_SIZE)
     {
@@ -2217,6 +2458,28 @@ HRESULT DirectX::LoadFromDDSFileEx(
     if (remaining == 0)
         return E_FAIL;
 
+#ifndef _WIN32
+    if ((flags & DDS_FLAGS_MEMORY_MAPPED)
+        && !(convFlags & (CONV_FLAGS_EXPAND | CONV_FLAGS_PAL8 | CONV_FLAGS_SWIZZLE | CONV_FLAGS_NOALPHA | CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
+        && !(flags & (DDS_FLAGS_LEGACY_DWORD | DDS_FLAGS_BAD_DXTN_TAILS)))
+    {
+        // Pixel data is usable as-is, so the image can reference the file contents directly
+        inFile.close();
+
+        hr = MapDDSFile(szFile, offset, flags, convFlags, mdata, image);
+        if (FAILED(hr))
+            return hr;
+
+        if (metadata)
+            memcpy(metadata, &mdata, sizeof(TexMetadata));
+
+        return S_OK;
+    }
+
+    if (len > UINT32_MAX)
+        return HRESULT_E_FILE_TOO_LARGE;
+#endif
+
     hr = image.Initialize(mdata);
     if (FAILED(hr))
         return hr;
@@ -2351,6 +2614,110 @@ HRESULT DirectX::LoadFromDDSFileEx(
 }
 
 
+//-------------------------------------------------------------------------------------
+// Open a DDS file for streaming
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT ImageReader::OpenDDSFile(const wchar_t* szFile, DDS_FLAGS flags) noexcept
+{
+    Close();
+
+    if (!szFile)
+        return E_INVALIDARG;
+
+    if (flags & DDS_FLAGS_BAD_DXTN_TAILS)
+    {
+        // Fix-up of the small mips requires data from other subresources
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    std::unique_ptr<DDSSource> source(new (std::nothrow) DDSSource);
+    if (!source)
+        return E_OUTOFMEMORY;
+
+    HRESULT hr = source->file.Open(szFile);
+    if (FAILED(hr))
+        return hr;
+
+    const uint64_t len = source->file.GetSize();
+
+    // Need at least enough data to fill the standard header and magic number to be a valid DDS
+    if (len < DDS_MIN_HEADER_SIZE)
+    {
+        return E_FAIL;
+    }
+
+    // Read the header in (including extended header if present)
+    uint8_t header[DDS_DX10_HEADER_SIZE] = {};
+
+    const auto headerLen = static_cast<size_t>(std::min<uint64_t>(len, DDS_DX10_HEADER_SIZE));
+    hr = source->file.Read(header, headerLen);
+    if (FAILED(hr))
+        return hr;
+
+    uint32_t convFlags = 0;
+    TexMetadata mdata;
+    hr = DecodeDDSHeader(header, headerLen, flags, mdata, nullptr, convFlags);
+    if (FAILED(hr))
+        return hr;
+
+    uint64_t offset = (convFlags & CONV_FLAGS_DX10) ? DDS_DX10_HEADER_SIZE : DDS_MIN_HEADER_SIZE;
+
+    if (convFlags & CONV_FLAGS_PAL8)
+    {
+        hr = source->file.Seek(offset);
+        if (SUCCEEDED(hr))
+        {
+            hr = source->file.Read(source->pal8, 256 * sizeof(uint32_t));
+        }
+        if (FAILED(hr))
+            return hr;
+
+        offset += (256 * sizeof(uint32_t));
+    }
+
+    if (offset >= len)
+        return E_FAIL;
+
+    const uint64_t remaining = len - offset;
+
+    const CP_FLAGS cpFlags = GetSourcePitchFlags(convFlags,
+        (flags & DDS_FLAGS_LEGACY_DWORD) ? CP_FLAGS_LEGACY_DWORD : CP_FLAGS_NONE);
+
+    size_t nimages = 0;
+    size_t pixelSize = 0;
+    hr = DetermineImageArray(mdata, cpFlags, nimages, pixelSize);
+    if (FAILED(hr))
+        return hr;
+
+    if (flags & DDS_FLAGS_PERMISSIVE)
+    {
+        // For cubemaps, DDS_HEADER_DXT10.arraySize is supposed to be 'number of cubes'.
+        // This handles cases where the value is incorrectly written as the original 6*numCubes value.
+        if ((mdata.miscFlags & TEX_MISC_TEXTURECUBE)
+            && (convFlags & CONV_FLAGS_DX10)
+            && (pixelSize > remaining)
+            && ((mdata.arraySize % 6) == 0))
+        {
+            mdata.arraySize = mdata.arraySize / 6;
+            hr = DetermineImageArray(mdata, cpFlags, nimages, pixelSize);
+            if (FAILED(hr))
+                return hr;
+        }
+    }
+
+    if (pixelSize > remaining)
+        return HRESULT_E_HANDLE_EOF;
+
+    source->mdata = mdata;
+    source->convFlags = convFlags;
+    source->cpFlags = cpFlags;
+    source->pixelOffset = offset;
+
+    return Attach(source.release(), mdata);
+}
+
+
 //-------------------------------------------------------------------------------------
 // Save a DDS file to memory
 //-------------------------------------------------------------------------------------
@@ -2586,6 +2953,8 @@ HRESULT DirectX::SaveToDDSFile(
     DDS_FLAGS flags,
     const wchar_t* szFile) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_FILE_WRITE);
+
     if (!szFile)
         return E_INVALIDARG;
 
@@ -2804,7 +3173,10 @@ HRESULT DirectX::SaveToDDSFile(
     }
 
 #ifdef _WIN32
+    TEX_INSTRUMENT_FILE_WRITTEN(hFile.get());
     delonfail.clear();
+#else
+    TEX_INSTRUMENT_FILE_WRITTEN(outFile);
 #endif
 
     return S_OK;
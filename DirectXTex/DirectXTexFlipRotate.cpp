@@ -11,85 +11,153 @@
 
 #include "DirectXTexP.h"
 
+#include "BC.h"
+
 using namespace DirectX;
 using namespace DirectX::Internal;
-using Microsoft::WRL::ComPtr;
 
 namespace
 {
+    constexpr size_t FLIPROTATE_TILE_SIZE = 32;
+
     //-------------------------------------------------------------------------------------
-    // Do flip/rotate operation using WIC
+    // Decode TEX_FR_FLAGS into a transpose plus flips applied in destination space
+    // (90 degree rotations are clockwise)
     //-------------------------------------------------------------------------------------
-    HRESULT PerformFlipRotateUsingWIC(
-        const Image& srcImage,
-        TEX_FR_FLAGS flags,
-        const WICPixelFormatGUID& pfGUID,
-        const Image& destImage) noexcept
+    void DecodeFlipRotate(TEX_FR_FLAGS flags, bool& swapXY, bool& flipX, bool& flipY) noexcept
     {
-        if (!srcImage.pixels || !destImage.pixels)
-            return E_POINTER;
+        swapXY = flipX = flipY = false;
 
-        assert(srcImage.format == destImage.format);
+        if (flags & TEX_FR_ROTATE90)
+        {
+            swapXY = true;
+            flipX = !flipX;
+        }
 
-        bool iswic2 = false;
-        auto pWIC = GetWICFactory(iswic2);
-        if (!pWIC)
-            return E_NOINTERFACE;
+        if (flags & TEX_FR_ROTATE180)
+        {
+            flipX = !flipX;
+            flipY = !flipY;
+        }
 
-        if (srcImage.rowPitch > UINT32_MAX || srcImage.slicePitch > UINT32_MAX
-            || destImage.rowPitch > UINT32_MAX || destImage.slicePitch > UINT32_MAX)
-            return HRESULT_E_ARITHMETIC_OVERFLOW;
+        if (flags & TEX_FR_FLIP_HORIZONTAL)
+            flipX = !flipX;
 
-        ComPtr<IWICBitmap> source;
-        HRESULT hr = pWIC->CreateBitmapFromMemory(static_cast<UINT>(srcImage.width), static_cast<UINT>(srcImage.height), pfGUID,
-            static_cast<UINT>(srcImage.rowPitch), static_cast<UINT>(srcImage.slicePitch),
-            srcImage.pixels, source.GetAddressOf());
-        if (FAILED(hr))
-            return hr;
+        if (flags & TEX_FR_FLIP_VERTICAL)
+            flipY = !flipY;
+    }
 
-        ComPtr<IWICBitmapFlipRotator> FR;
-        hr = pWIC->CreateBitmapFlipRotator(FR.GetAddressOf());
-        if (FAILED(hr))
-            return hr;
 
-        hr = FR->Initialize(source.Get(), static_cast<WICBitmapTransformOptions>(flags));
-        if (FAILED(hr))
-            return hr;
+    //-------------------------------------------------------------------------------------
+    // Flip without transposing: whole row copies, reversing pixel order for horizontal flips
+    //-------------------------------------------------------------------------------------
+    template<size_t bpp>
+    void FlipImage(const Image& srcImage, const Image& destImage, bool flipX, bool flipY) noexcept
+    {
+        const size_t width = destImage.width;
+        const size_t height = destImage.height;
 
-        WICPixelFormatGUID pfFR;
-        hr = FR->GetPixelFormat(&pfFR);
-        if (FAILED(hr))
-            return hr;
+        const uint8_t* pSrc = srcImage.pixels;
+        uint8_t* pDest = destImage.pixels;
 
-        if (memcmp(&pfFR, &pfGUID, sizeof(GUID)) != 0)
+        for (size_t y = 0; y < height; ++y)
         {
-            // Flip/rotate should return the same format as the source...
-            return HRESULT_E_NOT_SUPPORTED;
+            const uint8_t* sptr = pSrc + (flipY ? (height - 1 - y) : y) * srcImage.rowPitch;
+            uint8_t* dptr = pDest + y * destImage.rowPitch;
+
+            if (!flipX)
+            {
+                memcpy(dptr, sptr, width * bpp);
+                continue;
+            }
+
+            sptr += (width - 1) * bpp;
+            for (size_t x = 0; x < width; ++x, sptr -= bpp, dptr += bpp)
+            {
+                memcpy(dptr, sptr, bpp);
+            }
         }
+    }
 
-        UINT nwidth, nheight;
-        hr = FR->GetSize(&nwidth, &nheight);
-        if (FAILED(hr))
-            return hr;
 
-        if (destImage.width != nwidth || destImage.height != nheight)
-            return E_FAIL;
+    //-------------------------------------------------------------------------------------
+    // Transpose (90/270 rotations) in cache-sized tiles, applying flips on the way
+    //-------------------------------------------------------------------------------------
+    template<size_t bpp>
+    void TransposeImage(const Image& srcImage, const Image& destImage, bool flipX, bool flipY) noexcept
+    {
+        const size_t width = destImage.width;
+        const size_t height = destImage.height;
 
-        hr = FR->CopyPixels(nullptr, static_cast<UINT>(destImage.rowPitch), static_cast<UINT>(destImage.slicePitch), destImage.pixels);
-        if (FAILED(hr))
-            return hr;
+        const uint8_t* pSrc = srcImage.pixels;
+        uint8_t* pDest = destImage.pixels;
 
-        return S_OK;
+        for (size_t ty = 0; ty < height; ty += FLIPROTATE_TILE_SIZE)
+        {
+            const size_t yend = std::min(ty + FLIPROTATE_TILE_SIZE, height);
+
+            for (size_t tx = 0; tx < width; tx += FLIPROTATE_TILE_SIZE)
+            {
+                const size_t xend = std::min(tx + FLIPROTATE_TILE_SIZE, width);
+
+                for (size_t y = ty; y < yend; ++y)
+                {
+                    // Destination rows come from source columns
+                    const uint8_t* scol = pSrc + (flipY ? (height - 1 - y) : y) * bpp;
+                    uint8_t* dptr = pDest + y * destImage.rowPitch + tx * bpp;
+
+                    for (size_t x = tx; x < xend; ++x, dptr += bpp)
+                    {
+                        const size_t sy = flipX ? (width - 1 - x) : x;
+                        memcpy(dptr, scol + sy * srcImage.rowPitch, bpp);
+                    }
+                }
+            }
+        }
+    }
+
+
+    template<size_t bpp>
+    void FlipRotatePixels(const Image& srcImage, const Image& destImage, TEX_FR_FLAGS flags) noexcept
+    {
+        bool swapXY, flipX, flipY;
+        DecodeFlipRotate(flags, swapXY, flipX, flipY);
+
+        if (swapXY)
+        {
+            TransposeImage<bpp>(srcImage, destImage, flipX, flipY);
+        }
+        else
+        {
+            FlipImage<bpp>(srcImage, destImage, flipX, flipY);
+        }
     }
 
 
     //-------------------------------------------------------------------------------------
-    // Do conversion, flip/rotate using WIC, conversion cycle
-    //
-    // For large images we have to use F16 instead of F32 to avoid exceeding the 32-bit
-    // memory limitations of WIC.
+    // Do flip/rotate operation directly in the source format
     //-------------------------------------------------------------------------------------
-    HRESULT PerformFlipRotateViaF16(
+    bool IsNativeFlipRotateFormat(DXGI_FORMAT fmt) noexcept
+    {
+        if (IsPacked(fmt) || IsPlanar(fmt))
+            return false;
+
+        switch (BitsPerPixel(fmt))
+        {
+        case 8:
+        case 16:
+        case 32:
+        case 64:
+        case 96:
+        case 128:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    HRESULT PerformFlipRotate(
         const Image& srcImage,
         TEX_FR_FLAGS flags,
         const Image& destImage) noexcept
@@ -97,40 +165,128 @@ namespace
         if (!srcImage.pixels || !destImage.pixels)
             return E_POINTER;
 
-        assert(srcImage.format != DXGI_FORMAT_R16G16B16A16_FLOAT);
         assert(srcImage.format == destImage.format);
 
-        ScratchImage temp;
-        HRESULT hr = ConvertToR16G16B16A16(srcImage, temp);
-        if (FAILED(hr))
-            return hr;
+        switch (BitsPerPixel(srcImage.format))
+        {
+        case 8:     FlipRotatePixels<1>(srcImage, destImage, flags); break;
+        case 16:    FlipRotatePixels<2>(srcImage, destImage, flags); break;
+        case 32:    FlipRotatePixels<4>(srcImage, destImage, flags); break;
+        case 64:    FlipRotatePixels<8>(srcImage, destImage, flags); break;
+        case 96:    FlipRotatePixels<12>(srcImage, destImage, flags); break;
+        case 128:   FlipRotatePixels<16>(srcImage, destImage, flags); break;
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
 
-        const Image *tsrc = temp.GetImage(0, 0, 0);
-        if (!tsrc)
-            return E_POINTER;
+        return S_OK;
+    }
 
-        ScratchImage rtemp;
-        hr = rtemp.Initialize2D(DXGI_FORMAT_R16G16B16A16_FLOAT, destImage.width, destImage.height, 1, 1);
-        if (FAILED(hr))
-            return hr;
 
-        const Image *tdest = rtemp.GetImage(0, 0, 0);
-        if (!tdest)
+    //-------------------------------------------------------------------------------------
+    // Do flip/rotate operation on BC1 - BC5 blocks without decompressing
+    //-------------------------------------------------------------------------------------
+    BC_PERMUTE GetBlockPermute(DXGI_FORMAT fmt) noexcept
+    {
+        switch (fmt)
+        {
+        case DXGI_FORMAT_BC1_TYPELESS:
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            return D3DXPermuteBC1;
+
+        case DXGI_FORMAT_BC2_TYPELESS:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+            return D3DXPermuteBC2;
+
+        case DXGI_FORMAT_BC3_TYPELESS:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            return D3DXPermuteBC3;
+
+        case DXGI_FORMAT_BC4_TYPELESS:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            return D3DXPermuteBC4;
+
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+            return D3DXPermuteBC5;
+
+        default:
+            return nullptr;
+        }
+    }
+
+    HRESULT PerformFlipRotateBlocks(
+        const Image& srcImage,
+        TEX_FR_FLAGS flags,
+        BC_PERMUTE pfPermute,
+        const Image& destImage) noexcept
+    {
+        if (!srcImage.pixels || !destImage.pixels)
             return E_POINTER;
 
-        hr = PerformFlipRotateUsingWIC(*tsrc, flags, GUID_WICPixelFormat64bppRGBAHalf, *tdest);
-        if (FAILED(hr))
-            return hr;
+        assert(srcImage.format == destImage.format);
+        assert(pfPermute != nullptr);
 
-        temp.Release();
+        bool swapXY, flipX, flipY;
+        DecodeFlipRotate(flags, swapXY, flipX, flipY);
 
-        hr = ConvertFromR16G16B16A16(*tdest, destImage);
-        if (FAILED(hr))
-            return hr;
+        const size_t width = destImage.width;
+        const size_t height = destImage.height;
+
+        // A mirrored axis with a partial last block would pull texels from two source blocks,
+        // which can't be done losslessly. Images no larger than one block mirror within it.
+        if ((flipX && width > 4 && (width & 3)) || (flipY && height > 4 && (height & 3)))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        const size_t extentX = std::min<size_t>(width, 4);
+        const size_t extentY = std::min<size_t>(height, 4);
+
+        // Every block uses the same texel remapping
+        uint8_t remap[NUM_PIXELS_PER_BLOCK];
+        for (size_t ly = 0; ly < 4; ++ly)
+        {
+            for (size_t lx = 0; lx < 4; ++lx)
+            {
+                const size_t x = (flipX && lx < extentX) ? (extentX - 1 - lx) : lx;
+                const size_t y = (flipY && ly < extentY) ? (extentY - 1 - ly) : ly;
+                remap[ly * 4 + lx] = static_cast<uint8_t>(swapXY ? (x * 4 + y) : (y * 4 + x));
+            }
+        }
+
+        const size_t blockSize = (BitsPerPixel(srcImage.format) * NUM_PIXELS_PER_BLOCK) / 8;
+        const size_t nbw = std::max<size_t>(1, (width + 3) / 4);
+        const size_t nbh = std::max<size_t>(1, (height + 3) / 4);
+
+        for (size_t by = 0; by < nbh; ++by)
+        {
+            const size_t sby = flipY ? (nbh - 1 - by) : by;
+            uint8_t* pDest = destImage.pixels + by * destImage.rowPitch;
+
+            for (size_t bx = 0; bx < nbw; ++bx, pDest += blockSize)
+            {
+                const size_t sbx = flipX ? (nbw - 1 - bx) : bx;
+
+                const uint8_t* pSrc = (swapXY)
+                    ? srcImage.pixels + sbx * srcImage.rowPitch + sby * blockSize
+                    : srcImage.pixels + sby * srcImage.rowPitch + sbx * blockSize;
+
+                pfPermute(pDest, pSrc, remap);
+            }
+        }
 
         return S_OK;
     }
 
+
+    //-------------------------------------------------------------------------------------
+    // Do conversion, flip/rotate, conversion cycle for formats without whole-byte pixels
+    //-------------------------------------------------------------------------------------
     HRESULT PerformFlipRotateViaF32(
         const Image& srcImage,
         TEX_FR_FLAGS flags,
@@ -160,7 +316,7 @@ namespace
         if (!tdest)
             return E_POINTER;
 
-        hr = PerformFlipRotateUsingWIC(*tsrc, flags, GUID_WICPixelFormat128bppRGBAFloat, *tdest);
+        hr = PerformFlipRotate(*tsrc, flags, *tdest);
         if (FAILED(hr))
             return hr;
 
@@ -197,19 +353,15 @@ HRESULT DirectX::FlipRotate(
     if ((srcImage.width > UINT32_MAX) || (srcImage.height > UINT32_MAX))
         return E_INVALIDARG;
 
+    BC_PERMUTE pfPermute = nullptr;
     if (IsCompressed(srcImage.format))
     {
-        // We don't support flip/rotate operations on compressed images
-        return HRESULT_E_NOT_SUPPORTED;
+        // Only BC1 - BC5 blocks can be flipped/rotated without decompressing
+        pfPermute = GetBlockPermute(srcImage.format);
+        if (!pfPermute)
+            return HRESULT_E_NOT_SUPPORTED;
     }
 
-    static_assert(static_cast<int>(TEX_FR_ROTATE0) == static_cast<int>(WICBitmapTransformRotate0), "TEX_FR_ROTATE0 no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_ROTATE90) == static_cast<int>(WICBitmapTransformRotate90), "TEX_FR_ROTATE90 no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_ROTATE180) == static_cast<int>(WICBitmapTransformRotate180), "TEX_FR_ROTATE180 no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_ROTATE270) == static_cast<int>(WICBitmapTransformRotate270), "TEX_FR_ROTATE270 no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_FLIP_HORIZONTAL) == static_cast<int>(WICBitmapTransformFlipHorizontal), "TEX_FR_FLIP_HORIZONTAL no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_FLIP_VERTICAL) == static_cast<int>(WICBitmapTransformFlipVertical), "TEX_FR_FLIP_VERTICAL no longer matches WIC");
-
     // Only supports 90, 180, 270, or no rotation flags... not a combination of rotation flags
     const int rotateMode = static_cast<int>(flags & (TEX_FR_ROTATE0 | TEX_FR_ROTATE90 | TEX_FR_ROTATE180 | TEX_FR_ROTATE270));
 
@@ -245,25 +397,20 @@ HRESULT DirectX::FlipRotate(
         return E_POINTER;
     }
 
-    WICPixelFormatGUID pfGUID;
-    if (DXGIToWIC(srcImage.format, pfGUID))
+    if (pfPermute)
+    {
+        // Case 1: Block-compressed, so remap the block indices rather than re-encode
+        hr = PerformFlipRotateBlocks(srcImage, flags, pfPermute, *rimage);
+    }
+    else if (IsNativeFlipRotateFormat(srcImage.format))
     {
-        // Case 1: Source format is supported by Windows Imaging Component
-        hr = PerformFlipRotateUsingWIC(srcImage, flags, pfGUID, *rimage);
+        // Case 2: Pixels are whole bytes, so we can shuffle them in the source format
+        hr = PerformFlipRotate(srcImage, flags, *rimage);
     }
     else
     {
-        // Case 2: Source format is not supported by WIC, so we have to convert, flip/rotate, and convert back
-        const uint64_t expandedSize = uint64_t(srcImage.width) * uint64_t(srcImage.height) * sizeof(float) * 4;
-        if (expandedSize > UINT32_MAX)
-        {
-            // Image is too large for float32, so have to use float16 instead
-            hr = PerformFlipRotateViaF16(srcImage, flags, *rimage);
-        }
-        else
-        {
-            hr = PerformFlipRotateViaF32(srcImage, flags, *rimage);
-        }
+        // Case 3: Source format packs multiple pixels per element, so we have to convert, flip/rotate, and convert back
+        hr = PerformFlipRotateViaF32(srcImage, flags, *rimage);
     }
 
     if (FAILED(hr))
@@ -290,19 +437,15 @@ HRESULT DirectX::FlipRotate(
     if (!srcImages || !nimages)
         return E_INVALIDARG;
 
+    BC_PERMUTE pfPermute = nullptr;
     if (IsCompressed(metadata.format))
     {
-        // We don't support flip/rotate operations on compressed images
-        return HRESULT_E_NOT_SUPPORTED;
+        // Only BC1 - BC5 blocks can be flipped/rotated without decompressing
+        pfPermute = GetBlockPermute(metadata.format);
+        if (!pfPermute)
+            return HRESULT_E_NOT_SUPPORTED;
     }
 
-    static_assert(static_cast<int>(TEX_FR_ROTATE0) == static_cast<int>(WICBitmapTransformRotate0), "TEX_FR_ROTATE0 no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_ROTATE90) == static_cast<int>(WICBitmapTransformRotate90), "TEX_FR_ROTATE90 no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_ROTATE180) == static_cast<int>(WICBitmapTransformRotate180), "TEX_FR_ROTATE180 no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_ROTATE270) == static_cast<int>(WICBitmapTransformRotate270), "TEX_FR_ROTATE270 no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_FLIP_HORIZONTAL) == static_cast<int>(WICBitmapTransformFlipHorizontal), "TEX_FR_FLIP_HORIZONTAL no longer matches WIC");
-    static_assert(static_cast<int>(TEX_FR_FLIP_VERTICAL) == static_cast<int>(WICBitmapTransformFlipVertical), "TEX_FR_FLIP_VERTICAL no longer matches WIC");
-
     // Only supports 90, 180, 270, or no rotation flags... not a combination of rotation flags
     const int rotateMode = static_cast<int>(flags & (TEX_FR_ROTATE0 | TEX_FR_ROTATE90 | TEX_FR_ROTATE180 | TEX_FR_ROTATE270));
 
@@ -345,8 +488,7 @@ HRESULT DirectX::FlipRotate(
         return E_POINTER;
     }
 
-    WICPixelFormatGUID pfGUID;
-    const bool wicpf = DXGIToWIC(metadata.format, pfGUID);
+    const bool native = IsNativeFlipRotateFormat(metadata.format);
 
     for (size_t index = 0; index < nimages; ++index)
     {
@@ -380,24 +522,20 @@ HRESULT DirectX::FlipRotate(
             }
         }
 
-        if (wicpf)
+        if (pfPermute)
+        {
+            // Case 1: Block-compressed, so remap the block indices rather than re-encode
+            hr = PerformFlipRotateBlocks(src, flags, pfPermute, dst);
+        }
+        else if (native)
         {
-            // Case 1: Source format is supported by Windows Imaging Component
-            hr = PerformFlipRotateUsingWIC(src, flags, pfGUID, dst);
+            // Case 2: Pixels are whole bytes, so we can shuffle them in the source format
+            hr = PerformFlipRotate(src, flags, dst);
         }
         else
         {
-            // Case 2: Source format is not supported by WIC, so we have to convert, flip/rotate, and convert back
-            const uint64_t expandedSize = uint64_t(src.width) * uint64_t(src.height) * sizeof(float) * 4;
-            if (expandedSize > UINT32_MAX)
-            {
-                // Image is too large for float32, so have to use float16 instead
-                hr = PerformFlipRotateViaF16(src, flags, dst);
-            }
-            else
-            {
-                hr = PerformFlipRotateViaF32(src, flags, dst);
-            }
+            // Case 3: Source format packs multiple pixels per element, so we have to convert, flip/rotate, and convert back
+            hr = PerformFlipRotateViaF32(src, flags, dst);
         }
 
         if (FAILED(hr))
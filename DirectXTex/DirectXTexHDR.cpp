@@ -589,6 +589,228 @@ namespace
         return encSize;
     #endif
     }
+
+    //-------------------------------------------------------------------------------------
+    // Decode a single scanline (adaptive RLE, standard RLE, or uncompressed) to RGBE floats
+    //-------------------------------------------------------------------------------------
+    HRESULT DecodeScanline(
+        _In_reads_bytes_(size) const uint8_t* pSource, size_t size,
+        _Out_writes_(width * 4) float* scanLine, size_t width,
+        _Out_ size_t& bytesUsed) noexcept
+    {
+        bytesUsed = 0;
+
+        auto sourcePtr = pSource;
+        size_t pixelLen = size;
+
+        if (pixelLen < 4)
+            return HRESULT_E_HANDLE_EOF;
+
+        uint8_t inColor[4];
+        memcpy(inColor, sourcePtr, 4);
+        sourcePtr += 4;
+        pixelLen -= 4;
+
+        if (inColor[0] == 2 && inColor[1] == 2 && inColor[2] < 128)
+        {
+            // Adaptive Run Length Encoding (RLE)
+            if (size_t((size_t(inColor[2]) << 8) + inColor[3]) != width)
+                return E_FAIL;
+
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                auto pixelLoc = scanLine + channel;
+                for (size_t pixelCount = 0; pixelCount < width;)
+                {
+                    if (pixelLen < 2)
+                        return HRESULT_E_HANDLE_EOF;
+
+                    uint8_t runLen = *sourcePtr;
+                    if (runLen > 128)
+                    {
+                        runLen &= 127;
+                        if (pixelCount + runLen > width)
+                            return E_FAIL;
+
+                        auto val = static_cast<float>(sourcePtr[1]);
+                        for (uint8_t j = 0; j < runLen; ++j)
+                        {
+                            *pixelLoc = val;
+                            pixelLoc += 4;
+                        }
+                        pixelCount += runLen;
+                        sourcePtr += 2;
+                        pixelLen -= 2;
+                    }
+                    else if ((pixelCount + size_t(runLen)) > width)
+                    {
+                        return E_FAIL;
+                    }
+                    else if (pixelLen < size_t(runLen) + 1)
+                    {
+                        return HRESULT_E_HANDLE_EOF;
+                    }
+                    else
+                    {
+                        ++sourcePtr;
+                        for (uint8_t j = 0; j < runLen; ++j)
+                        {
+                            auto val = static_cast<float>(*sourcePtr++);
+                            *pixelLoc = val;
+                            pixelLoc += 4;
+                        }
+                        pixelCount += runLen;
+                        pixelLen -= size_t(runLen) + 1;
+                    }
+                }
+            }
+        }
+        else
+        {
+            auto pixelLoc = scanLine;
+
+            float prevColor[4];
+            prevColor[0] = inColor[0];
+            prevColor[1] = inColor[1];
+            prevColor[2] = inColor[2];
+            prevColor[3] = inColor[3];
+
+            int bitShift = 0;
+            for (size_t pixelCount = 0; pixelCount < width;)
+            {
+                if (inColor[0] == 1 && inColor[1] == 1 && inColor[2] == 1)
+                {
+                    if (bitShift > 24)
+                        return E_FAIL;
+
+                    // "Standard" Run Length Encoding
+                    const size_t spanLen = size_t(inColor[3]) << bitShift;
+                    if (spanLen + pixelCount > width)
+                        return E_FAIL;
+
+                    for (size_t j = 0; j < spanLen; ++j)
+                    {
+                        pixelLoc[0] = prevColor[0];
+                        pixelLoc[1] = prevColor[1];
+                        pixelLoc[2] = prevColor[2];
+                        pixelLoc[3] = prevColor[3];
+                        pixelLoc += 4;
+                    }
+                    pixelCount += spanLen;
+                    bitShift += 8;
+                }
+                else
+                {
+                    // Uncompressed
+                    pixelLoc[0] = prevColor[0] = inColor[0];
+                    pixelLoc[1] = prevColor[1] = inColor[1];
+                    pixelLoc[2] = prevColor[2] = inColor[2];
+                    pixelLoc[3] = prevColor[3] = inColor[3];
+                    bitShift = 0;
+                    ++pixelCount;
+                    pixelLoc += 4;
+                }
+
+                if (pixelCount >= width)
+                    break;
+
+                if (pixelLen < 4)
+                    return HRESULT_E_HANDLE_EOF;
+
+                memcpy(inColor, sourcePtr, 4);
+                sourcePtr += 4;
+                pixelLen -= 4;
+            }
+        }
+
+        bytesUsed = size - pixelLen;
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Converts decoded RGBE values to floating-point using the file exposure
+    //-------------------------------------------------------------------------------------
+    void ExposeScanline(_Inout_updates_all_(width * 4) float* fdata, size_t width, float exposure) noexcept
+    {
+        for (size_t j = 0; j < width; ++j)
+        {
+            const auto exponent = static_cast<int>(fdata[3]);
+            fdata[0] = 1.0f / exposure*ldexpf((fdata[0] + 0.5f), exponent - (128 + 8));
+            fdata[1] = 1.0f / exposure*ldexpf((fdata[1] + 0.5f), exponent - (128 + 8));
+            fdata[2] = 1.0f / exposure*ldexpf((fdata[2] + 0.5f), exponent - (128 + 8));
+            fdata[3] = 1.f;
+
+            fdata += 4;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Row source for ImageReader
+    //-------------------------------------------------------------------------------------
+    class HDRSource : public ImageReader::Source
+    {
+    public:
+        HDRSource() noexcept : width(0), height(0), dataOffset(0), exposure(1.f) {}
+
+        HRESULT __cdecl Seek(size_t, size_t, size_t, Image& image) noexcept override
+        {
+            image = {};
+
+            const HRESULT hr = file.Seek(dataOffset);
+            if (FAILED(hr))
+                return hr;
+
+            image.width = width;
+            image.height = height;
+            image.format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+            image.rowPitch = width * sizeof(float) * 4;
+            image.slicePitch = image.rowPitch * height;
+            return S_OK;
+        }
+
+        HRESULT __cdecl ReadRow(uint8_t* pDest, size_t rowPitch) noexcept override
+        {
+            if (rowPitch < width * sizeof(float) * 4)
+                return E_INVALIDARG;
+
+            auto scanLine = reinterpret_cast<float*>(pDest);
+
+            // Most scanlines fit in the initial window, but old-style RLE can expand beyond it
+            size_t window = width * 4 + 64;
+            for (;;)
+            {
+                const uint8_t* sourcePtr = nullptr;
+                size_t available = 0;
+                HRESULT hr = file.Peek(window, &sourcePtr, available);
+                if (FAILED(hr))
+                    return hr;
+
+                size_t bytesUsed = 0;
+                hr = DecodeScanline(sourcePtr, available, scanLine, width, bytesUsed);
+                if (hr == HRESULT_E_HANDLE_EOF && available >= window)
+                {
+                    window *= 2;
+                    continue;
+                }
+                else if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                file.Skip(bytesUsed);
+                break;
+            }
+
+            ExposeScanline(scanLine, width, exposure);
+            return S_OK;
+        }
+
+        Internal::ImageReaderFile file;
+        size_t width;
+        size_t height;
+        size_t dataOffset;
+        float exposure;
+    };
 }
 
 
@@ -739,167 +961,25 @@ HRESULT DirectX::LoadFromHDRMemory(const uint8_t* pSource, size_t size, TexMetad
 
     for (size_t scan = 0; scan < mdata.height; ++scan)
     {
-        if (pixelLen < 4)
-        {
-            image.Release();
-            return E_FAIL;
-        }
-
-        uint8_t inColor[4];
-        memcpy(inColor, sourcePtr, 4);
-        sourcePtr += 4;
-        pixelLen -= 4;
-
         auto scanLine = reinterpret_cast<float*>(destPtr);
 
-        if (inColor[0] == 2 && inColor[1] == 2 && inColor[2] < 128)
+        size_t bytesUsed = 0;
+        hr = DecodeScanline(sourcePtr, pixelLen, scanLine, mdata.width, bytesUsed);
+        if (FAILED(hr))
         {
-            // Adaptive Run Length Encoding (RLE)
-            if (size_t((size_t(inColor[2]) << 8) + inColor[3]) != mdata.width)
-            {
-                image.Release();
-                return E_FAIL;
-            }
-
-            for (int channel = 0; channel < 4; ++channel)
-            {
-                auto pixelLoc = scanLine + channel;
-                for (size_t pixelCount = 0; pixelCount < mdata.width;)
-                {
-                    if (pixelLen < 2)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-
-                    assert(sourcePtr < (reinterpret_cast<const uint8_t*>(pSource) + size));
-
-                    uint8_t runLen = *sourcePtr;
-                    if (runLen > 128)
-                    {
-                        runLen &= 127;
-                        if (pixelCount + runLen > mdata.width)
-                        {
-                            image.Release();
-                            return E_FAIL;
-                        }
-
-                        auto val = static_cast<float>(sourcePtr[1]);
-                        for (uint8_t j = 0; j < runLen; ++j)
-                        {
-                            *pixelLoc = val;
-                            pixelLoc += 4;
-                        }
-                        pixelCount += runLen;
-                        sourcePtr += 2;
-                        pixelLen -= 2;
-                    }
-                    else if ((size < size_t(runLen) + 1) || ((pixelCount + size_t(runLen)) > mdata.width))
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-                    else
-                    {
-                        ++sourcePtr;
-                        for (uint8_t j = 0; j < runLen; ++j)
-                        {
-                            auto val = static_cast<float>(*sourcePtr++);
-                            *pixelLoc = val;
-                            pixelLoc += 4;
-                        }
-                        pixelCount += runLen;
-                        pixelLen -= size_t(runLen) + 1;
-                    }
-                }
-            }
+            image.Release();
+            return E_FAIL;
         }
-        else
-        {
-            auto pixelLoc = scanLine;
 
-            float prevColor[4];
-            prevColor[0] = inColor[0];
-            prevColor[1] = inColor[1];
-            prevColor[2] = inColor[2];
-            prevColor[3] = inColor[3];
+        sourcePtr += bytesUsed;
+        pixelLen -= bytesUsed;
 
-            int bitShift = 0;
-            for (size_t pixelCount = 0; pixelCount < mdata.width;)
-            {
-                if (inColor[0] == 1 && inColor[1] == 1 && inColor[2] == 1)
-                {
-                    if (bitShift > 24)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-
-                    // "Standard" Run Length Encoding
-                    const size_t spanLen = size_t(inColor[3]) << bitShift;
-                    if (spanLen + pixelCount > mdata.width)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-
-                    for (size_t j = 0; j < spanLen; ++j)
-                    {
-                        pixelLoc[0] = prevColor[0];
-                        pixelLoc[1] = prevColor[1];
-                        pixelLoc[2] = prevColor[2];
-                        pixelLoc[3] = prevColor[3];
-                        pixelLoc += 4;
-                    }
-                    pixelCount += spanLen;
-                    bitShift += 8;
-                }
-                else
-                {
-                    // Uncompressed
-                    pixelLoc[0] = prevColor[0] = inColor[0];
-                    pixelLoc[1] = prevColor[1] = inColor[1];
-                    pixelLoc[2] = prevColor[2] = inColor[2];
-                    pixelLoc[3] = prevColor[3] = inColor[3];
-                    bitShift = 0;
-                    ++pixelCount;
-                    pixelLoc += 4;
-                }
-
-                if (pixelCount >= mdata.width)
-                    break;
-
-                if (pixelLen < 4)
-                {
-                    image.Release();
-                    return E_FAIL;
-                }
-
-                memcpy(inColor, sourcePtr, 4);
-                sourcePtr += 4;
-                pixelLen -= 4;
-            }
-        }
+        // Transform values
+        ExposeScanline(scanLine, mdata.width, exposure);
 
         destPtr += img->rowPitch;
     }
 
-    // Transform values
-    {
-        auto fdata = reinterpret_cast<float*>(image.GetPixels());
-
-        for (size_t j = 0; j < image.GetPixelsSize(); j += 16)
-        {
-            const auto exponent = static_cast<int>(fdata[3]);
-            fdata[0] = 1.0f / exposure*ldexpf((fdata[0] + 0.5f), exponent - (128 + 8));
-            fdata[1] = 1.0f / exposure*ldexpf((fdata[1] + 0.5f), exponent - (128 + 8));
-            fdata[2] = 1.0f / exposure*ldexpf((fdata[2] + 0.5f), exponent - (128 + 8));
-            fdata[3] = 1.f;
-
-            fdata += 4;
-        }
-    }
-
     if (metadata)
         memcpy(metadata, &mdata, sizeof(TexMetadata));
 
@@ -913,6 +993,8 @@ HRESULT DirectX::LoadFromHDRMemory(const uint8_t* pSource, size_t size, TexMetad
 _Use_decl_annotations_
 HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, ScratchImage& image) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_FILE_READ);
+
     if (!szFile)
         return E_INVALIDARG;
 
@@ -961,6 +1043,8 @@ HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, S
     const size_t len = fileLen;
 #endif
 
+    TEX_INSTRUMENT_BYTES_READ(len);
+
     // Need at least enough data to fill the header to be a valid HDR
     if (len < sizeof(g_Signature))
     {
@@ -995,6 +1079,56 @@ HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, S
 }
 
 
+//-------------------------------------------------------------------------------------
+// Open a HDR file for streaming
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT ImageReader::OpenHDRFile(const wchar_t* szFile) noexcept
+{
+    Close();
+
+    if (!szFile)
+        return E_INVALIDARG;
+
+    std::unique_ptr<HDRSource> source(new (std::nothrow) HDRSource);
+    if (!source)
+        return E_OUTOFMEMORY;
+
+    HRESULT hr = source->file.Open(szFile);
+    if (FAILED(hr))
+        return hr;
+
+    const uint64_t len = source->file.GetSize();
+
+    // Need at least enough data to fill the standard header to be a valid HDR
+    if (len < sizeof(g_Signature))
+    {
+        return E_FAIL;
+    }
+
+    // Read the first part of the file to find the header
+    uint8_t header[8192] = {};
+
+    const auto headerLen = static_cast<size_t>(std::min<uint64_t>(sizeof(header), len));
+    hr = source->file.Read(header, headerLen);
+    if (FAILED(hr))
+        return hr;
+
+    TexMetadata mdata;
+    hr = DecodeHDRHeader(header, headerLen, mdata, source->dataOffset, source->exposure);
+    if (FAILED(hr))
+        return hr;
+
+    if (source->dataOffset >= len)
+        return E_FAIL;
+
+    source->width = mdata.width;
+    source->height = mdata.height;
+
+    return Attach(source.release(), mdata);
+}
+
+
 //-------------------------------------------------------------------------------------
 // Save a HDR file to memory
 //-------------------------------------------------------------------------------------
@@ -1110,6 +1244,8 @@ HRESULT DirectX::SaveToHDRMemory(const Image& image, Blob& blob) noexcept
 _Use_decl_annotations_
 HRESULT DirectX::SaveToHDRFile(const Image& image, const wchar_t* szFile) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_FILE_WRITE);
+
     if (!szFile)
         return E_INVALIDARG;
 
@@ -1303,7 +1439,10 @@ HRESULT DirectX::SaveToHDRFile(const Image& image, const wchar_t* szFile) noexce
     }
 
 #ifdef _WIN32
+    TEX_INSTRUMENT_FILE_WRITTEN(hFile.get());
     delonfail.clear();
+#else
+    TEX_INSTRUMENT_FILE_WRITTEN(outFile);
 #endif
 
     return S_OK;
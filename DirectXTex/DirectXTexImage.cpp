@@ -15,6 +15,8 @@ using namespace DirectX;
 using namespace DirectX::Internal;
 
 #ifndef _WIN32
+#include <sys/mman.h>
+
 namespace
 {
     inline void * _aligned_malloc(size_t size, size_t alignment)
@@ -283,11 +285,15 @@ ScratchImage& ScratchImage::operator= (ScratchImage&& moveFrom) noexcept
         m_metadata = moveFrom.m_metadata;
         m_image = moveFrom.m_image;
         m_memory = moveFrom.m_memory;
+        m_mapping = moveFrom.m_mapping;
+        m_mappingSize = moveFrom.m_mappingSize;
 
         moveFrom.m_nimages = 0;
         moveFrom.m_size = 0;
         moveFrom.m_image = nullptr;
         moveFrom.m_memory = nullptr;
+        moveFrom.m_mapping = nullptr;
+        moveFrom.m_mappingSize = 0;
     }
     return *this;
 }
@@ -375,6 +381,7 @@ HRESULT ScratchImage::Initialize(const TexMetadata& mdata, CP_FLAGS flags) noexc
     }
     memset(m_memory, 0, pixelSize);
     m_size = pixelSize;
+    TEX_INSTRUMENT_ALLOCATION(pixelSize);
 
     if (!SetupImageArray(m_memory, pixelSize, m_metadata, flags, m_image, nimages))
     {
@@ -445,6 +452,7 @@ HRESULT ScratchImage::Initialize2D(DXGI_FORMAT fmt, size_t width, size_t height,
     }
     memset(m_memory, 0, pixelSize);
     m_size = pixelSize;
+    TEX_INSTRUMENT_ALLOCATION(pixelSize);
 
     if (!SetupImageArray(m_memory, pixelSize, m_metadata, flags, m_image, nimages))
     {
@@ -504,6 +512,7 @@ HRESULT ScratchImage::Initialize3D(DXGI_FORMAT fmt, size_t width, size_t height,
     }
     memset(m_memory, 0, pixelSize);
     m_size = pixelSize;
+    TEX_INSTRUMENT_ALLOCATION(pixelSize);
 
     if (!SetupImageArray(m_memory, pixelSize, m_metadata, flags, m_image, nimages))
     {
@@ -706,6 +715,57 @@ HRESULT ScratchImage::Initialize3DFromImages(const Image* images, size_t depth,
     return S_OK;
 }
 
+#ifndef _WIN32
+_Use_decl_annotations_
+HRESULT ScratchImage::InitializeFromMappedView(const TexMetadata& mdata, void* view, size_t viewSize, size_t offset) noexcept
+{
+    if (!view || offset >= viewSize)
+        return E_INVALIDARG;
+
+    if (!IsValid(mdata.format))
+        return E_INVALIDARG;
+
+    if (IsPalettized(mdata.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (!mdata.width || !mdata.height || !mdata.depth || !mdata.arraySize || !mdata.mipLevels)
+        return E_INVALIDARG;
+
+    size_t pixelSize, nimages;
+    HRESULT hr = DetermineImageArray(mdata, CP_FLAGS_NONE, nimages, pixelSize);
+    if (FAILED(hr))
+        return hr;
+
+    if (pixelSize > (viewSize - offset))
+        return HRESULT_E_HANDLE_EOF;
+
+    Release();
+
+    m_metadata = mdata;
+
+    m_image = new (std::nothrow) Image[nimages];
+    if (!m_image)
+        return E_OUTOFMEMORY;
+
+    m_nimages = nimages;
+    memset(m_image, 0, sizeof(Image) * nimages);
+
+    auto pixels = static_cast<uint8_t*>(view) + offset;
+    if (!SetupImageArray(pixels, pixelSize, m_metadata, CP_FLAGS_NONE, m_image, nimages))
+    {
+        Release();
+        return E_FAIL;
+    }
+
+    m_memory = pixels;
+    m_size = pixelSize;
+    m_mapping = view;
+    m_mappingSize = viewSize;
+
+    return S_OK;
+}
+#endif // !WIN32
+
 void ScratchImage::Release() noexcept
 {
     m_nimages = 0;
@@ -717,7 +777,17 @@ void ScratchImage::Release() noexcept
         m_image = nullptr;
     }
 
-    if (m_memory)
+    if (m_mapping)
+    {
+        // m_memory points into the file mapping
+    #ifndef _WIN32
+        munmap(m_mapping, m_mappingSize);
+    #endif
+        m_mapping = nullptr;
+        m_mappingSize = 0;
+        m_memory = nullptr;
+    }
+    else if (m_memory)
     {
         _aligned_free(m_memory);
         m_memory = nullptr;
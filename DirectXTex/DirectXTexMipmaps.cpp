@@ -629,6 +629,12 @@ namespace
             return false;
         }
 
+        if (filter & TEX_FILTER_PARALLEL)
+        {
+            // Multithreading is only implemented by the non-WIC code paths
+            return false;
+        }
+
         if (filter & TEX_FILTER_FORCE_WIC)
         {
             // Explicit flag to use WIC code paths, skips all the case checks below
@@ -683,7 +689,10 @@ namespace
             break;
 
         case TEX_FILTER_TRIANGLE:
-            // WIC does not implement this filter
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_MITCHELL:
+        case TEX_FILTER_KAISER:
+            // WIC does not implement these filters
             return false;
 
         default:
@@ -1024,6 +1033,7 @@ namespace
             if (height <= 1)
             {
                 urow1 = urow0;
+                urow3 = urow1 + 1;
             }
 
             if (width <= 1)
@@ -1602,6 +1612,43 @@ namespace
     }
 
 
+    //--- 2D Polyphase Filter (Lanczos, Mitchell-Netravali, Kaiser) ---
+    constexpr bool IsPolyphaseFilter(uint32_t filterSelect) noexcept
+    {
+        return (filterSelect == TEX_FILTER_LANCZOS) || (filterSelect == TEX_FILTER_MITCHELL) || (filterSelect == TEX_FILTER_KAISER);
+    }
+
+    HRESULT Generate2DMipsPolyphaseFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        // Each level is resampled from the previous one; TEX_FILTER_PARALLEL is handled by the plan
+        ResizePlan plan;
+        for (size_t level = 1; level < levels; ++level)
+        {
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
+            if (!src || !dest)
+                return E_POINTER;
+
+            HRESULT hr = plan.Initialize(src->width, src->height, dest->width, dest->height, filter);
+            if (FAILED(hr))
+                return hr;
+
+            hr = plan.Execute(*src, *dest);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return S_OK;
+    }
+
+
     //-------------------------------------------------------------------------------------
     // Generate volume mip-map helpers
     //-------------------------------------------------------------------------------------
@@ -1855,7 +1902,9 @@ namespace
             if (height <= 1)
             {
                 urow1 = urow0;
+                urow3 = urow1 + 1;
                 vrow1 = vrow0;
+                vrow3 = vrow1 + 1;
             }
 
             if (width <= 1)
@@ -2814,6 +2863,729 @@ namespace
 
         return S_OK;
     }
+
+
+#ifdef _OPENMP
+    //-------------------------------------------------------------------------------------
+    // Generate mip-map helpers (custom filtering, multithreaded)
+    //-------------------------------------------------------------------------------------
+
+    // Each destination level is split into bands of scanlines that are processed independently. A band loads
+    // every source scanline it needs itself, so the results are identical to the single-threaded filters above.
+    constexpr size_t MIP_BAND_ROWS = 16;
+
+    // Maps the requested source scanlines onto a worker's scratch slots, only loading the ones not already resident
+    template<size_t N, typename TLoad>
+    bool MapBandRows(
+        _In_reads_(N) const size_t* need,
+        _In_reads_(N) XMVECTOR* const* slots,
+        _Inout_updates_(N) size_t* cached,
+        _Out_writes_(N) const XMVECTOR** mapped,
+        TLoad& load) noexcept
+    {
+        bool used[N] = {};
+        bool found[N] = {};
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            for (size_t j = 0; j < N; ++j)
+            {
+                if (cached[j] == need[i])
+                {
+                    mapped[i] = slots[j];
+                    used[j] = true;
+                    found[i] = true;
+                    break;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (found[i])
+                continue;
+
+            for (size_t k = 0; k < i; ++k)
+            {
+                if (need[k] == need[i])
+                {
+                    mapped[i] = mapped[k];
+                    found[i] = true;
+                    break;
+                }
+            }
+
+            if (found[i])
+                continue;
+
+            // There are at most N distinct requests, so a free slot always exists
+            size_t j = 0;
+            while (used[j])
+                ++j;
+            assert(j < N);
+
+            cached[j] = size_t(-1);
+            if (!load(slots[j], need[i]))
+                return false;
+
+            cached[j] = need[i];
+            mapped[i] = slots[j];
+            used[j] = true;
+            found[i] = true;
+        }
+
+        return true;
+    }
+
+    // Runs the band worker for each task, where each thread has its own 'scratchSize' XMVECTORs of temporary space
+    template<typename TWork>
+    HRESULT ProcessBandsParallel(size_t tasks, size_t scratchSize, TWork& work) noexcept
+    {
+        if (!tasks)
+            return S_OK;
+
+        if (tasks > INT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        bool fail = false;
+        bool outOfMemory = false;
+
+        const int nthreads = GetWorkerThreadCount(tasks);
+
+#pragma omp parallel num_threads(nthreads)
+        {
+            auto scratch = make_AlignedArrayXMVECTOR(scratchSize);
+            if (!scratch)
+            {
+                outOfMemory = true;
+            }
+
+#pragma omp for schedule(dynamic)
+            for (int task = 0; task < static_cast<int>(tasks); ++task)
+            {
+#pragma omp flush (fail, outOfMemory)
+                if (fail || outOfMemory)
+                {
+                    // OpenMP 2.0 does not support cancellation of a 'for' loop.
+                    continue;
+                }
+
+                if (!work(static_cast<size_t>(task), scratch.get()))
+                {
+                    fail = true;
+                }
+            }
+        }
+
+        if (outOfMemory)
+            return E_OUTOFMEMORY;
+
+        return (fail) ? E_FAIL : S_OK;
+    }
+
+    //--- Point Filter (band) ---
+    bool PointFilterBand(
+        const Image& src, const Image& dest,
+        size_t width, size_t height, size_t nwidth, size_t nheight,
+        size_t y0, size_t y1,
+        _Inout_updates_(width * 2) XMVECTOR* scratch) noexcept
+    {
+        XMVECTOR* target = scratch;
+        XMVECTOR* row = scratch + width;
+
+        const size_t xinc = (width << 16) / nwidth;
+        const size_t yinc = (height << 16) / nheight;
+
+        uint8_t* pDest = dest.pixels + (dest.rowPitch * y0);
+
+        size_t lasty = size_t(-1);
+
+        size_t sy = y0 * yinc;
+        for (size_t y = y0; y < y1; ++y)
+        {
+            if ((lasty ^ sy) >> 16)
+            {
+                if (!LoadScanline(row, width, src.pixels + (src.rowPitch * (sy >> 16)), src.rowPitch, src.format))
+                    return false;
+                lasty = sy;
+            }
+
+            size_t sx = 0;
+            for (size_t x = 0; x < nwidth; ++x)
+            {
+                target[x] = row[sx >> 16];
+                sx += xinc;
+            }
+
+            if (!StoreScanline(pDest, dest.rowPitch, dest.format, target, nwidth))
+                return false;
+            pDest += dest.rowPitch;
+
+            sy += yinc;
+        }
+
+        return true;
+    }
+
+    //--- Box Filter (band) ---
+    bool BoxFilterBand(
+        const Image& srca, _In_opt_ const Image* srcb, const Image& dest, TEX_FILTER_FLAGS filter,
+        size_t width, size_t height, size_t nwidth,
+        size_t y0, size_t y1,
+        _Inout_updates_(width * 5) XMVECTOR* scratch) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        XMVECTOR* target = scratch;
+
+        XMVECTOR* urow0 = scratch + width;
+        XMVECTOR* urow1 = (height > 1) ? (scratch + width * 2) : urow0;
+        XMVECTOR* vrow0 = scratch + width * 3;
+        XMVECTOR* vrow1 = (height > 1) ? (scratch + width * 4) : vrow0;
+
+        const size_t xn = (width > 1) ? 1u : 0u;
+        const size_t rowStep = (height > 1) ? 2u : 1u;
+
+        uint8_t* pDest = dest.pixels + (dest.rowPitch * y0);
+
+        for (size_t y = y0; y < y1; ++y)
+        {
+            const size_t u = y * rowStep;
+
+            if (!LoadScanlineLinear(urow0, width, srca.pixels + (srca.rowPitch * u), srca.rowPitch, srca.format, filter))
+                return false;
+
+            if (urow0 != urow1)
+            {
+                if (!LoadScanlineLinear(urow1, width, srca.pixels + (srca.rowPitch * (u + 1)), srca.rowPitch, srca.format, filter))
+                    return false;
+            }
+
+            if (srcb)
+            {
+                if (!LoadScanlineLinear(vrow0, width, srcb->pixels + (srcb->rowPitch * u), srcb->rowPitch, srcb->format, filter))
+                    return false;
+
+                if (vrow0 != vrow1)
+                {
+                    if (!LoadScanlineLinear(vrow1, width, srcb->pixels + (srcb->rowPitch * (u + 1)), srcb->rowPitch, srcb->format, filter))
+                        return false;
+                }
+
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    const size_t x2 = x << 1;
+
+                    AVERAGE8(target[x], urow0[x2], urow1[x2], urow0[x2 + xn], urow1[x2 + xn],
+                        vrow0[x2], vrow1[x2], vrow0[x2 + xn], vrow1[x2 + xn])
+                }
+            }
+            else
+            {
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    const size_t x2 = x << 1;
+
+                    AVERAGE4(target[x], urow0[x2], urow1[x2], urow0[x2 + xn], urow1[x2 + xn])
+                }
+            }
+
+            if (!StoreScanlineLinear(pDest, dest.rowPitch, dest.format, target, nwidth, filter))
+                return false;
+            pDest += dest.rowPitch;
+        }
+
+        return true;
+    }
+
+    //--- Linear Filter (band) ---
+    bool LinearFilterBand(
+        const Image& srca, _In_opt_ const Image* srcb, const Image& dest, TEX_FILTER_FLAGS filter,
+        size_t width, size_t height, size_t nwidth,
+        _In_reads_(nwidth) const Filters::LinearFilter* lfX,
+        _In_ const Filters::LinearFilter* lfY,
+        _In_opt_ const Filters::LinearFilter* toZ,
+        size_t y0, size_t y1,
+        _Inout_updates_(width * 5) XMVECTOR* scratch) noexcept
+    {
+        assert(!srcb || toZ != nullptr);
+
+        XMVECTOR* target = scratch;
+
+        // Source scanlines are keyed by row, with the rows of the second slice following the first
+        auto load = [&](XMVECTOR* row, size_t key) noexcept -> bool
+            {
+                const Image& src = (key >= height) ? *srcb : srca;
+                const size_t u = (key >= height) ? (key - height) : key;
+                return LoadScanlineLinear(row, width, src.pixels + (src.rowPitch * u), src.rowPitch, src.format, filter);
+            };
+
+        XMVECTOR* const slots[4] = { scratch + width, scratch + width * 2, scratch + width * 3, scratch + width * 4 };
+        size_t cached[4] = { size_t(-1), size_t(-1), size_t(-1), size_t(-1) };
+
+        uint8_t* pDest = dest.pixels + (dest.rowPitch * y0);
+
+        if (srcb)
+        {
+            for (size_t y = y0; y < y1; ++y)
+            {
+                const auto& toY = lfY[y];
+
+                const size_t need[4] = { toY.u0, toY.u1, toY.u0 + height, toY.u1 + height };
+                const XMVECTOR* rows[4] = {};
+                if (!MapBandRows<4>(need, slots, cached, rows, load))
+                    return false;
+
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    const auto& toX = lfX[x];
+
+                    TRILINEAR_INTERPOLATE(target[x], toX, toY, (*toZ), rows[0], rows[1], rows[2], rows[3])
+                }
+
+                if (!StoreScanlineLinear(pDest, dest.rowPitch, dest.format, target, nwidth, filter))
+                    return false;
+                pDest += dest.rowPitch;
+            }
+        }
+        else
+        {
+            for (size_t y = y0; y < y1; ++y)
+            {
+                const auto& toY = lfY[y];
+
+                const size_t need[2] = { toY.u0, toY.u1 };
+                const XMVECTOR* rows[2] = {};
+                if (!MapBandRows<2>(need, slots, cached, rows, load))
+                    return false;
+
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    const auto& toX = lfX[x];
+
+                    BILINEAR_INTERPOLATE(target[x], toX, toY, rows[0], rows[1])
+                }
+
+                if (!StoreScanlineLinear(pDest, dest.rowPitch, dest.format, target, nwidth, filter))
+                    return false;
+                pDest += dest.rowPitch;
+            }
+        }
+
+        return true;
+    }
+
+    //--- Cubic Filter (band) ---
+    bool CubicFilterBand(
+        _In_reads_(nslices) const Image* const* srcs, size_t nslices, const Image& dest, TEX_FILTER_FLAGS filter,
+        size_t width, size_t height, size_t nwidth,
+        _In_reads_(nwidth) const Filters::CubicFilter* cfX,
+        _In_ const Filters::CubicFilter* cfY,
+        _In_opt_ const Filters::CubicFilter* toZ,
+        size_t y0, size_t y1,
+        _Inout_updates_(width * 17) XMVECTOR* scratch) noexcept
+    {
+        assert(nslices == 1 || (nslices == 4 && toZ != nullptr));
+
+        XMVECTOR* target = scratch;
+
+        // Source scanlines are keyed by row, with the rows of each slice following the previous one
+        auto load = [&](XMVECTOR* row, size_t key) noexcept -> bool
+            {
+                const Image& src = *srcs[key / height];
+                const size_t u = key % height;
+                return LoadScanlineLinear(row, width, src.pixels + (src.rowPitch * u), src.rowPitch, src.format, filter);
+            };
+
+        uint8_t* pDest = dest.pixels + (dest.rowPitch * y0);
+
+        if (nslices > 1)
+        {
+            XMVECTOR* slots[16];
+            size_t cached[16];
+            for (size_t j = 0; j < 16; ++j)
+            {
+                slots[j] = scratch + width * (j + 1);
+                cached[j] = size_t(-1);
+            }
+
+            for (size_t y = y0; y < y1; ++y)
+            {
+                const auto& toY = cfY[y];
+
+                // rows[j * 4 + k] is scanline toY.uk of slice toZ.uj
+                size_t need[16];
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    need[j * 4] = toY.u0 + j * height;
+                    need[j * 4 + 1] = toY.u1 + j * height;
+                    need[j * 4 + 2] = toY.u2 + j * height;
+                    need[j * 4 + 3] = toY.u3 + j * height;
+                }
+
+                const XMVECTOR* rows[16] = {};
+                if (!MapBandRows<16>(need, slots, cached, rows, load))
+                    return false;
+
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    const auto& toX = cfX[x];
+
+                    XMVECTOR D[4];
+
+                    for (size_t j = 0; j < 4; ++j)
+                    {
+                        const XMVECTOR* urow = rows[j * 4];
+                        const XMVECTOR* vrow = rows[j * 4 + 1];
+                        const XMVECTOR* srow = rows[j * 4 + 2];
+                        const XMVECTOR* trow = rows[j * 4 + 3];
+
+                        XMVECTOR C0, C1, C2, C3;
+                        CUBIC_INTERPOLATE(C0, toX.x, urow[toX.u0], urow[toX.u1], urow[toX.u2], urow[toX.u3]);
+                        CUBIC_INTERPOLATE(C1, toX.x, vrow[toX.u0], vrow[toX.u1], vrow[toX.u2], vrow[toX.u3]);
+                        CUBIC_INTERPOLATE(C2, toX.x, srow[toX.u0], srow[toX.u1], srow[toX.u2], srow[toX.u3]);
+                        CUBIC_INTERPOLATE(C3, toX.x, trow[toX.u0], trow[toX.u1], trow[toX.u2], trow[toX.u3]);
+
+                        CUBIC_INTERPOLATE(D[j], toY.x, C0, C1, C2, C3);
+                    }
+
+                    CUBIC_INTERPOLATE(target[x], toZ->x, D[0], D[1], D[2], D[3]);
+                }
+
+                if (!StoreScanlineLinear(pDest, dest.rowPitch, dest.format, target, nwidth, filter))
+                    return false;
+                pDest += dest.rowPitch;
+            }
+        }
+        else
+        {
+            XMVECTOR* const slots[4] = { scratch + width, scratch + width * 2, scratch + width * 3, scratch + width * 4 };
+            size_t cached[4] = { size_t(-1), size_t(-1), size_t(-1), size_t(-1) };
+
+            for (size_t y = y0; y < y1; ++y)
+            {
+                const auto& toY = cfY[y];
+
+                const size_t need[4] = { toY.u0, toY.u1, toY.u2, toY.u3 };
+                const XMVECTOR* rows[4] = {};
+                if (!MapBandRows<4>(need, slots, cached, rows, load))
+                    return false;
+
+                for (size_t x = 0; x < nwidth; ++x)
+                {
+                    const auto& toX = cfX[x];
+
+                    XMVECTOR C0, C1, C2, C3;
+
+                    CUBIC_INTERPOLATE(C0, toX.x, rows[0][toX.u0], rows[0][toX.u1], rows[0][toX.u2], rows[0][toX.u3]);
+                    CUBIC_INTERPOLATE(C1, toX.x, rows[1][toX.u0], rows[1][toX.u1], rows[1][toX.u2], rows[1][toX.u3]);
+                    CUBIC_INTERPOLATE(C2, toX.x, rows[2][toX.u0], rows[2][toX.u1], rows[2][toX.u2], rows[2][toX.u3]);
+                    CUBIC_INTERPOLATE(C3, toX.x, rows[3][toX.u0], rows[3][toX.u1], rows[3][toX.u2], rows[3][toX.u3]);
+
+                    CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3);
+                }
+
+                if (!StoreScanlineLinear(pDest, dest.rowPitch, dest.format, target, nwidth, filter))
+                    return false;
+                pDest += dest.rowPitch;
+            }
+        }
+
+        return true;
+    }
+
+    //--- 2D mip-map chain (multithreaded) ---
+    HRESULT Generate2DMipsParallel(size_t levels, uint32_t filterSelect, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        const size_t items = mipChain.GetMetadata().arraySize;
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        if (filterSelect == TEX_FILTER_TRIANGLE)
+        {
+            // The triangle filter accumulates each level in a single pass, so only the array items are processed concurrently
+            auto triangle = [&](size_t item, XMVECTOR*) noexcept -> bool
+                {
+                    return SUCCEEDED(Generate2DMipsTriangleFilter(levels, filter, mipChain, item));
+                };
+
+            return ProcessBandsParallel(items, 1, triangle);
+        }
+
+        if (filterSelect == TEX_FILTER_BOX && (!ispow2(width) || !ispow2(height)))
+            return E_FAIL;
+
+        std::unique_ptr<LinearFilter[]> lf;
+        std::unique_ptr<CubicFilter[]> cf;
+        if (filterSelect == TEX_FILTER_LINEAR)
+        {
+            lf.reset(new (std::nothrow) LinearFilter[width + height]);
+            if (!lf)
+                return E_OUTOFMEMORY;
+        }
+        else if (filterSelect == TEX_FILTER_CUBIC)
+        {
+            cf.reset(new (std::nothrow) CubicFilter[width + height]);
+            if (!cf)
+                return E_OUTOFMEMORY;
+        }
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+            if (lf)
+            {
+                CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lf.get());
+                CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lf.get() + width);
+            }
+            else if (cf)
+            {
+                CreateCubicFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cf.get());
+                CreateCubicFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cf.get() + width);
+            }
+
+            const size_t bands = (nheight + MIP_BAND_ROWS - 1) / MIP_BAND_ROWS;
+
+            auto band = [&](size_t task, XMVECTOR* scratch) noexcept -> bool
+                {
+                    const size_t item = task / bands;
+                    const size_t y0 = (task % bands) * MIP_BAND_ROWS;
+                    const size_t y1 = std::min(y0 + MIP_BAND_ROWS, nheight);
+
+                    const Image* src = mipChain.GetImage(level - 1, item, 0);
+                    const Image* dest = mipChain.GetImage(level, item, 0);
+                    if (!src || !dest)
+                        return false;
+
+                    switch (filterSelect)
+                    {
+                    case TEX_FILTER_POINT:
+                        return PointFilterBand(*src, *dest, width, height, nwidth, nheight, y0, y1, scratch);
+
+                    case TEX_FILTER_BOX:
+                        return BoxFilterBand(*src, nullptr, *dest, filter, width, height, nwidth, y0, y1, scratch);
+
+                    case TEX_FILTER_LINEAR:
+                        return LinearFilterBand(*src, nullptr, *dest, filter, width, height, nwidth, lf.get(), lf.get() + width, nullptr, y0, y1, scratch);
+
+                    case TEX_FILTER_CUBIC:
+                        return CubicFilterBand(&src, 1, *dest, filter, width, height, nwidth, cf.get(), cf.get() + width, nullptr, y0, y1, scratch);
+
+                    default:
+                        return false;
+                    }
+                };
+
+            const HRESULT hr = ProcessBandsParallel(items * bands, uint64_t(width) * 5, band);
+            if (FAILED(hr))
+                return hr;
+
+            if (height > 1)
+                height >>= 1;
+
+            if (width > 1)
+                width >>= 1;
+        }
+
+        return S_OK;
+    }
+
+    //--- 3D mip-map chain (multithreaded) ---
+    HRESULT Generate3DMipsParallel(size_t depth, size_t levels, uint32_t filterSelect, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        if (!depth || !mipChain.GetImages())
+            return E_INVALIDARG;
+
+        if (depth > INT16_MAX)
+            return E_INVALIDARG;
+
+        // This assumes that the base images are already placed into the mipChain at the top level... (see _Setup3DMips)
+
+        assert(levels > 1);
+
+        if (filterSelect == TEX_FILTER_TRIANGLE)
+        {
+            // The triangle filter accumulates each level in a single pass over all slices, so it is not split up
+            return Generate3DMipsTriangleFilter(depth, levels, filter, mipChain);
+        }
+
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
+
+        if (filterSelect == TEX_FILTER_BOX && (!ispow2(width) || !ispow2(height) || !ispow2(depth)))
+            return E_FAIL;
+
+        std::unique_ptr<LinearFilter[]> lf;
+        std::unique_ptr<CubicFilter[]> cf;
+        if (filterSelect == TEX_FILTER_LINEAR)
+        {
+            lf.reset(new (std::nothrow) LinearFilter[width + height + depth]);
+            if (!lf)
+                return E_OUTOFMEMORY;
+        }
+        else if (filterSelect == TEX_FILTER_CUBIC)
+        {
+            cf.reset(new (std::nothrow) CubicFilter[width + height + depth]);
+            if (!cf)
+                return E_OUTOFMEMORY;
+        }
+
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+            const size_t ndepth = (depth > 1) ? (depth >> 1) : 1;
+
+            if (lf)
+            {
+                CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lf.get());
+                CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lf.get() + width);
+                if (depth > 1)
+                {
+                    CreateLinearFilter(depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, lf.get() + width + height);
+                }
+            }
+            else if (cf)
+            {
+                CreateCubicFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cf.get());
+                CreateCubicFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cf.get() + width);
+                if (depth > 1)
+                {
+                    CreateCubicFilter(depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, (filter & TEX_FILTER_MIRROR_W) != 0, cf.get() + width + height);
+                }
+            }
+
+            const size_t bands = (nheight + MIP_BAND_ROWS - 1) / MIP_BAND_ROWS;
+
+            auto band = [&](size_t task, XMVECTOR* scratch) noexcept -> bool
+                {
+                    const size_t slice = task / bands;
+                    const size_t y0 = (task % bands) * MIP_BAND_ROWS;
+                    const size_t y1 = std::min(y0 + MIP_BAND_ROWS, nheight);
+
+                    const Image* dest = mipChain.GetImage(level, 0, slice);
+                    if (!dest)
+                        return false;
+
+                    if (depth <= 1)
+                    {
+                        // 2D filter on the last remaining slice
+                        const Image* src = mipChain.GetImage(level - 1, 0, 0);
+                        if (!src)
+                            return false;
+
+                        switch (filterSelect)
+                        {
+                        case TEX_FILTER_POINT:
+                            return PointFilterBand(*src, *dest, width, height, nwidth, nheight, y0, y1, scratch);
+
+                        case TEX_FILTER_BOX:
+                            return BoxFilterBand(*src, nullptr, *dest, filter, width, height, nwidth, y0, y1, scratch);
+
+                        case TEX_FILTER_LINEAR:
+                            return LinearFilterBand(*src, nullptr, *dest, filter, width, height, nwidth, lf.get(), lf.get() + width, nullptr, y0, y1, scratch);
+
+                        case TEX_FILTER_CUBIC:
+                            return CubicFilterBand(&src, 1, *dest, filter, width, height, nwidth, cf.get(), cf.get() + width, nullptr, y0, y1, scratch);
+
+                        default:
+                            return false;
+                        }
+                    }
+
+                    switch (filterSelect)
+                    {
+                    case TEX_FILTER_POINT:
+                        {
+                            const size_t zinc = (depth << 16) / ndepth;
+
+                            const Image* src = mipChain.GetImage(level - 1, 0, (slice * zinc) >> 16);
+                            if (!src)
+                                return false;
+
+                            return PointFilterBand(*src, *dest, width, height, nwidth, nheight, y0, y1, scratch);
+                        }
+
+                    case TEX_FILTER_BOX:
+                        {
+                            const size_t slicea = std::min<size_t>(slice * 2, depth - 1);
+                            const size_t sliceb = std::min<size_t>(slicea + 1, depth - 1);
+
+                            const Image* srca = mipChain.GetImage(level - 1, 0, slicea);
+                            const Image* srcb = mipChain.GetImage(level - 1, 0, sliceb);
+                            if (!srca || !srcb)
+                                return false;
+
+                            return BoxFilterBand(*srca, srcb, *dest, filter, width, height, nwidth, y0, y1, scratch);
+                        }
+
+                    case TEX_FILTER_LINEAR:
+                        {
+                            const LinearFilter* toZ = lf.get() + width + height + slice;
+
+                            const Image* srca = mipChain.GetImage(level - 1, 0, toZ->u0);
+                            const Image* srcb = mipChain.GetImage(level - 1, 0, toZ->u1);
+                            if (!srca || !srcb)
+                                return false;
+
+                            return LinearFilterBand(*srca, srcb, *dest, filter, width, height, nwidth, lf.get(), lf.get() + width, toZ, y0, y1, scratch);
+                        }
+
+                    case TEX_FILTER_CUBIC:
+                        {
+                            const CubicFilter* toZ = cf.get() + width + height + slice;
+
+                            const Image* srcs[4] =
+                            {
+                                mipChain.GetImage(level - 1, 0, toZ->u0),
+                                mipChain.GetImage(level - 1, 0, toZ->u1),
+                                mipChain.GetImage(level - 1, 0, toZ->u2),
+                                mipChain.GetImage(level - 1, 0, toZ->u3),
+                            };
+                            if (!srcs[0] || !srcs[1] || !srcs[2] || !srcs[3])
+                                return false;
+
+                            return CubicFilterBand(srcs, 4, *dest, filter, width, height, nwidth, cf.get(), cf.get() + width, toZ, y0, y1, scratch);
+                        }
+
+                    default:
+                        return false;
+                    }
+                };
+
+            const HRESULT hr = ProcessBandsParallel(ndepth * bands, uint64_t(width) * 17, band);
+            if (FAILED(hr))
+                return hr;
+
+            if (height > 1)
+                height >>= 1;
+
+            if (width > 1)
+                width >>= 1;
+
+            if (depth > 1)
+                depth >>= 1;
+        }
+
+        return S_OK;
+    }
+#endif // _OPENMP
 }
 
 
@@ -2832,6 +3604,8 @@ HRESULT DirectX::GenerateMipMaps(
     ScratchImage& mipChain,
     bool allow1D) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_MIPMAPS);
+
     if (!IsValid(baseImage.format))
         return E_INVALIDARG;
 
@@ -2958,6 +3732,35 @@ HRESULT DirectX::GenerateMipMaps(
             filter_select = (ispow2(baseImage.width) && ispow2(baseImage.height)) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
         }
 
+        if ((filter & TEX_FILTER_PARALLEL) && !IsPolyphaseFilter(filter_select))
+        {
+        #ifndef _OPENMP
+            return E_NOTIMPL;
+        #else
+            switch (filter_select)
+            {
+            case TEX_FILTER_BOX:
+            case TEX_FILTER_POINT:
+            case TEX_FILTER_LINEAR:
+            case TEX_FILTER_CUBIC:
+            case TEX_FILTER_TRIANGLE:
+                break;
+
+            default:
+                return HRESULT_E_NOT_SUPPORTED;
+            }
+
+            hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            hr = Generate2DMipsParallel(levels, filter_select, filter, mipChain);
+            if (FAILED(hr))
+                mipChain.Release();
+            return hr;
+        #endif // _OPENMP
+        }
+
         switch (filter_select)
         {
         case TEX_FILTER_BOX:
@@ -3010,6 +3813,18 @@ HRESULT DirectX::GenerateMipMaps(
                 mipChain.Release();
             return hr;
 
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_MITCHELL:
+        case TEX_FILTER_KAISER:
+            hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            hr = Generate2DMipsPolyphaseFilter(levels, filter, mipChain, 0);
+            if (FAILED(hr))
+                mipChain.Release();
+            return hr;
+
         default:
             return HRESULT_E_NOT_SUPPORTED;
         }
@@ -3025,6 +3840,8 @@ HRESULT DirectX::GenerateMipMaps(
     size_t levels,
     ScratchImage& mipChain)
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_MIPMAPS);
+
     if (!srcImages || !nimages || !IsValid(metadata.format))
         return E_INVALIDARG;
 
@@ -3173,6 +3990,35 @@ HRESULT DirectX::GenerateMipMaps(
             filter_select = (ispow2(metadata.width) && ispow2(metadata.height)) ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
         }
 
+        if ((filter & TEX_FILTER_PARALLEL) && !IsPolyphaseFilter(filter_select))
+        {
+        #ifndef _OPENMP
+            return E_NOTIMPL;
+        #else
+            switch (filter_select)
+            {
+            case TEX_FILTER_BOX:
+            case TEX_FILTER_POINT:
+            case TEX_FILTER_LINEAR:
+            case TEX_FILTER_CUBIC:
+            case TEX_FILTER_TRIANGLE:
+                break;
+
+            default:
+                return HRESULT_E_NOT_SUPPORTED;
+            }
+
+            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            hr = Generate2DMipsParallel(levels, filter_select, filter, mipChain);
+            if (FAILED(hr))
+                mipChain.Release();
+            return hr;
+        #endif // _OPENMP
+        }
+
         switch (filter_select)
         {
         case TEX_FILTER_BOX:
@@ -3240,6 +4086,24 @@ HRESULT DirectX::GenerateMipMaps(
             }
             return hr;
 
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_MITCHELL:
+        case TEX_FILTER_KAISER:
+            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            for (size_t item = 0; item < metadata.arraySize; ++item)
+            {
+                hr = Generate2DMipsPolyphaseFilter(levels, filter, mipChain, item);
+                if (FAILED(hr))
+                {
+                    mipChain.Release();
+                    return hr;
+                }
+            }
+            return hr;
+
         default:
             return HRESULT_E_NOT_SUPPORTED;
         }
@@ -3258,6 +4122,8 @@ HRESULT DirectX::GenerateMipMaps3D(
     size_t levels,
     ScratchImage& mipChain) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_MIPMAPS);
+
     if (!baseImages || !depth)
         return E_INVALIDARG;
 
@@ -3303,6 +4169,41 @@ HRESULT DirectX::GenerateMipMaps3D(
         filter_select = (ispow2(width) && ispow2(height) && ispow2(depth)) ? TEX_FILTER_BOX : TEX_FILTER_TRIANGLE;
     }
 
+    if (IsPolyphaseFilter(filter_select))
+    {
+        // The polyphase filters only resample in 2D, so there is no volume version
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    if (filter & TEX_FILTER_PARALLEL)
+    {
+    #ifndef _OPENMP
+        return E_NOTIMPL;
+    #else
+        switch (filter_select)
+        {
+        case TEX_FILTER_BOX:
+        case TEX_FILTER_POINT:
+        case TEX_FILTER_LINEAR:
+        case TEX_FILTER_CUBIC:
+        case TEX_FILTER_TRIANGLE:
+            break;
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+
+        hr = Setup3DMips(baseImages, depth, levels, mipChain);
+        if (FAILED(hr))
+            return hr;
+
+        hr = Generate3DMipsParallel(depth, levels, filter_select, filter, mipChain);
+        if (FAILED(hr))
+            mipChain.Release();
+        return hr;
+    #endif // _OPENMP
+    }
+
     switch (filter_select)
     {
     case TEX_FILTER_BOX:
@@ -3369,6 +4270,8 @@ HRESULT DirectX::GenerateMipMaps3D(
     size_t levels,
     ScratchImage& mipChain)
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_MIPMAPS);
+
     if (!srcImages || !nimages || !IsValid(metadata.format))
         return E_INVALIDARG;
 
@@ -3422,6 +4325,41 @@ HRESULT DirectX::GenerateMipMaps3D(
         filter_select = (ispow2(metadata.width) && ispow2(metadata.height) && ispow2(metadata.depth)) ? TEX_FILTER_BOX : TEX_FILTER_TRIANGLE;
     }
 
+    if (IsPolyphaseFilter(filter_select))
+    {
+        // The polyphase filters only resample in 2D, so there is no volume version
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    if (filter & TEX_FILTER_PARALLEL)
+    {
+    #ifndef _OPENMP
+        return E_NOTIMPL;
+    #else
+        switch (filter_select)
+        {
+        case TEX_FILTER_BOX:
+        case TEX_FILTER_POINT:
+        case TEX_FILTER_LINEAR:
+        case TEX_FILTER_CUBIC:
+        case TEX_FILTER_TRIANGLE:
+            break;
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+
+        hr = Setup3DMips(&baseImages[0], metadata.depth, levels, mipChain);
+        if (FAILED(hr))
+            return hr;
+
+        hr = Generate3DMipsParallel(metadata.depth, levels, filter_select, filter, mipChain);
+        if (FAILED(hr))
+            mipChain.Release();
+        return hr;
+    #endif // _OPENMP
+    }
+
     switch (filter_select)
     {
     case TEX_FILTER_BOX:
@@ -11,6 +11,10 @@
 
 #include "DirectXTexP.h"
 
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 
@@ -24,27 +28,10 @@ namespace
     const XMVECTORF32 g_Gamma22 = { { { 2.2f, 2.2f, 2.2f, 1.f } } };
 
     //-------------------------------------------------------------------------------------
-    HRESULT ComputeMSE_(
-        const Image& image1,
-        const Image& image2,
-        float& mse,
-        _Out_writes_opt_(4) float* mseV,
-        CMSE_FLAGS flags) noexcept
+    // Flags implied from image formats
+    CMSE_FLAGS GetImpliedMSEFlags(DXGI_FORMAT format1, DXGI_FORMAT format2, CMSE_FLAGS flags) noexcept
     {
-        if (!image1.pixels || !image2.pixels)
-            return E_POINTER;
-
-        assert(image1.width == image2.width && image1.height == image2.height);
-        assert(!IsCompressed(image1.format) && !IsCompressed(image2.format));
-
-        const size_t width = image1.width;
-
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        // Flags implied from image formats
-        switch (image1.format)
+        switch (format1)
         {
         case DXGI_FORMAT_B8G8R8X8_UNORM:
             flags |= CMSE_IGNORE_ALPHA;
@@ -67,7 +54,7 @@ namespace
             break;
         }
 
-        switch (image2.format)
+        switch (format2)
         {
         case DXGI_FORMAT_B8G8R8X8_UNORM:
             flags |= CMSE_IGNORE_ALPHA;
@@ -90,75 +77,206 @@ namespace
             break;
         }
 
-        const uint8_t *pSrc1 = image1.pixels;
-        const size_t rowPitch1 = image1.rowPitch;
+        return flags;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Adds sum[ (I1 - I2)^2 ] for one scanline to acc
+    XMVECTOR XM_CALLCONV AccumulateMSE(
+        FXMVECTOR sum,
+        _In_reads_(width) const XMVECTOR* ptr1,
+        _In_reads_(width) const XMVECTOR* ptr2,
+        size_t width,
+        CMSE_FLAGS flags) noexcept
+    {
+        static const XMVECTORF32 two = { { { 2.0f, 2.0f, 2.0f, 2.0f } } };
+
+        XMVECTOR acc = sum;
+        for (size_t i = 0; i < width; ++i)
+        {
+            XMVECTOR v1 = *(ptr1++);
+            if (flags & CMSE_IMAGE1_SRGB)
+            {
+                v1 = XMVectorPow(v1, g_Gamma22);
+            }
+            if (flags & CMSE_IMAGE1_X2_BIAS)
+            {
+                v1 = XMVectorMultiplyAdd(v1, two, g_XMNegativeOne);
+            }
+
+            XMVECTOR v2 = *(ptr2++);
+            if (flags & CMSE_IMAGE2_SRGB)
+            {
+                v2 = XMVectorPow(v2, g_Gamma22);
+            }
+            if (flags & CMSE_IMAGE2_X2_BIAS)
+            {
+                v2 = XMVectorMultiplyAdd(v2, two, g_XMNegativeOne);
+            }
+
+            // sum[ (I1 - I2)^2 ]
+            XMVECTOR v = XMVectorSubtract(v1, v2);
+            if (flags & CMSE_IGNORE_RED)
+            {
+                v = XMVectorSelect(v, g_XMZero, g_XMMaskX);
+            }
+            if (flags & CMSE_IGNORE_GREEN)
+            {
+                v = XMVectorSelect(v, g_XMZero, g_XMMaskY);
+            }
+            if (flags & CMSE_IGNORE_BLUE)
+            {
+                v = XMVectorSelect(v, g_XMZero, g_XMMaskZ);
+            }
+            if (flags & CMSE_IGNORE_ALPHA)
+            {
+                v = XMVectorSelect(v, g_XMZero, g_XMMaskW);
+            }
+
+            acc = XMVectorMultiplyAdd(v, v, acc);
+        }
+
+        return acc;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Loads the band of up to four scanlines starting at y; BC images are decoded a row of
+    // blocks at a time, giving the same values as a Decompress to R32G32B32A32_FLOAT
+    bool LoadMSEBand(const Image& image, size_t y, _Out_writes_(image.width * 4) XMVECTOR* pBand) noexcept
+    {
+        if (IsCompressed(image.format))
+            return DecompressBlockRow(image, y, pBand, DXGI_FORMAT_R32G32B32A32_FLOAT);
+
+        const size_t rows = std::min<size_t>(4, image.height - y);
+        const uint8_t* pSrc = image.pixels + y * image.rowPitch;
+        for (size_t row = 0; row < rows; ++row)
+        {
+            if (!LoadScanline(pBand + row * image.width, image.width, pSrc, image.rowPitch, image.format))
+                return false;
+
+            pSrc += image.rowPitch;
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------
+    HRESULT ComputeMSE_(
+        const Image& image1,
+        const Image& image2,
+        float& mse,
+        _Out_writes_opt_(4) float* mseV,
+        CMSE_FLAGS flags) noexcept
+    {
+        if (!image1.pixels || !image2.pixels)
+            return E_POINTER;
+
+        assert(image1.width == image2.width && image1.height == image2.height);
+
+        // Compressed images are compared as the R32G32B32A32_FLOAT data Decompress produces, so their format implies no flags
+        flags = GetImpliedMSEFlags(
+            IsCompressed(image1.format) ? DXGI_FORMAT_R32G32B32A32_FLOAT : image1.format,
+            IsCompressed(image2.format) ? DXGI_FORMAT_R32G32B32A32_FLOAT : image2.format,
+            flags);
 
-        const uint8_t *pSrc2 = image2.pixels;
-        const size_t rowPitch2 = image2.rowPitch;
+        const size_t width = image1.width;
+        const size_t height = image1.height;
+        const size_t bandSize = width * 4;
+        const size_t bands = (height + 3) / 4;
 
         XMVECTOR acc = g_XMZero;
-        static XMVECTORF32 two = { { { 2.0f, 2.0f, 2.0f, 2.0f } } };
 
-        for (size_t h = 0; h < image1.height; ++h)
+    #ifdef _OPENMP
+        if (flags & CMSE_PARALLEL)
         {
-            XMVECTOR* ptr1 = scanline.get();
-            if (!LoadScanline(ptr1, width, pSrc1, rowPitch1, image1.format))
-                return E_FAIL;
+            if (bands > INT32_MAX)
+                return HRESULT_E_ARITHMETIC_OVERFLOW;
 
-            XMVECTOR* ptr2 = scanline.get() + width;
-            if (!LoadScanline(ptr2, width, pSrc2, rowPitch2, image2.format))
-                return E_FAIL;
+            auto partial = make_AlignedArrayXMVECTOR(bands);
+            if (!partial)
+                return E_OUTOFMEMORY;
 
-            for (size_t i = 0; i < width; ++i)
+            bool fail = false;
+            bool outOfMemory = false;
+
+            const int nthreads = GetWorkerThreadCount(bands);
+
+#pragma omp parallel num_threads(nthreads)
             {
-                XMVECTOR v1 = *(ptr1++);
-                if (flags & CMSE_IMAGE1_SRGB)
-                {
-                    v1 = XMVectorPow(v1, g_Gamma22);
-                }
-                if (flags & CMSE_IMAGE1_X2_BIAS)
+                auto scanlines = make_AlignedArrayXMVECTOR(uint64_t(bandSize) * 2);
+                if (!scanlines)
                 {
-                    v1 = XMVectorMultiplyAdd(v1, two, g_XMNegativeOne);
+                    outOfMemory = true;
                 }
 
-                XMVECTOR v2 = *(ptr2++);
-                if (flags & CMSE_IMAGE2_SRGB)
+#pragma omp for schedule(dynamic)
+                for (int nb = 0; nb < static_cast<int>(bands); ++nb)
                 {
-                    v2 = XMVectorPow(v2, g_Gamma22);
-                }
-                if (flags & CMSE_IMAGE2_X2_BIAS)
-                {
-                    v2 = XMVectorMultiplyAdd(v2, two, g_XMNegativeOne);
-                }
+#pragma omp flush (fail, outOfMemory)
+                    if (fail || outOfMemory)
+                    {
+                        // OpenMP 2.0 does not support cancellation of a 'for' loop.
+                        continue;
+                    }
 
-                // sum[ (I1 - I2)^2 ]
-                XMVECTOR v = XMVectorSubtract(v1, v2);
-                if (flags & CMSE_IGNORE_RED)
-                {
-                    v = XMVectorSelect(v, g_XMZero, g_XMMaskX);
-                }
-                if (flags & CMSE_IGNORE_GREEN)
-                {
-                    v = XMVectorSelect(v, g_XMZero, g_XMMaskY);
-                }
-                if (flags & CMSE_IGNORE_BLUE)
-                {
-                    v = XMVectorSelect(v, g_XMZero, g_XMMaskZ);
-                }
-                if (flags & CMSE_IGNORE_ALPHA)
-                {
-                    v = XMVectorSelect(v, g_XMZero, g_XMMaskW);
+                    const size_t y = static_cast<size_t>(nb) * 4;
+                    XMVECTOR* band1 = scanlines.get();
+                    XMVECTOR* band2 = scanlines.get() + bandSize;
+                    if (!LoadMSEBand(image1, y, band1) || !LoadMSEBand(image2, y, band2))
+                    {
+                        fail = true;
+                        continue;
+                    }
+
+                    XMVECTOR sum = g_XMZero;
+                    const size_t rows = std::min<size_t>(4, height - y);
+                    for (size_t row = 0; row < rows; ++row)
+                    {
+                        sum = AccumulateMSE(sum, band1 + row * width, band2 + row * width, width, flags);
+                    }
+
+                    partial[static_cast<size_t>(nb)] = sum;
                 }
+            }
+
+            if (outOfMemory)
+                return E_OUTOFMEMORY;
 
-                acc = XMVectorMultiplyAdd(v, v, acc);
+            if (fail)
+                return E_FAIL;
+
+            // Bands are summed in order so the result does not depend on the thread count
+            for (size_t j = 0; j < bands; ++j)
+            {
+                acc = XMVectorAdd(acc, partial[j]);
             }
+        }
+        else
+    #endif // _OPENMP
+        {
+            auto scanlines = make_AlignedArrayXMVECTOR(uint64_t(bandSize) * 2);
+            if (!scanlines)
+                return E_OUTOFMEMORY;
+
+            XMVECTOR* band1 = scanlines.get();
+            XMVECTOR* band2 = scanlines.get() + bandSize;
+
+            // Scanlines are accumulated in image order, so this matches comparing fully decompressed images
+            for (size_t y = 0; y < height; y += 4)
+            {
+                if (!LoadMSEBand(image1, y, band1) || !LoadMSEBand(image2, y, band2))
+                    return E_FAIL;
 
-            pSrc1 += rowPitch1;
-            pSrc2 += rowPitch2;
+                const size_t rows = std::min<size_t>(4, height - y);
+                for (size_t row = 0; row < rows; ++row)
+                {
+                    acc = AccumulateMSE(acc, band1 + row * width, band2 + row * width, width, flags);
+                }
+            }
         }
 
         // MSE = sum[ (I1 - I2)^2 ] / w*h
-        const XMVECTOR d = XMVectorReplicate(float(image1.width * image1.height));
+        const XMVECTOR d = XMVectorReplicate(float(width * height));
         const XMVECTOR v = XMVectorDivide(acc, d);
         if (mseV)
         {
@@ -261,257 +379,1583 @@ namespace
 
         return S_OK;
     }
-};
-
-
-//=====================================================================================
-// Entry points
-//=====================================================================================
-
-//-------------------------------------------------------------------------------------
-// Copies a rectangle from one image into another
-//-------------------------------------------------------------------------------------
-_Use_decl_annotations_
-HRESULT DirectX::CopyRectangle(
-    const Image& srcImage,
-    const Rect& srcRect,
-    const Image& dstImage,
-    TEX_FILTER_FLAGS filter,
-    size_t xOffset,
-    size_t yOffset) noexcept
-{
-    if (!srcImage.pixels || !dstImage.pixels)
-        return E_POINTER;
 
-    if (IsCompressed(srcImage.format) || IsCompressed(dstImage.format)
-        || IsPlanar(srcImage.format) || IsPlanar(dstImage.format)
-        || IsPalettized(srcImage.format) || IsPalettized(dstImage.format))
-        return HRESULT_E_NOT_SUPPORTED;
+    //-------------------------------------------------------------------------------------
+    // Band-parallel evaluation and transforms
+    //-------------------------------------------------------------------------------------
 
-    // Validate rectangle/offset
-    if (!srcRect.w || !srcRect.h || ((srcRect.x + srcRect.w) > srcImage.width) || ((srcRect.y + srcRect.h) > srcImage.height))
+    // Rows [y0, y1) covered by one of 'bands' contiguous ranges of the rows [rowStart, rowEnd)
+    inline void GetBandRows(size_t rowStart, size_t rowEnd, size_t band, size_t bands, size_t& y0, size_t& y1) noexcept
     {
-        return E_INVALIDARG;
+        const uint64_t rows = uint64_t(rowEnd - rowStart);
+        y0 = rowStart + static_cast<size_t>(rows * band / bands);
+        y1 = rowStart + static_cast<size_t>(rows * (band + 1) / bands);
     }
 
-    if (((xOffset + srcRect.w) > dstImage.width) || ((yOffset + srcRect.h) > dstImage.height))
+    // Runs the band worker for each band, where each thread has its own 'scratchSize' XMVECTORs of temporary space
+    template<typename TWork>
+    HRESULT ProcessImageBands(size_t bands, uint64_t scratchSize, TWork& work)
     {
-        return E_INVALIDARG;
-    }
+        assert(bands > 0 && bands <= INT32_MAX);
 
-    // Compute source bytes-per-pixel
-    size_t sbpp = BitsPerPixel(srcImage.format);
-    if (!sbpp)
-        return E_FAIL;
+    #ifdef _OPENMP
+        bool fail = false;
+        bool outOfMemory = false;
 
-    if (sbpp < 8)
-    {
-        // We don't support monochrome (DXGI_FORMAT_R1_UNORM)
-        return HRESULT_E_NOT_SUPPORTED;
-    }
+        const int nthreads = GetWorkerThreadCount(bands);
 
-    const uint8_t* pEndSrc = srcImage.pixels + srcImage.rowPitch*srcImage.height;
-    const uint8_t* pEndDest = dstImage.pixels + dstImage.rowPitch*dstImage.height;
+#pragma omp parallel num_threads(nthreads)
+        {
+            auto scratch = make_AlignedArrayXMVECTOR(scratchSize);
+            if (!scratch)
+            {
+                outOfMemory = true;
+            }
 
-    // Round to bytes
-    sbpp = (sbpp + 7) / 8;
+#pragma omp for schedule(dynamic)
+            for (int nb = 0; nb < static_cast<int>(bands); ++nb)
+            {
+#pragma omp flush (fail, outOfMemory)
+                if (fail || outOfMemory)
+                {
+                    // OpenMP 2.0 does not support cancellation of a 'for' loop.
+                    continue;
+                }
 
-    const uint8_t* pSrc = srcImage.pixels + (srcRect.y * srcImage.rowPitch) + (srcRect.x * sbpp);
+                if (!work(static_cast<size_t>(nb), scratch.get()))
+                {
+                    fail = true;
+                }
+            }
+        }
 
-    if (srcImage.format == dstImage.format)
-    {
-        // Direct copy case (avoid intermediate conversions)
-        uint8_t* pDest = dstImage.pixels + (yOffset * dstImage.rowPitch) + (xOffset * sbpp);
-        const size_t copyW = srcRect.w * sbpp;
-        for (size_t h = 0; h < srcRect.h; ++h)
-        {
-            if (((pSrc + copyW) > pEndSrc) || (pDest > pEndDest))
-                return E_FAIL;
+        if (outOfMemory)
+            return E_OUTOFMEMORY;
 
-            memcpy(pDest, pSrc, copyW);
+        return (fail) ? E_FAIL : S_OK;
+    #else
+        auto scratch = make_AlignedArrayXMVECTOR(scratchSize);
+        if (!scratch)
+            return E_OUTOFMEMORY;
 
-            pSrc += srcImage.rowPitch;
-            pDest += dstImage.rowPitch;
+        for (size_t band = 0; band < bands; ++band)
+        {
+            if (!work(band, scratch.get()))
+                return E_FAIL;
         }
 
         return S_OK;
+    #endif
     }
 
-    // Compute destination bytes-per-pixel (not the same format as source)
-    size_t dbpp = BitsPerPixel(dstImage.format);
-    if (!dbpp)
-        return E_FAIL;
-
-    if (dbpp < 8)
+    HRESULT EvaluateImageBands_(
+        const Image& image,
+        size_t rowStart,
+        size_t rowEnd,
+        size_t bands,
+        const std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t band)>& pixelFunc)
     {
-        // We don't support monochrome (DXGI_FORMAT_R1_UNORM)
-        return HRESULT_E_NOT_SUPPORTED;
-    }
+        if (!pixelFunc)
+            return E_INVALIDARG;
 
-    // Round to bytes
-    dbpp = (dbpp + 7) / 8;
+        if (!image.pixels)
+            return E_POINTER;
 
-    uint8_t* pDest = dstImage.pixels + (yOffset * dstImage.rowPitch) + (xOffset * dbpp);
+        assert(!IsCompressed(image.format));
 
-    auto scanline = make_AlignedArrayXMVECTOR(srcRect.w);
-    if (!scanline)
-        return E_OUTOFMEMORY;
+        const size_t width = image.width;
+        const size_t rowPitch = image.rowPitch;
 
-    const size_t copyS = srcRect.w * sbpp;
-    const size_t copyD = srcRect.w * dbpp;
+        auto work = [&](size_t band, XMVECTOR* scanline) -> bool
+            {
+                size_t y0, y1;
+                GetBandRows(rowStart, rowEnd, band, bands, y0, y1);
 
-    for (size_t h = 0; h < srcRect.h; ++h)
-    {
-        if (((pSrc + copyS) > pEndSrc) || ((pDest + copyD) > pEndDest))
-            return E_FAIL;
+                const uint8_t *pSrc = image.pixels + y0 * rowPitch;
 
-        if (!LoadScanline(scanline.get(), srcRect.w, pSrc, copyS, srcImage.format))
-            return E_FAIL;
+                for (size_t h = y0; h < y1; ++h)
+                {
+                    if (!LoadScanline(scanline, width, pSrc, rowPitch, image.format))
+                        return false;
 
-        ConvertScanline(scanline.get(), srcRect.w, dstImage.format, srcImage.format, filter);
+                    pixelFunc(scanline, width, h, band);
 
-        if (!StoreScanline(pDest, copyD, dstImage.format, scanline.get(), srcRect.w))
-            return E_FAIL;
+                    pSrc += rowPitch;
+                }
 
-        pSrc += srcImage.rowPitch;
-        pDest += dstImage.rowPitch;
+                return true;
+            };
+
+        return ProcessImageBands(bands, width, work);
     }
 
-    return S_OK;
-}
+    HRESULT TransformImageBands_(
+        const Image& srcImage,
+        size_t rowStart,
+        size_t rowEnd,
+        size_t bands,
+        const std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)>& pixelFunc,
+        const Image& destImage)
+    {
+        if (!pixelFunc)
+            return E_INVALIDARG;
 
+        if (!srcImage.pixels || !destImage.pixels)
+            return E_POINTER;
 
-//-------------------------------------------------------------------------------------
-// Computes the Mean-Squared-Error (MSE) between two images
-//-------------------------------------------------------------------------------------
-_Use_decl_annotations_
-HRESULT DirectX::ComputeMSE(
-    const Image& image1,
-    const Image& image2,
-    float& mse,
-    float* mseV,
-    CMSE_FLAGS flags) noexcept
-{
-    if (!image1.pixels || !image2.pixels)
-        return E_POINTER;
+        if (srcImage.width != destImage.width || srcImage.height != destImage.height || srcImage.format != destImage.format)
+            return E_FAIL;
 
-    if (image1.width != image2.width || image1.height != image2.height)
-        return E_INVALIDARG;
+        const size_t width = srcImage.width;
+        const size_t spitch = srcImage.rowPitch;
+        const size_t dpitch = destImage.rowPitch;
 
-    if (!IsValid(image1.format) || !IsValid(image2.format))
-        return E_INVALIDARG;
+        auto work = [&](size_t band, XMVECTOR* scanlines) -> bool
+            {
+                size_t y0, y1;
+                GetBandRows(rowStart, rowEnd, band, bands, y0, y1);
 
-    if (IsPlanar(image1.format) || IsPlanar(image2.format)
-        || IsPalettized(image1.format) || IsPalettized(image2.format)
-        || IsTypeless(image1.format) || IsTypeless(image2.format))
-        return HRESULT_E_NOT_SUPPORTED;
+                XMVECTOR* sScanline = scanlines;
+                XMVECTOR* dScanline = scanlines + width;
+
+                const uint8_t *pSrc = srcImage.pixels + y0 * spitch;
+                uint8_t *pDest = destImage.pixels + y0 * dpitch;
+
+                for (size_t h = y0; h < y1; ++h)
+                {
+                    if (!LoadScanline(sScanline, width, pSrc, spitch, srcImage.format))
+                        return false;
+
+                #ifdef _DEBUG
+                    memset(dScanline, 0xCD, sizeof(XMVECTOR)*width);
+                #endif
+
+                    pixelFunc(dScanline, sScanline, width, h);
+
+                    if (!StoreScanline(pDest, dpitch, destImage.format, dScanline, width))
+                        return false;
 
-    if (IsCompressed(image1.format))
+                    pSrc += spitch;
+                    pDest += dpitch;
+                }
+
+                return true;
+            };
+
+        return ProcessImageBands(bands, uint64_t(width) * 2, work);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Validates the image(s) and runs the evaluation on each one, decompressing first if needed
+    template<typename TEval>
+    HRESULT EvaluateImages(const Image& image, TEval& evaluate)
     {
-        if (IsCompressed(image2.format))
-        {
-            // Case 1: both images are compressed, expand to RGBA32F
-            ScratchImage temp1;
-            HRESULT hr = Decompress(image1, DXGI_FORMAT_R32G32B32A32_FLOAT, temp1);
-            if (FAILED(hr))
-                return hr;
+        if (image.width > UINT32_MAX
+            || image.height > UINT32_MAX)
+            return E_INVALIDARG;
+
+        if (!IsValid(image.format))
+            return E_INVALIDARG;
 
-            ScratchImage temp2;
-            hr = Decompress(image2, DXGI_FORMAT_R32G32B32A32_FLOAT, temp2);
+        if (IsPlanar(image.format) || IsPalettized(image.format) || IsTypeless(image.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        if (IsCompressed(image.format))
+        {
+            ScratchImage temp;
+            HRESULT hr = Decompress(image, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
             if (FAILED(hr))
                 return hr;
 
-            const Image* img1 = temp1.GetImage(0, 0, 0);
-            const Image* img2 = temp2.GetImage(0, 0, 0);
-            if (!img1 || !img2)
+            const Image* img = temp.GetImage(0, 0, 0);
+            if (!img)
                 return E_POINTER;
 
-            return ComputeMSE_(*img1, *img2, mse, mseV, flags);
+            return evaluate(*img);
         }
         else
         {
-            // Case 2: image1 is compressed, expand to RGBA32F
-            ScratchImage temp;
-            HRESULT hr = Decompress(image1, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
+            return evaluate(image);
+        }
+    }
+
+    template<typename TEval>
+    HRESULT EvaluateImages(
+        const Image* images,
+        size_t nimages,
+        const TexMetadata& metadata,
+        TEval& evaluate)
+    {
+        if (!images || !nimages)
+            return E_INVALIDARG;
+
+        if (!IsValid(metadata.format))
+            return E_INVALIDARG;
+
+        if (IsPlanar(metadata.format) || IsPalettized(metadata.format) || IsTypeless(metadata.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        if (metadata.width > UINT32_MAX
+            || metadata.height > UINT32_MAX)
+            return E_INVALIDARG;
+
+        if (metadata.IsVolumemap() && metadata.depth > UINT16_MAX)
+            return E_INVALIDARG;
+
+        ScratchImage temp;
+        DXGI_FORMAT format = metadata.format;
+        if (IsCompressed(format))
+        {
+            HRESULT hr = Decompress(images, nimages, metadata, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
             if (FAILED(hr))
                 return hr;
 
-            const Image* img = temp.GetImage(0, 0, 0);
-            if (!img)
-                return E_POINTER;
+            if (nimages != temp.GetImageCount())
+                return E_UNEXPECTED;
+
+            images = temp.GetImages();
+            format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        }
+
+        switch (metadata.dimension)
+        {
+        case TEX_DIMENSION_TEXTURE1D:
+        case TEX_DIMENSION_TEXTURE2D:
+            for (size_t index = 0; index < nimages; ++index)
+            {
+                const Image& img = images[index];
+                if (img.format != format)
+                    return E_FAIL;
+
+                if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
+                    return E_FAIL;
+
+                HRESULT hr = evaluate(img);
+                if (FAILED(hr))
+                    return hr;
+            }
+            break;
+
+        case TEX_DIMENSION_TEXTURE3D:
+            {
+                size_t index = 0;
+                size_t d = metadata.depth;
+                for (size_t level = 0; level < metadata.mipLevels; ++level)
+                {
+                    for (size_t slice = 0; slice < d; ++slice, ++index)
+                    {
+                        if (index >= nimages)
+                            return E_FAIL;
+
+                        const Image& img = images[index];
+                        if (img.format != format)
+                            return E_FAIL;
+
+                        if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
+                            return E_FAIL;
+
+                        HRESULT hr = evaluate(img);
+                        if (FAILED(hr))
+                            return hr;
+                    }
+
+                    if (d > 1)
+                        d >>= 1;
+                }
+            }
+            break;
+
+        default:
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Validates the image(s), creates the result, and runs the transform on each one
+    template<typename TTransform>
+    HRESULT TransformImages(const Image& image, TTransform& transform, ScratchImage& result)
+    {
+        if (image.width > UINT32_MAX
+            || image.height > UINT32_MAX)
+            return E_INVALIDARG;
+
+        if (IsPlanar(image.format) || IsPalettized(image.format) || IsCompressed(image.format) || IsTypeless(image.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        HRESULT hr = result.Initialize2D(image.format, image.width, image.height, 1, 1);
+        if (FAILED(hr))
+            return hr;
+
+        const Image* dimg = result.GetImage(0, 0, 0);
+        if (!dimg)
+        {
+            result.Release();
+            return E_POINTER;
+        }
+
+        hr = transform(image, *dimg);
+        if (FAILED(hr))
+        {
+            result.Release();
+            return hr;
+        }
+
+        return S_OK;
+    }
+
+    template<typename TTransform>
+    HRESULT TransformImages(
+        const Image* srcImages,
+        size_t nimages,
+        const TexMetadata& metadata,
+        TTransform& transform,
+        ScratchImage& result)
+    {
+        if (!srcImages || !nimages)
+            return E_INVALIDARG;
+
+        if (IsPlanar(metadata.format) || IsPalettized(metadata.format) || IsCompressed(metadata.format) || IsTypeless(metadata.format))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        if (metadata.width > UINT32_MAX
+            || metadata.height > UINT32_MAX)
+            return E_INVALIDARG;
+
+        if (metadata.IsVolumemap() && metadata.depth > UINT16_MAX)
+            return E_INVALIDARG;
+
+        HRESULT hr = result.Initialize(metadata);
+        if (FAILED(hr))
+            return hr;
+
+        if (nimages != result.GetImageCount())
+        {
+            result.Release();
+            return E_FAIL;
+        }
+
+        const Image* dest = result.GetImages();
+        if (!dest)
+        {
+            result.Release();
+            return E_POINTER;
+        }
+
+        switch (metadata.dimension)
+        {
+        case TEX_DIMENSION_TEXTURE1D:
+        case TEX_DIMENSION_TEXTURE2D:
+            for (size_t index = 0; index < nimages; ++index)
+            {
+                const Image& src = srcImages[index];
+                if (src.format != metadata.format)
+                {
+                    result.Release();
+                    return E_FAIL;
+                }
+
+                if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
+                {
+                    result.Release();
+                    return E_FAIL;
+                }
+
+                const Image& dst = dest[index];
+
+                if (src.width != dst.width || src.height != dst.height)
+                {
+                    result.Release();
+                    return E_FAIL;
+                }
+
+                hr = transform(src, dst);
+                if (FAILED(hr))
+                {
+                    result.Release();
+                    return hr;
+                }
+            }
+            break;
+
+        case TEX_DIMENSION_TEXTURE3D:
+            {
+                size_t index = 0;
+                size_t d = metadata.depth;
+                for (size_t level = 0; level < metadata.mipLevels; ++level)
+                {
+                    for (size_t slice = 0; slice < d; ++slice, ++index)
+                    {
+                        if (index >= nimages)
+                        {
+                            result.Release();
+                            return E_FAIL;
+                        }
+
+                        const Image& src = srcImages[index];
+                        if (src.format != metadata.format)
+                        {
+                            result.Release();
+                            return E_FAIL;
+                        }
+
+                        if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
+                        {
+                            result.Release();
+                            return E_FAIL;
+                        }
+
+                        const Image& dst = dest[index];
+
+                        if (src.width != dst.width || src.height != dst.height)
+                        {
+                            result.Release();
+                            return E_FAIL;
+                        }
+
+                        hr = transform(src, dst);
+                        if (FAILED(hr))
+                        {
+                            result.Release();
+                            return hr;
+                        }
+                    }
+
+                    if (d > 1)
+                        d >>= 1;
+                }
+            }
+            break;
+
+        default:
+            result.Release();
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Image quality metrics (SSIM, MS-SSIM, and PSNR-HVS)
+    //-------------------------------------------------------------------------------------
+    constexpr size_t SSIM_RADIUS = 5;
+    constexpr size_t SSIM_TAPS = SSIM_RADIUS * 2 + 1;
+    constexpr size_t SSIM_BAND_ROWS = 32;   // Multiple of 8 for the PSNR-HVS blocks, and even for downsampling
+    constexpr size_t SSIM_MAX_SCALES = 5;
+    constexpr size_t SSIM_CHANNELS = 5;     // RGBA, then luminance
+
+    constexpr float SSIM_C1 = 0.01f * 0.01f;
+    constexpr float SSIM_C2 = 0.03f * 0.03f;
+
+    const float g_MSSSIMWeights[SSIM_MAX_SCALES] = { 0.0448f, 0.2856f, 0.3001f, 0.2363f, 0.1333f };
+
+    const XMVECTORF32 g_Luminance = { { { 0.2125f, 0.7154f, 0.0721f, 0.f } } };
+
+    // Contrast sensitivity weights of the 8x8 DCT coefficients (Egiazarian et al., "New full-reference
+    // quality metrics based on HVS")
+    const float g_CSF[8][8] =
+    {
+        { 1.608443f, 2.339554f, 2.573509f, 1.608443f, 1.072295f, 0.643377f, 0.504610f, 0.421887f },
+        { 2.144591f, 2.144591f, 1.838221f, 1.354478f, 0.989811f, 0.443708f, 0.428918f, 0.467911f },
+        { 1.838221f, 1.979622f, 1.608443f, 1.072295f, 0.643377f, 0.451493f, 0.372972f, 0.459555f },
+        { 1.838221f, 1.513829f, 1.169777f, 0.887417f, 0.504610f, 0.295806f, 0.321689f, 0.415082f },
+        { 1.429727f, 1.169777f, 0.695543f, 0.459555f, 0.378457f, 0.236102f, 0.249855f, 0.334222f },
+        { 1.072295f, 0.735288f, 0.467911f, 0.402111f, 0.317717f, 0.247453f, 0.227744f, 0.279729f },
+        { 0.525206f, 0.402111f, 0.329937f, 0.295806f, 0.249855f, 0.212687f, 0.214459f, 0.254803f },
+        { 0.357432f, 0.279729f, 0.270896f, 0.262603f, 0.229778f, 0.257351f, 0.249855f, 0.259950f },
+    };
+
+    struct SSIMKernel
+    {
+        XMVECTOR weight[SSIM_TAPS]; // 11-tap Gaussian, sigma 1.5, replicated into all four lanes
+        float gauss[SSIM_TAPS];
+        float dct[8][8];            // Orthonormal DCT-II basis
+
+        SSIMKernel() noexcept : weight{}, gauss{}, dct{}
+        {
+            float sum = 0.f;
+            for (size_t k = 0; k < SSIM_TAPS; ++k)
+            {
+                const float d = float(k) - float(SSIM_RADIUS);
+                gauss[k] = std::exp(-(d * d) / (2.f * 1.5f * 1.5f));
+                sum += gauss[k];
+            }
+
+            for (size_t k = 0; k < SSIM_TAPS; ++k)
+            {
+                gauss[k] /= sum;
+                weight[k] = XMVectorReplicate(gauss[k]);
+            }
+
+            for (size_t u = 0; u < 8; ++u)
+            {
+                const float alpha = (u == 0) ? std::sqrt(1.f / 8.f) : std::sqrt(2.f / 8.f);
+                for (size_t x = 0; x < 8; ++x)
+                {
+                    dct[u][x] = alpha * std::cos(float(2 * x + 1) * float(u) * XM_PI / 16.f);
+                }
+            }
+        }
+    };
+
+    struct SSIMSource
+    {
+        const Image*    image;
+        size_t          scale;      // Each scale is the 2x2 box filter of the previous one, rebuilt from the image as needed
+        size_t          width;
+        size_t          height;
+        bool            srgb;
+        bool            bias;
+    };
+
+    struct SSIMResult
+    {
+        double  ssim[SSIM_CHANNELS];
+        double  cs[SSIM_CHANNELS];
+        double  hvs;
+        size_t  hvsBlocks;
+
+        void Add(const SSIMResult& other) noexcept
+        {
+            for (size_t j = 0; j < SSIM_CHANNELS; ++j)
+            {
+                ssim[j] += other.ssim[j];
+                cs[j] += other.cs[j];
+            }
+            hvs += other.hvs;
+            hvsBlocks += other.hvsBlocks;
+        }
+    };
+
+    // Scratch for one band: the rows of both images and their luminance including the
+    // filter apron, and the vertically filtered statistics of a row at the scale's width;
+    // then a row of BC blocks and the rows for rebuilding a coarser scale at the image's width
+    inline size_t SSIMScratchSize(size_t width, size_t imageWidth) noexcept
+    {
+        return width * ((SSIM_BAND_ROWS + SSIM_TAPS - 1) * 3 + 7) + imageWidth * (4 + 4);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Loads scanlines [y0, y1) of the image with the comparison flags applied
+    bool LoadSSIMImageRows(
+        const SSIMSource& src,
+        size_t y0,
+        size_t y1,
+        _Out_writes_(src.image->width * (y1 - y0)) XMVECTOR* pDest,
+        _Out_writes_(src.image->width * 4) XMVECTOR* pBlocks) noexcept
+    {
+        const Image& image = *src.image;
+        const size_t width = image.width;
+
+        if (IsCompressed(image.format))
+        {
+            for (size_t by = y0 & ~size_t(3); by < y1; by += 4)
+            {
+                if (!DecompressBlockRow(image, by, pBlocks, DXGI_FORMAT_R32G32B32A32_FLOAT))
+                    return false;
+
+                const size_t r0 = std::max(by, y0);
+                const size_t r1 = std::min(by + 4, y1);
+                memcpy(pDest + (r0 - y0) * width, pBlocks + (r0 - by) * width, sizeof(XMVECTOR) * width * (r1 - r0));
+            }
+        }
+        else
+        {
+            const uint8_t* pSrc = image.pixels + y0 * image.rowPitch;
+            for (size_t y = y0; y < y1; ++y)
+            {
+                if (!LoadScanline(pDest + (y - y0) * width, width, pSrc, image.rowPitch, image.format))
+                    return false;
+
+                pSrc += image.rowPitch;
+            }
+        }
+
+        if (src.srgb || src.bias)
+        {
+            static const XMVECTORF32 two = { { { 2.0f, 2.0f, 2.0f, 2.0f } } };
+
+            XMVECTOR* ptr = pDest;
+            for (size_t i = 0; i < width * (y1 - y0); ++i, ++ptr)
+            {
+                XMVECTOR v = *ptr;
+                if (src.srgb)
+                {
+                    v = XMVectorPow(v, g_Gamma22);
+                }
+                if (src.bias)
+                {
+                    v = XMVectorMultiplyAdd(v, two, g_XMNegativeOne);
+                }
+                *ptr = v;
+            }
+        }
+
+        return true;
+    }
+
+    // Builds row y of a coarser scale from two rows of the scale above it, recursing up to the
+    // image. The filter runs in the same order as downsampling whole planes would, so only the
+    // rows of one band are ever held instead of a full-resolution plane per scale.
+    bool LoadSSIMScaleRow(
+        const SSIMSource& src,
+        size_t scale,
+        size_t y,
+        _Out_writes_(src.image->width >> scale) XMVECTOR* pDest,
+        _Inout_updates_(src.image->width * 4) XMVECTOR* pTemp,
+        _Out_writes_(src.image->width * 4) XMVECTOR* pBlocks) noexcept
+    {
+        assert(scale > 0);
+
+        const size_t width = src.image->width >> (scale - 1);
+        XMVECTOR* row0 = pTemp;
+        XMVECTOR* row1 = pTemp + width;
+
+        if (scale == 1)
+        {
+            if (!LoadSSIMImageRows(src, y * 2, y * 2 + 2, row0, pBlocks))
+                return false;
+        }
+        else if (!LoadSSIMScaleRow(src, scale - 1, y * 2, row0, row1 + width, pBlocks)
+            || !LoadSSIMScaleRow(src, scale - 1, y * 2 + 1, row1, row1 + width, pBlocks))
+        {
+            return false;
+        }
+
+        static const XMVECTORF32 quarter = { { { 0.25f, 0.25f, 0.25f, 0.25f } } };
+
+        const size_t width2 = width / 2;
+        for (size_t xo = 0; xo < width2; ++xo)
+        {
+            const size_t x = xo * 2;
+            const XMVECTOR v = XMVectorAdd(XMVectorAdd(row0[x], row0[x + 1]), XMVectorAdd(row1[x], row1[x + 1]));
+            pDest[xo] = XMVectorMultiply(v, quarter);
+        }
+
+        return true;
+    }
+
+    // Loads scanlines [y0, y1) of the source's scale
+    bool LoadSSIMRows(
+        const SSIMSource& src,
+        size_t y0,
+        size_t y1,
+        _Out_writes_(src.width * (y1 - y0)) XMVECTOR* pDest,
+        _Inout_updates_(src.image->width * 4) XMVECTOR* pTemp,
+        _Out_writes_(src.image->width * 4) XMVECTOR* pBlocks) noexcept
+    {
+        if (!src.scale)
+            return LoadSSIMImageRows(src, y0, y1, pDest, pBlocks);
+
+        for (size_t y = y0; y < y1; ++y)
+        {
+            if (!LoadSSIMScaleRow(src, src.scale, y, pDest + (y - y0) * src.width, pTemp, pBlocks))
+                return false;
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Computes SSIM for the output rows [y0, y1) of one scale, optionally with the PSNR-HVS
+    // error of the 8x8 blocks
+    bool SSIMBand(
+        const SSIMSource& src1,
+        const SSIMSource& src2,
+        const SSIMKernel& kernel,
+        size_t y0,
+        size_t y1,
+        _Inout_ XMVECTOR* scratch,
+        bool hvs,
+        SSIMResult& result) noexcept
+    {
+        const size_t width = src1.width;
+        const size_t height = src1.height;
+
+        // Rows are loaded with the filter apron, and taps past the edges are clamped
+        const size_t ylo = (y0 > SSIM_RADIUS) ? (y0 - SSIM_RADIUS) : 0;
+        const size_t yhi = std::min(y1 + SSIM_RADIUS, height);
+        const size_t rowCount = yhi - ylo;
+
+        XMVECTOR* rows1 = scratch;
+        XMVECTOR* rows2 = rows1 + width * (SSIM_BAND_ROWS + SSIM_TAPS - 1);
+        XMVECTOR* lum = rows2 + width * (SSIM_BAND_ROWS + SSIM_TAPS - 1);
+        XMVECTOR* cols = lum + width * (SSIM_BAND_ROWS + SSIM_TAPS - 1);
+        XMVECTOR* blocks = cols + width * 7;
+        XMVECTOR* temp = blocks + src1.image->width * 4;
+
+        if (!LoadSSIMRows(src1, ylo, yhi, rows1, temp, blocks)
+            || !LoadSSIMRows(src2, ylo, yhi, rows2, temp, blocks))
+            return false;
+
+        // Luminance of both images packed as [Y1, Y2, Y1^2, Y2^2]
+        for (size_t i = 0; i < width * rowCount; ++i)
+        {
+            const XMVECTOR l = XMVectorMergeXY(XMVector3Dot(rows1[i], g_Luminance), XMVector3Dot(rows2[i], g_Luminance));
+            lum[i] = XMVectorPermute<0, 1, 4, 5>(l, XMVectorMultiply(l, l));
+        }
+
+        const XMVECTOR c1 = XMVectorReplicate(SSIM_C1);
+        const XMVECTOR c2 = XMVectorReplicate(SSIM_C2);
+
+        memset(&result, 0, sizeof(SSIMResult));
+
+        for (size_t y = y0; y < y1; ++y)
+        {
+            size_t offsets[SSIM_TAPS];
+            for (size_t k = 0; k < SSIM_TAPS; ++k)
+            {
+                const ptrdiff_t yy = std::min<ptrdiff_t>(std::max<ptrdiff_t>(ptrdiff_t(y + k) - ptrdiff_t(SSIM_RADIUS), 0), ptrdiff_t(height) - 1);
+                offsets[k] = (size_t(yy) - ylo) * width;
+            }
+
+            // Vertical pass: means, second moments, and cross moment of each column
+            for (size_t x = 0; x < width; ++x)
+            {
+                XMVECTOR mu1 = g_XMZero, mu2 = g_XMZero, e11 = g_XMZero, e22 = g_XMZero, e12 = g_XMZero;
+                XMVECTOR lumAcc = g_XMZero, lum12 = g_XMZero;
+                for (size_t k = 0; k < SSIM_TAPS; ++k)
+                {
+                    const XMVECTOR w = kernel.weight[k];
+                    const XMVECTOR a = rows1[offsets[k] + x];
+                    const XMVECTOR b = rows2[offsets[k] + x];
+                    const XMVECTOR l = lum[offsets[k] + x];
+
+                    const XMVECTOR wa = XMVectorMultiply(w, a);
+                    const XMVECTOR wb = XMVectorMultiply(w, b);
+                    mu1 = XMVectorAdd(mu1, wa);
+                    mu2 = XMVectorAdd(mu2, wb);
+                    e11 = XMVectorMultiplyAdd(wa, a, e11);
+                    e22 = XMVectorMultiplyAdd(wb, b, e22);
+                    e12 = XMVectorMultiplyAdd(wa, b, e12);
+                    lumAcc = XMVectorMultiplyAdd(w, l, lumAcc);
+                    lum12 = XMVectorMultiplyAdd(XMVectorMultiply(w, XMVectorSplatX(l)), XMVectorSplatY(l), lum12);
+                }
+
+                XMVECTOR* col = cols + x * 7;
+                col[0] = mu1;
+                col[1] = mu2;
+                col[2] = e11;
+                col[3] = e22;
+                col[4] = e12;
+                col[5] = lumAcc;
+                col[6] = lum12;
+            }
+
+            // Horizontal pass and the SSIM terms: l = (2 mu1 mu2 + C1) / (mu1^2 + mu2^2 + C1), cs = (2 s12 + C2) / (s1^2 + s2^2 + C2)
+            XMVECTOR rowSSIM = g_XMZero, rowCS = g_XMZero, rowLumSSIM = g_XMZero, rowLumCS = g_XMZero;
+            for (size_t x = 0; x < width; ++x)
+            {
+                XMVECTOR acc[7] = { g_XMZero, g_XMZero, g_XMZero, g_XMZero, g_XMZero, g_XMZero, g_XMZero };
+                for (size_t k = 0; k < SSIM_TAPS; ++k)
+                {
+                    const ptrdiff_t xx = std::min<ptrdiff_t>(std::max<ptrdiff_t>(ptrdiff_t(x + k) - ptrdiff_t(SSIM_RADIUS), 0), ptrdiff_t(width) - 1);
+                    const XMVECTOR w = kernel.weight[k];
+                    const XMVECTOR* col = cols + size_t(xx) * 7;
+                    for (size_t j = 0; j < 7; ++j)
+                    {
+                        acc[j] = XMVectorMultiplyAdd(w, col[j], acc[j]);
+                    }
+                }
+
+                for (size_t pass = 0; pass < 2; ++pass)
+                {
+                    XMVECTOR mu1, mu2, e11, e22, e12;
+                    if (!pass)
+                    {
+                        mu1 = acc[0]; mu2 = acc[1]; e11 = acc[2]; e22 = acc[3]; e12 = acc[4];
+                    }
+                    else
+                    {
+                        mu1 = XMVectorSplatX(acc[5]); mu2 = XMVectorSplatY(acc[5]);
+                        e11 = XMVectorSplatZ(acc[5]); e22 = XMVectorSplatW(acc[5]); e12 = acc[6];
+                    }
+
+                    const XMVECTOR mu12 = XMVectorMultiply(mu1, mu2);
+                    const XMVECTOR mu11 = XMVectorMultiply(mu1, mu1);
+                    const XMVECTOR mu22 = XMVectorMultiply(mu2, mu2);
+                    const XMVECTOR sigma12 = XMVectorSubtract(e12, mu12);
+                    const XMVECTOR sigma11 = XMVectorSubtract(e11, mu11);
+                    const XMVECTOR sigma22 = XMVectorSubtract(e22, mu22);
+
+                    const XMVECTOR l = XMVectorDivide(XMVectorAdd(XMVectorAdd(mu12, mu12), c1), XMVectorAdd(XMVectorAdd(mu11, mu22), c1));
+                    const XMVECTOR cs = XMVectorDivide(XMVectorAdd(XMVectorAdd(sigma12, sigma12), c2), XMVectorAdd(XMVectorAdd(sigma11, sigma22), c2));
+
+                    if (!pass)
+                    {
+                        rowSSIM = XMVectorMultiplyAdd(l, cs, rowSSIM);
+                        rowCS = XMVectorAdd(rowCS, cs);
+                    }
+                    else
+                    {
+                        rowLumSSIM = XMVectorMultiplyAdd(l, cs, rowLumSSIM);
+                        rowLumCS = XMVectorAdd(rowLumCS, cs);
+                    }
+                }
+            }
+
+            XMFLOAT4 s, c;
+            XMStoreFloat4(&s, rowSSIM);
+            XMStoreFloat4(&c, rowCS);
+            result.ssim[0] += double(s.x); result.ssim[1] += double(s.y); result.ssim[2] += double(s.z); result.ssim[3] += double(s.w);
+            result.cs[0] += double(c.x); result.cs[1] += double(c.y); result.cs[2] += double(c.z); result.cs[3] += double(c.w);
+            result.ssim[4] += double(XMVectorGetX(rowLumSSIM));
+            result.cs[4] += double(XMVectorGetX(rowLumCS));
+        }
+
+        if (hvs)
+        {
+            // PSNR-HVS: contrast sensitivity weighted error of the DCT of each full 8x8 luminance block
+            for (size_t by = y0; by + 8 <= y1; by += 8)
+            {
+                for (size_t bx = 0; bx + 8 <= width; bx += 8)
+                {
+                    float diff[8][8];
+                    for (size_t j = 0; j < 8; ++j)
+                    {
+                        const XMVECTOR* ptr = lum + (by + j - ylo) * width + bx;
+                        for (size_t i = 0; i < 8; ++i)
+                        {
+                            diff[j][i] = XMVectorGetX(ptr[i]) - XMVectorGetY(ptr[i]);
+                        }
+                    }
+
+                    // Rows then columns of the separable DCT
+                    float tmp[8][8];
+                    for (size_t j = 0; j < 8; ++j)
+                    {
+                        for (size_t u = 0; u < 8; ++u)
+                        {
+                            float sum = 0.f;
+                            for (size_t i = 0; i < 8; ++i)
+                                sum += kernel.dct[u][i] * diff[j][i];
+                            tmp[j][u] = sum;
+                        }
+                    }
+
+                    double err = 0.0;
+                    for (size_t v = 0; v < 8; ++v)
+                    {
+                        for (size_t u = 0; u < 8; ++u)
+                        {
+                            float sum = 0.f;
+                            for (size_t j = 0; j < 8; ++j)
+                                sum += kernel.dct[v][j] * tmp[j][u];
+
+                            const float weighted = sum * g_CSF[v][u];
+                            err += double(weighted * weighted);
+                        }
+                    }
+
+                    result.hvs += err;
+                    ++result.hvsBlocks;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Runs SSIMBand over every band of a scale, summing the bands in order so the result
+    // does not depend on the thread count
+    HRESULT SSIMScale(
+        const SSIMSource& src1,
+        const SSIMSource& src2,
+        const SSIMKernel& kernel,
+        bool parallel,
+        bool hvs,
+        SSIMResult& total) noexcept
+    {
+        memset(&total, 0, sizeof(SSIMResult));
+
+        const size_t bands = (src1.height + SSIM_BAND_ROWS - 1) / SSIM_BAND_ROWS;
+        const size_t scratchSize = SSIMScratchSize(src1.width, src1.image->width);
+
+    #ifdef _OPENMP
+        if (parallel && bands > 1)
+        {
+            if (bands > INT32_MAX)
+                return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+            std::unique_ptr<SSIMResult[]> results(new (std::nothrow) SSIMResult[bands]);
+            if (!results)
+                return E_OUTOFMEMORY;
+
+            bool fail = false;
+            bool outOfMemory = false;
+
+            const int nthreads = GetWorkerThreadCount(bands);
+
+#pragma omp parallel num_threads(nthreads)
+            {
+                auto scratch = make_AlignedArrayXMVECTOR(scratchSize);
+                if (!scratch)
+                {
+                    outOfMemory = true;
+                }
+
+#pragma omp for schedule(dynamic)
+                for (int nb = 0; nb < static_cast<int>(bands); ++nb)
+                {
+#pragma omp flush (fail, outOfMemory)
+                    if (fail || outOfMemory)
+                    {
+                        // OpenMP 2.0 does not support cancellation of a 'for' loop.
+                        continue;
+                    }
+
+                    const size_t y0 = static_cast<size_t>(nb) * SSIM_BAND_ROWS;
+                    const size_t y1 = std::min(y0 + SSIM_BAND_ROWS, src1.height);
+                    if (!SSIMBand(src1, src2, kernel, y0, y1, scratch.get(), hvs, results[static_cast<size_t>(nb)]))
+                    {
+                        fail = true;
+                    }
+                }
+            }
+
+            if (outOfMemory)
+                return E_OUTOFMEMORY;
+
+            if (fail)
+                return E_FAIL;
+
+            for (size_t j = 0; j < bands; ++j)
+            {
+                total.Add(results[j]);
+            }
+
+            return S_OK;
+        }
+    #else
+        UNREFERENCED_PARAMETER(parallel);
+    #endif
+
+        auto scratch = make_AlignedArrayXMVECTOR(scratchSize);
+        if (!scratch)
+            return E_OUTOFMEMORY;
+
+        for (size_t y0 = 0; y0 < src1.height; y0 += SSIM_BAND_ROWS)
+        {
+            SSIMResult result;
+            if (!SSIMBand(src1, src2, kernel, y0, std::min(y0 + SSIM_BAND_ROWS, src1.height), scratch.get(), hvs, result))
+                return E_FAIL;
+
+            total.Add(result);
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Content analysis for choosing a BC format
+    //-------------------------------------------------------------------------------------
+    constexpr size_t ANALYZE_BAND_ROWS = 64;    // Multiple of 4 so bands hold whole rows of blocks
+    constexpr float ANALYZE_EPSILON = 0.002f;
+    constexpr float ANALYZE_OPAQUE = 0.997f;    // Same threshold as ScratchImage::IsAlphaAllOpaque
+
+    struct AnalyzeResult
+    {
+        double   error;         // Estimated BC1 RGB squared error summed over all pixels
+        uint64_t pixels;
+        uint64_t normalPixels;
+        float    minv[4];
+        float    maxv[4];
+        bool     alphaOpaque;
+        bool     alphaBinary;
+        bool     grayscale;
+
+        void Reset() noexcept
+        {
+            error = 0.0;
+            pixels = normalPixels = 0;
+            for (size_t j = 0; j < 4; ++j)
+            {
+                minv[j] = FLT_MAX;
+                maxv[j] = -FLT_MAX;
+            }
+            alphaOpaque = alphaBinary = grayscale = true;
+        }
+
+        void Add(const AnalyzeResult& other) noexcept
+        {
+            error += other.error;
+            pixels += other.pixels;
+            normalPixels += other.normalPixels;
+            for (size_t j = 0; j < 4; ++j)
+            {
+                minv[j] = std::min(minv[j], other.minv[j]);
+                maxv[j] = std::max(maxv[j], other.maxv[j]);
+            }
+            alphaOpaque = alphaOpaque && other.alphaOpaque;
+            alphaBinary = alphaBinary && other.alphaBinary;
+            grayscale = grayscale && other.grayscale;
+        }
+    };
+
+    // Estimated BC1 squared RGB error of a block: the spread off its principal axis, the
+    // quantization of the positions along it to four levels, and the 5:6:5 endpoints
+    float EstimateBC1Error(_In_reads_(count) const XMFLOAT4* pixels, size_t count) noexcept
+    {
+        float mean[3] = {};
+        for (size_t j = 0; j < count; ++j)
+        {
+            mean[0] += pixels[j].x;
+            mean[1] += pixels[j].y;
+            mean[2] += pixels[j].z;
+        }
+        for (size_t c = 0; c < 3; ++c)
+            mean[c] /= float(count);
+
+        // Covariance (xx, yy, zz, xy, xz, yz)
+        float cov[6] = {};
+        for (size_t j = 0; j < count; ++j)
+        {
+            const float x = pixels[j].x - mean[0];
+            const float y = pixels[j].y - mean[1];
+            const float z = pixels[j].z - mean[2];
+            cov[0] += x * x;
+            cov[1] += y * y;
+            cov[2] += z * z;
+            cov[3] += x * y;
+            cov[4] += x * z;
+            cov[5] += y * z;
+        }
+        for (size_t c = 0; c < 6; ++c)
+            cov[c] /= float(count);
+
+        constexpr float c_endpointError = (1.f / (31.f * 31.f) + 1.f / (63.f * 63.f) + 1.f / (31.f * 31.f)) / 12.f;
+
+        const float trace = cov[0] + cov[1] + cov[2];
+        if (trace <= 0.f)
+            return c_endpointError * float(count);
+
+        // Power iteration for the principal axis, seeded with the covariance column of the largest
+        // variance; a fixed seed such as (1,1,1) can be orthogonal to the axis (a red/green checker)
+        size_t seed = 0;
+        if (cov[1] > cov[seed])
+            seed = 1;
+        if (cov[2] > cov[seed])
+            seed = 2;
+
+        static const size_t s_column[3][3] = { { 0, 3, 4 }, { 3, 1, 5 }, { 4, 5, 2 } };
+        float axis[3] = { cov[s_column[seed][0]], cov[s_column[seed][1]], cov[s_column[seed][2]] };
+        {
+            const float len = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            axis[0] /= len;
+            axis[1] /= len;
+            axis[2] /= len;
+        }
+
+        float lambda = 0.f;
+        for (size_t iter = 0; iter < 8; ++iter)
+        {
+            const float ax = cov[0] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            const float ay = cov[3] * axis[0] + cov[1] * axis[1] + cov[5] * axis[2];
+            const float az = cov[4] * axis[0] + cov[5] * axis[1] + cov[2] * axis[2];
+
+            const float len = std::sqrt(ax * ax + ay * ay + az * az);
+            if (len <= 0.f)
+                break;
+
+            axis[0] = ax / len;
+            axis[1] = ay / len;
+            axis[2] = az / len;
+            lambda = len;
+        }
+
+        float pmin = FLT_MAX;
+        float pmax = -FLT_MAX;
+        for (size_t j = 0; j < count; ++j)
+        {
+            const float p = (pixels[j].x - mean[0]) * axis[0] + (pixels[j].y - mean[1]) * axis[1] + (pixels[j].z - mean[2]) * axis[2];
+            pmin = std::min(pmin, p);
+            pmax = std::max(pmax, p);
+        }
+
+        const float step = (pmax - pmin) / 3.f;
+        const float perpendicular = std::max(trace - lambda, 0.f);
+
+        return (perpendicular + step * step / 12.f + c_endpointError) * float(count);
+    }
+
+    bool AnalyzeBand(
+        const Image& image,
+        bool snorm,
+        size_t y0,
+        size_t y1,
+        _Inout_updates_(image.width * 4) XMVECTOR* pBand,
+        AnalyzeResult& result) noexcept
+    {
+        result.Reset();
+
+        const size_t width = image.width;
+
+        XMVECTOR minv = g_XMFltMax;
+        XMVECTOR maxv = XMVectorNegate(g_XMFltMax);
+
+        for (size_t y = y0; y < y1; y += 4)
+        {
+            if (!LoadMSEBand(image, y, pBand))
+                return false;
+
+            const size_t rows = std::min<size_t>(4, image.height - y);
+
+            for (size_t x = 0; x < width; x += 4)
+            {
+                const size_t columns = std::min<size_t>(4, width - x);
+
+                XMFLOAT4 block[16];
+                size_t count = 0;
+                for (size_t row = 0; row < rows; ++row)
+                {
+                    for (size_t col = 0; col < columns; ++col)
+                    {
+                        const XMVECTOR v = pBand[row * width + x + col];
+                        minv = XMVectorMin(minv, v);
+                        maxv = XMVectorMax(maxv, v);
+
+                        XMFLOAT4& f = block[count++];
+                        XMStoreFloat4(&f, v);
+
+                        if (f.w < ANALYZE_OPAQUE)
+                        {
+                            result.alphaOpaque = false;
+                            if (f.w > (1.f - ANALYZE_OPAQUE))
+                                result.alphaBinary = false;
+                        }
+
+                        if (std::abs(f.x - f.y) > ANALYZE_EPSILON || std::abs(f.y - f.z) > ANALYZE_EPSILON)
+                            result.grayscale = false;
+
+                        const float nx = (snorm) ? f.x : (f.x * 2.f - 1.f);
+                        const float ny = (snorm) ? f.y : (f.y * 2.f - 1.f);
+                        const float nz = (snorm) ? f.z : (f.z * 2.f - 1.f);
+                        const float length = nx * nx + ny * ny + nz * nz;
+                        if (std::abs(length - 1.f) <= 0.2f && nz >= -0.05f)
+                            ++result.normalPixels;
+                    }
+                }
+
+                result.error += double(EstimateBC1Error(block, count));
+                result.pixels += count;
+            }
+        }
+
+        XMFLOAT4 f;
+        XMStoreFloat4(&f, minv);
+        result.minv[0] = f.x; result.minv[1] = f.y; result.minv[2] = f.z; result.minv[3] = f.w;
+        XMStoreFloat4(&f, maxv);
+        result.maxv[0] = f.x; result.maxv[1] = f.y; result.maxv[2] = f.z; result.maxv[3] = f.w;
+
+        return true;
+    }
+
+    HRESULT AnalyzeImage(const Image& image, bool parallel, AnalyzeResult& total) noexcept
+    {
+        if (!image.pixels)
+            return E_POINTER;
+
+        const bool snorm = (FormatDataType(image.format) == FORMAT_TYPE_SNORM);
+        const size_t bands = (image.height + ANALYZE_BAND_ROWS - 1) / ANALYZE_BAND_ROWS;
+
+        if (bands > INT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        std::unique_ptr<AnalyzeResult[]> results(new (std::nothrow) AnalyzeResult[bands]);
+        if (!results)
+            return E_OUTOFMEMORY;
+
+        auto work = [&](size_t band, XMVECTOR* pBand) -> bool
+            {
+                const size_t y0 = band * ANALYZE_BAND_ROWS;
+                return AnalyzeBand(image, snorm, y0, std::min(y0 + ANALYZE_BAND_ROWS, image.height), pBand, results[band]);
+            };
+
+        const uint64_t scratchSize = uint64_t(image.width) * 4;
+
+        if (parallel)
+        {
+            HRESULT hr = ProcessImageBands(bands, scratchSize, work);
+            if (FAILED(hr))
+                return hr;
+        }
+        else
+        {
+            auto scratch = make_AlignedArrayXMVECTOR(scratchSize);
+            if (!scratch)
+                return E_OUTOFMEMORY;
+
+            for (size_t band = 0; band < bands; ++band)
+            {
+                if (!work(band, scratch.get()))
+                    return E_FAIL;
+            }
+        }
+
+        // Bands are combined in order so the result does not depend on the thread count
+        for (size_t band = 0; band < bands; ++band)
+        {
+            total.Add(results[band]);
+        }
+
+        return S_OK;
+    }
+
+    void RecommendFormat(
+        const AnalyzeResult& total,
+        bool snorm,
+        bool srgb,
+        float targetPSNR,
+        CompressionAnalysis& analysis) noexcept
+    {
+        analysis.alphaOpaque = total.alphaOpaque;
+        analysis.alphaBinary = total.alphaBinary;
+
+        analysis.channels = 1;
+        for (uint32_t c = 1; c < 3; ++c)
+        {
+            if (std::max(std::abs(total.minv[c]), std::abs(total.maxv[c])) > ANALYZE_EPSILON)
+                analysis.channels = c + 1;
+        }
+
+        analysis.highDynamicRange = std::max(total.maxv[0], std::max(total.maxv[1], total.maxv[2])) > (1.f + ANALYZE_EPSILON);
+        analysis.negativeValues = std::min(total.minv[0], std::min(total.minv[1], total.minv[2])) < -ANALYZE_EPSILON;
+
+        analysis.normalMap = !total.grayscale && analysis.channels == 3 && !analysis.highDynamicRange
+            && (total.normalPixels * 20) >= (total.pixels * 19);
+
+        if (total.error > 0.0)
+        {
+            analysis.bc1PSNR = float(10.0 * std::log10(3.0 * double(total.pixels) / total.error));
+        }
+        else
+        {
+            analysis.bc1PSNR = std::numeric_limits<float>::infinity();
+        }
+
+        // BC4, BC5, and BC6H have no alpha channel
+        if (analysis.normalMap && analysis.alphaOpaque)
+        {
+            analysis.format = (snorm) ? DXGI_FORMAT_BC5_SNORM : DXGI_FORMAT_BC5_UNORM;
+        }
+        else if (analysis.alphaOpaque && analysis.channels < 3 && !analysis.highDynamicRange)
+        {
+            if (analysis.channels == 1)
+                analysis.format = (analysis.negativeValues) ? DXGI_FORMAT_BC4_SNORM : DXGI_FORMAT_BC4_UNORM;
+            else
+                analysis.format = (analysis.negativeValues) ? DXGI_FORMAT_BC5_SNORM : DXGI_FORMAT_BC5_UNORM;
+        }
+        else if (analysis.highDynamicRange || analysis.negativeValues)
+        {
+            // No BC format keeps both the range and the alpha, and BC7 would clamp the color
+            analysis.format = (analysis.negativeValues) ? DXGI_FORMAT_BC6H_SF16 : DXGI_FORMAT_BC6H_UF16;
+            analysis.alphaDropped = !analysis.alphaOpaque;
+        }
+        else if (analysis.bc1PSNR >= targetPSNR)
+        {
+            if (analysis.alphaOpaque || analysis.alphaBinary)
+                analysis.format = (srgb) ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+            else
+                analysis.format = (srgb) ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+        }
+        else
+        {
+            analysis.format = (srgb) ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+        }
+    }
+};
+
+
+//=====================================================================================
+// Entry points
+//=====================================================================================
+
+//-------------------------------------------------------------------------------------
+// Copies a rectangle from one image into another
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::CopyRectangle(
+    const Image& srcImage,
+    const Rect& srcRect,
+    const Image& dstImage,
+    TEX_FILTER_FLAGS filter,
+    size_t xOffset,
+    size_t yOffset) noexcept
+{
+    if (!srcImage.pixels || !dstImage.pixels)
+        return E_POINTER;
+
+    if (IsCompressed(srcImage.format) || IsCompressed(dstImage.format)
+        || IsPlanar(srcImage.format) || IsPlanar(dstImage.format)
+        || IsPalettized(srcImage.format) || IsPalettized(dstImage.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    // Validate rectangle/offset
+    if (!srcRect.w || !srcRect.h || ((srcRect.x + srcRect.w) > srcImage.width) || ((srcRect.y + srcRect.h) > srcImage.height))
+    {
+        return E_INVALIDARG;
+    }
+
+    if (((xOffset + srcRect.w) > dstImage.width) || ((yOffset + srcRect.h) > dstImage.height))
+    {
+        return E_INVALIDARG;
+    }
+
+    // Compute source bytes-per-pixel
+    size_t sbpp = BitsPerPixel(srcImage.format);
+    if (!sbpp)
+        return E_FAIL;
+
+    if (sbpp < 8)
+    {
+        // We don't support monochrome (DXGI_FORMAT_R1_UNORM)
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    const uint8_t* pEndSrc = srcImage.pixels + srcImage.rowPitch*srcImage.height;
+    const uint8_t* pEndDest = dstImage.pixels + dstImage.rowPitch*dstImage.height;
+
+    // Round to bytes
+    sbpp = (sbpp + 7) / 8;
+
+    const uint8_t* pSrc = srcImage.pixels + (srcRect.y * srcImage.rowPitch) + (srcRect.x * sbpp);
+
+    if (srcImage.format == dstImage.format)
+    {
+        // Direct copy case (avoid intermediate conversions)
+        uint8_t* pDest = dstImage.pixels + (yOffset * dstImage.rowPitch) + (xOffset * sbpp);
+        const size_t copyW = srcRect.w * sbpp;
+        for (size_t h = 0; h < srcRect.h; ++h)
+        {
+            if (((pSrc + copyW) > pEndSrc) || (pDest > pEndDest))
+                return E_FAIL;
+
+            memcpy(pDest, pSrc, copyW);
+
+            pSrc += srcImage.rowPitch;
+            pDest += dstImage.rowPitch;
+        }
+
+        return S_OK;
+    }
+
+    // Compute destination bytes-per-pixel (not the same format as source)
+    size_t dbpp = BitsPerPixel(dstImage.format);
+    if (!dbpp)
+        return E_FAIL;
+
+    if (dbpp < 8)
+    {
+        // We don't support monochrome (DXGI_FORMAT_R1_UNORM)
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    // Round to bytes
+    dbpp = (dbpp + 7) / 8;
+
+    uint8_t* pDest = dstImage.pixels + (yOffset * dstImage.rowPitch) + (xOffset * dbpp);
+
+    auto scanline = make_AlignedArrayXMVECTOR(srcRect.w);
+    if (!scanline)
+        return E_OUTOFMEMORY;
+
+    const size_t copyS = srcRect.w * sbpp;
+    const size_t copyD = srcRect.w * dbpp;
+
+    for (size_t h = 0; h < srcRect.h; ++h)
+    {
+        if (((pSrc + copyS) > pEndSrc) || ((pDest + copyD) > pEndDest))
+            return E_FAIL;
+
+        if (!LoadScanline(scanline.get(), srcRect.w, pSrc, copyS, srcImage.format))
+            return E_FAIL;
+
+        ConvertScanline(scanline.get(), srcRect.w, dstImage.format, srcImage.format, filter);
+
+        if (!StoreScanline(pDest, copyD, dstImage.format, scanline.get(), srcRect.w))
+            return E_FAIL;
+
+        pSrc += srcImage.rowPitch;
+        pDest += dstImage.rowPitch;
+    }
+
+    return S_OK;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Computes the Mean-Squared-Error (MSE) between two images
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::ComputeMSE(
+    const Image& image1,
+    const Image& image2,
+    float& mse,
+    float* mseV,
+    CMSE_FLAGS flags) noexcept
+{
+    if (!image1.pixels || !image2.pixels)
+        return E_POINTER;
+
+    if (image1.width != image2.width || image1.height != image2.height)
+        return E_INVALIDARG;
 
-            return ComputeMSE_(*img, image2, mse, mseV, flags);
-        }
-    }
-    else
-    {
-        if (IsCompressed(image2.format))
-        {
-            // Case 3: image2 is compressed, expand to RGBA32F
-            ScratchImage temp;
-            HRESULT hr = Decompress(image2, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
-            if (FAILED(hr))
-                return hr;
+    if (!IsValid(image1.format) || !IsValid(image2.format))
+        return E_INVALIDARG;
 
-            const Image* img = temp.GetImage(0, 0, 0);
-            if (!img)
-                return E_POINTER;
+    if (IsPlanar(image1.format) || IsPlanar(image2.format)
+        || IsPalettized(image1.format) || IsPalettized(image2.format)
+        || IsTypeless(image1.format) || IsTypeless(image2.format))
+        return HRESULT_E_NOT_SUPPORTED;
 
-            return ComputeMSE_(image1, *img, mse, mseV, flags);
-        }
-        else
-        {
-            // Case 4: neither image is compressed
-            return ComputeMSE_(image1, image2, mse, mseV, flags);
-        }
-    }
+    // BC images are decoded a row of blocks at a time rather than decompressed up front
+    return ComputeMSE_(image1, image2, mse, mseV, flags);
 }
 
 
 //-------------------------------------------------------------------------------------
-// Evaluates a user-supplied function for all the pixels in the image
+// Computes perceptual quality metrics (SSIM, MS-SSIM, PSNR-HVS) between two images
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT DirectX::EvaluateImage(
-    const Image& image,
-    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc)
+HRESULT DirectX::ComputeImageQuality(
+    const Image& image1,
+    const Image& image2,
+    ImageQuality& quality,
+    CMSE_FLAGS flags) noexcept
 {
-    if (image.width > UINT32_MAX
-        || image.height > UINT32_MAX)
+    quality = {};
+
+    if (!image1.pixels || !image2.pixels)
+        return E_POINTER;
+
+    if (image1.width != image2.width || image1.height != image2.height)
         return E_INVALIDARG;
 
-    if (!IsValid(image.format))
+    if (!IsValid(image1.format) || !IsValid(image2.format))
         return E_INVALIDARG;
 
-    if (IsPlanar(image.format) || IsPalettized(image.format) || IsTypeless(image.format))
+    if (IsPlanar(image1.format) || IsPlanar(image2.format)
+        || IsPalettized(image1.format) || IsPalettized(image2.format)
+        || IsTypeless(image1.format) || IsTypeless(image2.format))
         return HRESULT_E_NOT_SUPPORTED;
 
-    if (IsCompressed(image.format))
+    // Same implied flags as ComputeMSE
+    flags = GetImpliedMSEFlags(
+        IsCompressed(image1.format) ? DXGI_FORMAT_R32G32B32A32_FLOAT : image1.format,
+        IsCompressed(image2.format) ? DXGI_FORMAT_R32G32B32A32_FLOAT : image2.format,
+        flags);
+
+    const SSIMKernel kernel;
+    const bool parallel = (flags & CMSE_PARALLEL) != 0;
+
+    SSIMSource src1 = { &image1, 0, image1.width, image1.height, (flags & CMSE_IMAGE1_SRGB) != 0, (flags & CMSE_IMAGE1_X2_BIAS) != 0 };
+    SSIMSource src2 = { &image2, 0, image2.width, image2.height, (flags & CMSE_IMAGE2_SRGB) != 0, (flags & CMSE_IMAGE2_X2_BIAS) != 0 };
+
+    // Use as many of the five MS-SSIM scales as keep the window inside the image
+    size_t scales = 1;
+    for (size_t w = image1.width / 2, h = image1.height / 2; scales < SSIM_MAX_SCALES && std::min(w, h) >= SSIM_TAPS; w /= 2, h /= 2)
+        ++scales;
+
+    double msssim[SSIM_CHANNELS] = { 1.0, 1.0, 1.0, 1.0, 1.0 };
+    float weightSum = 0.f;
+    for (size_t s = 0; s < scales; ++s)
+        weightSum += g_MSSSIMWeights[s];
+
+    for (size_t s = 0; s < scales; ++s)
     {
-        ScratchImage temp;
-        HRESULT hr = Decompress(image, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
+        const bool last = (s + 1) == scales;
+
+        SSIMResult result;
+        const HRESULT hr = SSIMScale(src1, src2, kernel, parallel, (s == 0), result);
         if (FAILED(hr))
             return hr;
 
-        const Image* img = temp.GetImage(0, 0, 0);
-        if (!img)
-            return E_POINTER;
+        const double pixels = double(src1.width) * double(src1.height);
+        const double weight = double(g_MSSSIMWeights[s] / weightSum);
+        for (size_t j = 0; j < SSIM_CHANNELS; ++j)
+        {
+            const double ssim = result.ssim[j] / pixels;
+            const double cs = result.cs[j] / pixels;
+
+            if (s == 0)
+            {
+                if (j < 4)
+                    quality.ssim[j] = float(ssim);
+                else
+                    quality.ssimLuminance = float(ssim);
+            }
+
+            // Coarser scales contribute contrast-structure only, and the last scale also contributes luminance
+            msssim[j] *= std::pow(std::max(last ? ssim : cs, 0.0), weight);
+        }
+
+        if (s == 0)
+        {
+            if (!result.hvsBlocks)
+            {
+                quality.psnrHVS = 0.f;
+            }
+            else if (result.hvs <= 0.0)
+            {
+                quality.psnrHVS = std::numeric_limits<float>::infinity();
+            }
+            else
+            {
+                quality.psnrHVS = float(10.0 * std::log10(double(result.hvsBlocks) * 64.0 / result.hvs));
+            }
+        }
 
-        return EvaluateImage_(*img, pixelFunc);
+        ++src1.scale;
+        src1.width /= 2;
+        src1.height /= 2;
+        ++src2.scale;
+        src2.width /= 2;
+        src2.height /= 2;
     }
-    else
+
+    for (size_t j = 0; j < 4; ++j)
     {
-        return EvaluateImage_(image, pixelFunc);
+        quality.msssim[j] = float(msssim[j]);
     }
+    quality.msssimLuminance = float(msssim[4]);
+
+    return S_OK;
 }
 
+
+//-------------------------------------------------------------------------------------
+// Recommends a BC format from the content of the image(s)
+//-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT DirectX::EvaluateImage(
+HRESULT DirectX::AnalyzeForCompression(
+    const Image& image,
+    TEX_COMPRESS_FLAGS compress,
+    float targetPSNR,
+    CompressionAnalysis& analysis) noexcept
+{
+    TexMetadata mdata = {};
+    mdata.width = image.width;
+    mdata.height = image.height;
+    mdata.depth = mdata.arraySize = mdata.mipLevels = 1;
+    mdata.format = image.format;
+    mdata.dimension = TEX_DIMENSION_TEXTURE2D;
+
+    return AnalyzeForCompression(&image, 1, mdata, compress, targetPSNR, analysis);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::AnalyzeForCompression(
     const Image* images,
     size_t nimages,
     const TexMetadata& metadata,
-    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc)
+    TEX_COMPRESS_FLAGS compress,
+    float targetPSNR,
+    CompressionAnalysis& analysis) noexcept
 {
+    analysis = {};
+
     if (!images || !nimages)
         return E_INVALIDARG;
 
@@ -525,243 +1969,253 @@ HRESULT DirectX::EvaluateImage(
         || metadata.height > UINT32_MAX)
         return E_INVALIDARG;
 
-    if (metadata.IsVolumemap() && metadata.depth > UINT16_MAX)
-        return E_INVALIDARG;
+    const bool parallel = (compress & TEX_COMPRESS_PARALLEL) != 0;
 
-    ScratchImage temp;
-    DXGI_FORMAT format = metadata.format;
-    if (IsCompressed(format))
+    AnalyzeResult total;
+    total.Reset();
+
+    for (size_t index = 0; index < nimages; ++index)
     {
-        HRESULT hr = Decompress(images, nimages, metadata, DXGI_FORMAT_R32G32B32A32_FLOAT, temp);
+        const Image& img = images[index];
+        if (img.format != metadata.format)
+            return E_FAIL;
+
+        if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
+            return E_FAIL;
+
+        HRESULT hr = AnalyzeImage(img, parallel, total);
         if (FAILED(hr))
             return hr;
+    }
 
-        if (nimages != temp.GetImageCount())
-            return E_UNEXPECTED;
+    const bool snorm = (FormatDataType(metadata.format) == FORMAT_TYPE_SNORM);
+    const bool srgb = IsSRGB(metadata.format) || (compress & TEX_COMPRESS_SRGB_OUT);
 
-        images = temp.GetImages();
-        format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-    }
+    RecommendFormat(total, snorm, srgb, targetPSNR, analysis);
 
-    switch (metadata.dimension)
-    {
-    case TEX_DIMENSION_TEXTURE1D:
-    case TEX_DIMENSION_TEXTURE2D:
-        for (size_t index = 0; index < nimages; ++index)
-        {
-            const Image& img = images[index];
-            if (img.format != format)
-                return E_FAIL;
+    return S_OK;
+}
 
-            if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
-                return E_FAIL;
 
-            HRESULT hr = EvaluateImage_(img, pixelFunc);
-            if (FAILED(hr))
-                return hr;
-        }
-        break;
+//-------------------------------------------------------------------------------------
+// Evaluates a user-supplied function for all the pixels in the image
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::EvaluateImage(
+    const Image& image,
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc)
+{
+    auto evaluate = [&](const Image& img) -> HRESULT
+        {
+            return EvaluateImage_(img, pixelFunc);
+        };
+
+    return EvaluateImages(image, evaluate);
+}
 
-    case TEX_DIMENSION_TEXTURE3D:
+_Use_decl_annotations_
+HRESULT DirectX::EvaluateImage(
+    const Image* images,
+    size_t nimages,
+    const TexMetadata& metadata,
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y)> pixelFunc)
+{
+    auto evaluate = [&](const Image& img) -> HRESULT
         {
-            size_t index = 0;
-            size_t d = metadata.depth;
-            for (size_t level = 0; level < metadata.mipLevels; ++level)
-            {
-                for (size_t slice = 0; slice < d; ++slice, ++index)
-                {
-                    if (index >= nimages)
-                        return E_FAIL;
+            return EvaluateImage_(img, pixelFunc);
+        };
 
-                    const Image& img = images[index];
-                    if (img.format != format)
-                        return E_FAIL;
+    return EvaluateImages(images, nimages, metadata, evaluate);
+}
 
-                    if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
-                        return E_FAIL;
+_Use_decl_annotations_
+HRESULT DirectX::EvaluateImage(
+    const Image& image,
+    size_t bands,
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t band)> pixelFunc,
+    std::function<void __cdecl(size_t band)> combineFunc)
+{
+    if (!bands || bands > INT32_MAX)
+        return E_INVALIDARG;
 
-                    HRESULT hr = EvaluateImage_(img, pixelFunc);
-                    if (FAILED(hr))
-                        return hr;
-                }
+    auto evaluate = [&](const Image& img) -> HRESULT
+        {
+            return EvaluateImageBands_(img, 0, img.height, bands, pixelFunc);
+        };
 
-                if (d > 1)
-                    d >>= 1;
-            }
-        }
-        break;
+    HRESULT hr = EvaluateImages(image, evaluate);
+    if (FAILED(hr))
+        return hr;
 
-    default:
-        return E_FAIL;
+    if (combineFunc)
+    {
+        for (size_t band = 0; band < bands; ++band)
+        {
+            combineFunc(band);
+        }
     }
 
     return S_OK;
 }
 
-
-//-------------------------------------------------------------------------------------
-// Use a user-supplied function to compute a new image from an input image
-//-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT DirectX::TransformImage(
-    const Image& image,
-    std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
-    ScratchImage& result)
+HRESULT DirectX::EvaluateImage(
+    const Image* images,
+    size_t nimages,
+    const TexMetadata& metadata,
+    size_t bands,
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t band)> pixelFunc,
+    std::function<void __cdecl(size_t band)> combineFunc)
 {
-    if (image.width > UINT32_MAX
-        || image.height > UINT32_MAX)
+    if (!bands || bands > INT32_MAX)
         return E_INVALIDARG;
 
-    if (IsPlanar(image.format) || IsPalettized(image.format) || IsCompressed(image.format) || IsTypeless(image.format))
-        return HRESULT_E_NOT_SUPPORTED;
+    auto evaluate = [&](const Image& img) -> HRESULT
+        {
+            return EvaluateImageBands_(img, 0, img.height, bands, pixelFunc);
+        };
 
-    HRESULT hr = result.Initialize2D(image.format, image.width, image.height, 1, 1);
+    HRESULT hr = EvaluateImages(images, nimages, metadata, evaluate);
     if (FAILED(hr))
         return hr;
 
-    const Image* dimg = result.GetImage(0, 0, 0);
-    if (!dimg)
-    {
-        result.Release();
-        return E_POINTER;
-    }
-
-    hr = TransformImage_(image, pixelFunc, *dimg);
-    if (FAILED(hr))
+    if (combineFunc)
     {
-        result.Release();
-        return hr;
+        for (size_t band = 0; band < bands; ++band)
+        {
+            combineFunc(band);
+        }
     }
 
     return S_OK;
 }
 
 _Use_decl_annotations_
-HRESULT DirectX::TransformImage(
-    const Image* srcImages,
-    size_t nimages, const TexMetadata& metadata,
-    std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
-    ScratchImage& result)
+HRESULT DirectX::EvaluateImage(
+    const Image& image,
+    size_t y0,
+    size_t y1,
+    size_t bands,
+    std::function<void __cdecl(_In_reads_(width) const XMVECTOR* pixels, size_t width, size_t y, size_t band)> pixelFunc,
+    std::function<void __cdecl(size_t band)> combineFunc)
 {
-    if (!srcImages || !nimages)
+    if (!bands || bands > INT32_MAX)
         return E_INVALIDARG;
 
-    if (IsPlanar(metadata.format) || IsPalettized(metadata.format) || IsCompressed(metadata.format) || IsTypeless(metadata.format))
-        return HRESULT_E_NOT_SUPPORTED;
-
-    if (metadata.width > UINT32_MAX
-        || metadata.height > UINT32_MAX)
+    if (y0 > y1 || y1 > image.height)
         return E_INVALIDARG;
 
-    if (metadata.IsVolumemap() && metadata.depth > UINT16_MAX)
-        return E_INVALIDARG;
+    auto evaluate = [&](const Image& img) -> HRESULT
+        {
+            return EvaluateImageBands_(img, y0, y1, bands, pixelFunc);
+        };
 
-    HRESULT hr = result.Initialize(metadata);
+    HRESULT hr = EvaluateImages(image, evaluate);
     if (FAILED(hr))
         return hr;
 
-    if (nimages != result.GetImageCount())
+    if (combineFunc)
     {
-        result.Release();
-        return E_FAIL;
+        for (size_t band = 0; band < bands; ++band)
+        {
+            combineFunc(band);
+        }
     }
 
-    const Image* dest = result.GetImages();
-    if (!dest)
-    {
-        result.Release();
-        return E_POINTER;
-    }
+    return S_OK;
+}
 
-    switch (metadata.dimension)
-    {
-    case TEX_DIMENSION_TEXTURE1D:
-    case TEX_DIMENSION_TEXTURE2D:
-        for (size_t index = 0; index < nimages; ++index)
+
+//-------------------------------------------------------------------------------------
+// Use a user-supplied function to compute a new image from an input image
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::TransformImage(
+    const Image& image,
+    std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+    ScratchImage& result)
+{
+    auto transform = [&](const Image& src, const Image& dst) -> HRESULT
         {
-            const Image& src = srcImages[index];
-            if (src.format != metadata.format)
-            {
-                result.Release();
-                return E_FAIL;
-            }
+            return TransformImage_(src, pixelFunc, dst);
+        };
 
-            if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
-            {
-                result.Release();
-                return E_FAIL;
-            }
+    return TransformImages(image, transform, result);
+}
 
-            const Image& dst = dest[index];
+_Use_decl_annotations_
+HRESULT DirectX::TransformImage(
+    const Image* srcImages,
+    size_t nimages, const TexMetadata& metadata,
+    std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+    ScratchImage& result)
+{
+    auto transform = [&](const Image& src, const Image& dst) -> HRESULT
+        {
+            return TransformImage_(src, pixelFunc, dst);
+        };
 
-            if (src.width != dst.width || src.height != dst.height)
-            {
-                result.Release();
-                return E_FAIL;
-            }
+    return TransformImages(srcImages, nimages, metadata, transform, result);
+}
 
-            hr = TransformImage_(src, pixelFunc, dst);
-            if (FAILED(hr))
-            {
-                result.Release();
-                return hr;
-            }
-        }
-        break;
+_Use_decl_annotations_
+HRESULT DirectX::TransformImage(
+    const Image& image,
+    size_t bands,
+    std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+    ScratchImage& result)
+{
+    if (!bands || bands > INT32_MAX)
+        return E_INVALIDARG;
 
-    case TEX_DIMENSION_TEXTURE3D:
+    auto transform = [&](const Image& src, const Image& dst) -> HRESULT
         {
-            size_t index = 0;
-            size_t d = metadata.depth;
-            for (size_t level = 0; level < metadata.mipLevels; ++level)
-            {
-                for (size_t slice = 0; slice < d; ++slice, ++index)
-                {
-                    if (index >= nimages)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
+            return TransformImageBands_(src, 0, src.height, bands, pixelFunc, dst);
+        };
 
-                    const Image& src = srcImages[index];
-                    if (src.format != metadata.format)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
+    return TransformImages(image, transform, result);
+}
 
-                    if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
+_Use_decl_annotations_
+HRESULT DirectX::TransformImage(
+    const Image* srcImages,
+    size_t nimages, const TexMetadata& metadata,
+    size_t bands,
+    std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+    ScratchImage& result)
+{
+    if (!bands || bands > INT32_MAX)
+        return E_INVALIDARG;
 
-                    const Image& dst = dest[index];
+    auto transform = [&](const Image& src, const Image& dst) -> HRESULT
+        {
+            return TransformImageBands_(src, 0, src.height, bands, pixelFunc, dst);
+        };
 
-                    if (src.width != dst.width || src.height != dst.height)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
+    return TransformImages(srcImages, nimages, metadata, transform, result);
+}
 
-                    hr = TransformImage_(src, pixelFunc, dst);
-                    if (FAILED(hr))
-                    {
-                        result.Release();
-                        return hr;
-                    }
-                }
+_Use_decl_annotations_
+HRESULT DirectX::TransformImage(
+    const Image& srcImage,
+    size_t y0,
+    size_t y1,
+    size_t bands,
+    std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+    const Image& destImage)
+{
+    if (!bands || bands > INT32_MAX)
+        return E_INVALIDARG;
 
-                if (d > 1)
-                    d >>= 1;
-            }
-        }
-        break;
+    if (srcImage.width > UINT32_MAX
+        || srcImage.height > UINT32_MAX)
+        return E_INVALIDARG;
 
-    default:
-        result.Release();
-        return E_FAIL;
-    }
+    if (y0 > y1 || y1 > srcImage.height)
+        return E_INVALIDARG;
 
-    return S_OK;
+    if (IsPlanar(srcImage.format) || IsPalettized(srcImage.format) || IsCompressed(srcImage.format) || IsTypeless(srcImage.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    return TransformImageBands_(srcImage, y0, y1, bands, pixelFunc, destImage);
 }
@@ -151,6 +151,10 @@
 #include <new>
 #include <tuple>
 
+#ifdef DIRECTX_TEX_INSTRUMENTATION
+#include <chrono>
+#endif
+
 #ifndef _WIN32
 #include <fstream>
 #include <filesystem>
@@ -410,6 +414,16 @@ namespace DirectX
             _Out_writes_bytes_(size) void* pDestination, _In_ size_t size, _In_ DXGI_FORMAT format,
             _In_reads_(count) const XMVECTOR* pSource, _In_ size_t count, _In_ float threshold = 0) noexcept;
 
+        _Success_(return) bool __cdecl LoadScanlineScalar(
+            _Out_writes_(count) XMVECTOR* pDestination, _In_ size_t count,
+            _In_reads_bytes_(size) const void* pSource, _In_ size_t size,
+            _In_ DXGI_FORMAT format) noexcept;
+
+        _Success_(return) bool __cdecl StoreScanlineScalar(
+            _Out_writes_bytes_(size) void* pDestination, _In_ size_t size, _In_ DXGI_FORMAT format,
+            _In_reads_(count) const XMVECTOR* pSource, _In_ size_t count, _In_ float threshold = 0) noexcept;
+            // Per-pixel conversions that LoadScanline/StoreScanline fall back to when there is no vectorized path for the format
+
         _Success_(return) bool __cdecl StoreScanlineLinear(
             _Out_writes_bytes_(size) void* pDestination, _In_ size_t size, _In_ DXGI_FORMAT format,
             _Inout_updates_all_(count) XMVECTOR* pSource, _In_ size_t count,
@@ -441,10 +455,73 @@ namespace DirectX
         //---------------------------------------------------------------------------------
         // Misc helper functions
         bool __cdecl IsAlphaAllOpaqueBC(_In_ const Image& cImage) noexcept;
+        bool __cdecl DecompressBlockRow(_In_ const Image& cImage, _In_ size_t y,
+            _Out_writes_(cImage.width * 4) XMVECTOR* pDest, _In_ DXGI_FORMAT format) noexcept;
         bool __cdecl CalculateMipLevels(_In_ size_t width, _In_ size_t height, _Inout_ size_t& mipLevels) noexcept;
         bool __cdecl CalculateMipLevels3D(_In_ size_t width, _In_ size_t height, _In_ size_t depth,
             _Inout_ size_t& mipLevels) noexcept;
 
+        int __cdecl GetWorkerThreadCount(_In_ size_t workItems) noexcept;
+            // Number of threads to use for a parallel region with the given amount of work (honors SetMaxThreadCount)
+
+    #ifdef DIRECTX_TEX_INSTRUMENTATION
+        //---------------------------------------------------------------------------------
+        // Instrumentation counters (use the TEX_INSTRUMENT_* macros so disabled builds compile them out)
+        void __cdecl AddStageTime(_In_ TEX_STAGE stage, _In_ uint64_t nanoseconds) noexcept;
+        void __cdecl AddEncodeTime(_In_ DXGI_FORMAT format, _In_ size_t blocks, _In_ uint64_t nanoseconds) noexcept;
+        void __cdecl AddBytesRead(_In_ uint64_t bytes) noexcept;
+        void __cdecl AddBytesWritten(_In_ uint64_t bytes) noexcept;
+        void __cdecl AddAllocation(_In_ uint64_t bytes) noexcept;
+
+        inline uint64_t __cdecl ElapsedNanoseconds(std::chrono::steady_clock::time_point start) noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        class StageTimer
+        {
+        public:
+            explicit StageTimer(TEX_STAGE stage) noexcept : m_stage(stage), m_start(std::chrono::steady_clock::now()) {}
+            ~StageTimer() { AddStageTime(m_stage, ElapsedNanoseconds(m_start)); }
+
+            StageTimer(const StageTimer&) = delete;
+            StageTimer& operator=(const StageTimer&) = delete;
+
+        private:
+            TEX_STAGE                               m_stage;
+            std::chrono::steady_clock::time_point   m_start;
+        };
+
+        class EncodeTimer
+        {
+        public:
+            EncodeTimer(DXGI_FORMAT format, size_t blocks) noexcept : m_format(format), m_blocks(blocks), m_start(std::chrono::steady_clock::now()) {}
+            ~EncodeTimer() { AddEncodeTime(m_format, m_blocks, ElapsedNanoseconds(m_start)); }
+
+            EncodeTimer(const EncodeTimer&) = delete;
+            EncodeTimer& operator=(const EncodeTimer&) = delete;
+
+        private:
+            DXGI_FORMAT                             m_format;
+            size_t                                  m_blocks;
+            std::chrono::steady_clock::time_point   m_start;
+        };
+
+    #ifdef _WIN32
+        inline uint64_t __cdecl GetFileLength(_In_ HANDLE hFile) noexcept
+        {
+            LARGE_INTEGER fileSize = {};
+            return GetFileSizeEx(hFile, &fileSize) ? static_cast<uint64_t>(fileSize.QuadPart) : 0;
+        }
+    #else
+        inline uint64_t __cdecl GetFileLength(std::ofstream& outFile)
+        {
+            const std::streampos pos = outFile.tellp();
+            return (pos > 0) ? static_cast<uint64_t>(pos) : 0;
+        }
+    #endif
+    #endif // DIRECTX_TEX_INSTRUMENTATION
+
     #ifdef _WIN32
         HRESULT __cdecl ResizeSeparateColorAndAlpha(_In_ IWICImagingFactory* pWIC,
             _In_ bool iswic2,
@@ -453,5 +530,76 @@ namespace DirectX
             _Inout_ const Image* img) noexcept;
     #endif
 
+        //---------------------------------------------------------------------------------
+        // Buffered file input for ImageReader
+        class ImageReaderFile
+        {
+        public:
+            ImageReaderFile() noexcept : m_size(0), m_filePos(0), m_capacity(0), m_begin(0), m_end(0) {}
+
+            ImageReaderFile(const ImageReaderFile&) = delete;
+            ImageReaderFile& operator=(const ImageReaderFile&) = delete;
+
+            HRESULT __cdecl Open(_In_z_ const wchar_t* szFile) noexcept;
+
+            uint64_t __cdecl GetSize() const noexcept { return m_size; }
+            uint64_t __cdecl Tell() const noexcept { return m_filePos - (m_end - m_begin); }
+
+            HRESULT __cdecl Seek(_In_ uint64_t pos, _In_ size_t bytes = 0) noexcept;
+                // 'bytes' is the size of the read that follows, if known; it keeps backward seeks from refilling forward
+            HRESULT __cdecl Read(_Out_writes_bytes_(bytes) void* pDest, _In_ size_t bytes) noexcept;
+
+            HRESULT __cdecl Peek(_In_ size_t bytes, _Outptr_ const uint8_t** ppData, _Out_ size_t& available) noexcept;
+                // Returns a contiguous view of at least 'bytes' bytes at the current position, or up to the end of the file
+            void __cdecl Skip(_In_ size_t bytes) noexcept;
+                // Consumes bytes previously returned by Peek
+
+        private:
+        #ifdef _WIN32
+            ScopedHandle                m_handle;
+        #else
+            std::ifstream               m_file;
+        #endif
+            std::unique_ptr<uint8_t[]>  m_buffer;
+            uint64_t                    m_size;
+            uint64_t                    m_filePos;
+            size_t                      m_capacity;
+            size_t                      m_begin;
+            size_t                      m_end;
+
+            HRESULT __cdecl Fill(_In_ size_t bytes) noexcept;
+            HRESULT __cdecl ReadBlock(_In_ size_t bytes) noexcept;
+        };
+
     } // namespace Internal
+
+    //-------------------------------------------------------------------------------------
+    // Format-specific row producer for ImageReader
+    struct ImageReader::Source
+    {
+        virtual ~Source() = default;
+
+        virtual HRESULT __cdecl Seek(_In_ size_t mip, _In_ size_t item, _In_ size_t slice, _Out_ Image& image) noexcept = 0;
+            // Positions at the first row of the subresource and returns its layout (pixels is nullptr)
+
+        virtual HRESULT __cdecl ReadRow(_Out_writes_bytes_(rowPitch) uint8_t* pDest, _In_ size_t rowPitch) noexcept = 0;
+            // Rows are always returned top-down in the format reported by Seek
+
+        std::unique_ptr<uint8_t[]> scanline;
+        size_t scanlineSize = 0;
+    };
 } // namespace DirectX
+
+#ifdef DIRECTX_TEX_INSTRUMENTATION
+#define TEX_INSTRUMENT_STAGE(stage) const DirectX::Internal::StageTimer texStageTimer(stage)
+#define TEX_INSTRUMENT_ENCODE(format, blocks) const DirectX::Internal::EncodeTimer texEncodeTimer(format, blocks)
+#define TEX_INSTRUMENT_BYTES_READ(bytes) DirectX::Internal::AddBytesRead(bytes)
+#define TEX_INSTRUMENT_FILE_WRITTEN(file) DirectX::Internal::AddBytesWritten(DirectX::Internal::GetFileLength(file))
+#define TEX_INSTRUMENT_ALLOCATION(bytes) DirectX::Internal::AddAllocation(bytes)
+#else
+#define TEX_INSTRUMENT_STAGE(stage)
+#define TEX_INSTRUMENT_ENCODE(format, blocks)
+#define TEX_INSTRUMENT_BYTES_READ(bytes)
+#define TEX_INSTRUMENT_FILE_WRITTEN(file)
+#define TEX_INSTRUMENT_ALLOCATION(bytes)
+#endif
@@ -0,0 +1,430 @@
+//-------------------------------------------------------------------------------------
+// DirectXTexReader.cpp
+//
+// DirectX Texture Library - Streaming image reader
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//-------------------------------------------------------------------------------------
+
+#include "DirectXTexP.h"
+
+using namespace DirectX;
+using namespace DirectX::Internal;
+
+namespace
+{
+    constexpr size_t READER_BUFFER_SIZE = 256 * 1024;
+}
+
+
+//=====================================================================================
+// ImageReaderFile
+//=====================================================================================
+
+_Use_decl_annotations_
+HRESULT ImageReaderFile::Open(const wchar_t* szFile) noexcept
+{
+    if (!szFile)
+        return E_INVALIDARG;
+
+    m_size = m_filePos = 0;
+    m_begin = m_end = 0;
+
+#ifdef _WIN32
+    m_handle.reset(safe_handle(CreateFile2(
+        szFile,
+        GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING,
+        nullptr)));
+    if (!m_handle)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    FILE_STANDARD_INFO fileInfo;
+    if (!GetFileInformationByHandleEx(m_handle.get(), FileStandardInfo, &fileInfo, sizeof(fileInfo)))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    m_size = static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart);
+#else // !WIN32
+    m_file.open(std::filesystem::path(szFile), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!m_file)
+        return E_FAIL;
+
+    const std::streampos fileLen = m_file.tellg();
+    if (!m_file)
+        return E_FAIL;
+
+    m_file.seekg(0, std::ios::beg);
+    if (!m_file)
+        return E_FAIL;
+
+    m_size = static_cast<uint64_t>(fileLen);
+#endif
+
+    if (!m_buffer)
+    {
+        m_buffer.reset(new (std::nothrow) uint8_t[READER_BUFFER_SIZE]);
+        if (!m_buffer)
+            return E_OUTOFMEMORY;
+
+        m_capacity = READER_BUFFER_SIZE;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReaderFile::Seek(uint64_t pos, size_t bytes) noexcept
+{
+    if (pos > m_size)
+        return HRESULT_E_HANDLE_EOF;
+
+    // Reuse the buffer if the target is already resident
+    const uint64_t bufferStart = m_filePos - m_end;
+    if (pos >= bufferStart && pos <= m_filePos)
+    {
+        m_begin = static_cast<size_t>(pos - bufferStart);
+        return S_OK;
+    }
+
+    // Going backwards (bottom-up TGA rows), load the window that ends with the requested range so the
+    // preceding rows are resident for the next seeks, rather than reading forward from every target
+    const uint64_t end = std::min(pos + bytes, m_size);
+    const bool backward = (bytes > 0) && (bytes <= m_capacity) && (pos < bufferStart);
+    const uint64_t target = (!backward) ? pos : ((end > m_capacity) ? (end - m_capacity) : 0);
+
+#ifdef _WIN32
+    LARGE_INTEGER filePos;
+    filePos.QuadPart = static_cast<LONGLONG>(target);
+    if (!SetFilePointerEx(m_handle.get(), filePos, nullptr, FILE_BEGIN))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+#else
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(target), std::ios::beg);
+    if (!m_file)
+        return E_FAIL;
+#endif
+
+    m_filePos = target;
+    m_begin = m_end = 0;
+
+    if (backward)
+    {
+        const size_t count = static_cast<size_t>(end - target);
+        while (m_end < count)
+        {
+            const HRESULT hr = ReadBlock(count - m_end);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        m_begin = static_cast<size_t>(pos - target);
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReaderFile::Fill(size_t bytes) noexcept
+{
+    const uint64_t remaining = m_size - Tell();
+    if (bytes > remaining)
+        bytes = static_cast<size_t>(remaining);
+
+    if ((m_end - m_begin) >= bytes)
+        return S_OK;
+
+    if ((m_capacity - m_begin) < bytes)
+    {
+        // Move unread data to the front, growing the buffer if a single request needs more room
+        const size_t pending = m_end - m_begin;
+        if (m_capacity < bytes)
+        {
+            const size_t capacity = std::max(bytes * 2, READER_BUFFER_SIZE);
+            std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[capacity]);
+            if (!buffer)
+                return E_OUTOFMEMORY;
+
+            if (pending > 0)
+            {
+                memcpy(buffer.get(), m_buffer.get() + m_begin, pending);
+            }
+
+            m_buffer = std::move(buffer);
+            m_capacity = capacity;
+        }
+        else if (pending > 0)
+        {
+            memmove(m_buffer.get(), m_buffer.get() + m_begin, pending);
+        }
+
+        m_begin = 0;
+        m_end = pending;
+    }
+
+    while ((m_end - m_begin) < bytes)
+    {
+        const size_t request = static_cast<size_t>(std::min<uint64_t>(m_capacity - m_end, m_size - m_filePos));
+        if (!request)
+            return HRESULT_E_HANDLE_EOF;
+
+        const HRESULT hr = ReadBlock(request);
+        if (FAILED(hr))
+            return hr;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReaderFile::ReadBlock(size_t bytes) noexcept
+{
+#ifdef _WIN32
+    DWORD bytesRead = 0;
+    if (!ReadFile(m_handle.get(), m_buffer.get() + m_end, static_cast<DWORD>(std::min<size_t>(bytes, UINT32_MAX)), &bytesRead, nullptr))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    if (!bytesRead)
+        return HRESULT_E_HANDLE_EOF;
+
+    const size_t count = bytesRead;
+#else
+    m_file.read(reinterpret_cast<char*>(m_buffer.get() + m_end), static_cast<std::streamsize>(bytes));
+    if (!m_file)
+        return E_FAIL;
+
+    const size_t count = bytes;
+#endif
+
+    m_end += count;
+    m_filePos += count;
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReaderFile::Read(void* pDest, size_t bytes) noexcept
+{
+    if (!pDest)
+        return E_POINTER;
+
+    if (bytes > (m_size - Tell()))
+        return HRESULT_E_HANDLE_EOF;
+
+    auto ptr = static_cast<uint8_t*>(pDest);
+    while (bytes > 0)
+    {
+        if (m_begin == m_end)
+        {
+            const HRESULT hr = Fill(std::min(bytes, m_capacity));
+            if (FAILED(hr))
+                return hr;
+        }
+
+        const size_t count = std::min(bytes, m_end - m_begin);
+        memcpy(ptr, m_buffer.get() + m_begin, count);
+        m_begin += count;
+        ptr += count;
+        bytes -= count;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReaderFile::Peek(size_t bytes, const uint8_t** ppData, size_t& available) noexcept
+{
+    if (!ppData)
+        return E_POINTER;
+
+    *ppData = nullptr;
+    available = 0;
+
+    const HRESULT hr = Fill(bytes);
+    if (FAILED(hr))
+        return hr;
+
+    *ppData = m_buffer.get() + m_begin;
+    available = m_end - m_begin;
+    return S_OK;
+}
+
+_Use_decl_annotations_
+void ImageReaderFile::Skip(size_t bytes) noexcept
+{
+    assert(bytes <= (m_end - m_begin));
+    m_begin += std::min(bytes, m_end - m_begin);
+}
+
+
+//=====================================================================================
+// ImageReader
+//=====================================================================================
+
+ImageReader& ImageReader::operator= (ImageReader&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
+    {
+        Close();
+
+        m_source = moveFrom.m_source;
+        m_metadata = moveFrom.m_metadata;
+        m_image = moveFrom.m_image;
+        m_row = moveFrom.m_row;
+        m_rowCount = moveFrom.m_rowCount;
+
+        moveFrom.m_source = nullptr;
+        moveFrom.m_row = moveFrom.m_rowCount = 0;
+    }
+    return *this;
+}
+
+void ImageReader::Close() noexcept
+{
+    delete m_source;
+    m_source = nullptr;
+
+    memset(&m_metadata, 0, sizeof(m_metadata));
+    memset(&m_image, 0, sizeof(m_image));
+    m_row = m_rowCount = 0;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReader::Attach(Source* source, const TexMetadata& mdata) noexcept
+{
+    Close();
+
+    if (!source)
+        return E_INVALIDARG;
+
+    m_source = source;
+    m_metadata = mdata;
+
+    const HRESULT hr = SelectImage(0, 0, 0);
+    if (FAILED(hr))
+    {
+        Close();
+        return hr;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReader::SelectImage(size_t mip, size_t item, size_t slice) noexcept
+{
+    if (!m_source)
+        return E_UNEXPECTED;
+
+    if (mip >= m_metadata.mipLevels)
+        return E_INVALIDARG;
+
+    if (m_metadata.dimension == TEX_DIMENSION_TEXTURE3D)
+    {
+        const size_t depth = std::max<size_t>(m_metadata.depth >> mip, 1);
+        if (item > 0 || slice >= depth)
+            return E_INVALIDARG;
+    }
+    else if (item >= m_metadata.arraySize || slice > 0)
+    {
+        return E_INVALIDARG;
+    }
+
+    memset(&m_image, 0, sizeof(m_image));
+    m_row = m_rowCount = 0;
+
+    Image image = {};
+    const HRESULT hr = m_source->Seek(mip, item, slice, image);
+    if (FAILED(hr))
+        return hr;
+
+    m_image = image;
+    m_image.pixels = nullptr;
+    m_rowCount = ComputeScanlines(image.format, image.height);
+    if (!m_rowCount)
+        return E_UNEXPECTED;
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReader::ReadRows(uint8_t* pDest, size_t rowPitch, size_t maxRows, size_t& rowsRead) noexcept
+{
+    rowsRead = 0;
+
+    if (!pDest || !maxRows)
+        return E_INVALIDARG;
+
+    if (!m_source || !m_rowCount)
+        return E_UNEXPECTED;
+
+    if (rowPitch < m_image.rowPitch)
+        return E_INVALIDARG;
+
+    const size_t count = std::min(maxRows, m_rowCount - m_row);
+    for (size_t j = 0; j < count; ++j)
+    {
+        const HRESULT hr = m_source->ReadRow(pDest, m_image.rowPitch);
+        if (FAILED(hr))
+            return hr;
+
+        pDest += rowPitch;
+        ++m_row;
+        ++rowsRead;
+    }
+
+    return (m_row < m_rowCount) ? S_OK : S_FALSE;
+}
+
+_Use_decl_annotations_
+HRESULT ImageReader::ReadRows(XMVECTOR* pDest, size_t maxRows, size_t& rowsRead) noexcept
+{
+    rowsRead = 0;
+
+    if (!pDest || !maxRows)
+        return E_INVALIDARG;
+
+    if (!m_source || !m_rowCount)
+        return E_UNEXPECTED;
+
+    if (IsCompressed(m_image.format) || IsPlanar(m_image.format) || IsPalettized(m_image.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (m_source->scanlineSize < m_image.rowPitch)
+    {
+        m_source->scanline.reset(new (std::nothrow) uint8_t[m_image.rowPitch]);
+        if (!m_source->scanline)
+        {
+            m_source->scanlineSize = 0;
+            return E_OUTOFMEMORY;
+        }
+        m_source->scanlineSize = m_image.rowPitch;
+    }
+
+    auto pRow = m_source->scanline.get();
+
+    const size_t count = std::min(maxRows, m_rowCount - m_row);
+    for (size_t j = 0; j < count; ++j)
+    {
+        HRESULT hr = m_source->ReadRow(pRow, m_image.rowPitch);
+        if (FAILED(hr))
+            return hr;
+
+        if (!LoadScanline(pDest, m_image.width, pRow, m_image.rowPitch, m_image.format))
+            return E_FAIL;
+
+        pDest += m_image.width;
+        ++m_row;
+        ++rowsRead;
+    }
+
+    return (m_row < m_rowCount) ? S_OK : S_FALSE;
+}
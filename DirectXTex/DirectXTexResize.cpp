@@ -177,6 +177,12 @@ namespace
             return false;
         }
 
+        if (filter & TEX_FILTER_PARALLEL)
+        {
+            // Multithreading is only implemented by the non-WIC code paths
+            return false;
+        }
+
         if (filter & TEX_FILTER_FORCE_WIC)
         {
             // Explicit flag to use WIC code paths, skips all the case checks below
@@ -231,7 +237,10 @@ namespace
             break;
 
         case TEX_FILTER_TRIANGLE:
-            // WIC does not implement this filter
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_MITCHELL:
+        case TEX_FILTER_KAISER:
+            // WIC does not implement these filters
             return false;
 
         default:
@@ -251,18 +260,24 @@ namespace
     // Resize custom filters
     //-------------------------------------------------------------------------------------
 
+    // Destination rows per work item when resizing with TEX_FILTER_PARALLEL
+    constexpr size_t RESIZE_BAND_ROWS = 16;
+
+    // The box filter halves each dimension, or keeps a dimension of 1 as it does at the bottom of a mip chain
+    constexpr bool IsBoxReduction(size_t srcSize, size_t destSize) noexcept
+    {
+        return ((destSize << 1) == srcSize) || ((srcSize == 1) && (destSize == 1));
+    }
+
     //--- Point Filter ---
-    HRESULT ResizePointFilter(const Image& srcImage, const Image& destImage) noexcept
+    bool ResizePointFilter(
+        const Image& srcImage, const Image& destImage,
+        size_t y0, size_t y1,
+        _Inout_updates_(srcImage.width + destImage.width) XMVECTOR* scratch) noexcept
     {
         assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
 
-        // Allocate temporary space (2 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        XMVECTOR* target = scanline.get();
+        XMVECTOR* target = scratch;
 
         XMVECTOR* row = target + destImage.width;
 
@@ -271,7 +286,7 @@ namespace
     #endif
 
         const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * y0);
 
         const size_t rowPitch = srcImage.rowPitch;
 
@@ -280,13 +295,13 @@ namespace
 
         size_t lasty = size_t(-1);
 
-        size_t sy = 0;
-        for (size_t y = 0; y < destImage.height; ++y)
+        size_t sy = y0 * yinc;
+        for (size_t y = y0; y < y1; ++y)
         {
             if ((lasty ^ sy) >> 16)
             {
                 if (!LoadScanline(row, srcImage.width, pSrc + (rowPitch * (sy >> 16)), rowPitch, srcImage.format))
-                    return E_FAIL;
+                    return false;
                 lasty = sy;
             }
 
@@ -298,33 +313,28 @@ namespace
             }
 
             if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, target, destImage.width))
-                return E_FAIL;
+                return false;
             pDest += destImage.rowPitch;
 
             sy += yinc;
         }
 
-        return S_OK;
+        return true;
     }
 
 
     //--- Box Filter ---
-    HRESULT ResizeBoxFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    bool ResizeBoxFilter(
+        const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage,
+        size_t y0, size_t y1,
+        _Inout_updates_(srcImage.width * 2 + destImage.width) XMVECTOR* scratch) noexcept
     {
         using namespace DirectX::Filters;
 
         assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
+        assert(IsBoxReduction(srcImage.width, destImage.width) && IsBoxReduction(srcImage.height, destImage.height));
 
-        if (((destImage.width << 1) != srcImage.width) || ((destImage.height << 1) != srcImage.height))
-            return E_FAIL;
-
-        // Allocate temporary space (3 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        XMVECTOR* target = scanline.get();
+        XMVECTOR* target = scratch;
 
         XMVECTOR* urow0 = target + destImage.width;
         XMVECTOR* urow1 = urow0 + srcImage.width;
@@ -337,21 +347,34 @@ namespace
         const XMVECTOR* urow2 = urow0 + 1;
         const XMVECTOR* urow3 = urow1 + 1;
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+        // A dimension of 1 averages its single row or column with itself, as GenerateMipMaps does
+        if (srcImage.height <= 1)
+        {
+            urow1 = urow0;
+            urow3 = urow1 + 1;
+        }
+
+        if (srcImage.width <= 1)
+        {
+            urow2 = urow0;
+            urow3 = urow1;
+        }
 
         const size_t rowPitch = srcImage.rowPitch;
 
-        for (size_t y = 0; y < destImage.height; ++y)
+        const uint8_t* pSrc = srcImage.pixels + (rowPitch * (y0 << 1));
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * y0);
+
+        for (size_t y = y0; y < y1; ++y)
         {
             if (!LoadScanlineLinear(urow0, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
-                return E_FAIL;
+                return false;
             pSrc += rowPitch;
 
             if (urow0 != urow1)
             {
                 if (!LoadScanlineLinear(urow1, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
-                    return E_FAIL;
+                    return false;
                 pSrc += rowPitch;
             }
 
@@ -363,38 +386,27 @@ namespace
             }
 
             if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
+                return false;
             pDest += destImage.rowPitch;
         }
 
-        return S_OK;
+        return true;
     }
 
 
     //--- Linear Filter ---
-    HRESULT ResizeLinearFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    bool ResizeLinearFilter(
+        const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage,
+        _In_reads_(destImage.width) const Filters::LinearFilter* lfX,
+        _In_reads_(destImage.height) const Filters::LinearFilter* lfY,
+        size_t y0, size_t y1,
+        _Inout_updates_(srcImage.width * 2 + destImage.width) XMVECTOR* scratch) noexcept
     {
         using namespace DirectX::Filters;
 
         assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
-
-        // Allocate temporary space (3 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[destImage.width + destImage.height]);
-        if (!lf)
-            return E_OUTOFMEMORY;
-
-        LinearFilter* lfX = lf.get();
-        LinearFilter* lfY = lf.get() + destImage.width;
-
-        CreateLinearFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
-        CreateLinearFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
 
-        XMVECTOR* target = scanline.get();
+        XMVECTOR* target = scratch;
 
         XMVECTOR* row0 = target + destImage.width;
         XMVECTOR* row1 = row0 + srcImage.width;
@@ -405,14 +417,14 @@ namespace
     #endif
 
         const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * y0);
 
         const size_t rowPitch = srcImage.rowPitch;
 
         size_t u0 = size_t(-1);
         size_t u1 = size_t(-1);
 
-        for (size_t y = 0; y < destImage.height; ++y)
+        for (size_t y = y0; y < y1; ++y)
         {
             const auto& toY = lfY[y];
 
@@ -423,7 +435,7 @@ namespace
                     u0 = toY.u0;
 
                     if (!LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
+                        return false;
                 }
                 else
                 {
@@ -439,7 +451,7 @@ namespace
                 u1 = toY.u1;
 
                 if (!LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
-                    return E_FAIL;
+                    return false;
             }
 
             for (size_t x = 0; x < destImage.width; ++x)
@@ -450,11 +462,11 @@ namespace
             }
 
             if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
+                return false;
             pDest += destImage.rowPitch;
         }
 
-        return S_OK;
+        return true;
     }
 
 
@@ -463,29 +475,18 @@ namespace
 #pragma clang diagnostic ignored "-Wextra-semi-stmt"
 #endif
 
-    HRESULT ResizeCubicFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    bool ResizeCubicFilter(
+        const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage,
+        _In_reads_(destImage.width) const Filters::CubicFilter* cfX,
+        _In_reads_(destImage.height) const Filters::CubicFilter* cfY,
+        size_t y0, size_t y1,
+        _Inout_updates_(srcImage.width * 4 + destImage.width) XMVECTOR* scratch) noexcept
     {
         using namespace DirectX::Filters;
 
         assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
-
-        // Allocate temporary space (5 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 4 + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[destImage.width + destImage.height]);
-        if (!cf)
-            return E_OUTOFMEMORY;
-
-        CubicFilter* cfX = cf.get();
-        CubicFilter* cfY = cf.get() + destImage.width;
-
-        CreateCubicFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
-        CreateCubicFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
 
-        XMVECTOR* target = scanline.get();
+        XMVECTOR* target = scratch;
 
         XMVECTOR* row0 = target + destImage.width;
         XMVECTOR* row1 = row0 + srcImage.width;
@@ -500,7 +501,7 @@ namespace
     #endif
 
         const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * y0);
 
         const size_t rowPitch = srcImage.rowPitch;
 
@@ -509,7 +510,7 @@ namespace
         size_t u2 = size_t(-1);
         size_t u3 = size_t(-1);
 
-        for (size_t y = 0; y < destImage.height; ++y)
+        for (size_t y = y0; y < y1; ++y)
         {
             const auto& toY = cfY[y];
 
@@ -521,7 +522,7 @@ namespace
                     u0 = toY.u0;
 
                     if (!LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
+                        return false;
                 }
                 else if (toY.u0 == u1)
                 {
@@ -554,7 +555,7 @@ namespace
                     u1 = toY.u1;
 
                     if (!LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
+                        return false;
                 }
                 else if (toY.u1 == u2)
                 {
@@ -580,7 +581,7 @@ namespace
                     u2 = toY.u2;
 
                     if (!LoadScanlineLinear(row2, srcImage.width, pSrc + (rowPitch * u2), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
+                        return false;
                 }
                 else
                 {
@@ -597,7 +598,7 @@ namespace
                 u3 = toY.u3;
 
                 if (!LoadScanlineLinear(row3, srcImage.width, pSrc + (rowPitch * u3), rowPitch, srcImage.format, filter))
-                    return E_FAIL;
+                    return false;
             }
 
             for (size_t x = 0; x < destImage.width; ++x)
@@ -615,23 +616,122 @@ namespace
             }
 
             if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
+                return false;
             pDest += destImage.rowPitch;
         }
 
-        return S_OK;
+        return true;
+    }
+
+
+    size_t RingSlot(ptrdiff_t j, size_t ringSize) noexcept
+    {
+        ptrdiff_t k = j % ptrdiff_t(ringSize);
+        if (k < 0)
+            k += ptrdiff_t(ringSize);
+        return size_t(k);
+    }
+
+    //--- Polyphase Filter (Lanczos, Mitchell-Netravali, Kaiser) ---
+    bool ResizePolyphaseFilter(
+        const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage,
+        const Filters::PolyphaseFilter& pfX, const Filters::PolyphaseFilter& pfY,
+        size_t y0, size_t y1,
+        _Inout_updates_(srcImage.width + destImage.width * (pfY.taps + 1)) XMVECTOR* scratch) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        assert(srcImage.pixels && destImage.pixels);
+        assert(pfX.taps > 0 && pfY.taps > 0);
+
+        const size_t ringSize = pfY.taps;
+
+        XMVECTOR* target = scratch;
+        XMVECTOR* row = target + destImage.width;
+        XMVECTOR* ring = row + srcImage.width;
+
+    #ifdef _DEBUG
+        memset(row, 0xCD, sizeof(XMVECTOR)*srcImage.width);
+    #endif
+
+        const uint8_t* pSrc = srcImage.pixels;
+        uint8_t* pDest = destImage.pixels + (destImage.rowPitch * y0);
+
+        const size_t rowPitch = srcImage.rowPitch;
+
+        // The ring holds horizontally filtered rows for the unbounded source indices [next - ringSize, next)
+        ptrdiff_t next = pfY.first[y0];
+
+        for (size_t y = y0; y < y1; ++y)
+        {
+            const ptrdiff_t first = pfY.first[y];
+            const PolyphaseTap* tapY = &pfY.tap[y * ringSize];
+            const XMVECTOR* weightY = &pfY.splat[y * ringSize];
+
+            // Horizontal pass for the source rows entering the window
+            for (ptrdiff_t j = std::max(next, first); j < first + ptrdiff_t(ringSize); ++j)
+            {
+                if (!LoadScanlineLinear(row, srcImage.width, pSrc + (rowPitch * tapY[j - first].u), rowPitch, srcImage.format, filter))
+                    return false;
+
+                XMVECTOR* hrow = ring + destImage.width * RingSlot(j, ringSize);
+
+                const PolyphaseTap* tapX = pfX.tap.get();
+                const XMVECTOR* weightX = pfX.splat.get();
+                for (size_t x = 0; x < destImage.width; ++x, tapX += pfX.taps, weightX += pfX.taps)
+                {
+                    XMVECTOR acc = XMVectorZero();
+                    for (size_t k = 0; k < pfX.taps; ++k)
+                    {
+                        acc = XMVectorMultiplyAdd(row[tapX[k].u], weightX[k], acc);
+                    }
+                    hrow[x] = acc;
+                }
+            }
+
+            next = std::max(next, first + ptrdiff_t(ringSize));
+
+            // Vertical pass
+            for (size_t x = 0; x < destImage.width; ++x)
+            {
+                target[x] = XMVectorZero();
+            }
+
+            for (size_t k = 0; k < ringSize; ++k)
+            {
+                if (tapY[k].weight == 0.f)
+                    continue;
+
+                const XMVECTOR weight = weightY[k];
+                const XMVECTOR* hrow = ring + destImage.width * RingSlot(first + ptrdiff_t(k), ringSize);
+
+                for (size_t x = 0; x < destImage.width; ++x)
+                {
+                    target[x] = XMVectorMultiplyAdd(hrow[x], weight, target[x]);
+                }
+            }
+
+            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
+                return false;
+            pDest += destImage.rowPitch;
+        }
+
+        return true;
     }
 
 
     //--- Triangle Filter ---
-    HRESULT ResizeTriangleFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    HRESULT ResizeTriangleFilter(
+        const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage,
+        const Filters::Filter* tfX, const Filters::Filter* tfY) noexcept
     {
         using namespace DirectX::Filters;
 
         assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
 
-        // Allocate initial temporary space (1 scanline, accumulation rows, plus X and Y filters)
+        assert(tfX != nullptr && tfY != nullptr);
+
+        // Allocate initial temporary space (1 scanline, accumulation rows)
         auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
         if (!scanline)
             return E_OUTOFMEMORY;
@@ -642,27 +742,17 @@ namespace
 
         TriangleRow * rowFree = nullptr;
 
-        std::unique_ptr<Filter> tfX;
-        HRESULT hr = CreateTriangleFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, tfX);
-        if (FAILED(hr))
-            return hr;
-
-        std::unique_ptr<Filter> tfY;
-        hr = CreateTriangleFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, tfY);
-        if (FAILED(hr))
-            return hr;
-
         XMVECTOR* row = scanline.get();
 
     #ifdef _DEBUG
         memset(row, 0xCD, sizeof(XMVECTOR)*srcImage.width);
     #endif
 
-        auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX.get()) + tfX->sizeInBytes);
-        auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY.get()) + tfY->sizeInBytes);
+        auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX) + tfX->sizeInBytes);
+        auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY) + tfY->sizeInBytes);
 
         // Count times rows get written
-        for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
+        for (const FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
         {
             for (size_t j = 0; j < yFrom->count; ++j)
             {
@@ -671,7 +761,7 @@ namespace
                 ++rowActive[v].remaining;
             }
 
-            yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
+            yFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(yFrom) + yFrom->sizeInBytes);
         }
 
         // Filter image
@@ -681,7 +771,7 @@ namespace
 
         uint8_t* pDest = destImage.pixels;
 
-        for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
+        for (const FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
         {
             // Create accumulation rows as needed
             for (size_t j = 0; j < yFrom->count; ++j)
@@ -722,7 +812,7 @@ namespace
 
             // Process row
             size_t x = 0;
-            for (FilterFrom* xFrom = tfX->from; xFrom < xFromEnd; ++x)
+            for (const FilterFrom* xFrom = tfX->from; xFrom < xFromEnd; ++x)
             {
                 for (size_t j = 0; j < yFrom->count; ++j)
                 {
@@ -746,7 +836,7 @@ namespace
                     }
                 }
 
-                xFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(xFrom) + xFrom->sizeInBytes);
+                xFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(xFrom) + xFrom->sizeInBytes);
             }
 
             // Write completed accumulation rows
@@ -796,7 +886,7 @@ namespace
                 }
             }
 
-            yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
+            yFrom = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(yFrom) + yFrom->sizeInBytes);
         }
 
         return S_OK;
@@ -804,42 +894,352 @@ namespace
 
 
     //--- Custom filter resize ---
-    HRESULT PerformResizeUsingCustomFilters(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    HRESULT PerformResizeUsingCustomFilters(
+        ResizePlan& plan,
+        const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
     {
-        if (!srcImage.pixels || !destImage.pixels)
-            return E_POINTER;
+        // Rebuild the plan only when the sizes or filter differ from the previous image
+        if (plan.GetSourceWidth() != srcImage.width || plan.GetSourceHeight() != srcImage.height
+            || plan.GetDestWidth() != destImage.width || plan.GetDestHeight() != destImage.height
+            || plan.GetFilter() != filter)
+        {
+            const HRESULT hr = plan.Initialize(srcImage.width, srcImage.height, destImage.width, destImage.height, filter);
+            if (FAILED(hr))
+                return hr;
+        }
 
-        static_assert(TEX_FILTER_POINT == 0x100000, "TEX_FILTER_ flag values don't match TEX_FILTER_MASK");
+        return plan.Execute(srcImage, destImage);
+    }
+}
+
+
+//=====================================================================================
+// ResizePlan
+//=====================================================================================
 
-        uint32_t filter_select = filter & TEX_FILTER_MODE_MASK;
-        if (!filter_select)
+namespace DirectX
+{
+    struct ResizePlan::Kernels
+    {
+        uint32_t                                    filterSelect;
+        std::unique_ptr<Filters::LinearFilter[]>    lf;
+        std::unique_ptr<Filters::CubicFilter[]>     cf;
+        std::unique_ptr<Filters::Filter>            tfX;
+        std::unique_ptr<Filters::Filter>            tfY;
+        Filters::PolyphaseFilter                    pfX;
+        Filters::PolyphaseFilter                    pfY;
+    };
+}
+
+ResizePlan& ResizePlan::operator= (ResizePlan&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
+    {
+        Release();
+
+        m_kernels = moveFrom.m_kernels;
+        m_srcWidth = moveFrom.m_srcWidth;
+        m_srcHeight = moveFrom.m_srcHeight;
+        m_destWidth = moveFrom.m_destWidth;
+        m_destHeight = moveFrom.m_destHeight;
+        m_filter = moveFrom.m_filter;
+
+        moveFrom.m_kernels = nullptr;
+        moveFrom.m_srcWidth = moveFrom.m_srcHeight = 0;
+        moveFrom.m_destWidth = moveFrom.m_destHeight = 0;
+        moveFrom.m_filter = TEX_FILTER_DEFAULT;
+    }
+    return *this;
+}
+
+void ResizePlan::Release() noexcept
+{
+    delete m_kernels;
+    m_kernels = nullptr;
+
+    m_srcWidth = m_srcHeight = 0;
+    m_destWidth = m_destHeight = 0;
+    m_filter = TEX_FILTER_DEFAULT;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Select the filter and build its tables
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT ResizePlan::Initialize(
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    TEX_FILTER_FLAGS filter) noexcept
+{
+    using namespace DirectX::Filters;
+
+    Release();
+
+    if (!srcWidth || !srcHeight || !destWidth || !destHeight)
+        return E_INVALIDARG;
+
+    if ((srcWidth > UINT32_MAX) || (srcHeight > UINT32_MAX)
+        || (destWidth > UINT32_MAX) || (destHeight > UINT32_MAX))
+        return E_INVALIDARG;
+
+#ifndef _OPENMP
+    if (filter & TEX_FILTER_PARALLEL)
+        return E_NOTIMPL;
+#endif
+
+    static_assert(TEX_FILTER_POINT == 0x100000, "TEX_FILTER_ flag values don't match TEX_FILTER_MASK");
+
+    uint32_t filter_select = filter & TEX_FILTER_MODE_MASK;
+    if (!filter_select)
+    {
+        // Default filter choice
+        filter_select = (((destWidth << 1) == srcWidth) && ((destHeight << 1) == srcHeight))
+            ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+    }
+
+    std::unique_ptr<Kernels> kernels(new (std::nothrow) Kernels());
+    if (!kernels)
+        return E_OUTOFMEMORY;
+
+    kernels->filterSelect = filter_select;
+
+    switch (filter_select)
+    {
+    case TEX_FILTER_POINT:
+        break;
+
+    case TEX_FILTER_BOX:
+        if (!IsBoxReduction(srcWidth, destWidth) || !IsBoxReduction(srcHeight, destHeight))
+            return E_FAIL;
+        break;
+
+    case TEX_FILTER_LINEAR:
+        kernels->lf.reset(new (std::nothrow) LinearFilter[destWidth + destHeight]);
+        if (!kernels->lf)
+            return E_OUTOFMEMORY;
+
+        CreateLinearFilter(srcWidth, destWidth, (filter & TEX_FILTER_WRAP_U) != 0, kernels->lf.get());
+        CreateLinearFilter(srcHeight, destHeight, (filter & TEX_FILTER_WRAP_V) != 0, kernels->lf.get() + destWidth);
+        break;
+
+    case TEX_FILTER_CUBIC:
+        kernels->cf.reset(new (std::nothrow) CubicFilter[destWidth + destHeight]);
+        if (!kernels->cf)
+            return E_OUTOFMEMORY;
+
+        CreateCubicFilter(srcWidth, destWidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, kernels->cf.get());
+        CreateCubicFilter(srcHeight, destHeight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, kernels->cf.get() + destWidth);
+        break;
+
+    case TEX_FILTER_TRIANGLE:
         {
-            // Default filter choice
-            filter_select = (((destImage.width << 1) == srcImage.width) && ((destImage.height << 1) == srcImage.height))
-                ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+            HRESULT hr = CreateTriangleFilter(srcWidth, destWidth, (filter & TEX_FILTER_WRAP_U) != 0, kernels->tfX);
+            if (FAILED(hr))
+                return hr;
+
+            hr = CreateTriangleFilter(srcHeight, destHeight, (filter & TEX_FILTER_WRAP_V) != 0, kernels->tfY);
+            if (FAILED(hr))
+                return hr;
         }
+        break;
 
-        switch (filter_select)
+    case TEX_FILTER_LANCZOS:
+    case TEX_FILTER_MITCHELL:
+    case TEX_FILTER_KAISER:
         {
-        case TEX_FILTER_POINT:
-            return ResizePointFilter(srcImage, destImage);
+            float(*kernel)(float) = LanczosKernel;
+            float radius = PF_LANCZOS_RADIUS;
+            if (filter_select == TEX_FILTER_MITCHELL)
+            {
+                kernel = MitchellKernel;
+                radius = PF_MITCHELL_RADIUS;
+            }
+            else if (filter_select == TEX_FILTER_KAISER)
+            {
+                kernel = KaiserKernel;
+                radius = PF_KAISER_RADIUS;
+            }
 
-        case TEX_FILTER_BOX:
-            return ResizeBoxFilter(srcImage, filter, destImage);
+            HRESULT hr = CreatePolyphaseFilter(srcWidth, destWidth,
+                (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, kernel, radius, kernels->pfX);
+            if (FAILED(hr))
+                return hr;
 
-        case TEX_FILTER_LINEAR:
-            return ResizeLinearFilter(srcImage, filter, destImage);
+            hr = CreatePolyphaseFilter(srcHeight, destHeight,
+                (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, kernel, radius, kernels->pfY);
+            if (FAILED(hr))
+                return hr;
+        }
+        break;
 
-        case TEX_FILTER_CUBIC:
-            return ResizeCubicFilter(srcImage, filter, destImage);
+    default:
+        return HRESULT_E_NOT_SUPPORTED;
+    }
 
-        case TEX_FILTER_TRIANGLE:
-            return ResizeTriangleFilter(srcImage, filter, destImage);
+    m_kernels = kernels.release();
+    m_srcWidth = srcWidth;
+    m_srcHeight = srcHeight;
+    m_destWidth = destWidth;
+    m_destHeight = destHeight;
+    m_filter = filter;
 
-        default:
+    return S_OK;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Resize one image using the cached tables
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT ResizePlan::Execute(const Image& srcImage, const Image& destImage) const noexcept
+{
+    return Execute(srcImage, destImage, 0, destImage.height);
+}
+
+_Use_decl_annotations_
+HRESULT ResizePlan::Execute(const Image& srcImage, const Image& destImage, size_t rowStart, size_t rowEnd) const noexcept
+{
+    if (!m_kernels)
+        return E_UNEXPECTED;
+
+    if (!srcImage.pixels || !destImage.pixels)
+        return E_POINTER;
+
+    if ((srcImage.width != m_srcWidth) || (srcImage.height != m_srcHeight)
+        || (destImage.width != m_destWidth) || (destImage.height != m_destHeight))
+        return E_INVALIDARG;
+
+    if ((rowStart >= rowEnd) || (rowEnd > destImage.height))
+        return E_INVALIDARG;
+
+    if (IsCompressed(srcImage.format) || IsCompressed(destImage.format))
+    {
+        // We don't support resizing compressed images
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    const uint32_t filterSelect = m_kernels->filterSelect;
+    if (filterSelect == TEX_FILTER_TRIANGLE)
+    {
+        // Each source row accumulates into several destination rows, so this filter always runs on one thread
+        // and always produces the whole image
+        if ((rowStart > 0) || (rowEnd < destImage.height))
             return HRESULT_E_NOT_SUPPORTED;
+
+        return ResizeTriangleFilter(srcImage, m_filter, destImage, m_kernels->tfX.get(), m_kernels->tfY.get());
+    }
+
+    // Scratch holds the target row plus the cached rows for the filter
+    uint64_t scratchSize = 0;
+    switch (filterSelect)
+    {
+    case TEX_FILTER_POINT:
+        scratchSize = uint64_t(srcImage.width) + destImage.width;
+        break;
+
+    case TEX_FILTER_BOX:
+    case TEX_FILTER_LINEAR:
+        scratchSize = uint64_t(srcImage.width) * 2 + destImage.width;
+        break;
+
+    case TEX_FILTER_CUBIC:
+        scratchSize = uint64_t(srcImage.width) * 4 + destImage.width;
+        break;
+
+    case TEX_FILTER_LANCZOS:
+    case TEX_FILTER_MITCHELL:
+    case TEX_FILTER_KAISER:
+        scratchSize = uint64_t(srcImage.width) + uint64_t(destImage.width) * (uint64_t(m_kernels->pfY.taps) + 1);
+        break;
+
+    default:
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    const auto lf = m_kernels->lf.get();
+    const auto cf = m_kernels->cf.get();
+
+    auto band = [&](size_t y0, size_t y1, XMVECTOR* scratch) noexcept -> bool
+        {
+            switch (filterSelect)
+            {
+            case TEX_FILTER_POINT:
+                return ResizePointFilter(srcImage, destImage, y0, y1, scratch);
+
+            case TEX_FILTER_BOX:
+                return ResizeBoxFilter(srcImage, m_filter, destImage, y0, y1, scratch);
+
+            case TEX_FILTER_LINEAR:
+                return ResizeLinearFilter(srcImage, m_filter, destImage, lf, lf + destImage.width, y0, y1, scratch);
+
+            case TEX_FILTER_CUBIC:
+                return ResizeCubicFilter(srcImage, m_filter, destImage, cf, cf + destImage.width, y0, y1, scratch);
+
+            case TEX_FILTER_LANCZOS:
+            case TEX_FILTER_MITCHELL:
+            case TEX_FILTER_KAISER:
+                return ResizePolyphaseFilter(srcImage, m_filter, destImage, m_kernels->pfX, m_kernels->pfY, y0, y1, scratch);
+
+            default:
+                return false;
+            }
+        };
+
+#ifdef _OPENMP
+    if (m_filter & TEX_FILTER_PARALLEL)
+    {
+        // Bands are independent: each one reloads the source rows it needs, so results match the serial path
+        const size_t bands = (rowEnd - rowStart + RESIZE_BAND_ROWS - 1) / RESIZE_BAND_ROWS;
+        if (bands > INT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        bool fail = false;
+        bool outOfMemory = false;
+
+        const int nthreads = GetWorkerThreadCount(bands);
+
+#pragma omp parallel num_threads(nthreads)
+        {
+            auto scratch = make_AlignedArrayXMVECTOR(scratchSize);
+            if (!scratch)
+            {
+                outOfMemory = true;
+            }
+
+#pragma omp for schedule(dynamic)
+            for (int nb = 0; nb < static_cast<int>(bands); ++nb)
+            {
+#pragma omp flush (fail, outOfMemory)
+                if (fail || outOfMemory)
+                {
+                    // OpenMP 2.0 does not support cancellation of a 'for' loop.
+                    continue;
+                }
+
+                const size_t y0 = rowStart + static_cast<size_t>(nb) * RESIZE_BAND_ROWS;
+                const size_t y1 = std::min(y0 + RESIZE_BAND_ROWS, rowEnd);
+                if (!band(y0, y1, scratch.get()))
+                {
+                    fail = true;
+                }
+            }
         }
+
+        if (outOfMemory)
+            return E_OUTOFMEMORY;
+
+        return (fail) ? E_FAIL : S_OK;
     }
+#endif // _OPENMP
+
+    auto scratch = make_AlignedArrayXMVECTOR(scratchSize);
+    if (!scratch)
+        return E_OUTOFMEMORY;
+
+    return band(rowStart, rowEnd, scratch.get()) ? S_OK : E_FAIL;
 }
 
 
@@ -858,6 +1258,8 @@ HRESULT DirectX::Resize(
     TEX_FILTER_FLAGS filter,
     ScratchImage& image) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_RESIZE);
+
     if (width == 0 || height == 0)
         return E_INVALIDARG;
 
@@ -923,7 +1325,8 @@ HRESULT DirectX::Resize(
     #endif
     {
         // Case 3: not using WIC resizing
-        hr = PerformResizeUsingCustomFilters(srcImage, filter, *rimage);
+        ResizePlan plan;
+        hr = PerformResizeUsingCustomFilters(plan, srcImage, filter, *rimage);
     }
 
     if (FAILED(hr))
@@ -949,6 +1352,8 @@ HRESULT DirectX::Resize(
     TEX_FILTER_FLAGS filter,
     ScratchImage& result) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_RESIZE);
+
     if (!srcImages || !nimages || width == 0 || height == 0)
         return E_INVALIDARG;
 
@@ -984,6 +1389,9 @@ HRESULT DirectX::Resize(
     }
 #endif
 
+    // Every item or slice shares the same sizes, so the filter tables are built once
+    ResizePlan plan;
+
     switch (metadata.dimension)
     {
     case TEX_DIMENSION_TEXTURE1D:
@@ -1037,7 +1445,7 @@ HRESULT DirectX::Resize(
             #endif
             {
                 // Case 3: not using WIC resizing
-                hr = PerformResizeUsingCustomFilters(*srcimg, filter, *destimg);
+                hr = PerformResizeUsingCustomFilters(plan, *srcimg, filter, *destimg);
             }
 
             if (FAILED(hr))
@@ -1098,7 +1506,7 @@ HRESULT DirectX::Resize(
             #endif
             {
                 // Case 3: not using WIC resizing
-                hr = PerformResizeUsingCustomFilters(*srcimg, filter, *destimg);
+                hr = PerformResizeUsingCustomFilters(plan, *srcimg, filter, *destimg);
             }
 
             if (FAILED(hr))
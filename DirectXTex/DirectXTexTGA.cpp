@@ -1435,6 +1435,306 @@ namespace
 
         return format;
     }
+
+    //-------------------------------------------------------------------------------------
+    // Decodes one RLE-compressed scanline into file pixel order (packets may not span rows)
+    //-------------------------------------------------------------------------------------
+    HRESULT DecodeRLEScanline(
+        _In_reads_bytes_(size) const uint8_t* pSource,
+        size_t size,
+        size_t width,
+        size_t bytesPerPixel,
+        _Out_writes_bytes_(width * bytesPerPixel) uint8_t* pDest,
+        _Out_ size_t& bytesUsed) noexcept
+    {
+        bytesUsed = 0;
+
+        auto sPtr = pSource;
+        const uint8_t* endPtr = pSource + size;
+
+        for (size_t x = 0; x < width; )
+        {
+            if (sPtr >= endPtr)
+                return HRESULT_E_HANDLE_EOF;
+
+            const size_t j = (*sPtr & 0x7F) + 1u;
+            if (x + j > width)
+                return E_FAIL;
+
+            if (*sPtr++ & 0x80)
+            {
+                // Repeat
+                if (sPtr + bytesPerPixel > endPtr)
+                    return HRESULT_E_HANDLE_EOF;
+
+                for (size_t k = 0; k < j; ++k)
+                {
+                    memcpy(pDest + (x + k) * bytesPerPixel, sPtr, bytesPerPixel);
+                }
+                sPtr += bytesPerPixel;
+            }
+            else
+            {
+                // Literal
+                if (sPtr + j * bytesPerPixel > endPtr)
+                    return HRESULT_E_HANDLE_EOF;
+
+                memcpy(pDest + x * bytesPerPixel, sPtr, j * bytesPerPixel);
+                sPtr += j * bytesPerPixel;
+            }
+
+            x += j;
+        }
+
+        bytesUsed = static_cast<size_t>(sPtr - pSource);
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Row source for ImageReader
+    //-------------------------------------------------------------------------------------
+    class TGASource : public ImageReader::Source
+    {
+    public:
+        TGASource() noexcept :
+            format(DXGI_FORMAT_UNKNOWN), baseFormat(DXGI_FORMAT_UNKNOWN),
+            width(0), height(0), bytesPerPixel(0), convFlags(0), pixelOffset(0),
+            row(0), setAlpha(false), palette{} {}
+
+        HRESULT __cdecl Seek(size_t, size_t, size_t, Image& image) noexcept override
+        {
+            image = {};
+
+            const HRESULT hr = file.Seek(pixelOffset);
+            if (FAILED(hr))
+                return hr;
+
+            row = 0;
+
+            image.width = width;
+            image.height = height;
+            image.format = format;
+            return ComputePitch(format, width, height, image.rowPitch, image.slicePitch, CP_FLAGS_NONE);
+        }
+
+        HRESULT __cdecl ReadRow(uint8_t* pDest, size_t rowPitch) noexcept override
+        {
+            if (row >= height)
+                return E_UNEXPECTED;
+
+            HRESULT hr = ReadStoredRow((convFlags & CONV_FLAGS_INVERTY) ? row : (height - row - 1));
+            if (FAILED(hr))
+                return hr;
+
+            ConvertRow(pDest);
+
+            if (setAlpha)
+            {
+                CopyScanline(pDest, rowPitch, pDest, rowPitch, baseFormat, TEXP_SCANLINE_SETALPHA);
+            }
+
+            ++row;
+            return S_OK;
+        }
+
+        HRESULT __cdecl ReadStoredRow(size_t stored) noexcept
+        {
+            const size_t srcPitch = width * bytesPerPixel;
+
+            if (convFlags & CONV_FLAGS_RLE)
+            {
+                if (rowOffsets)
+                {
+                    HRESULT hr = file.Seek(rowOffsets[stored], width * (bytesPerPixel + 1));
+                    if (FAILED(hr))
+                        return hr;
+                }
+
+                const uint8_t* sPtr = nullptr;
+                size_t available = 0;
+                HRESULT hr = file.Peek(width * (bytesPerPixel + 1), &sPtr, available);
+                if (FAILED(hr))
+                    return hr;
+
+                size_t bytesUsed = 0;
+                hr = DecodeRLEScanline(sPtr, available, width, bytesPerPixel, raw.get(), bytesUsed);
+                if (FAILED(hr))
+                    return hr;
+
+                file.Skip(bytesUsed);
+                return S_OK;
+            }
+
+            HRESULT hr = file.Seek(pixelOffset + uint64_t(stored) * srcPitch, srcPitch);
+            if (FAILED(hr))
+                return hr;
+
+            return file.Read(raw.get(), srcPitch);
+        }
+
+        // Pre-pass to record RLE row offsets for bottom-up files, and to gather alpha statistics
+        HRESULT __cdecl Scan(TGA_FLAGS flags, bool& opaquealpha) noexcept
+        {
+            opaquealpha = false;
+
+            const bool scanAlpha = !(convFlags & (CONV_FLAGS_PALETTED | CONV_FLAGS_EXPAND))
+                && (bytesPerPixel == 2 || bytesPerPixel == 4);
+            const bool indexRows = (convFlags & CONV_FLAGS_RLE) && !(convFlags & CONV_FLAGS_INVERTY);
+
+            if (!scanAlpha && !indexRows)
+                return S_OK;
+
+            if (convFlags & CONV_FLAGS_RLE)
+            {
+                rowOffsets.reset(new (std::nothrow) uint64_t[height]);
+                if (!rowOffsets)
+                    return E_OUTOFMEMORY;
+            }
+
+            HRESULT hr = file.Seek(pixelOffset);
+            if (FAILED(hr))
+                return hr;
+
+            uint32_t minalpha = 255;
+            uint32_t maxalpha = 0;
+
+            for (size_t y = 0; y < height; ++y)
+            {
+                if (rowOffsets)
+                {
+                    rowOffsets[y] = file.Tell();
+                }
+
+                hr = ReadStoredRow(y);
+                if (FAILED(hr))
+                    return hr;
+
+                if (scanAlpha)
+                {
+                    const uint8_t* sPtr = raw.get();
+                    for (size_t x = 0; x < width; ++x)
+                    {
+                        const uint32_t alpha = (bytesPerPixel == 2)
+                            ? ((sPtr[1] & 0x80) ? 255u : 0u)
+                            : sPtr[3];
+
+                        minalpha = std::min(minalpha, alpha);
+                        maxalpha = std::max(maxalpha, alpha);
+
+                        sPtr += bytesPerPixel;
+                    }
+                }
+            }
+
+            if (scanAlpha)
+            {
+                // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
+                if (maxalpha == 0 && !(flags & TGA_FLAGS_ALLOW_ALL_ZERO_ALPHA))
+                {
+                    opaquealpha = setAlpha = true;
+                }
+                else if (minalpha == 255)
+                {
+                    opaquealpha = true;
+                }
+            }
+
+            return S_OK;
+        }
+
+        void __cdecl ConvertRow(_Out_ uint8_t* pDest) const noexcept
+        {
+            const uint8_t* sPtr = raw.get();
+            const bool invertX = (convFlags & CONV_FLAGS_INVERTX) != 0;
+
+            if (convFlags & CONV_FLAGS_PALETTED)
+            {
+                const auto table = reinterpret_cast<const uint32_t*>(palette);
+                auto dPtr = reinterpret_cast<uint32_t*>(pDest);
+                for (size_t x = 0; x < width; ++x)
+                {
+                    dPtr[invertX ? (width - x - 1) : x] = table[sPtr[x]];
+                }
+                return;
+            }
+
+            switch (baseFormat)
+            {
+            case DXGI_FORMAT_R8_UNORM:
+                for (size_t x = 0; x < width; ++x)
+                {
+                    pDest[invertX ? (width - x - 1) : x] = sPtr[x];
+                }
+                break;
+
+            case DXGI_FORMAT_B5G5R5A1_UNORM:
+                {
+                    auto dPtr = reinterpret_cast<uint16_t*>(pDest);
+                    for (size_t x = 0; x < width; ++x, sPtr += 2)
+                    {
+                        dPtr[invertX ? (width - x - 1) : x] = static_cast<uint16_t>(uint32_t(*sPtr) | uint32_t(*(sPtr + 1u) << 8));
+                    }
+                }
+                break;
+
+            case DXGI_FORMAT_R8G8B8A8_UNORM:
+                {
+                    auto dPtr = reinterpret_cast<uint32_t*>(pDest);
+                    if (convFlags & CONV_FLAGS_EXPAND)
+                    {
+                        // BGR -> RGBA
+                        for (size_t x = 0; x < width; ++x, sPtr += 3)
+                        {
+                            dPtr[invertX ? (width - x - 1) : x] = uint32_t(*sPtr << 16) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2)) | 0xFF000000;
+                        }
+                    }
+                    else
+                    {
+                        // BGRA -> RGBA
+                        for (size_t x = 0; x < width; ++x, sPtr += 4)
+                        {
+                            dPtr[invertX ? (width - x - 1) : x] = uint32_t(*sPtr << 16) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2)) | uint32_t(*(sPtr + 3) << 24);
+                        }
+                    }
+                }
+                break;
+
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+                for (size_t x = 0; x < width; ++x, sPtr += 4)
+                {
+                    memcpy(pDest + (invertX ? (width - x - 1) : x) * 4, sPtr, 4);
+                }
+                break;
+
+            case DXGI_FORMAT_B8G8R8X8_UNORM:
+                {
+                    auto dPtr = reinterpret_cast<uint32_t*>(pDest);
+                    for (size_t x = 0; x < width; ++x, sPtr += 3)
+                    {
+                        dPtr[invertX ? (width - x - 1) : x] = uint32_t(*sPtr) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2) << 16);
+                    }
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        ImageReaderFile file;
+        std::unique_ptr<uint8_t[]> raw;
+        std::unique_ptr<uint64_t[]> rowOffsets;
+        DXGI_FORMAT format;
+        DXGI_FORMAT baseFormat;
+        size_t width;
+        size_t height;
+        size_t bytesPerPixel;
+        uint32_t convFlags;
+        uint64_t pixelOffset;
+        size_t row;
+        bool setAlpha;
+        uint8_t palette[256 * 4];
+    };
 }
 
 
@@ -1750,6 +2050,8 @@ HRESULT DirectX::LoadFromTGAFile(
     TexMetadata* metadata,
     ScratchImage& image) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_FILE_READ);
+
     if (!szFile)
         return E_INVALIDARG;
 
@@ -1798,6 +2100,8 @@ HRESULT DirectX::LoadFromTGAFile(
     size_t len = fileLen;
 #endif
 
+    TEX_INSTRUMENT_BYTES_READ(len);
+
     // Need at least enough data to fill the header to be a valid TGA
     if (len < TGA_HEADER_LEN)
     {
@@ -2242,6 +2546,147 @@ HRESULT DirectX::LoadFromTGAFile(
 }
 
 
+//-------------------------------------------------------------------------------------
+// Open a TGA file for streaming
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT ImageReader::OpenTGAFile(const wchar_t* szFile, TGA_FLAGS flags) noexcept
+{
+    Close();
+
+    if (!szFile)
+        return E_INVALIDARG;
+
+    std::unique_ptr<TGASource> source(new (std::nothrow) TGASource);
+    if (!source)
+        return E_OUTOFMEMORY;
+
+    HRESULT hr = source->file.Open(szFile);
+    if (FAILED(hr))
+        return hr;
+
+    const uint64_t len = source->file.GetSize();
+
+    // Need at least enough data to fill the header to be a valid TGA
+    if (len < TGA_HEADER_LEN)
+    {
+        return E_FAIL;
+    }
+
+    // Read the header
+    uint8_t header[TGA_HEADER_LEN] = {};
+    hr = source->file.Read(header, TGA_HEADER_LEN);
+    if (FAILED(hr))
+        return hr;
+
+    size_t offset;
+    uint32_t convFlags = 0;
+    TexMetadata mdata;
+    hr = DecodeTGAHeader(header, TGA_HEADER_LEN, flags, mdata, offset, &convFlags);
+    if (FAILED(hr))
+        return hr;
+
+    if (offset > len)
+        return HRESULT_E_INVALID_DATA;
+
+    if (offset == len)
+        return E_FAIL;
+
+    if (convFlags & CONV_FLAGS_PALETTED)
+    {
+        // Palette is limited to 256 24-bit entries
+        uint8_t colorMap[256 * 3] = {};
+        const auto colorMapLen = static_cast<size_t>(std::min<uint64_t>(sizeof(colorMap), len - offset));
+
+        hr = source->file.Seek(offset);
+        if (SUCCEEDED(hr))
+        {
+            hr = source->file.Read(colorMap, colorMapLen);
+        }
+        if (FAILED(hr))
+            return hr;
+
+        size_t paletteOffset = 0;
+        hr = ReadPalette(header, colorMap, colorMapLen, flags, source->palette, paletteOffset);
+        if (FAILED(hr))
+            return hr;
+
+        offset += paletteOffset;
+        if (offset >= len)
+            return HRESULT_E_HANDLE_EOF;
+    }
+
+    source->baseFormat = mdata.format;
+    source->width = mdata.width;
+    source->height = mdata.height;
+    source->bytesPerPixel = reinterpret_cast<const TGA_HEADER*>(header)->bBitsPerPixel / 8u;
+    source->convFlags = convFlags;
+    source->pixelOffset = offset;
+
+    if (!(convFlags & CONV_FLAGS_RLE)
+        && (len - offset) < uint64_t(mdata.width) * uint64_t(mdata.height) * source->bytesPerPixel)
+    {
+        return HRESULT_E_HANDLE_EOF;
+    }
+
+    source->raw.reset(new (std::nothrow) uint8_t[mdata.width * source->bytesPerPixel]);
+    if (!source->raw)
+        return E_OUTOFMEMORY;
+
+    bool opaquealpha = false;
+    hr = source->Scan(flags, opaquealpha);
+    if (FAILED(hr))
+        return hr;
+
+    // Optional TGA 2.0 footer & extension area
+    const TGA_EXTENSION* ext = nullptr;
+    TGA_EXTENSION extData = {};
+    if (len >= sizeof(TGA_FOOTER))
+    {
+        TGA_FOOTER footer = {};
+
+        hr = source->file.Seek(len - sizeof(TGA_FOOTER));
+        if (SUCCEEDED(hr))
+        {
+            hr = source->file.Read(&footer, sizeof(TGA_FOOTER));
+        }
+        if (FAILED(hr))
+            return hr;
+
+        if (memcmp(footer.Signature, g_Signature, sizeof(g_Signature)) == 0)
+        {
+            if (footer.dwExtensionOffset != 0
+                && ((footer.dwExtensionOffset + sizeof(TGA_EXTENSION)) <= len))
+            {
+                if (SUCCEEDED(source->file.Seek(footer.dwExtensionOffset))
+                    && SUCCEEDED(source->file.Read(&extData, sizeof(TGA_EXTENSION))))
+                {
+                    ext = &extData;
+                }
+            }
+        }
+    }
+
+    if (!(flags & TGA_FLAGS_IGNORE_SRGB))
+    {
+        mdata.format = GetSRGBFromExtension(ext, mdata.format, flags, nullptr);
+    }
+
+    if (opaquealpha)
+    {
+        mdata.SetAlphaMode(TEX_ALPHA_MODE_OPAQUE);
+    }
+    else if (ext)
+    {
+        mdata.SetAlphaMode(GetAlphaModeFromExtension(ext));
+    }
+
+    source->format = mdata.format;
+
+    return Attach(source.release(), mdata);
+}
+
+
 //-------------------------------------------------------------------------------------
 // Save a TGA file to memory
 //-------------------------------------------------------------------------------------
@@ -2342,6 +2787,8 @@ HRESULT DirectX::SaveToTGAFile(
     const wchar_t* szFile,
     const TexMetadata* metadata) noexcept
 {
+    TEX_INSTRUMENT_STAGE(TEX_STAGE_FILE_WRITE);
+
     if (!szFile)
         return E_INVALIDARG;
 
@@ -2527,7 +2974,10 @@ HRESULT DirectX::SaveToTGAFile(
     }
 
 #ifdef _WIN32
+    TEX_INSTRUMENT_FILE_WRITTEN(hFile.get());
     delonfail.clear();
+#else
+    TEX_INSTRUMENT_FILE_WRITTEN(outFile);
 #endif
 
     return S_OK;
@@ -11,6 +11,12 @@
 
 #include "DirectXTexP.h"
 
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #if (defined(_XBOX_ONE) && defined(_TITLE)) || defined(_GAMING_XBOX)
 static_assert(XBOX_DXGI_FORMAT_R10G10B10_7E3_A2_FLOAT == DXGI_FORMAT_R10G10B10_7E3_A2_FLOAT, "Xbox mismatch detected");
 static_assert(XBOX_DXGI_FORMAT_R10G10B10_6E4_A2_FLOAT == DXGI_FORMAT_R10G10B10_6E4_A2_FLOAT, "Xbox mismatch detected");
@@ -36,6 +42,41 @@ using Microsoft::WRL::ComPtr;
 
 namespace
 {
+    std::atomic<size_t> g_MaxThreadCount(0);
+
+#ifdef DIRECTX_TEX_INSTRUMENTATION
+    std::atomic<uint64_t> g_StageCalls[TEX_STAGE_COUNT] = {};
+    std::atomic<uint64_t> g_StageTime[TEX_STAGE_COUNT] = {};
+    std::atomic<uint64_t> g_EncodeBlocks[TEX_BC_CODEC_COUNT] = {};
+    std::atomic<uint64_t> g_EncodeTime[TEX_BC_CODEC_COUNT] = {};
+    std::atomic<uint64_t> g_BytesRead(0);
+    std::atomic<uint64_t> g_BytesWritten(0);
+    std::atomic<uint64_t> g_Allocations(0);
+    std::atomic<uint64_t> g_AllocatedBytes(0);
+
+    TEX_BC_CODEC GetCodec(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:    return TEX_BC_CODEC_BC1;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:    return TEX_BC_CODEC_BC2;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:    return TEX_BC_CODEC_BC3;
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:         return TEX_BC_CODEC_BC4;
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:         return TEX_BC_CODEC_BC5;
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:         return TEX_BC_CODEC_BC6H;
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:    return TEX_BC_CODEC_BC7;
+        default:                            return TEX_BC_CODEC_COUNT;
+        }
+    }
+#endif
+
 #ifdef _WIN32
     //-------------------------------------------------------------------------------------
     // WIC Pixel Format Translation Data
@@ -330,6 +371,128 @@ void DirectX::SetWICFactory(_In_opt_ IWICImagingFactory* pWIC) noexcept
 #endif // WIN32
 
 
+//-------------------------------------------------------------------------------------
+// Multithreading control
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::SetMaxThreadCount(size_t count) noexcept
+{
+    g_MaxThreadCount = count;
+}
+
+size_t DirectX::GetMaxThreadCount() noexcept
+{
+    return g_MaxThreadCount;
+}
+
+_Use_decl_annotations_
+int DirectX::Internal::GetWorkerThreadCount(size_t workItems) noexcept
+{
+#ifdef _OPENMP
+    size_t count = static_cast<size_t>(std::max(omp_get_max_threads(), 1));
+
+    const size_t limit = g_MaxThreadCount;
+    if (limit > 0 && count > limit)
+        count = limit;
+
+    if (count > workItems)
+        count = std::max<size_t>(workItems, 1);
+
+    return static_cast<int>(count);
+#else
+    UNREFERENCED_PARAMETER(workItems);
+    return 1;
+#endif
+}
+
+
+#ifdef DIRECTX_TEX_INSTRUMENTATION
+//-------------------------------------------------------------------------------------
+// Instrumentation
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::GetInstrumentation(TexInstrumentation& stats) noexcept
+{
+    for (size_t j = 0; j < TEX_STAGE_COUNT; ++j)
+    {
+        stats.stageCalls[j] = g_StageCalls[j].load(std::memory_order_relaxed);
+        stats.stageTime[j] = g_StageTime[j].load(std::memory_order_relaxed);
+    }
+
+    for (size_t j = 0; j < TEX_BC_CODEC_COUNT; ++j)
+    {
+        stats.encodeBlocks[j] = g_EncodeBlocks[j].load(std::memory_order_relaxed);
+        stats.encodeTime[j] = g_EncodeTime[j].load(std::memory_order_relaxed);
+    }
+
+    stats.bytesRead = g_BytesRead.load(std::memory_order_relaxed);
+    stats.bytesWritten = g_BytesWritten.load(std::memory_order_relaxed);
+    stats.allocations = g_Allocations.load(std::memory_order_relaxed);
+    stats.allocatedBytes = g_AllocatedBytes.load(std::memory_order_relaxed);
+}
+
+void DirectX::ResetInstrumentation() noexcept
+{
+    for (size_t j = 0; j < TEX_STAGE_COUNT; ++j)
+    {
+        g_StageCalls[j].store(0, std::memory_order_relaxed);
+        g_StageTime[j].store(0, std::memory_order_relaxed);
+    }
+
+    for (size_t j = 0; j < TEX_BC_CODEC_COUNT; ++j)
+    {
+        g_EncodeBlocks[j].store(0, std::memory_order_relaxed);
+        g_EncodeTime[j].store(0, std::memory_order_relaxed);
+    }
+
+    g_BytesRead.store(0, std::memory_order_relaxed);
+    g_BytesWritten.store(0, std::memory_order_relaxed);
+    g_Allocations.store(0, std::memory_order_relaxed);
+    g_AllocatedBytes.store(0, std::memory_order_relaxed);
+}
+
+_Use_decl_annotations_
+void DirectX::Internal::AddStageTime(TEX_STAGE stage, uint64_t nanoseconds) noexcept
+{
+    if (stage >= TEX_STAGE_COUNT)
+        return;
+
+    g_StageCalls[stage].fetch_add(1, std::memory_order_relaxed);
+    g_StageTime[stage].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+_Use_decl_annotations_
+void DirectX::Internal::AddEncodeTime(DXGI_FORMAT format, size_t blocks, uint64_t nanoseconds) noexcept
+{
+    const TEX_BC_CODEC codec = GetCodec(format);
+    if (codec >= TEX_BC_CODEC_COUNT)
+        return;
+
+    g_EncodeBlocks[codec].fetch_add(blocks, std::memory_order_relaxed);
+    g_EncodeTime[codec].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+_Use_decl_annotations_
+void DirectX::Internal::AddBytesRead(uint64_t bytes) noexcept
+{
+    g_BytesRead.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+_Use_decl_annotations_
+void DirectX::Internal::AddBytesWritten(uint64_t bytes) noexcept
+{
+    g_BytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+_Use_decl_annotations_
+void DirectX::Internal::AddAllocation(uint64_t bytes) noexcept
+{
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    g_AllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+#endif // DIRECTX_TEX_INSTRUMENTATION
+
+
 //=====================================================================================
 // DXGI Format Utilities
 //=====================================================================================
@@ -1852,6 +2015,7 @@ HRESULT Blob::Initialize(size_t size) noexcept
     }
 
     m_size = size;
+    TEX_INSTRUMENT_ALLOCATION(size);
 
     return S_OK;
 }
@@ -1884,6 +2048,8 @@ HRESULT Blob::Resize(size_t size) noexcept
     if (!tbuffer)
         return E_OUTOFMEMORY;
 
+    TEX_INSTRUMENT_ALLOCATION(size);
+
     memcpy(tbuffer, m_buffer, std::min(m_size, size));
 
     Release();
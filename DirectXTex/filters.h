@@ -418,5 +418,189 @@ namespace DirectX
             return S_OK;
         }
 
+
+        //-------------------------------------------------------------------------------------
+        // Polyphase (windowed kernel) filtering helpers
+        //-------------------------------------------------------------------------------------
+
+        constexpr float PF_LANCZOS_RADIUS = 3.f;
+        constexpr float PF_MITCHELL_RADIUS = 2.f;
+        constexpr float PF_KAISER_RADIUS = 3.f;
+        constexpr float PF_KAISER_ALPHA = 4.f;
+
+        inline float Sinc(float x) noexcept
+        {
+            if (fabsf(x) < 1e-6f)
+                return 1.f;
+
+            const float px = XM_PI * x;
+            return sinf(px) / px;
+        }
+
+        inline float BesselI0(float x) noexcept
+        {
+            // Power series for the modified Bessel function of the first kind, order 0
+            float sum = 1.f;
+            float term = 1.f;
+            const float halfx = x * 0.5f;
+            for (int k = 1; k < 32; ++k)
+            {
+                const float f = halfx / float(k);
+                term *= f * f;
+                sum += term;
+                if (term < sum * 1e-7f)
+                    break;
+            }
+            return sum;
+        }
+
+        inline float LanczosKernel(float x) noexcept
+        {
+            x = fabsf(x);
+            if (x >= PF_LANCZOS_RADIUS)
+                return 0.f;
+
+            return Sinc(x) * Sinc(x / PF_LANCZOS_RADIUS);
+        }
+
+        inline float MitchellKernel(float x) noexcept
+        {
+            // Mitchell-Netravali with B = C = 1/3
+            x = fabsf(x);
+            if (x < 1.f)
+            {
+                return (7.f * x * x * x - 12.f * x * x + 16.f / 3.f) / 6.f;
+            }
+            else if (x < 2.f)
+            {
+                return ((-7.f / 3.f) * x * x * x + 12.f * x * x - 20.f * x + 32.f / 3.f) / 6.f;
+            }
+
+            return 0.f;
+        }
+
+        inline float KaiserKernel(float x) noexcept
+        {
+            x = fabsf(x);
+            if (x >= PF_KAISER_RADIUS)
+                return 0.f;
+
+            const float t = x / PF_KAISER_RADIUS;
+            return Sinc(x) * BesselI0(PF_KAISER_ALPHA * sqrtf(1.f - t * t)) / BesselI0(PF_KAISER_ALPHA);
+        }
+
+        constexpr ptrdiff_t boundpolyphase(ptrdiff_t u, ptrdiff_t source, bool wrap, bool mirror) noexcept
+        {
+            // Unlike bounduvw, wide kernels on small images can reach more than one period away
+            if (wrap)
+            {
+                u %= source;
+                if (u < 0)
+                {
+                    u += source;
+                }
+            }
+            else if (mirror)
+            {
+                const ptrdiff_t period = source * 2;
+                u %= period;
+                if (u < 0)
+                {
+                    u += period;
+                }
+                if (u >= source)
+                {
+                    u = period - 1 - u;
+                }
+            }
+
+            u = std::min<ptrdiff_t>(u, source - 1);
+            u = std::max<ptrdiff_t>(u, 0);
+
+            return u;
+        }
+
+        struct PolyphaseTap
+        {
+            size_t  u;
+            float   weight;
+        };
+
+        struct PolyphaseFilter
+        {
+            size_t                          taps;   // Taps per destination sample (same for all samples)
+            std::unique_ptr<ptrdiff_t[]>    first;  // Unbounded source index of the first tap for each destination sample
+            std::unique_ptr<PolyphaseTap[]> tap;    // dest * taps entries; 'u' is already wrapped, mirrored, or clamped
+            ScopedAlignedArrayXMVECTOR      splat;  // dest * taps entries; each tap weight replicated into all four lanes
+
+            PolyphaseFilter() noexcept : taps(0) {}
+        };
+
+        inline HRESULT CreatePolyphaseFilter(
+            _In_ size_t source, _In_ size_t dest, _In_ bool wrap, _In_ bool mirror,
+            _In_ float(*kernel)(float), _In_ float radius,
+            _Inout_ PolyphaseFilter& pf) noexcept
+        {
+            assert(source > 0);
+            assert(dest > 0);
+            assert(kernel != nullptr);
+
+            const float scale = float(dest) / float(source);
+
+            // When minifying, the kernel is stretched to cover the source footprint of each destination sample
+            const float fscale = std::min(scale, 1.f);
+            const float support = radius / fscale;
+
+            const size_t taps = size_t(ceilf(support * 2.f)) + 1;
+
+            pf.first.reset(new (std::nothrow) ptrdiff_t[dest]);
+            pf.tap.reset(new (std::nothrow) PolyphaseTap[dest * taps]);
+            pf.splat = make_AlignedArrayXMVECTOR(uint64_t(dest) * taps);
+            if (!pf.first || !pf.tap || !pf.splat)
+            {
+                pf.taps = 0;
+                return E_OUTOFMEMORY;
+            }
+
+            pf.taps = taps;
+
+            for (size_t u = 0; u < dest; ++u)
+            {
+                const float center = (float(u) + 0.5f) / scale - 0.5f;
+                const auto first = static_cast<ptrdiff_t>(floorf(center - support)) + 1;
+
+                pf.first[u] = first;
+
+                PolyphaseTap* entry = &pf.tap[u * taps];
+
+                float total = 0.f;
+                for (size_t k = 0; k < taps; ++k)
+                {
+                    const ptrdiff_t j = first + ptrdiff_t(k);
+                    const float weight = kernel((float(j) - center) * fscale);
+
+                    entry[k].u = size_t(boundpolyphase(j, ptrdiff_t(source), wrap, mirror));
+                    entry[k].weight = weight;
+                    total += weight;
+                }
+
+                // Normalize so flat regions are preserved exactly
+                if (fabsf(total) > 1e-6f)
+                {
+                    const float inv = 1.f / total;
+                    for (size_t k = 0; k < taps; ++k)
+                    {
+                        entry[k].weight *= inv;
+                    }
+                }
+
+                for (size_t k = 0; k < taps; ++k)
+                {
+                    pf.splat[u * taps + k] = XMVectorReplicate(entry[k].weight);
+                }
+            }
+
+            return S_OK;
+        }
     } // namespace Filters
 } // namespace DirectX
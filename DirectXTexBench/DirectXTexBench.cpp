@@ -0,0 +1,1353 @@
+//--------------------------------------------------------------------------------------
+// File: DirectXTexBench.cpp
+//
+// DirectX Texture Library - Performance benchmarks for the core CPU kernels
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#if __cplusplus < 201703L
+#error Requires C++17 (and /Zc:__cplusplus with MSVC)
+#endif
+
+#include "DirectXTexP.h"
+#include "BC.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace DirectX;
+using namespace DirectX::Internal;
+
+namespace
+{
+    const char* g_ToolName = "DirectXTexBench";
+
+    struct SOptions
+    {
+        size_t                          size;
+        double                          minTime;
+        const char*                     filter;
+        const char*                     jsonFile;
+        bool                            json;
+        bool                            list;
+        bool                            verify;
+        std::vector<std::string>        fixtures;
+    };
+
+    // Each benchmark reports throughput against the pixels and bytes one iteration consumes;
+    // encoders can also report the PSNR of their last output
+    struct SBenchmark
+    {
+        std::string                     name;
+        uint64_t                        pixels;
+        uint64_t                        bytes;
+        std::function<HRESULT()>        run;
+        std::function<double()>         psnr;
+    };
+
+    // Each check compares an optimized path against its reference implementation, returning
+    // S_FALSE and a description of the first difference when the results do not match
+    struct SCheck
+    {
+        std::string                             name;
+        std::function<HRESULT(std::string&)>    run;
+    };
+
+    struct SResult
+    {
+        std::string                     name;
+        uint64_t                        iterations;
+        double                          seconds;
+        uint64_t                        pixels;
+        uint64_t                        bytes;
+        double                          psnr;
+    };
+
+    const DXGI_FORMAT g_LoadFormats[] =
+    {
+        DXGI_FORMAT_R32G32B32A32_FLOAT,
+        DXGI_FORMAT_R16G16B16A16_FLOAT,
+        DXGI_FORMAT_R16G16B16A16_UNORM,
+        DXGI_FORMAT_R10G10B10A2_UNORM,
+        DXGI_FORMAT_R11G11B10_FLOAT,
+        DXGI_FORMAT_R9G9B9E5_SHAREDEXP,
+        DXGI_FORMAT_R8G8B8A8_UNORM,
+        DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        DXGI_FORMAT_B5G6R5_UNORM,
+        DXGI_FORMAT_R8G8_UNORM,
+        DXGI_FORMAT_R16_FLOAT,
+        DXGI_FORMAT_R8_UNORM,
+    };
+
+    struct SConvertCase
+    {
+        DXGI_FORMAT         src;
+        DXGI_FORMAT         dst;
+        TEX_FILTER_FLAGS    filter;
+    };
+
+    const SConvertCase g_ConvertCases[] =
+    {
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_B8G8R8A8_UNORM,         TEX_FILTER_DEFAULT },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R32G32B32A32_FLOAT,     TEX_FILTER_DEFAULT },
+        { DXGI_FORMAT_R32G32B32A32_FLOAT,   DXGI_FORMAT_R8G8B8A8_UNORM,         TEX_FILTER_DEFAULT },
+        { DXGI_FORMAT_R32G32B32A32_FLOAT,   DXGI_FORMAT_R8G8B8A8_UNORM,         TEX_FILTER_DITHER },
+        { DXGI_FORMAT_R16G16B16A16_FLOAT,   DXGI_FORMAT_R10G10B10A2_UNORM,      TEX_FILTER_DEFAULT },
+        { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,  DXGI_FORMAT_R16G16B16A16_FLOAT,     TEX_FILTER_DEFAULT },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_B5G6R5_UNORM,           TEX_FILTER_DEFAULT },
+    };
+
+    struct SFilterName
+    {
+        const char*         name;
+        TEX_FILTER_FLAGS    filter;
+    };
+
+    const SFilterName g_Filters[] =
+    {
+        { "POINT",      TEX_FILTER_POINT },
+        { "LINEAR",     TEX_FILTER_LINEAR },
+        { "CUBIC",      TEX_FILTER_CUBIC },
+        { "BOX",        TEX_FILTER_BOX },
+        { "TRIANGLE",   TEX_FILTER_TRIANGLE },
+        { "LANCZOS",    TEX_FILTER_LANCZOS },
+        { "MITCHELL",   TEX_FILTER_MITCHELL },
+        { "KAISER",     TEX_FILTER_KAISER },
+    };
+
+    // The BC6H/BC7 encoders are orders of magnitude slower, so every encoder runs on a fixed block set
+    constexpr size_t c_EncodeBlocks = 4096;
+
+    struct SEncoder
+    {
+        const char*         name;
+        size_t              blockSize;
+        BC_ENCODE           pfEncode;
+    };
+
+    void EncodeBC1(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+    {
+        D3DXEncodeBC1(pBC, pColor, TEX_THRESHOLD_DEFAULT, flags);
+    }
+
+    const SEncoder g_Encoders[] =
+    {
+        { "BC1",    8,  EncodeBC1 },
+        { "BC2",    16, D3DXEncodeBC2 },
+        { "BC3",    16, D3DXEncodeBC3 },
+        { "BC4U",   8,  D3DXEncodeBC4U },
+        { "BC4S",   8,  D3DXEncodeBC4S },
+        { "BC5U",   16, D3DXEncodeBC5U },
+        { "BC5S",   16, D3DXEncodeBC5S },
+        { "BC6HU",  16, D3DXEncodeBC6HU },
+        { "BC6HS",  16, D3DXEncodeBC6HS },
+        { "BC7",    16, D3DXEncodeBC7 },
+    };
+
+    // Encoder settings measured for speed against quality, which also report the PSNR of the encoded blocks
+    struct SEncoderLevel
+    {
+        const char*         name;
+        BC_ENCODE           pfEncode;
+        BC_DECODE           pfDecode;
+        uint32_t            flags;
+    };
+
+    const SEncoderLevel g_EncoderLevels[] =
+    {
+        { "BC7/LEVEL0", D3DXEncodeBC7, D3DXDecodeBC7, TEX_BC7_QUALITY_LEVEL0 << BC_FLAGS_BC7_QUALITY_SHIFT },
+        { "BC7/LEVEL1", D3DXEncodeBC7, D3DXDecodeBC7, TEX_BC7_QUALITY_LEVEL1 << BC_FLAGS_BC7_QUALITY_SHIFT },
+        { "BC7/LEVEL2", D3DXEncodeBC7, D3DXDecodeBC7, TEX_BC7_QUALITY_LEVEL2 << BC_FLAGS_BC7_QUALITY_SHIFT },
+        { "BC7/LEVEL3", D3DXEncodeBC7, D3DXDecodeBC7, TEX_BC7_QUALITY_LEVEL3 << BC_FLAGS_BC7_QUALITY_SHIFT },
+        { "BC7/LEVEL4", D3DXEncodeBC7, D3DXDecodeBC7, TEX_BC7_QUALITY_LEVEL4 << BC_FLAGS_BC7_QUALITY_SHIFT },
+        { "BC7/LEVEL5", D3DXEncodeBC7, D3DXDecodeBC7, TEX_BC7_QUALITY_LEVEL5 << BC_FLAGS_BC7_QUALITY_SHIFT },
+        { "BC6HU/SHAPES1",  D3DXEncodeBC6HU, D3DXDecodeBC6HU, 1u << BC_FLAGS_BC6H_SHAPES_SHIFT },
+        { "BC6HU/SHAPES8",  D3DXEncodeBC6HU, D3DXDecodeBC6HU, BC_FLAGS_NONE },
+        { "BC6HU/SHAPES32", D3DXEncodeBC6HU, D3DXDecodeBC6HU, 32u << BC_FLAGS_BC6H_SHAPES_SHIFT },
+        { "BC6HU/PERMODE",  D3DXEncodeBC6HU, D3DXDecodeBC6HU, BC_FLAGS_BC6H_RANK_PER_MODE },
+    };
+
+    // Formats with a vectorized LoadScanline or StoreScanline path
+    const DXGI_FORMAT g_ScanlineSIMDFormats[] =
+    {
+        DXGI_FORMAT_R32G32B32A32_FLOAT,
+        DXGI_FORMAT_R16G16B16A16_FLOAT,
+        DXGI_FORMAT_R10G10B10A2_UNORM,
+        DXGI_FORMAT_R8G8B8A8_UNORM,
+        DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,
+    };
+
+    // Float bit patterns the store paths must handle like the scalar code: NaNs, infinities,
+    // signed zeros, float and half denormals, and values outside the range of the format
+    const uint32_t g_SpecialFloats[] =
+    {
+        0x7FC00000, 0xFFC00000, 0x7F800001, 0x7FBFFFFF, 0x7F800000, 0xFF800000,
+        0x00000000, 0x80000000, 0x00000001, 0x807FFFFF, 0x00800000, 0x33800000,
+        0x387FC000, 0x477FE000, 0x477FF000, 0x47800000, 0xC7800000, 0x4F000000,
+        0x3F800000, 0x3F800001, 0x3F7FFFFF, 0xB8D1B717, 0x3B008081, 0x3BC0C0C1,
+        0x3F7F7F7F, 0x40000000, 0xC0000000, 0x7F7FFFFF, 0xFF7FFFFF,
+    };
+
+    const char* GetFormatName(DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:    return "R32G32B32A32_FLOAT";
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:    return "R16G16B16A16_FLOAT";
+        case DXGI_FORMAT_R16G16B16A16_UNORM:    return "R16G16B16A16_UNORM";
+        case DXGI_FORMAT_R10G10B10A2_UNORM:     return "R10G10B10A2_UNORM";
+        case DXGI_FORMAT_R11G11B10_FLOAT:       return "R11G11B10_FLOAT";
+        case DXGI_FORMAT_R9G9B9E5_SHAREDEXP:    return "R9G9B9E5_SHAREDEXP";
+        case DXGI_FORMAT_R8G8B8A8_UNORM:        return "R8G8B8A8_UNORM";
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:   return "R8G8B8A8_UNORM_SRGB";
+        case DXGI_FORMAT_B8G8R8A8_UNORM:        return "B8G8R8A8_UNORM";
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:   return "B8G8R8A8_UNORM_SRGB";
+        case DXGI_FORMAT_B5G6R5_UNORM:          return "B5G6R5_UNORM";
+        case DXGI_FORMAT_R8G8_UNORM:            return "R8G8_UNORM";
+        case DXGI_FORMAT_R16_FLOAT:             return "R16_FLOAT";
+        case DXGI_FORMAT_R8_UNORM:              return "R8_UNORM";
+        default:                                return "OTHER";
+        }
+    }
+
+    //----------------------------------------------------------------------------------
+    // Creates a deterministic test pattern: smooth gradients with per-pixel noise so
+    // the BC encoders and filters see both flat and detailed regions.
+    HRESULT CreateSyntheticImage(size_t width, size_t height, DXGI_FORMAT format, ScratchImage& result) noexcept
+    {
+        ScratchImage image;
+        HRESULT hr = image.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, width, height, 1, 1);
+        if (FAILED(hr))
+            return hr;
+
+        const Image* img = image.GetImage(0, 0, 0);
+        uint32_t seed = 0x12345678u;
+        for (size_t y = 0; y < height; ++y)
+        {
+            auto pRow = reinterpret_cast<XMFLOAT4*>(img->pixels + y * img->rowPitch);
+            for (size_t x = 0; x < width; ++x)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const float noise = float(seed >> 8) * (1.f / 16777216.f) * 0.125f;
+                const float u = float(x) / float(width);
+                const float v = float(y) / float(height);
+                pRow[x] = XMFLOAT4(
+                    std::min(u + noise, 1.f),
+                    std::min(v + noise, 1.f),
+                    float((x ^ y) & 0x3F) * (1.f / 63.f),
+                    std::min(0.5f + 0.5f * u * v + noise, 1.f));
+            }
+        }
+
+        if (format == DXGI_FORMAT_R32G32B32A32_FLOAT)
+        {
+            result = std::move(image);
+            return S_OK;
+        }
+
+        return Convert(*img, format, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, result);
+    }
+
+    HRESULT LoadFixture(const std::string& fileName, ScratchImage& result)
+    {
+        const std::filesystem::path path(fileName);
+        const std::wstring wpath = path.wstring();
+        std::string ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+
+        ScratchImage image;
+        HRESULT hr = E_FAIL;
+        if (ext == ".dds")
+        {
+            hr = LoadFromDDSFile(wpath.c_str(), DDS_FLAGS_ALLOW_LARGE_FILES, nullptr, image);
+        }
+        else if (ext == ".tga")
+        {
+            hr = LoadFromTGAFile(wpath.c_str(), TGA_FLAGS_NONE, nullptr, image);
+        }
+        else if (ext == ".hdr")
+        {
+            hr = LoadFromHDRFile(wpath.c_str(), nullptr, image);
+        }
+    #ifdef _WIN32
+        else
+        {
+            hr = LoadFromWICFile(wpath.c_str(), WIC_FLAGS_NONE, nullptr, image);
+        }
+    #else
+        else
+        {
+            hr = HRESULT_E_NOT_SUPPORTED;
+        }
+    #endif
+        if (FAILED(hr))
+            return hr;
+
+        // Benchmarks always work from the top-level 2D surface
+        const Image* img = image.GetImage(0, 0, 0);
+        if (IsCompressed(img->format))
+        {
+            return Decompress(*img, DXGI_FORMAT_UNKNOWN, result);
+        }
+
+        return result.InitializeFromImage(*img);
+    }
+
+    //----------------------------------------------------------------------------------
+    // PSNR over RGBA of decoded blocks against their [0,1] source
+    double ComputeBlockPSNR(const XMVECTOR* pSource, const XMVECTOR* pDecoded, size_t nblocks) noexcept
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < nblocks * NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const XMVECTOR d = XMVectorSubtract(pSource[i], pDecoded[i]);
+            sum += double(XMVectorGetX(XMVector4Dot(d, d)));
+        }
+
+        const double mse = sum / double(nblocks * NUM_PIXELS_PER_BLOCK * 4);
+        return (mse > 0.0) ? 10.0 * log10(1.0 / mse) : 999.0;
+    }
+
+    //----------------------------------------------------------------------------------
+    void AddLoadScanline(std::vector<SBenchmark>& list, const std::string& name, const std::shared_ptr<ScratchImage>& source)
+    {
+        const Image* img = source->GetImage(0, 0, 0);
+        if (IsCompressed(img->format) || IsPlanar(img->format) || IsPalettized(img->format))
+            return;
+
+        auto scanline = std::shared_ptr<XMVECTOR>(make_AlignedArrayXMVECTOR(img->width).release(), aligned_deleter());
+        if (!scanline)
+            return;
+
+        list.push_back({ name, uint64_t(img->width) * img->height, uint64_t(img->rowPitch) * img->height,
+            [source, img, scanline]() -> HRESULT
+            {
+                const uint8_t* pSrc = img->pixels;
+                for (size_t y = 0; y < img->height; ++y, pSrc += img->rowPitch)
+                {
+                    if (!LoadScanline(scanline.get(), img->width, pSrc, img->rowPitch, img->format))
+                        return E_FAIL;
+                }
+                return S_OK;
+            }, nullptr });
+    }
+
+    void AddConvert(std::vector<SBenchmark>& list, const std::string& name, const std::shared_ptr<ScratchImage>& source,
+        DXGI_FORMAT format, TEX_FILTER_FLAGS filter)
+    {
+        const Image* img = source->GetImage(0, 0, 0);
+        list.push_back({ name, uint64_t(img->width) * img->height, uint64_t(img->rowPitch) * img->height,
+            [source, img, format, filter]() -> HRESULT
+            {
+                ScratchImage result;
+                return Convert(*img, format, filter, TEX_THRESHOLD_DEFAULT, result);
+            }, nullptr });
+    }
+
+    void AddGenerateMipMaps(std::vector<SBenchmark>& list, const std::string& name, const std::shared_ptr<ScratchImage>& source,
+        TEX_FILTER_FLAGS filter)
+    {
+        const Image* img = source->GetImage(0, 0, 0);
+        list.push_back({ name, uint64_t(img->width) * img->height, uint64_t(img->rowPitch) * img->height,
+            [source, img, filter]() -> HRESULT
+            {
+                ScratchImage result;
+                return GenerateMipMaps(*img, filter | TEX_FILTER_FORCE_NON_WIC, 0, result);
+            }, nullptr });
+    }
+
+    void AddResize(std::vector<SBenchmark>& list, const std::string& name, const std::shared_ptr<ScratchImage>& source,
+        size_t width, size_t height, TEX_FILTER_FLAGS filter)
+    {
+        const Image* img = source->GetImage(0, 0, 0);
+        list.push_back({ name, uint64_t(width) * height, uint64_t(img->rowPitch) * img->height,
+            [source, img, width, height, filter]() -> HRESULT
+            {
+                ScratchImage result;
+                return Resize(*img, width, height, filter | TEX_FILTER_FORCE_NON_WIC, result);
+            }, nullptr });
+    }
+
+    void AddComputeImageQuality(std::vector<SBenchmark>& list, const std::string& name, const std::shared_ptr<ScratchImage>& source,
+        CMSE_FLAGS flags)
+    {
+        const Image* img = source->GetImage(0, 0, 0);
+        list.push_back({ name, uint64_t(img->width) * img->height, uint64_t(img->rowPitch) * img->height * 2,
+            [source, img, flags]() -> HRESULT
+            {
+                ImageQuality quality;
+                return ComputeImageQuality(*img, *img, quality, flags);
+            }, nullptr });
+    }
+
+    void AddEncoder(std::vector<SBenchmark>& list, const std::string& name, const std::shared_ptr<XMVECTOR>& blocks, size_t nblocks,
+        size_t blockSize, BC_ENCODE pfEncode, BC_DECODE pfDecode, uint32_t flags)
+    {
+        auto output = std::make_shared<std::vector<uint8_t>>(nblocks * blockSize);
+
+        SBenchmark bench = { name,
+            uint64_t(nblocks) * NUM_PIXELS_PER_BLOCK, uint64_t(nblocks) * NUM_PIXELS_PER_BLOCK * sizeof(XMVECTOR),
+            [blocks, output, nblocks, pfEncode, blockSize, flags]() -> HRESULT
+            {
+                uint8_t* pDest = output->data();
+                for (size_t b = 0; b < nblocks; ++b, pDest += blockSize)
+                {
+                    pfEncode(pDest, blocks.get() + b * NUM_PIXELS_PER_BLOCK, flags);
+                }
+                return S_OK;
+            },
+            nullptr };
+
+        if (pfDecode)
+        {
+            bench.psnr = [blocks, output, nblocks, pfDecode, blockSize]() -> double
+                {
+                    auto decoded = make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK);
+                    if (!decoded)
+                        return -1.0;
+
+                    for (size_t b = 0; b < nblocks; ++b)
+                    {
+                        pfDecode(decoded.get() + b * NUM_PIXELS_PER_BLOCK, output->data() + b * blockSize);
+                    }
+                    return ComputeBlockPSNR(blocks.get(), decoded.get(), nblocks);
+                };
+        }
+
+        list.push_back(std::move(bench));
+    }
+
+    void AddEncoders(std::vector<SBenchmark>& list, const std::string& suffix, const std::shared_ptr<ScratchImage>& source)
+    {
+        const Image* img = source->GetImage(0, 0, 0);
+        assert(img->format == DXGI_FORMAT_R32G32B32A32_FLOAT);
+
+        const size_t blocksX = img->width / 4;
+        const size_t blocksY = img->height / 4;
+        const size_t nblocks = std::min(blocksX * blocksY, c_EncodeBlocks);
+        if (!nblocks)
+            return;
+
+        auto blocks = std::shared_ptr<XMVECTOR>(make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK).release(), aligned_deleter());
+        if (!blocks)
+            return;
+
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            const size_t bx = (b % blocksX) * 4;
+            const size_t by = (b / blocksX) * 4;
+            for (size_t j = 0; j < 4; ++j)
+            {
+                auto pRow = reinterpret_cast<const XMVECTOR*>(img->pixels + (by + j) * img->rowPitch);
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    blocks.get()[b * NUM_PIXELS_PER_BLOCK + j * 4 + i] = pRow[bx + i];
+                }
+            }
+        }
+
+        for (const auto& encoder : g_Encoders)
+        {
+            AddEncoder(list, std::string("D3DXEncode") + encoder.name + suffix, blocks, nblocks,
+                encoder.blockSize, encoder.pfEncode, nullptr, BC_FLAGS_NONE);
+        }
+
+        for (const auto& level : g_EncoderLevels)
+        {
+            AddEncoder(list, std::string("D3DXEncode") + level.name + suffix, blocks, nblocks,
+                16, level.pfEncode, level.pfDecode, level.flags);
+        }
+    }
+
+    //----------------------------------------------------------------------------------
+    HRESULT BuildBenchmarks(const SOptions& opts, std::vector<SBenchmark>& list)
+    {
+        const size_t size = opts.size;
+
+        std::vector<std::shared_ptr<ScratchImage>> sources;
+        auto getSource = [&](DXGI_FORMAT format) -> std::shared_ptr<ScratchImage>
+        {
+            for (const auto& it : sources)
+            {
+                if (it->GetMetadata().format == format)
+                    return it;
+            }
+
+            auto image = std::make_shared<ScratchImage>();
+            if (FAILED(CreateSyntheticImage(size, size, format, *image)))
+                return nullptr;
+
+            sources.push_back(image);
+            return image;
+        };
+
+        const std::string dims = "/" + std::to_string(size) + "x" + std::to_string(size);
+
+        for (const auto format : g_LoadFormats)
+        {
+            auto source = getSource(format);
+            if (!source)
+                return E_OUTOFMEMORY;
+
+            AddLoadScanline(list, std::string("LoadScanline/") + GetFormatName(format) + dims, source);
+        }
+
+        for (const auto& it : g_ConvertCases)
+        {
+            auto source = getSource(it.src);
+            if (!source)
+                return E_OUTOFMEMORY;
+
+            std::string name = std::string("Convert/") + GetFormatName(it.src) + "->" + GetFormatName(it.dst);
+            if (it.filter & TEX_FILTER_DITHER)
+                name += "/DITHER";
+
+            AddConvert(list, name + dims, source, it.dst, it.filter);
+        }
+
+        auto rgba8 = getSource(DXGI_FORMAT_R8G8B8A8_UNORM);
+        auto rgba32f = getSource(DXGI_FORMAT_R32G32B32A32_FLOAT);
+        if (!rgba8 || !rgba32f)
+            return E_OUTOFMEMORY;
+
+        for (const auto& it : g_Filters)
+        {
+            AddGenerateMipMaps(list, std::string("GenerateMipMaps/") + it.name + "/R8G8B8A8_UNORM" + dims, rgba8, it.filter);
+        }
+        AddGenerateMipMaps(list, "GenerateMipMaps/BOX/R32G32B32A32_FLOAT" + dims, rgba32f, TEX_FILTER_BOX);
+
+        // The polyphase filters against the cubic filter they replace, without format conversion in the way
+        AddGenerateMipMaps(list, "GenerateMipMaps/CUBIC/R32G32B32A32_FLOAT" + dims, rgba32f, TEX_FILTER_CUBIC);
+        AddGenerateMipMaps(list, "GenerateMipMaps/LANCZOS/R32G32B32A32_FLOAT" + dims, rgba32f, TEX_FILTER_LANCZOS);
+        AddGenerateMipMaps(list, "GenerateMipMaps/MITCHELL/R32G32B32A32_FLOAT" + dims, rgba32f, TEX_FILTER_MITCHELL);
+
+        for (const auto& it : g_Filters)
+        {
+            AddResize(list, std::string("Resize/") + it.name + "/Down2x" + dims, rgba8, size / 2, size / 2, it.filter);
+            AddResize(list, std::string("Resize/") + it.name + "/Up1.5x" + dims, rgba8, size + size / 2, size + size / 2, it.filter);
+        }
+
+        // SSIM, MS-SSIM, and PSNR-HVS; the coarser scales are rebuilt from the image, so the sRGB rows include that load cost
+        AddComputeImageQuality(list, "ComputeImageQuality/R8G8B8A8_UNORM" + dims, rgba8, CMSE_DEFAULT);
+        AddComputeImageQuality(list, "ComputeImageQuality/R8G8B8A8_UNORM/SRGB" + dims, rgba8, CMSE_IMAGE1_SRGB | CMSE_IMAGE2_SRGB);
+        AddComputeImageQuality(list, "ComputeImageQuality/R32G32B32A32_FLOAT" + dims, rgba32f, CMSE_DEFAULT);
+
+        AddEncoders(list, "", rgba32f);
+
+        // Fixture images exercise real content through the same kernels
+        for (const auto& fileName : opts.fixtures)
+        {
+            auto fixture = std::make_shared<ScratchImage>();
+            HRESULT hr = LoadFixture(fileName, *fixture);
+            if (FAILED(hr))
+            {
+                fprintf(stderr, "ERROR: Failed loading fixture %s (%08X)\n", fileName.c_str(), static_cast<unsigned int>(hr));
+                return hr;
+            }
+
+            const std::string label = "/fixture:" + std::filesystem::path(fileName).filename().string();
+            const Image* img = fixture->GetImage(0, 0, 0);
+
+            AddLoadScanline(list, std::string("LoadScanline/") + GetFormatName(img->format) + label, fixture);
+            AddConvert(list, "Convert/->R32G32B32A32_FLOAT" + label, fixture, DXGI_FORMAT_R32G32B32A32_FLOAT, TEX_FILTER_DEFAULT);
+            AddGenerateMipMaps(list, "GenerateMipMaps/BOX" + label, fixture, TEX_FILTER_BOX);
+            AddResize(list, "Resize/LINEAR/Down2x" + label, fixture,
+                std::max<size_t>(img->width / 2, 1), std::max<size_t>(img->height / 2, 1), TEX_FILTER_LINEAR);
+
+            auto fixture32f = std::make_shared<ScratchImage>();
+            if (img->format == DXGI_FORMAT_R32G32B32A32_FLOAT)
+            {
+                hr = fixture32f->InitializeFromImage(*img);
+            }
+            else
+            {
+                hr = Convert(*img, DXGI_FORMAT_R32G32B32A32_FLOAT, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, *fixture32f);
+            }
+            if (FAILED(hr))
+                return hr;
+
+            AddEncoders(list, label, fixture32f);
+        }
+
+        return S_OK;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Compares the vectorized LoadScanline/StoreScanline paths against the per-pixel
+    // conversions. Loads see every bit pattern (including half NaNs and denormals), stores
+    // see the special float values plus random values outside [0,1], and the row width is
+    // odd so the scalar tails of the vector loops run too.
+    HRESULT CheckScanline(DXGI_FORMAT format, size_t width, std::string& message)
+    {
+        const size_t rowPitch = width * BitsPerPixel(format) / 8;
+
+        auto fast = make_AlignedArrayXMVECTOR(width);
+        auto reference = make_AlignedArrayXMVECTOR(width);
+        auto source = make_AlignedArrayXMVECTOR(width);
+        std::unique_ptr<uint8_t[]> bytes(new (std::nothrow) uint8_t[rowPitch]);
+        std::unique_ptr<uint8_t[]> fastBytes(new (std::nothrow) uint8_t[rowPitch]);
+        std::unique_ptr<uint8_t[]> referenceBytes(new (std::nothrow) uint8_t[rowPitch]);
+        if (!fast || !reference || !source || !bytes || !fastBytes || !referenceBytes)
+            return E_OUTOFMEMORY;
+
+        uint32_t seed = 0x9E3779B9u;
+        auto next = [&seed]() noexcept { seed = seed * 1664525u + 1013904223u; return seed; };
+
+        for (size_t pass = 0; pass < 64; ++pass)
+        {
+            // Load: random bytes, then compare the XMVECTOR results bit-for-bit
+            for (size_t j = 0; j < rowPitch; ++j)
+            {
+                bytes[j] = static_cast<uint8_t>(next() >> 24);
+            }
+
+            if (!LoadScanline(fast.get(), width, bytes.get(), rowPitch, format)
+                || !LoadScanlineScalar(reference.get(), width, bytes.get(), rowPitch, format))
+                return E_FAIL;
+
+            for (size_t x = 0; x < width; ++x)
+            {
+                if (memcmp(&fast[x], &reference[x], sizeof(XMVECTOR)) != 0)
+                {
+                    message = "load differs at pixel " + std::to_string(x);
+                    return S_FALSE;
+                }
+            }
+
+            // Round-trip: each path stores what it loaded
+            if (!StoreScanline(fastBytes.get(), rowPitch, format, fast.get(), width)
+                || !StoreScanlineScalar(referenceBytes.get(), rowPitch, format, reference.get(), width))
+                return E_FAIL;
+
+            if (memcmp(fastBytes.get(), referenceBytes.get(), rowPitch) != 0)
+            {
+                message = "round-trip differs";
+                return S_FALSE;
+            }
+
+            // Store: special values first, then random values in [-2,2]
+            auto pFloats = reinterpret_cast<uint32_t*>(source.get());
+            for (size_t j = 0; j < width * 4; ++j)
+            {
+                if (j < std::size(g_SpecialFloats))
+                {
+                    pFloats[j] = g_SpecialFloats[(j + pass) % std::size(g_SpecialFloats)];
+                }
+                else
+                {
+                    const float value = (float(next() >> 8) * (1.f / 16777216.f)) * 4.f - 2.f;
+                    memcpy(&pFloats[j], &value, sizeof(float));
+                }
+            }
+
+            if (!StoreScanline(fastBytes.get(), rowPitch, format, source.get(), width)
+                || !StoreScanlineScalar(referenceBytes.get(), rowPitch, format, source.get(), width))
+                return E_FAIL;
+
+            for (size_t x = 0; x < width; ++x)
+            {
+                const size_t bpp = rowPitch / width;
+                if (memcmp(fastBytes.get() + x * bpp, referenceBytes.get() + x * bpp, bpp) != 0)
+                {
+                    message = "store differs at pixel " + std::to_string(x);
+                    return S_FALSE;
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Creates blocks for the encoder checks, cycling through random, solid, two-color, and
+    // gradient content; gradients ramp alpha through the BC1 transparency threshold.
+    void CreateCheckBlocks(XMVECTOR* pBlocks, size_t nblocks, bool hdr) noexcept
+    {
+        uint32_t seed = 0x2545F491u;
+        auto next = [&seed]() noexcept { seed = seed * 1664525u + 1013904223u; return float(seed >> 8) * (1.f / 16777216.f); };
+
+        const float range = hdr ? 16.f : 1.f;
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            XMVECTOR* pColor = pBlocks + b * NUM_PIXELS_PER_BLOCK;
+            const XMVECTOR c0 = XMVectorScale(XMVectorSet(next(), next(), next(), 1.f), range);
+            const XMVECTOR c1 = XMVectorScale(XMVectorSet(next(), next(), next(), 1.f), range);
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                switch (b % 4)
+                {
+                case 0: pColor[i] = XMVectorScale(XMVectorSet(next(), next(), next(), next()), range); break;
+                case 1: pColor[i] = c0; break;
+                case 2: pColor[i] = (next() < 0.5f) ? c0 : c1; break;
+                default: pColor[i] = XMVectorSetW(XMVectorLerp(c0, c1, float(i) / 15.f), float(i) / 15.f); break;
+                }
+
+                if (hdr)
+                {
+                    pColor[i] = XMVectorSetW(pColor[i], 1.f);
+                }
+            }
+        }
+    }
+
+    // Compares the SIMD lane BC1/BC3 batch encoder against the per-block encoder. The batch
+    // path repeats the per-block arithmetic, so the blocks should match; a difference from
+    // FMA contraction is accepted if it costs no more than 0.01 dB.
+    HRESULT CheckBatchEncoder(bool bc3, uint32_t flags, std::string& message)
+    {
+        constexpr size_t nblocks = 4096;
+        const size_t blockSize = bc3 ? 16 : 8;
+
+        auto blocks = make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK);
+        auto decoded = make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK);
+        std::unique_ptr<uint8_t[]> fast(new (std::nothrow) uint8_t[nblocks * blockSize]);
+        std::unique_ptr<uint8_t[]> reference(new (std::nothrow) uint8_t[nblocks * blockSize]);
+        if (!blocks || !decoded || !fast || !reference)
+            return E_OUTOFMEMORY;
+
+        CreateCheckBlocks(blocks.get(), nblocks, false);
+
+        const BC_DECODE pfDecode = bc3 ? D3DXDecodeBC3 : D3DXDecodeBC1;
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            if (bc3)
+            {
+                D3DXEncodeBC3(reference.get() + b * blockSize, blocks.get() + b * NUM_PIXELS_PER_BLOCK, flags);
+            }
+            else
+            {
+                D3DXEncodeBC1(reference.get() + b * blockSize, blocks.get() + b * NUM_PIXELS_PER_BLOCK, TEX_THRESHOLD_DEFAULT, flags);
+            }
+        }
+
+        if (bc3)
+        {
+            D3DXEncodeBC3Batch(fast.get(), blocks.get(), nblocks, flags | BC_FLAGS_BATCH);
+        }
+        else
+        {
+            D3DXEncodeBC1Batch(fast.get(), blocks.get(), nblocks, TEX_THRESHOLD_DEFAULT, flags | BC_FLAGS_BATCH);
+        }
+
+        size_t differ = 0;
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            if (memcmp(fast.get() + b * blockSize, reference.get() + b * blockSize, blockSize) != 0)
+                ++differ;
+        }
+
+        if (!differ)
+            return S_OK;
+
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            pfDecode(decoded.get() + b * NUM_PIXELS_PER_BLOCK, reference.get() + b * blockSize);
+        }
+        const double referencePSNR = ComputeBlockPSNR(blocks.get(), decoded.get(), nblocks);
+
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            pfDecode(decoded.get() + b * NUM_PIXELS_PER_BLOCK, fast.get() + b * blockSize);
+        }
+        const double fastPSNR = ComputeBlockPSNR(blocks.get(), decoded.get(), nblocks);
+
+        char text[128] = {};
+        snprintf(text, sizeof(text), "%zu of %zu blocks differ, %+.4f dB", differ, nblocks, fastPSNR - referencePSNR);
+        message = text;
+
+        return (fastPSNR >= referencePSNR - 0.01) ? S_OK : S_FALSE;
+    }
+
+    // Compares the BC7 block classifier against the full mode search. The mode 5 encoding of
+    // solid blocks must be no worse on any block, and trying the single subset modes first on
+    // two color blocks must reach the same error overall.
+    HRESULT CheckBC7Classifier(std::string& message)
+    {
+        constexpr size_t nblocks = 2048;
+
+        auto blocks = make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK);
+        auto fast = make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK);
+        auto reference = make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK);
+        if (!blocks || !fast || !reference)
+            return E_OUTOFMEMORY;
+
+        CreateCheckBlocks(blocks.get(), nblocks, false);
+
+        size_t solidWorse = 0;
+        size_t twoColorWorse = 0;
+        double twoColorError[2] = {};
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            const size_t kind = b % 4;
+            if (kind != 1 && kind != 2)
+                continue;
+
+            const size_t offset = b * NUM_PIXELS_PER_BLOCK;
+            uint8_t bc[16] = {};
+            D3DXEncodeBC7(bc, blocks.get() + offset, BC_FLAGS_NONE);
+            D3DXDecodeBC7(fast.get() + offset, bc);
+            D3DXEncodeBC7(bc, blocks.get() + offset, BC_FLAGS_BC7_FULL_SEARCH);
+            D3DXDecodeBC7(reference.get() + offset, bc);
+
+            double error[2] = {};
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                XMVECTOR d = XMVectorSubtract(blocks.get()[offset + i], fast.get()[offset + i]);
+                error[0] += double(XMVectorGetX(XMVector4Dot(d, d)));
+                d = XMVectorSubtract(blocks.get()[offset + i], reference.get()[offset + i]);
+                error[1] += double(XMVectorGetX(XMVector4Dot(d, d)));
+            }
+
+            if (kind == 1)
+            {
+                if (error[0] > error[1])
+                    ++solidWorse;
+            }
+            else
+            {
+                if (error[0] > error[1])
+                    ++twoColorWorse;
+                twoColorError[0] += error[0];
+                twoColorError[1] += error[1];
+            }
+        }
+
+        const double delta = (twoColorError[0] > 0.0 && twoColorError[1] > 0.0)
+            ? 10.0 * log10(twoColorError[1] / twoColorError[0]) : 0.0;
+
+        char text[128] = {};
+        snprintf(text, sizeof(text), "%zu solid and %zu two color blocks worse, two color %+.4f dB", solidWorse, twoColorWorse, delta);
+        message = text;
+
+        return (!solidWorse && delta >= -0.01) ? S_OK : S_FALSE;
+    }
+
+    // Checks that the mode 6 only settings emit nothing but mode 6 blocks, including for the
+    // solid and two color blocks the classifier would otherwise shortcut.
+    HRESULT CheckBC7ModeSixOnly(uint32_t flags, std::string& message)
+    {
+        constexpr size_t nblocks = 2048;
+
+        auto blocks = make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK);
+        if (!blocks)
+            return E_OUTOFMEMORY;
+
+        CreateCheckBlocks(blocks.get(), nblocks, false);
+
+        size_t other = 0;
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            uint8_t bc[16] = {};
+            D3DXEncodeBC7(bc, blocks.get() + b * NUM_PIXELS_PER_BLOCK, flags);
+
+            // Mode 6 is six zero bits followed by a one
+            if ((bc[0] & 0x7F) != 0x40)
+                ++other;
+        }
+
+        if (!other)
+            return S_OK;
+
+        char text[128] = {};
+        snprintf(text, sizeof(text), "%zu of %zu blocks not mode 6", other, nblocks);
+        message = text;
+
+        return S_FALSE;
+    }
+
+    // Compares the BC6H shape ranking shared by all modes with the same region count against
+    // ranking the shapes again for every mode. Both refine the same top shapes, so the encoded
+    // blocks should be identical.
+    HRESULT CheckBC6HShapeRanking(bool bSigned, uint32_t flags, std::string& message)
+    {
+        constexpr size_t nblocks = 2048;
+
+        auto blocks = make_AlignedArrayXMVECTOR(nblocks * NUM_PIXELS_PER_BLOCK);
+        if (!blocks)
+            return E_OUTOFMEMORY;
+
+        CreateCheckBlocks(blocks.get(), nblocks, true);
+
+        if (bSigned)
+        {
+            const XMVECTOR bias = XMVectorSet(8.f, 8.f, 8.f, 0.f);
+            for (size_t i = 0; i < nblocks * NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                blocks.get()[i] = XMVectorSubtract(blocks.get()[i], bias);
+            }
+        }
+
+        const BC_ENCODE pfEncode = bSigned ? D3DXEncodeBC6HS : D3DXEncodeBC6HU;
+        size_t differ = 0;
+        for (size_t b = 0; b < nblocks; ++b)
+        {
+            uint8_t fast[16] = {};
+            uint8_t reference[16] = {};
+            pfEncode(fast, blocks.get() + b * NUM_PIXELS_PER_BLOCK, flags);
+            pfEncode(reference, blocks.get() + b * NUM_PIXELS_PER_BLOCK, flags | BC_FLAGS_BC6H_RANK_PER_MODE);
+            if (memcmp(fast, reference, sizeof(fast)) != 0)
+                ++differ;
+        }
+
+        if (!differ)
+            return S_OK;
+
+        char text[128] = {};
+        snprintf(text, sizeof(text), "%zu of %zu blocks differ", differ, nblocks);
+        message = text;
+
+        return S_FALSE;
+    }
+
+    // Compares GenerateMipMapsAndCompress against GenerateMipMaps with the custom filters followed
+    // by CompressEx. Both generate the same levels in the source format, so every block should match.
+    HRESULT CheckFusedMips(TEX_FILTER_FLAGS filter, size_t width, size_t height, bool srgb, std::string& message)
+    {
+        ScratchImage image;
+        HRESULT hr = CreateSyntheticImage(width, height, srgb ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM, image);
+        if (FAILED(hr))
+            return hr;
+
+        const DXGI_FORMAT format = srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+        CompressOptions options = {};
+        options.threshold = TEX_THRESHOLD_DEFAULT;
+
+        ScratchImage fused;
+        hr = GenerateMipMapsAndCompress(*image.GetImage(0, 0, 0), filter, 0, format, options, fused);
+        if (FAILED(hr))
+            return hr;
+
+        ScratchImage mipChain;
+        hr = GenerateMipMaps(*image.GetImage(0, 0, 0), filter | TEX_FILTER_FORCE_NON_WIC, 0, mipChain);
+        if (FAILED(hr))
+            return hr;
+
+        ScratchImage reference;
+        hr = CompressEx(mipChain.GetImages(), mipChain.GetImageCount(), mipChain.GetMetadata(), format, options, reference);
+        if (FAILED(hr))
+            return hr;
+
+        if (fused.GetImageCount() != reference.GetImageCount())
+        {
+            message = "level count differs";
+            return S_FALSE;
+        }
+
+        size_t differ = 0;
+        for (size_t level = 0; level < reference.GetImageCount(); ++level)
+        {
+            const Image& a = fused.GetImages()[level];
+            const Image& b = reference.GetImages()[level];
+            if (a.slicePitch != b.slicePitch || memcmp(a.pixels, b.pixels, a.slicePitch) != 0)
+                ++differ;
+        }
+
+        if (!differ)
+            return S_OK;
+
+        char text[128] = {};
+        snprintf(text, sizeof(text), "%zu of %zu levels differ", differ, reference.GetImageCount());
+        message = text;
+
+        return S_FALSE;
+    }
+
+    HRESULT BuildChecks(std::vector<SCheck>& list)
+    {
+        for (const auto format : g_ScanlineSIMDFormats)
+        {
+            list.push_back({ std::string("Scanline/") + GetFormatName(format),
+                [format](std::string& message) -> HRESULT
+                {
+                    return CheckScanline(format, 1027, message);
+                } });
+        }
+
+        for (const bool bc3 : { false, true })
+        {
+            for (const uint32_t flags : { uint32_t(BC_FLAGS_NONE), uint32_t(BC_FLAGS_UNIFORM) })
+            {
+                list.push_back({ std::string(bc3 ? "BatchEncoder/BC3" : "BatchEncoder/BC1") + ((flags & BC_FLAGS_UNIFORM) ? "/UNIFORM" : ""),
+                    [bc3, flags](std::string& message) -> HRESULT
+                    {
+                        return CheckBatchEncoder(bc3, flags, message);
+                    } });
+            }
+        }
+
+        list.push_back({ "BC7Classifier", CheckBC7Classifier });
+        list.push_back({ "BC7ModeSixOnly/FORCE_BC7_MODE6",
+            [](std::string& message) -> HRESULT { return CheckBC7ModeSixOnly(BC_FLAGS_FORCE_BC7_MODE6, message); } });
+        list.push_back({ "BC7ModeSixOnly/LEVEL0",
+            [](std::string& message) -> HRESULT { return CheckBC7ModeSixOnly(TEX_BC7_QUALITY_LEVEL0 << BC_FLAGS_BC7_QUALITY_SHIFT, message); } });
+
+        // The default filter is BOX for 256x64, including the levels where one dimension stays at 1, and LINEAR for 200x75
+        list.push_back({ "FusedMips/DEFAULT/256x64",
+            [](std::string& message) -> HRESULT { return CheckFusedMips(TEX_FILTER_DEFAULT, 256, 64, false, message); } });
+        list.push_back({ "FusedMips/DEFAULT/256x64/SRGB",
+            [](std::string& message) -> HRESULT { return CheckFusedMips(TEX_FILTER_DEFAULT, 256, 64, true, message); } });
+        list.push_back({ "FusedMips/DEFAULT/200x75",
+            [](std::string& message) -> HRESULT { return CheckFusedMips(TEX_FILTER_DEFAULT, 200, 75, false, message); } });
+        for (const auto& filter : g_Filters)
+        {
+            list.push_back({ std::string("FusedMips/") + filter.name + "/128x32",
+                [flags = filter.filter](std::string& message) -> HRESULT
+                {
+                    return CheckFusedMips(flags, 128, 32, false, message);
+                } });
+        }
+
+        for (const bool bSigned : { false, true })
+        {
+            for (const uint32_t flags : { uint32_t(BC_FLAGS_NONE), uint32_t(32u << BC_FLAGS_BC6H_SHAPES_SHIFT) })
+            {
+                list.push_back({ std::string(bSigned ? "BC6HShapeRanking/BC6HS" : "BC6HShapeRanking/BC6HU") + (flags ? "/SHAPES32" : ""),
+                    [bSigned, flags](std::string& message) -> HRESULT
+                    {
+                        return CheckBC6HShapeRanking(bSigned, flags, message);
+                    } });
+            }
+        }
+
+        return S_OK;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Runs a benchmark until at least minTime seconds have elapsed, growing the batch
+    // size so timer overhead stays negligible for the fast kernels.
+    HRESULT RunBenchmark(const SBenchmark& bench, double minTime, SResult& result)
+    {
+        using clock = std::chrono::steady_clock;
+
+        // Warm up caches and the allocator
+        HRESULT hr = bench.run();
+        if (FAILED(hr))
+            return hr;
+
+        uint64_t iterations = 0;
+        double elapsed = 0.0;
+        uint64_t batch = 1;
+        while (elapsed < minTime)
+        {
+            const auto start = clock::now();
+            for (uint64_t j = 0; j < batch; ++j)
+            {
+                hr = bench.run();
+                if (FAILED(hr))
+                    return hr;
+            }
+            elapsed += std::chrono::duration<double>(clock::now() - start).count();
+            iterations += batch;
+
+            if (elapsed < minTime * 0.1)
+                batch *= 2;
+        }
+
+        result.name = bench.name;
+        result.iterations = iterations;
+        result.seconds = elapsed;
+        result.pixels = bench.pixels;
+        result.bytes = bench.bytes;
+        result.psnr = (bench.psnr) ? bench.psnr() : -1.0;
+        return S_OK;
+    }
+
+    std::string EscapeJSON(const std::string& value)
+    {
+        std::string result;
+        result.reserve(value.size());
+        for (const char ch : value)
+        {
+            if (ch == '"' || ch == '\\')
+                result += '\\';
+            result += ch;
+        }
+        return result;
+    }
+
+    // Uses the Google Benchmark JSON layout so existing comparison tools can consume the results
+    void WriteJSON(FILE* fp, const SOptions& opts, const std::vector<SResult>& results)
+    {
+        fprintf(fp, "{\n  \"context\": {\n");
+        fprintf(fp, "    \"executable\": \"%s\",\n", g_ToolName);
+        fprintf(fp, "    \"library_version\": %d,\n", DIRECTX_TEX_VERSION);
+        fprintf(fp, "    \"image_size\": %zu,\n", opts.size);
+        fprintf(fp, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    #ifdef NDEBUG
+        fprintf(fp, "    \"library_build_type\": \"release\"\n");
+    #else
+        fprintf(fp, "    \"library_build_type\": \"debug\"\n");
+    #endif
+        fprintf(fp, "  },\n  \"benchmarks\": [\n");
+
+        for (size_t j = 0; j < results.size(); ++j)
+        {
+            const auto& it = results[j];
+            const double perIteration = it.seconds / double(it.iterations);
+            fprintf(fp, "    {\n");
+            fprintf(fp, "      \"name\": \"%s\",\n", EscapeJSON(it.name).c_str());
+            fprintf(fp, "      \"run_type\": \"iteration\",\n");
+            fprintf(fp, "      \"iterations\": %llu,\n", static_cast<unsigned long long>(it.iterations));
+            fprintf(fp, "      \"real_time\": %.3f,\n", perIteration * 1e9);
+            fprintf(fp, "      \"time_unit\": \"ns\",\n");
+            fprintf(fp, "      \"items_per_second\": %.1f,\n", double(it.pixels) / perIteration);
+            if (it.psnr >= 0.0)
+            {
+                fprintf(fp, "      \"bytes_per_second\": %.1f,\n", double(it.bytes) / perIteration);
+                fprintf(fp, "      \"psnr\": %.3f\n", it.psnr);
+            }
+            else
+            {
+                fprintf(fp, "      \"bytes_per_second\": %.1f\n", double(it.bytes) / perIteration);
+            }
+            fprintf(fp, "    }%s\n", (j + 1 < results.size()) ? "," : "");
+        }
+
+        fprintf(fp, "  ]\n}\n");
+    }
+
+    void PrintUsage()
+    {
+        printf("Usage: %s <options> [fixture files]\n"
+            "\n"
+            "   -size <n>           width and height of the synthetic images (defaults to 1024)\n"
+            "   -time <seconds>     minimum run time per benchmark (defaults to 0.5)\n"
+            "   -filter <text>      only run benchmarks whose name contains text\n"
+            "   -json               write results as JSON to stdout\n"
+            "   -o <filename>       write JSON results to a file\n"
+            "   -list               list the benchmarks without running them\n"
+            "   -verify             run the correctness checks instead of the benchmarks\n"
+            "\n"
+            "   Fixture files (DDS, TGA, HDR%s) add benchmarks over real image content.\n"
+            "   Throughput is reported in MPixel/s and MB/s of source data consumed.\n"
+            "   Encoder quality settings (e.g. -filter BC7/LEVEL) also report ms/MPixel and PSNR.\n",
+            g_ToolName,
+        #ifdef _WIN32
+            ", or WIC"
+        #else
+            ""
+        #endif
+            );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry-point
+//--------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    SOptions opts = {};
+    opts.size = 1024;
+    opts.minTime = 0.5;
+
+    for (int iArg = 1; iArg < argc; ++iArg)
+    {
+        const char* pArg = argv[iArg];
+
+        if ('-' == pArg[0])
+        {
+            pArg += ('-' == pArg[1]) ? 2 : 1;
+
+            const bool hasValue = (iArg + 1 < argc);
+            if (!strcmp(pArg, "size") && hasValue)
+            {
+                opts.size = strtoul(argv[++iArg], nullptr, 10);
+                if (opts.size < 4)
+                {
+                    printf("ERROR: -size must be at least 4\n");
+                    return 1;
+                }
+            }
+            else if (!strcmp(pArg, "time") && hasValue)
+            {
+                opts.minTime = strtod(argv[++iArg], nullptr);
+                if (opts.minTime <= 0.0)
+                {
+                    printf("ERROR: -time must be positive\n");
+                    return 1;
+                }
+            }
+            else if (!strcmp(pArg, "filter") && hasValue)
+            {
+                opts.filter = argv[++iArg];
+            }
+            else if (!strcmp(pArg, "o") && hasValue)
+            {
+                opts.jsonFile = argv[++iArg];
+            }
+            else if (!strcmp(pArg, "json"))
+            {
+                opts.json = true;
+            }
+            else if (!strcmp(pArg, "list"))
+            {
+                opts.list = true;
+            }
+            else if (!strcmp(pArg, "verify"))
+            {
+                opts.verify = true;
+            }
+            else if (!strcmp(pArg, "help") || !strcmp(pArg, "?"))
+            {
+                PrintUsage();
+                return 0;
+            }
+            else
+            {
+                printf("ERROR: Unknown or incomplete option: `%s`\n\n", argv[iArg]);
+                PrintUsage();
+                return 1;
+            }
+        }
+        else
+        {
+            opts.fixtures.emplace_back(pArg);
+        }
+    }
+
+    if (opts.verify)
+    {
+        std::vector<SCheck> checks;
+        HRESULT hr = BuildChecks(checks);
+        if (FAILED(hr))
+        {
+            fprintf(stderr, "ERROR: Failed creating checks (%08X)\n", static_cast<unsigned int>(hr));
+            return 1;
+        }
+
+        int failures = 0;
+        for (const auto& check : checks)
+        {
+            if (opts.filter && check.name.find(opts.filter) == std::string::npos)
+                continue;
+
+            if (opts.list)
+            {
+                printf("%s\n", check.name.c_str());
+                continue;
+            }
+
+            std::string message;
+            hr = check.run(message);
+            if (hr == S_OK)
+            {
+                if (message.empty())
+                {
+                    printf("%-56s PASS\n", check.name.c_str());
+                }
+                else
+                {
+                    printf("%-56s PASS (%s)\n", check.name.c_str(), message.c_str());
+                }
+            }
+            else if (hr == S_FALSE)
+            {
+                printf("%-56s MISMATCH (%s)\n", check.name.c_str(), message.c_str());
+                ++failures;
+            }
+            else
+            {
+                printf("%-56s FAILED (%08X)\n", check.name.c_str(), static_cast<unsigned int>(hr));
+                ++failures;
+            }
+            fflush(stdout);
+        }
+
+        return (failures > 0) ? 1 : 0;
+    }
+
+    std::vector<SBenchmark> benchmarks;
+    HRESULT hr = BuildBenchmarks(opts, benchmarks);
+    if (FAILED(hr))
+    {
+        fprintf(stderr, "ERROR: Failed creating benchmark images (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    // Human-readable progress goes to stderr when JSON is written to stdout
+    FILE* con = opts.json ? stderr : stdout;
+
+    std::vector<SResult> results;
+    for (const auto& bench : benchmarks)
+    {
+        if (opts.filter && bench.name.find(opts.filter) == std::string::npos)
+            continue;
+
+        if (opts.list)
+        {
+            fprintf(con, "%s\n", bench.name.c_str());
+            continue;
+        }
+
+        SResult result = {};
+        hr = RunBenchmark(bench, opts.minTime, result);
+        if (FAILED(hr))
+        {
+            fprintf(con, "%-56s FAILED (%08X)\n", bench.name.c_str(), static_cast<unsigned int>(hr));
+            return 1;
+        }
+
+        const double perIteration = result.seconds / double(result.iterations);
+        fprintf(con, "%-56s %10.3f ms %10.1f MPixel/s %10.1f MB/s",
+            result.name.c_str(),
+            perIteration * 1000.0,
+            double(result.pixels) / perIteration / 1e6,
+            double(result.bytes) / perIteration / (1024.0 * 1024.0));
+        if (result.psnr >= 0.0)
+        {
+            fprintf(con, " %10.3f ms/MPixel %8.3f dB", perIteration * 1000.0 * 1e6 / double(result.pixels), result.psnr);
+        }
+        fprintf(con, "\n");
+        fflush(con);
+
+        results.push_back(result);
+    }
+
+    if (opts.json)
+    {
+        WriteJSON(stdout, opts, results);
+    }
+
+    if (opts.jsonFile)
+    {
+        FILE* fp = nullptr;
+    #ifdef _WIN32
+        if (fopen_s(&fp, opts.jsonFile, "w") != 0)
+            fp = nullptr;
+    #else
+        fp = fopen(opts.jsonFile, "w");
+    #endif
+        if (!fp)
+        {
+            fprintf(stderr, "ERROR: Failed creating %s\n", opts.jsonFile);
+            return 1;
+        }
+
+        WriteJSON(fp, opts, results);
+        fclose(fp);
+    }
+
+    return 0;
+}
@@ -0,0 +1,1562 @@
+//--------------------------------------------------------------------------------------
+// File: texbatch.cpp
+//
+// DirectX Texture Batch Converter (portable, no WIC or Direct3D dependencies)
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#if __cplusplus < 201703L
+#error Requires C++17 (and /Zc:__cplusplus with MSVC)
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef  _MSC_VER
+#pragma warning(disable : 4619 4616 26812)
+#endif
+
+#include "DirectXTex.h"
+
+#ifdef USE_OPENEXR
+// See <https://github.com/Microsoft/DirectXTex/wiki/Adding-OpenEXR> for details
+#include "DirectXTexEXR.h"
+#endif
+
+// See <https://github.com/Microsoft/DirectXTex/wiki/Using-JPEG-PNG-OSS> for details
+#ifdef USE_LIBJPEG
+#include "DirectXTexJPEG.h"
+#endif
+#ifdef USE_LIBPNG
+#include "DirectXTexPNG.h"
+#endif
+
+#ifndef HRESULT_E_NOT_SUPPORTED
+#define HRESULT_E_NOT_SUPPORTED static_cast<HRESULT>(0x80070032L)
+#endif
+
+using namespace DirectX;
+
+namespace
+{
+    const char* g_ToolName = "texbatch";
+    const char* g_Description = "Microsoft (R) DirectX Texture Batch Converter [DirectXTex]";
+
+    enum OPTIONS : uint32_t
+    {
+        OPT_OVERWRITE = 1,
+        OPT_NOLOGO,
+        OPT_SRGBI,
+        OPT_SRGBO,
+        OPT_SRGB,
+        OPT_PREMUL_ALPHA,
+        OPT_FLAGS_MAX,
+        OPT_FILELIST,
+        OPT_WIDTH,
+        OPT_HEIGHT,
+        OPT_MIPLEVELS,
+        OPT_FORMAT,
+        OPT_FILTER,
+        OPT_OUTPUTDIR,
+        OPT_FILETYPE,
+        OPT_NORMAL_MAP,
+        OPT_NORMAL_MAP_AMPLITUDE,
+        OPT_BC_COMPRESS,
+        OPT_JOBS,
+        OPT_AUTO_FORMAT,
+        OPT_VERSION,
+        OPT_HELP,
+    };
+
+    static_assert(OPT_FLAGS_MAX <= 32, "dwOptions is a unsigned int bitfield");
+
+    enum CODEC : uint32_t
+    {
+        CODEC_DDS = 1,
+        CODEC_TGA,
+        CODEC_HDR,
+    #ifdef USE_OPENEXR
+        CODEC_EXR,
+    #endif
+    #ifdef USE_LIBJPEG
+        CODEC_JPEG,
+    #endif
+    #ifdef USE_LIBPNG
+        CODEC_PNG,
+    #endif
+    };
+
+    template<typename T>
+    struct SValue
+    {
+        const char*     name;
+        T               value;
+    };
+
+    const SValue<uint32_t> g_pOptions[] =
+    {
+        { "flist",      OPT_FILELIST },
+        { "w",          OPT_WIDTH },
+        { "h",          OPT_HEIGHT },
+        { "m",          OPT_MIPLEVELS },
+        { "f",          OPT_FORMAT },
+        { "if",         OPT_FILTER },
+        { "srgbi",      OPT_SRGBI },
+        { "srgbo",      OPT_SRGBO },
+        { "srgb",       OPT_SRGB },
+        { "o",          OPT_OUTPUTDIR },
+        { "y",          OPT_OVERWRITE },
+        { "ft",         OPT_FILETYPE },
+        { "nologo",     OPT_NOLOGO },
+        { "pmalpha",    OPT_PREMUL_ALPHA },
+        { "nmap",       OPT_NORMAL_MAP },
+        { "nmapamp",    OPT_NORMAL_MAP_AMPLITUDE },
+        { "bc",         OPT_BC_COMPRESS },
+        { "j",          OPT_JOBS },
+        { nullptr,      0 }
+    };
+
+    const SValue<uint32_t> g_pOptionsLong[] =
+    {
+        { "auto-format",            OPT_AUTO_FORMAT },
+        { "block-compress",         OPT_BC_COMPRESS },
+        { "file-list",              OPT_FILELIST },
+        { "file-type",              OPT_FILETYPE },
+        { "format",                 OPT_FORMAT },
+        { "height",                 OPT_HEIGHT },
+        { "help",                   OPT_HELP },
+        { "image-filter",           OPT_FILTER },
+        { "jobs",                   OPT_JOBS },
+        { "mip-levels",             OPT_MIPLEVELS },
+        { "normal-map-amplitude",   OPT_NORMAL_MAP_AMPLITUDE },
+        { "normal-map",             OPT_NORMAL_MAP },
+        { "overwrite",              OPT_OVERWRITE },
+        { "premultiplied-alpha",    OPT_PREMUL_ALPHA },
+        { "srgb-in",                OPT_SRGBI },
+        { "srgb-out",               OPT_SRGBO },
+        { "version",                OPT_VERSION },
+        { "width",                  OPT_WIDTH },
+        { nullptr,                  0 }
+    };
+
+    #define DEFFMT(fmt) { #fmt, DXGI_FORMAT_ ## fmt }
+
+    const SValue<DXGI_FORMAT> g_pFormats[] =
+    {
+        // List does not include _TYPELESS, depth/stencil, or video formats
+        DEFFMT(R32G32B32A32_FLOAT),
+        DEFFMT(R32G32B32A32_UINT),
+        DEFFMT(R32G32B32A32_SINT),
+        DEFFMT(R32G32B32_FLOAT),
+        DEFFMT(R32G32B32_UINT),
+        DEFFMT(R32G32B32_SINT),
+        DEFFMT(R16G16B16A16_FLOAT),
+        DEFFMT(R16G16B16A16_UNORM),
+        DEFFMT(R16G16B16A16_UINT),
+        DEFFMT(R16G16B16A16_SNORM),
+        DEFFMT(R16G16B16A16_SINT),
+        DEFFMT(R32G32_FLOAT),
+        DEFFMT(R32G32_UINT),
+        DEFFMT(R32G32_SINT),
+        DEFFMT(R10G10B10A2_UNORM),
+        DEFFMT(R10G10B10A2_UINT),
+        DEFFMT(R11G11B10_FLOAT),
+        DEFFMT(R8G8B8A8_UNORM),
+        DEFFMT(R8G8B8A8_UNORM_SRGB),
+        DEFFMT(R8G8B8A8_UINT),
+        DEFFMT(R8G8B8A8_SNORM),
+        DEFFMT(R8G8B8A8_SINT),
+        DEFFMT(R16G16_FLOAT),
+        DEFFMT(R16G16_UNORM),
+        DEFFMT(R16G16_UINT),
+        DEFFMT(R16G16_SNORM),
+        DEFFMT(R16G16_SINT),
+        DEFFMT(R32_FLOAT),
+        DEFFMT(R32_UINT),
+        DEFFMT(R32_SINT),
+        DEFFMT(R8G8_UNORM),
+        DEFFMT(R8G8_UINT),
+        DEFFMT(R8G8_SNORM),
+        DEFFMT(R8G8_SINT),
+        DEFFMT(R16_FLOAT),
+        DEFFMT(R16_UNORM),
+        DEFFMT(R16_UINT),
+        DEFFMT(R16_SNORM),
+        DEFFMT(R16_SINT),
+        DEFFMT(R8_UNORM),
+        DEFFMT(R8_UINT),
+        DEFFMT(R8_SNORM),
+        DEFFMT(R8_SINT),
+        DEFFMT(A8_UNORM),
+        DEFFMT(R9G9B9E5_SHAREDEXP),
+        DEFFMT(R8G8_B8G8_UNORM),
+        DEFFMT(G8R8_G8B8_UNORM),
+        DEFFMT(BC1_UNORM),
+        DEFFMT(BC1_UNORM_SRGB),
+        DEFFMT(BC2_UNORM),
+        DEFFMT(BC2_UNORM_SRGB),
+        DEFFMT(BC3_UNORM),
+        DEFFMT(BC3_UNORM_SRGB),
+        DEFFMT(BC4_UNORM),
+        DEFFMT(BC4_SNORM),
+        DEFFMT(BC5_UNORM),
+        DEFFMT(BC5_SNORM),
+        DEFFMT(B5G6R5_UNORM),
+        DEFFMT(B5G5R5A1_UNORM),
+
+        // DXGI 1.1 formats
+        DEFFMT(B8G8R8A8_UNORM),
+        DEFFMT(B8G8R8X8_UNORM),
+        DEFFMT(R10G10B10_XR_BIAS_A2_UNORM),
+        DEFFMT(B8G8R8A8_UNORM_SRGB),
+        DEFFMT(B8G8R8X8_UNORM_SRGB),
+        DEFFMT(BC6H_UF16),
+        DEFFMT(BC6H_SF16),
+        DEFFMT(BC7_UNORM),
+        DEFFMT(BC7_UNORM_SRGB),
+
+        // DXGI 1.2 formats
+        DEFFMT(B4G4R4A4_UNORM),
+
+        { nullptr, DXGI_FORMAT_UNKNOWN }
+    };
+
+    const SValue<DXGI_FORMAT> g_pFormatAliases[] =
+    {
+        { "DXT1", DXGI_FORMAT_BC1_UNORM },
+        { "DXT2", DXGI_FORMAT_BC2_UNORM },
+        { "DXT3", DXGI_FORMAT_BC2_UNORM },
+        { "DXT4", DXGI_FORMAT_BC3_UNORM },
+        { "DXT5", DXGI_FORMAT_BC3_UNORM },
+
+        { "RGBA", DXGI_FORMAT_R8G8B8A8_UNORM },
+        { "BGRA", DXGI_FORMAT_B8G8R8A8_UNORM },
+        { "BGR",  DXGI_FORMAT_B8G8R8X8_UNORM },
+
+        { "FP16", DXGI_FORMAT_R16G16B16A16_FLOAT },
+        { "FP32", DXGI_FORMAT_R32G32B32A32_FLOAT },
+
+        { "BPTC", DXGI_FORMAT_BC7_UNORM },
+        { "BPTC_FLOAT", DXGI_FORMAT_BC6H_UF16 },
+
+        { nullptr, DXGI_FORMAT_UNKNOWN }
+    };
+
+    const SValue<uint32_t> g_pFilters[] =
+    {
+        { "POINT",                      TEX_FILTER_POINT },
+        { "LINEAR",                     TEX_FILTER_LINEAR },
+        { "CUBIC",                      TEX_FILTER_CUBIC },
+        { "FANT",                       TEX_FILTER_FANT },
+        { "BOX",                        TEX_FILTER_BOX },
+        { "TRIANGLE",                   TEX_FILTER_TRIANGLE },
+        { "LANCZOS",                    TEX_FILTER_LANCZOS },
+        { "MITCHELL",                   TEX_FILTER_MITCHELL },
+        { "KAISER",                     TEX_FILTER_KAISER },
+        { "POINT_DITHER",               TEX_FILTER_POINT | TEX_FILTER_DITHER },
+        { "LINEAR_DITHER",              TEX_FILTER_LINEAR | TEX_FILTER_DITHER },
+        { "CUBIC_DITHER",               TEX_FILTER_CUBIC | TEX_FILTER_DITHER },
+        { "FANT_DITHER",                TEX_FILTER_FANT | TEX_FILTER_DITHER },
+        { "BOX_DITHER",                 TEX_FILTER_BOX | TEX_FILTER_DITHER },
+        { "TRIANGLE_DITHER",            TEX_FILTER_TRIANGLE | TEX_FILTER_DITHER },
+        { "POINT_DITHER_DIFFUSION",     TEX_FILTER_POINT | TEX_FILTER_DITHER_DIFFUSION },
+        { "LINEAR_DITHER_DIFFUSION",    TEX_FILTER_LINEAR | TEX_FILTER_DITHER_DIFFUSION },
+        { "CUBIC_DITHER_DIFFUSION",     TEX_FILTER_CUBIC | TEX_FILTER_DITHER_DIFFUSION },
+        { "FANT_DITHER_DIFFUSION",      TEX_FILTER_FANT | TEX_FILTER_DITHER_DIFFUSION },
+        { "BOX_DITHER_DIFFUSION",       TEX_FILTER_BOX | TEX_FILTER_DITHER_DIFFUSION },
+        { "TRIANGLE_DITHER_DIFFUSION",  TEX_FILTER_TRIANGLE | TEX_FILTER_DITHER_DIFFUSION },
+        { nullptr,                      TEX_FILTER_DEFAULT                              }
+    };
+
+    const SValue<uint32_t> g_pSaveFileTypes[] =   // valid formats to write to
+    {
+        { "dds",    CODEC_DDS },
+        { "tga",    CODEC_TGA },
+        { "hdr",    CODEC_HDR },
+    #ifdef USE_OPENEXR
+        { "exr",    CODEC_EXR },
+    #endif
+    #ifdef USE_LIBJPEG
+        { "jpg",    CODEC_JPEG },
+        { "jpeg",   CODEC_JPEG },
+    #endif
+    #ifdef USE_LIBPNG
+        { "png",    CODEC_PNG },
+    #endif
+        { nullptr,  0 }
+    };
+
+#ifdef _PREFAST_
+#pragma prefast(disable : 26018, "Only used with static internal arrays")
+#endif
+
+    //----------------------------------------------------------------------------------
+    // Conversion settings shared by every worker
+    //----------------------------------------------------------------------------------
+    struct SOptions
+    {
+        uint32_t dwOptions;
+        size_t width;
+        size_t height;
+        size_t mipLevels;
+        DXGI_FORMAT format;
+        TEX_FILTER_FLAGS dwFilter;
+        TEX_FILTER_FLAGS dwSRGB;
+        TEX_FILTER_FLAGS dwFilterOpts;
+        TEX_COMPRESS_FLAGS dwCompress;
+        CNMAP_FLAGS dwNormalMap;
+        float nmapAmplitude;
+        float autoFormatPSNR;
+        uint32_t fileType;
+        std::filesystem::path outputDir;
+        std::string suffix;
+    };
+
+    int CompareNoCase(const char* a, const char* b) noexcept
+    {
+        for (;; ++a, ++b)
+        {
+            const int ca = tolower(static_cast<unsigned char>(*a));
+            const int cb = tolower(static_cast<unsigned char>(*b));
+            if (ca != cb || !ca)
+                return ca - cb;
+        }
+    }
+
+    template<typename T>
+    T LookupByName(const char* pName, const SValue<T>* pArray)
+    {
+        while (pArray->name)
+        {
+            if (!CompareNoCase(pName, pArray->name))
+                return pArray->value;
+
+            pArray++;
+        }
+
+        return static_cast<T>(0);
+    }
+
+    template<typename T>
+    const char* LookupByValue(T value, const SValue<T>* pArray)
+    {
+        while (pArray->name)
+        {
+            if (value == pArray->value)
+                return pArray->name;
+
+            pArray++;
+        }
+
+        return "";
+    }
+
+    template<typename T>
+    void PrintList(size_t cch, const SValue<T>* pValue)
+    {
+        while (pValue->name)
+        {
+            const size_t cchName = strlen(pValue->name);
+
+            if (cch + cchName + 2 >= 80)
+            {
+                printf("\n      ");
+                cch = 6;
+            }
+
+            printf("%s ", pValue->name);
+            cch += cchName + 2;
+            pValue++;
+        }
+
+        printf("\n");
+    }
+
+    void PrintLogo(bool versionOnly)
+    {
+        if (versionOnly)
+        {
+            printf("%s version %03d (library)\n", g_ToolName, DIRECTX_TEX_VERSION);
+        }
+        else
+        {
+            printf("%s Version %03d (library)\n", g_Description, DIRECTX_TEX_VERSION);
+            printf("Copyright (C) Microsoft Corp.\n");
+        #ifdef _DEBUG
+            printf("*** Debug build ***\n");
+        #endif
+            printf("\n");
+        }
+    }
+
+    void PrintUsage()
+    {
+        PrintLogo(false);
+
+        static const char* const s_usage =
+            "Usage: texbatch <options> [--] <files>\n"
+            "\n"
+            "   -flist <filename>, --file-list <filename>\n"
+            "                       use text file with a list of input files (one per line)\n"
+            "\n"
+            "   -w <n>, --width <n>                     width for output\n"
+            "   -h <n>, --height <n>                    height for output\n"
+            "   -m <n>, --mip-levels <n>                miplevels for output\n"
+            "   -f <format>, --format <format>          pixel format for output\n"
+            "   --auto-format <dB>                      pick the smallest BC format estimated to reach\n"
+            "                                           this PSNR (DDS output only)\n"
+            "\n"
+            "   -if <filter>, --image-filter <filter>   image filtering\n"
+            "   -srgb{i|o}, --srgb-in, --srgb-out       sRGB {input, output}\n"
+            "\n"
+            "   -o <directory>                          output directory\n"
+            "   -y, --overwrite                         overwrite existing output file (if any)\n"
+            "   -ft <filetype>, --file-type <filetype>  output file type\n"
+            "\n"
+            "   -pmalpha, --premultiplied-alpha         convert final texture to use premultiplied alpha\n"
+            "   -nmap <options>, --normal-map <options> converts height-map to normal-map\n"
+            "                                           options must be one or more of\n"
+            "                                              r, g, b, a, l, m, u, v, i, o\n"
+            "   -nmapamp <weight>, --normal-map-amplitude <weight>\n"
+            "                                           normal map amplitude (defaults to 1.0)\n"
+            "   -bc <options>, --block-compress <options>\n"
+            "                                           Sets options for BC compression\n"
+            "                                           options must be one or more of\n"
+            "                                              d, u, q, x, b\n"
+            "\n"
+            "   -j <n>, --jobs <n>                      number of files converted at once\n"
+            "                                           (defaults to the number of hardware threads)\n"
+            "\n"
+            "   -nologo                                 suppress copyright message\n"
+            "\n"
+            "   '-- ' is needed if any input filepath starts with the '-' or '/' character\n";
+
+        printf("%s", s_usage);
+
+        printf("\n   <format>: ");
+        PrintList(13, g_pFormats);
+        printf("      ");
+        PrintList(13, g_pFormatAliases);
+
+        printf("\n   <filter>: ");
+        PrintList(13, g_pFilters);
+
+        printf("\n   <filetype>: ");
+        PrintList(15, g_pSaveFileTypes);
+    }
+
+
+    //----------------------------------------------------------------------------------
+    // Per-file output is buffered so concurrent conversions don't interleave
+    //----------------------------------------------------------------------------------
+#ifdef __GNUC__
+    __attribute__((format(printf, 2, 3)))
+#endif
+    void LogPrintf(std::string& log, const char* fmt, ...)
+    {
+        char buff[1024] = {};
+
+        va_list args;
+        va_start(args, fmt);
+        const int len = vsnprintf(buff, sizeof(buff), fmt, args);
+        va_end(args);
+
+        if (len > 0)
+        {
+            log.append(buff, std::min(static_cast<size_t>(len), sizeof(buff) - 1));
+        }
+    }
+
+    void LogInfo(std::string& log, const TexMetadata& info)
+    {
+        LogPrintf(log, " (%zux%zu", info.width, info.height);
+
+        if (TEX_DIMENSION_TEXTURE3D == info.dimension)
+            LogPrintf(log, "x%zu", info.depth);
+
+        if (info.mipLevels > 1)
+            LogPrintf(log, ",%zu", info.mipLevels);
+
+        if (info.arraySize > 1)
+            LogPrintf(log, ",%zu", info.arraySize);
+
+        const char* name = LookupByValue(info.format, g_pFormats);
+        LogPrintf(log, " %s", (*name) ? name : "*UNKNOWN*");
+
+        switch (info.dimension)
+        {
+        case TEX_DIMENSION_TEXTURE1D:
+            LogPrintf(log, "%s", (info.arraySize > 1) ? " 1DArray" : " 1D");
+            break;
+
+        case TEX_DIMENSION_TEXTURE2D:
+            if (info.IsCubemap())
+            {
+                LogPrintf(log, "%s", (info.arraySize > 6) ? " CubeArray" : " Cube");
+            }
+            else
+            {
+                LogPrintf(log, "%s", (info.arraySize > 1) ? " 2DArray" : " 2D");
+            }
+            break;
+
+        case TEX_DIMENSION_TEXTURE3D:
+            LogPrintf(log, " 3D");
+            break;
+        }
+
+        LogPrintf(log, ")");
+    }
+
+    bool ReadFileList(const char* pFile, std::vector<std::filesystem::path>& files)
+    {
+        std::ifstream inFile(pFile);
+        if (!inFile)
+            return false;
+
+        std::string line;
+        while (std::getline(inFile, line))
+        {
+            // Trim trailing whitespace (including CR from Windows line endings)
+            while (!line.empty() && isspace(static_cast<unsigned char>(line.back())))
+                line.pop_back();
+
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            files.emplace_back(line);
+        }
+
+        return true;
+    }
+
+
+    //----------------------------------------------------------------------------------
+    // Load a source image based on the file extension
+    //----------------------------------------------------------------------------------
+    HRESULT LoadImageFile(const std::filesystem::path& path, TexMetadata& info, ScratchImage& image)
+    {
+        const std::string ext = path.extension().string();
+        const std::wstring wpath = path.wstring();
+
+        if (!CompareNoCase(ext.c_str(), ".dds"))
+        {
+            return LoadFromDDSFile(wpath.c_str(), DDS_FLAGS_ALLOW_LARGE_FILES, &info, image);
+        }
+        else if (!CompareNoCase(ext.c_str(), ".tga"))
+        {
+            return LoadFromTGAFile(wpath.c_str(), TGA_FLAGS_NONE, &info, image);
+        }
+        else if (!CompareNoCase(ext.c_str(), ".hdr"))
+        {
+            return LoadFromHDRFile(wpath.c_str(), &info, image);
+        }
+    #ifdef USE_OPENEXR
+        else if (!CompareNoCase(ext.c_str(), ".exr"))
+        {
+            return LoadFromEXRFile(wpath.c_str(), &info, image);
+        }
+    #endif
+    #ifdef USE_LIBJPEG
+        else if (!CompareNoCase(ext.c_str(), ".jpg") || !CompareNoCase(ext.c_str(), ".jpeg"))
+        {
+            return LoadFromJPEGFile(wpath.c_str(), &info, image);
+        }
+    #endif
+    #ifdef USE_LIBPNG
+        else if (!CompareNoCase(ext.c_str(), ".png"))
+        {
+            return LoadFromPNGFile(wpath.c_str(), &info, image);
+        }
+    #endif
+
+        return HRESULT_E_NOT_SUPPORTED;
+    }
+
+    HRESULT SaveImageFile(const SOptions& opts, const ScratchImage& image, const TexMetadata& info, const std::filesystem::path& path)
+    {
+        const std::wstring wpath = path.wstring();
+        auto img = image.GetImage(0, 0, 0);
+        assert(img);
+
+        switch (opts.fileType)
+        {
+        case CODEC_DDS:
+            return SaveToDDSFile(img, image.GetImageCount(), info, DDS_FLAGS_NONE, wpath.c_str());
+
+        case CODEC_TGA:
+            return SaveToTGAFile(*img, TGA_FLAGS_NONE, wpath.c_str(), &info);
+
+        case CODEC_HDR:
+            return SaveToHDRFile(*img, wpath.c_str());
+
+    #ifdef USE_OPENEXR
+        case CODEC_EXR:
+            return SaveToEXRFile(*img, wpath.c_str());
+    #endif
+    #ifdef USE_LIBJPEG
+        case CODEC_JPEG:
+            return SaveToJPEGFile(*img, wpath.c_str());
+    #endif
+    #ifdef USE_LIBPNG
+        case CODEC_PNG:
+            return SaveToPNGFile(*img, wpath.c_str());
+    #endif
+
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------
+    // Output naming: every source writes <outputDir>/<stem><suffix>
+    //----------------------------------------------------------------------------------
+    std::filesystem::path GetOutputPath(const SOptions& opts, const std::filesystem::path& srcPath)
+    {
+        std::filesystem::path dest(opts.outputDir);
+        dest.append(srcPath.stem().string() + opts.suffix);
+        return dest;
+    }
+
+    // Sources with the same stem (a/foo.png and b/foo.tga) would write the same file, so they are rejected up front
+    bool CheckOutputCollisions(const SOptions& opts, const std::vector<std::filesystem::path>& files)
+    {
+        std::vector<std::pair<std::string, size_t>> outputs;
+        outputs.reserve(files.size());
+        for (size_t index = 0; index < files.size(); ++index)
+        {
+            std::string key = GetOutputPath(opts, files[index]).lexically_normal().string();
+        #ifdef _WIN32
+            // NTFS names are case-insensitive
+            std::transform(key.begin(), key.end(), key.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+        #endif
+            outputs.emplace_back(std::move(key), index);
+        }
+
+        std::stable_sort(outputs.begin(), outputs.end(),
+            [](const std::pair<std::string, size_t>& a, const std::pair<std::string, size_t>& b) { return a.first < b.first; });
+
+        bool unique = true;
+        for (size_t j = 1; j < outputs.size(); ++j)
+        {
+            if (outputs[j].first == outputs[j - 1].first)
+            {
+                printf("ERROR: %s and %s both write %s\n",
+                    files[outputs[j - 1].second].string().c_str(),
+                    files[outputs[j].second].string().c_str(),
+                    GetOutputPath(opts, files[outputs[j].second]).string().c_str());
+                unique = false;
+            }
+        }
+
+        return unique;
+    }
+
+    // Creates the output file only if it does not exist yet, so a file that appears after an
+    // existence check is never overwritten; returns the errno value on failure
+    int CreateOutputFileExclusive(const std::filesystem::path& path)
+    {
+        FILE* file = nullptr;
+    #ifdef _WIN32
+        const errno_t err = _wfopen_s(&file, path.c_str(), L"wbx");
+        if (err)
+            return err;
+    #else
+        file = fopen(path.c_str(), "wbx");
+        if (!file)
+            return errno;
+    #endif
+        fclose(file);
+        return 0;
+    }
+
+
+    //----------------------------------------------------------------------------------
+    // Convert a single file; all output goes to 'log'
+    //----------------------------------------------------------------------------------
+    bool ConvertFile(const SOptions& opts, const std::filesystem::path& srcPath, bool allowParallel, std::string& log)
+    {
+    #ifndef _OPENMP
+        std::ignore = allowParallel;
+    #endif
+
+        // --- Load source image -------------------------------------------------------
+        LogPrintf(log, "reading %s", srcPath.string().c_str());
+
+        TexMetadata info;
+        std::unique_ptr<ScratchImage> image(new (std::nothrow) ScratchImage);
+        if (!image)
+        {
+            LogPrintf(log, "\nERROR: Memory allocation failed\n");
+            return false;
+        }
+
+        HRESULT hr = LoadImageFile(srcPath, info, *image);
+        if (FAILED(hr))
+        {
+            LogPrintf(log, " FAILED (%08X)\n", static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        if (IsTypeless(info.format))
+        {
+            LogPrintf(log, " FAILED due to Typeless format %d\n", static_cast<int>(info.format));
+            return false;
+        }
+
+        LogInfo(log, info);
+
+        size_t tMips = (!opts.mipLevels && info.mipLevels > 1) ? info.mipLevels : opts.mipLevels;
+        if (opts.fileType != CODEC_DDS)
+        {
+            tMips = 1;
+        }
+
+        DXGI_FORMAT tformat = (opts.format == DXGI_FORMAT_UNKNOWN) ? info.format : opts.format;
+
+        // --- Decompress --------------------------------------------------------------
+        if (IsCompressed(info.format))
+        {
+            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+            if (!timage)
+            {
+                LogPrintf(log, "\nERROR: Memory allocation failed\n");
+                return false;
+            }
+
+            hr = Decompress(image->GetImages(), image->GetImageCount(), image->GetMetadata(), DXGI_FORMAT_UNKNOWN, *timage);
+            if (FAILED(hr))
+            {
+                LogPrintf(log, " FAILED [decompress] (%08X)\n", static_cast<unsigned int>(hr));
+                return false;
+            }
+
+            info.format = timage->GetMetadata().format;
+            image.swap(timage);
+        }
+
+        if (opts.fileType != CODEC_DDS && IsCompressed(tformat))
+        {
+            // Only DDS can store block-compressed data
+            tformat = info.format;
+        }
+
+        // --- Resize ------------------------------------------------------------------
+        const size_t twidth = (!opts.width) ? info.width : opts.width;
+        const size_t theight = (!opts.height) ? info.height : opts.height;
+
+        if (info.width != twidth || info.height != theight)
+        {
+            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+            if (!timage)
+            {
+                LogPrintf(log, "\nERROR: Memory allocation failed\n");
+                return false;
+            }
+
+            hr = Resize(image->GetImages(), image->GetImageCount(), image->GetMetadata(), twidth, theight, opts.dwFilter | opts.dwFilterOpts, *timage);
+            if (FAILED(hr))
+            {
+                LogPrintf(log, " FAILED [resize] (%08X)\n", static_cast<unsigned int>(hr));
+                return false;
+            }
+
+            auto& tinfo = timage->GetMetadata();
+
+            assert(tinfo.width == twidth && tinfo.height == theight && tinfo.mipLevels == 1);
+            info.width = tinfo.width;
+            info.height = tinfo.height;
+            info.mipLevels = 1;
+
+            image.swap(timage);
+
+            if (tMips > 0)
+            {
+                const size_t maxMips = (info.depth > 1)
+                    ? CountMips3D(info.width, info.height, info.depth)
+                    : CountMips(info.width, info.height);
+
+                if (tMips > maxMips)
+                {
+                    tMips = maxMips;
+                }
+            }
+        }
+
+        // --- Convert -----------------------------------------------------------------
+        if (opts.dwNormalMap)
+        {
+            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+            if (!timage)
+            {
+                LogPrintf(log, "\nERROR: Memory allocation failed\n");
+                return false;
+            }
+
+            DXGI_FORMAT nmfmt = tformat;
+            if (IsCompressed(tformat))
+            {
+                switch (tformat)
+                {
+                case DXGI_FORMAT_BC4_SNORM:
+                case DXGI_FORMAT_BC5_SNORM:
+                    nmfmt = (BitsPerColor(info.format) > 8) ? DXGI_FORMAT_R16G16B16A16_SNORM : DXGI_FORMAT_R8G8B8A8_SNORM;
+                    break;
+
+                case DXGI_FORMAT_BC6H_SF16:
+                case DXGI_FORMAT_BC6H_UF16:
+                    nmfmt = DXGI_FORMAT_R32G32B32_FLOAT;
+                    break;
+
+                default:
+                    nmfmt = (BitsPerColor(info.format) > 8) ? DXGI_FORMAT_R16G16B16A16_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM;
+                    break;
+                }
+            }
+
+            hr = ComputeNormalMap(image->GetImages(), image->GetImageCount(), image->GetMetadata(), opts.dwNormalMap, opts.nmapAmplitude, nmfmt, *timage);
+            if (FAILED(hr))
+            {
+                LogPrintf(log, " FAILED [normalmap] (%08X)\n", static_cast<unsigned int>(hr));
+                return false;
+            }
+
+            info.format = timage->GetMetadata().format;
+            image.swap(timage);
+        }
+        else if (info.format != tformat && !IsCompressed(tformat))
+        {
+            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+            if (!timage)
+            {
+                LogPrintf(log, "\nERROR: Memory allocation failed\n");
+                return false;
+            }
+
+            hr = Convert(image->GetImages(), image->GetImageCount(), image->GetMetadata(), tformat,
+                opts.dwFilter | opts.dwFilterOpts | opts.dwSRGB, TEX_THRESHOLD_DEFAULT, *timage);
+            if (FAILED(hr))
+            {
+                LogPrintf(log, " FAILED [convert] (%08X)\n", static_cast<unsigned int>(hr));
+                return false;
+            }
+
+            info.format = timage->GetMetadata().format;
+            image.swap(timage);
+        }
+
+        // --- Generate mips -----------------------------------------------------------
+        if ((!tMips || info.mipLevels != tMips) && (info.width > 1 || info.height > 1 || info.depth > 1))
+        {
+            if (info.mipLevels != 1)
+            {
+                // Mips generation only works on a single base image, so strip off existing mip levels
+                std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+                if (!timage)
+                {
+                    LogPrintf(log, "\nERROR: Memory allocation failed\n");
+                    return false;
+                }
+
+                TexMetadata mdata = info;
+                mdata.mipLevels = 1;
+                hr = timage->Initialize(mdata);
+                if (FAILED(hr))
+                {
+                    LogPrintf(log, " FAILED [copy to single level] (%08X)\n", static_cast<unsigned int>(hr));
+                    return false;
+                }
+
+                const size_t nitems = (info.dimension == TEX_DIMENSION_TEXTURE3D) ? info.depth : info.arraySize;
+                for (size_t i = 0; i < nitems; ++i)
+                {
+                    auto simg = (info.dimension == TEX_DIMENSION_TEXTURE3D) ? image->GetImage(0, 0, i) : image->GetImage(0, i, 0);
+                    auto dimg = (info.dimension == TEX_DIMENSION_TEXTURE3D) ? timage->GetImage(0, 0, i) : timage->GetImage(0, i, 0);
+
+                    memcpy(dimg->pixels, simg->pixels, std::min(dimg->slicePitch, simg->slicePitch));
+                }
+
+                info.mipLevels = 1;
+                image.swap(timage);
+            }
+
+            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+            if (!timage)
+            {
+                LogPrintf(log, "\nERROR: Memory allocation failed\n");
+                return false;
+            }
+
+            if (info.dimension == TEX_DIMENSION_TEXTURE3D)
+            {
+                TEX_FILTER_FLAGS dwFilter3D = opts.dwFilter;
+                switch (dwFilter3D & TEX_FILTER_MODE_MASK)
+                {
+                case TEX_FILTER_LANCZOS:
+                case TEX_FILTER_MITCHELL:
+                case TEX_FILTER_KAISER:
+                    // Volume mipmaps do not support the separable resampler filters
+                    dwFilter3D = TEX_FILTER_TRIANGLE;
+                    break;
+
+                default:
+                    break;
+                }
+
+                hr = GenerateMipMaps3D(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwFilter3D | opts.dwFilterOpts, tMips, *timage);
+            }
+            else
+            {
+                TEX_FILTER_FLAGS dwMipFilter = opts.dwFilter | opts.dwFilterOpts;
+            #ifdef _OPENMP
+                if (allowParallel)
+                {
+                    dwMipFilter |= TEX_FILTER_PARALLEL;
+                }
+            #endif
+
+                hr = GenerateMipMaps(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwMipFilter, tMips, *timage);
+            }
+            if (FAILED(hr))
+            {
+                LogPrintf(log, " FAILED [mipmaps] (%08X)\n", static_cast<unsigned int>(hr));
+                return false;
+            }
+
+            info.mipLevels = timage->GetMetadata().mipLevels;
+            image.swap(timage);
+        }
+
+        // --- Premultiplied alpha (if requested) --------------------------------------
+        if ((opts.dwOptions & (1u << OPT_PREMUL_ALPHA))
+            && HasAlpha(info.format)
+            && info.format != DXGI_FORMAT_A8_UNORM
+            && !info.IsPMAlpha())
+        {
+            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+            if (!timage)
+            {
+                LogPrintf(log, "\nERROR: Memory allocation failed\n");
+                return false;
+            }
+
+            hr = PremultiplyAlpha(image->GetImages(), image->GetImageCount(), info, TEX_PMALPHA_DEFAULT | opts.dwSRGB, *timage);
+            if (FAILED(hr))
+            {
+                LogPrintf(log, " FAILED [premultiply alpha] (%08X)\n", static_cast<unsigned int>(hr));
+                return false;
+            }
+
+            info.miscFlags2 = timage->GetMetadata().miscFlags2;
+            image.swap(timage);
+        }
+
+        // --- Choose BC format --------------------------------------------------------
+        if (opts.autoFormatPSNR >= 0.f && (opts.fileType == CODEC_DDS))
+        {
+            TEX_COMPRESS_FLAGS aflags = TEX_COMPRESS_DEFAULT;
+        #ifdef _OPENMP
+            if (allowParallel)
+            {
+                aflags |= TEX_COMPRESS_PARALLEL;
+            }
+        #endif
+
+            CompressionAnalysis analysis = {};
+            hr = AnalyzeForCompression(image->GetImages(), image->GetImageCount(), info, aflags | opts.dwSRGB, opts.autoFormatPSNR, analysis);
+            if (FAILED(hr))
+            {
+                LogPrintf(log, " FAILED [analyze] (%08X)\n", static_cast<unsigned int>(hr));
+                return false;
+            }
+
+            tformat = analysis.format;
+            LogPrintf(log, " auto %s (BC1 ~%.1f dB)", LookupByValue(tformat, g_pFormats), double(analysis.bc1PSNR));
+            if (analysis.alphaDropped)
+            {
+                LogPrintf(log, " (alpha dropped)");
+            }
+        }
+
+        // --- Compress ----------------------------------------------------------------
+        if (IsCompressed(tformat) && (opts.fileType == CODEC_DDS))
+        {
+            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+            if (!timage)
+            {
+                LogPrintf(log, "\nERROR: Memory allocation failed\n");
+                return false;
+            }
+
+            TEX_COMPRESS_FLAGS cflags = opts.dwCompress;
+        #ifdef _OPENMP
+            if (allowParallel)
+            {
+                cflags |= TEX_COMPRESS_PARALLEL;
+            }
+        #endif
+
+            hr = Compress(image->GetImages(), image->GetImageCount(), info, tformat, cflags | opts.dwSRGB, TEX_THRESHOLD_DEFAULT, *timage);
+            if (FAILED(hr))
+            {
+                LogPrintf(log, " FAILED [compress] (%08X)\n", static_cast<unsigned int>(hr));
+                return false;
+            }
+
+            info.format = timage->GetMetadata().format;
+            image.swap(timage);
+        }
+
+        // --- Set alpha mode ----------------------------------------------------------
+        if (HasAlpha(info.format) && info.format != DXGI_FORMAT_A8_UNORM)
+        {
+            if (image->IsAlphaAllOpaque())
+            {
+                info.SetAlphaMode(TEX_ALPHA_MODE_OPAQUE);
+            }
+            else if (!info.IsPMAlpha() && info.GetAlphaMode() == TEX_ALPHA_MODE_UNKNOWN)
+            {
+                info.SetAlphaMode(TEX_ALPHA_MODE_STRAIGHT);
+            }
+        }
+        else
+        {
+            info.SetAlphaMode(TEX_ALPHA_MODE_UNKNOWN);
+        }
+
+        // --- Save result -------------------------------------------------------------
+        LogPrintf(log, "\n");
+        LogInfo(log, info);
+        LogPrintf(log, "\n");
+
+        const std::filesystem::path dest = GetOutputPath(opts, srcPath);
+
+        LogPrintf(log, "writing %s", dest.string().c_str());
+
+        const bool exclusive = (opts.dwOptions & (1u << OPT_OVERWRITE)) == 0;
+        if (exclusive)
+        {
+            // Claim the name atomically rather than testing for it, then write over the empty file we own
+            const int err = CreateOutputFileExclusive(dest);
+            if (err == EEXIST)
+            {
+                LogPrintf(log, "\nERROR: Output file already exists, use -y to overwrite\n");
+                return false;
+            }
+            else if (err)
+            {
+                LogPrintf(log, " FAILED creating output file (errno %d)\n", err);
+                return false;
+            }
+        }
+
+        hr = SaveImageFile(opts, *image, info, dest);
+        if (FAILED(hr))
+        {
+            LogPrintf(log, " FAILED (%08X)\n", static_cast<unsigned int>(hr));
+            if (exclusive)
+            {
+                std::error_code ec;
+                std::filesystem::remove(dest, ec);
+            }
+            return false;
+        }
+
+        LogPrintf(log, "\n");
+        return true;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry-point
+//--------------------------------------------------------------------------------------
+#ifdef _PREFAST_
+#pragma prefast(disable : 28198, "Command-line tool, frees all memory on exit")
+#endif
+
+int main(int argc, char* argv[])
+{
+    // Parameters and defaults
+    SOptions opts = {};
+    opts.dwFilter = TEX_FILTER_DEFAULT;
+    opts.dwSRGB = TEX_FILTER_DEFAULT;
+    opts.dwFilterOpts = TEX_FILTER_DEFAULT;
+    opts.dwCompress = TEX_COMPRESS_DEFAULT;
+    opts.dwNormalMap = CNMAP_DEFAULT;
+    opts.nmapAmplitude = 1.f;
+    opts.autoFormatPSNR = -1.f;
+    opts.fileType = CODEC_DDS;
+    opts.format = DXGI_FORMAT_UNKNOWN;
+
+    size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+
+    // Process command line
+    std::vector<std::filesystem::path> conversion;
+    bool allowOpts = true;
+
+    for (int iArg = 1; iArg < argc; ++iArg)
+    {
+        char* pArg = argv[iArg];
+
+        if (allowOpts && ('-' == pArg[0]))
+        {
+            uint32_t dwOption = 0;
+            char* pValue = nullptr;
+
+            if ('-' == pArg[1])
+            {
+                if (pArg[2] == 0)
+                {
+                    // "-- " is the POSIX standard for "end of options" marking to escape the '-' character at the start of filepaths.
+                    allowOpts = false;
+                    continue;
+                }
+
+                pArg += 2;
+
+                for (pValue = pArg; *pValue && (':' != *pValue) && ('=' != *pValue); ++pValue);
+
+                if (*pValue)
+                    *pValue++ = 0;
+
+                dwOption = LookupByName(pArg, g_pOptionsLong);
+            }
+            else
+            {
+                pArg++;
+
+                for (pValue = pArg; *pValue && (':' != *pValue) && ('=' != *pValue); ++pValue);
+
+                if (*pValue)
+                    *pValue++ = 0;
+
+                dwOption = LookupByName(pArg, g_pOptions);
+
+                if (!dwOption && LookupByName(pArg, g_pOptionsLong))
+                {
+                    printf("ERROR: did you mean `--%s` (with two dashes)?\n", pArg);
+                    return 1;
+                }
+            }
+
+            switch (dwOption)
+            {
+            case 0:
+                printf("ERROR: Unknown option: `%s`\n\nUse %s --help\n", pArg, g_ToolName);
+                return 1;
+
+            case OPT_FILELIST:
+            case OPT_WIDTH:
+            case OPT_HEIGHT:
+            case OPT_MIPLEVELS:
+            case OPT_FORMAT:
+            case OPT_FILTER:
+            case OPT_SRGBI:
+            case OPT_SRGBO:
+            case OPT_SRGB:
+            case OPT_OUTPUTDIR:
+            case OPT_FILETYPE:
+            case OPT_NORMAL_MAP:
+            case OPT_NORMAL_MAP_AMPLITUDE:
+            case OPT_BC_COMPRESS:
+            case OPT_JOBS:
+            case OPT_AUTO_FORMAT:
+                // These don't use flag bits
+                break;
+
+            case OPT_VERSION:
+                PrintLogo(true);
+                return 0;
+
+            case OPT_HELP:
+                PrintUsage();
+                return 0;
+
+            default:
+                if (opts.dwOptions & (1u << dwOption))
+                {
+                    printf("ERROR: Duplicate option: `%s`\n\n", pArg);
+                    return 1;
+                }
+
+                opts.dwOptions |= (1u << dwOption);
+                break;
+            }
+
+            // Handle options with additional value parameter
+            switch (dwOption)
+            {
+            case OPT_FILELIST:
+            case OPT_WIDTH:
+            case OPT_HEIGHT:
+            case OPT_MIPLEVELS:
+            case OPT_FORMAT:
+            case OPT_FILTER:
+            case OPT_OUTPUTDIR:
+            case OPT_FILETYPE:
+            case OPT_NORMAL_MAP:
+            case OPT_NORMAL_MAP_AMPLITUDE:
+            case OPT_BC_COMPRESS:
+            case OPT_JOBS:
+            case OPT_AUTO_FORMAT:
+                // These support either "-arg:value" or "-arg value"
+                if (!*pValue)
+                {
+                    if ((iArg + 1 >= argc))
+                    {
+                        PrintUsage();
+                        return 1;
+                    }
+
+                    iArg++;
+                    pValue = argv[iArg];
+                }
+                break;
+
+            default:
+                break;
+            }
+
+            switch (dwOption)
+            {
+            case OPT_WIDTH:
+                if (sscanf(pValue, "%zu", &opts.width) != 1)
+                {
+                    printf("Invalid value specified with -w (%s)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
+            case OPT_HEIGHT:
+                if (sscanf(pValue, "%zu", &opts.height) != 1)
+                {
+                    printf("Invalid value specified with -h (%s)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
+            case OPT_MIPLEVELS:
+                if (sscanf(pValue, "%zu", &opts.mipLevels) != 1)
+                {
+                    printf("Invalid value specified with -m (%s)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
+            case OPT_FORMAT:
+                opts.format = LookupByName(pValue, g_pFormats);
+                if (!opts.format)
+                {
+                    opts.format = LookupByName(pValue, g_pFormatAliases);
+                    if (!opts.format)
+                    {
+                        printf("Invalid value specified with -f (%s)\n\n", pValue);
+                        PrintUsage();
+                        return 1;
+                    }
+                }
+                break;
+
+            case OPT_FILTER:
+                opts.dwFilter = static_cast<TEX_FILTER_FLAGS>(LookupByName(pValue, g_pFilters));
+                if (!opts.dwFilter)
+                {
+                    printf("Invalid value specified with -if (%s)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
+            case OPT_SRGBI:
+                opts.dwSRGB |= TEX_FILTER_SRGB_IN;
+                break;
+
+            case OPT_SRGBO:
+                opts.dwSRGB |= TEX_FILTER_SRGB_OUT;
+                break;
+
+            case OPT_SRGB:
+                opts.dwSRGB |= TEX_FILTER_SRGB;
+                break;
+
+            case OPT_OUTPUTDIR:
+                {
+                    std::filesystem::path path(pValue);
+                    opts.outputDir = path.make_preferred();
+                }
+                break;
+
+            case OPT_FILETYPE:
+                opts.fileType = LookupByName(pValue, g_pSaveFileTypes);
+                if (!opts.fileType)
+                {
+                    printf("Invalid value specified with -ft (%s)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
+            case OPT_NORMAL_MAP:
+                {
+                    opts.dwNormalMap = CNMAP_DEFAULT;
+
+                    if (strchr(pValue, 'l'))
+                    {
+                        opts.dwNormalMap |= CNMAP_CHANNEL_LUMINANCE;
+                    }
+                    else if (strchr(pValue, 'r'))
+                    {
+                        opts.dwNormalMap |= CNMAP_CHANNEL_RED;
+                    }
+                    else if (strchr(pValue, 'g'))
+                    {
+                        opts.dwNormalMap |= CNMAP_CHANNEL_GREEN;
+                    }
+                    else if (strchr(pValue, 'b'))
+                    {
+                        opts.dwNormalMap |= CNMAP_CHANNEL_BLUE;
+                    }
+                    else if (strchr(pValue, 'a'))
+                    {
+                        opts.dwNormalMap |= CNMAP_CHANNEL_ALPHA;
+                    }
+                    else
+                    {
+                        printf("Invalid value specified for -nmap (%s), missing l, r, g, b, or a\n\n", pValue);
+                        return 1;
+                    }
+
+                    if (strchr(pValue, 'm'))
+                    {
+                        opts.dwNormalMap |= CNMAP_MIRROR;
+                    }
+                    else
+                    {
+                        if (strchr(pValue, 'u'))
+                        {
+                            opts.dwNormalMap |= CNMAP_MIRROR_U;
+                        }
+                        if (strchr(pValue, 'v'))
+                        {
+                            opts.dwNormalMap |= CNMAP_MIRROR_V;
+                        }
+                    }
+
+                    if (strchr(pValue, 'i'))
+                    {
+                        opts.dwNormalMap |= CNMAP_INVERT_SIGN;
+                    }
+
+                    if (strchr(pValue, 'o'))
+                    {
+                        opts.dwNormalMap |= CNMAP_COMPUTE_OCCLUSION;
+                    }
+                }
+                break;
+
+            case OPT_NORMAL_MAP_AMPLITUDE:
+                if (!opts.dwNormalMap)
+                {
+                    printf("-nmapamp requires -nmap\n\n");
+                    PrintUsage();
+                    return 1;
+                }
+                else if (sscanf(pValue, "%f", &opts.nmapAmplitude) != 1)
+                {
+                    printf("Invalid value specified with -nmapamp (%s)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                else if (opts.nmapAmplitude < 0.f)
+                {
+                    printf("Normal map amplitude must be positive (%s)\n\n", pValue);
+                    return 1;
+                }
+                break;
+
+            case OPT_BC_COMPRESS:
+                {
+                    opts.dwCompress = TEX_COMPRESS_DEFAULT;
+
+                    bool found = false;
+                    if (strchr(pValue, 'u'))
+                    {
+                        opts.dwCompress |= TEX_COMPRESS_UNIFORM;
+                        found = true;
+                    }
+
+                    if (strchr(pValue, 'd'))
+                    {
+                        opts.dwCompress |= TEX_COMPRESS_DITHER;
+                        found = true;
+                    }
+
+                    if (strchr(pValue, 'q'))
+                    {
+                        opts.dwCompress |= TEX_COMPRESS_BC7_QUICK;
+                        found = true;
+                    }
+
+                    if (strchr(pValue, 'x'))
+                    {
+                        opts.dwCompress |= TEX_COMPRESS_BC7_USE_3SUBSETS;
+                        found = true;
+                    }
+
+                    if (strchr(pValue, 'b'))
+                    {
+                        opts.dwCompress |= TEX_COMPRESS_BC_BATCH;
+                        found = true;
+                    }
+
+                    if ((opts.dwCompress & (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS)) == (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS))
+                    {
+                        printf("Can't use -bc x (max) and -bc q (quick) at same time\n\n");
+                        PrintUsage();
+                        return 1;
+                    }
+
+                    if (!found)
+                    {
+                        printf("Invalid value specified for -bc (%s), missing d, u, q, x, or b\n\n", pValue);
+                        return 1;
+                    }
+                }
+                break;
+
+            case OPT_JOBS:
+                if (sscanf(pValue, "%zu", &jobs) != 1 || !jobs)
+                {
+                    printf("Invalid value specified with -j (%s)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
+            case OPT_AUTO_FORMAT:
+                if (sscanf(pValue, "%f", &opts.autoFormatPSNR) != 1 || opts.autoFormatPSNR < 0.f)
+                {
+                    printf("Invalid value specified with --auto-format (%s)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
+            case OPT_FILELIST:
+                if (!ReadFileList(pValue, conversion))
+                {
+                    printf("Error opening -flist file %s\n", pValue);
+                    return 1;
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+        else
+        {
+            std::filesystem::path path(pArg);
+            conversion.emplace_back(path.make_preferred());
+        }
+    }
+
+    if (conversion.empty())
+    {
+        PrintUsage();
+        return 0;
+    }
+
+    if (opts.autoFormatPSNR >= 0.f && opts.format != DXGI_FORMAT_UNKNOWN)
+    {
+        printf("Can't use --auto-format and -f at same time\n\n");
+        PrintUsage();
+        return 1;
+    }
+
+    if (~opts.dwOptions & (1u << OPT_NOLOGO))
+        PrintLogo(false);
+
+    opts.suffix = ".";
+    opts.suffix += LookupByValue(opts.fileType, g_pSaveFileTypes);
+
+    if (!CheckOutputCollisions(opts, conversion))
+    {
+        printf("\nSources with the same name can't be converted into the same output directory\n");
+        return 1;
+    }
+
+    // Convert images, one file per worker
+    jobs = std::min(jobs, conversion.size());
+
+    // With a single worker the library's own OpenMP parallelism is used instead
+    const bool allowParallel = (jobs == 1);
+
+    std::atomic<size_t> nextFile(0);
+    std::atomic<int> retVal(0);
+    std::mutex outputLock;
+
+    auto worker = [&]()
+    {
+        for (;;)
+        {
+            const size_t index = nextFile.fetch_add(1);
+            if (index >= conversion.size())
+                break;
+
+            std::string log;
+            if (!ConvertFile(opts, conversion[index], allowParallel, log))
+            {
+                retVal = 1;
+            }
+
+            const std::lock_guard<std::mutex> lock(outputLock);
+            printf("%s\n", log.c_str());
+            fflush(stdout);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(jobs - 1);
+    for (size_t j = 1; j < jobs; ++j)
+    {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    return retVal;
+}
@@ -30,7 +30,10 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstdarg>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -44,9 +47,13 @@
 #include <list>
 #include <locale>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include <wrl\client.h>
 
@@ -120,6 +127,7 @@ namespace
         OPT_WIC_UNCOMPRESSED,
         OPT_NOLOGO,
         OPT_TIMING,
+        OPT_BC_MODE_STATS,
         OPT_SEPALPHA,
         OPT_NO_WIC,
         OPT_TYPELESS_UNORM,
@@ -169,6 +177,11 @@ namespace
         OPT_ROTATE_COLOR,
         OPT_PAPER_WHITE_NITS,
         OPT_SWIZZLE,
+        OPT_JOBS,
+        OPT_MAX_MEMORY,
+        OPT_TARGET_PSNR,
+        OPT_TARGET_SSIM,
+        OPT_TARGET_REGION,
         OPT_VERSION,
         OPT_HELP,
     };
@@ -239,6 +252,8 @@ namespace
         { L"bc",            OPT_BC_COMPRESS },
         { L"c",             OPT_COLORKEY },
         { L"nits",          OPT_PAPER_WHITE_NITS },
+        { L"j",             OPT_JOBS },
+        { L"maxmem",        OPT_MAX_MEMORY },
     #ifdef USE_XBOX_EXTS
         { L"xbox",          OPT_USE_XBOX },
         { L"xgmode",        OPT_XGMODE },
@@ -270,6 +285,7 @@ namespace
         { L"alpha-threshold",       OPT_ALPHA_THRESHOLD },
         { L"alpha-weight",          OPT_ALPHA_WEIGHT },
         { L"bad-tails",             OPT_DDS_BAD_DXTN_TAILS },
+        { L"bc-mode-stats",         OPT_BC_MODE_STATS },
         { L"block-compress",        OPT_BC_COMPRESS },
         { L"color-key",             OPT_COLORKEY },
         { L"dword-alignment",       OPT_DDS_DWORD_ALIGN },
@@ -287,7 +303,9 @@ namespace
         { L"ignore-srgb",           OPT_IGNORE_SRGB_METADATA },
         { L"image-filter",          OPT_FILTER },
         { L"invert-y",              OPT_INVERT_Y },
+        { L"jobs",                  OPT_JOBS },
         { L"keep-coverage",         OPT_PRESERVE_ALPHA_COVERAGE },
+        { L"max-memory",            OPT_MAX_MEMORY },
         { L"mip-levels",            OPT_MIPLEVELS },
         { L"normal-map-amplitude",  OPT_NORMAL_MAP_AMPLITUDE },
         { L"normal-map",            OPT_NORMAL_MAP },
@@ -304,6 +322,9 @@ namespace
         { L"srgb-out",              OPT_SRGBO },
         { L"suffix",                OPT_SUFFIX },
         { L"swizzle",               OPT_SWIZZLE },
+        { L"target-psnr",           OPT_TARGET_PSNR },
+        { L"target-region",         OPT_TARGET_REGION },
+        { L"target-ssim",           OPT_TARGET_SSIM },
         { L"tga-zero-alpha",        OPT_TGAZEROALPHA },
         { L"timing",                OPT_TIMING },
         { L"to-lowercase",          OPT_TOLOWER },
@@ -520,6 +541,9 @@ namespace
         { L"FANT",                      TEX_FILTER_FANT },
         { L"BOX",                       TEX_FILTER_BOX },
         { L"TRIANGLE",                  TEX_FILTER_TRIANGLE },
+        { L"LANCZOS",                   TEX_FILTER_LANCZOS },
+        { L"MITCHELL",                  TEX_FILTER_MITCHELL },
+        { L"KAISER",                    TEX_FILTER_KAISER },
         { L"POINT_DITHER",              TEX_FILTER_POINT | TEX_FILTER_DITHER },
         { L"LINEAR_DITHER",             TEX_FILTER_LINEAR | TEX_FILTER_DITHER },
         { L"CUBIC_DITHER",              TEX_FILTER_CUBIC | TEX_FILTER_DITHER },
@@ -658,57 +682,163 @@ namespace
         return ((x != 0) && !(x & (x - 1)));
     }
 
+    enum
+    {
+        CONVERT_OK = 0,
+        CONVERT_FAILED,
+        CONVERT_FATAL,
+    };
+
+    // When converting several files at once, each worker captures its console output here
+    thread_local std::wstring* t_log = nullptr;
+
+    void LogPrintf(_In_z_ _Printf_format_string_ const wchar_t* format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+
+        if (t_log)
+        {
+            va_list argsCopy;
+            va_copy(argsCopy, args);
+            const int len = _vscwprintf(format, argsCopy);
+            va_end(argsCopy);
+
+            if (len > 0)
+            {
+                const size_t offset = t_log->size();
+                t_log->resize(offset + size_t(len) + 1);
+                std::ignore = vswprintf_s(&(*t_log)[offset], size_t(len) + 1, format, args);
+                t_log->resize(offset + size_t(len));
+            }
+        }
+        else
+        {
+            vwprintf(format, args);
+        }
+
+        va_end(args);
+    }
+
+    uint64_t EstimateMemoryUsage(_In_z_ const wchar_t* szFile, size_t width, size_t height)
+    {
+        const std::filesystem::path path(szFile);
+        const auto ext = path.extension();
+
+        TexMetadata info = {};
+        HRESULT hr = E_FAIL;
+        if (_wcsicmp(ext.c_str(), L".dds") == 0 || _wcsicmp(ext.c_str(), L".ddx") == 0)
+        {
+            hr = GetMetadataFromDDSFile(szFile, DDS_FLAGS_ALLOW_LARGE_FILES, info);
+        }
+        else if (_wcsicmp(ext.c_str(), L".tga") == 0)
+        {
+            hr = GetMetadataFromTGAFile(szFile, TGA_FLAGS_NONE, info);
+        }
+        else if (_wcsicmp(ext.c_str(), L".hdr") == 0)
+        {
+            hr = GetMetadataFromHDRFile(szFile, info);
+        }
+    #ifdef USE_OPENEXR
+        else if (_wcsicmp(ext.c_str(), L".exr") == 0)
+        {
+            hr = GetMetadataFromEXRFile(szFile, info);
+        }
+    #endif
+    #ifdef USE_LIBJPEG
+        else if (_wcsicmp(ext.c_str(), L".jpg") == 0 || _wcsicmp(ext.c_str(), L".jpeg") == 0)
+        {
+            hr = GetMetadataFromJPEGFile(szFile, info);
+        }
+    #endif
+    #ifdef USE_LIBPNG
+        else if (_wcsicmp(ext.c_str(), L".png") == 0)
+        {
+            hr = GetMetadataFromPNGFile(szFile, info);
+        }
+    #endif
+        else if (_wcsicmp(ext.c_str(), L".ppm") != 0
+            && _wcsicmp(ext.c_str(), L".pfm") != 0
+            && _wcsicmp(ext.c_str(), L".phm") != 0)
+        {
+            hr = GetMetadataFromWICFile(szFile, WIC_FLAGS_NONE, info);
+        }
+
+        // Source, working, and result images can all be live at once, in up to 128 bits per pixel
+        constexpr uint64_t c_BytesPerPixel = 3 * 16;
+
+        if (FAILED(hr))
+        {
+            // No metadata available, so assume the file is stored at roughly 4 bits per pixel
+            std::error_code ec;
+            const uint64_t fileSize = std::filesystem::file_size(path, ec);
+            return ec ? 0 : (fileSize * 2 * c_BytesPerPixel);
+        }
+
+        uint64_t pixels = uint64_t(std::max(info.width, width)) * uint64_t(std::max(info.height, height))
+            * uint64_t(info.depth) * uint64_t(info.arraySize);
+
+        // Allow for a full mip chain
+        pixels += pixels / 3;
+
+        return pixels * c_BytesPerPixel;
+    }
+
     void PrintInfo(const TexMetadata& info, bool isXbox)
     {
-        wprintf(L" (%zux%zu", info.width, info.height);
+        LogPrintf(L" (%zux%zu", info.width, info.height);
 
         if (TEX_DIMENSION_TEXTURE3D == info.dimension)
-            wprintf(L"x%zu", info.depth);
+            LogPrintf(L"x%zu", info.depth);
 
         if (info.mipLevels > 1)
-            wprintf(L",%zu", info.mipLevels);
+            LogPrintf(L",%zu", info.mipLevels);
 
         if (info.arraySize > 1)
-            wprintf(L",%zu", info.arraySize);
+            LogPrintf(L",%zu", info.arraySize);
 
-        wprintf(L" ");
-        PrintFormat(info.format, g_pFormats, g_pReadOnlyFormats);
+        const wchar_t* formatName = LookupByValue(info.format, g_pFormats);
+        if (!*formatName)
+        {
+            formatName = LookupByValue(info.format, g_pReadOnlyFormats);
+        }
+        LogPrintf(L" %ls", *formatName ? formatName : L"*UNKNOWN*");
 
         switch (info.dimension)
         {
         case TEX_DIMENSION_TEXTURE1D:
-            wprintf(L"%ls", (info.arraySize > 1) ? L" 1DArray" : L" 1D");
+            LogPrintf(L"%ls", (info.arraySize > 1) ? L" 1DArray" : L" 1D");
             break;
 
         case TEX_DIMENSION_TEXTURE2D:
             if (info.IsCubemap())
             {
-                wprintf(L"%ls", (info.arraySize > 6) ? L" CubeArray" : L" Cube");
+                LogPrintf(L"%ls", (info.arraySize > 6) ? L" CubeArray" : L" Cube");
             }
             else
             {
-                wprintf(L"%ls", (info.arraySize > 1) ? L" 2DArray" : L" 2D");
+                LogPrintf(L"%ls", (info.arraySize > 1) ? L" 2DArray" : L" 2D");
             }
             break;
 
         case TEX_DIMENSION_TEXTURE3D:
-            wprintf(L" 3D");
+            LogPrintf(L" 3D");
             break;
         }
 
         switch (info.GetAlphaMode())
         {
         case TEX_ALPHA_MODE_OPAQUE:
-            wprintf(L" \x03B1:Opaque");
+            LogPrintf(L" \x03B1:Opaque");
             break;
         case TEX_ALPHA_MODE_PREMULTIPLIED:
-            wprintf(L" \x03B1:PM");
+            LogPrintf(L" \x03B1:PM");
             break;
         case TEX_ALPHA_MODE_STRAIGHT:
-            wprintf(L" \x03B1:NonPM");
+            LogPrintf(L" \x03B1:NonPM");
             break;
         case TEX_ALPHA_MODE_CUSTOM:
-            wprintf(L" \x03B1:Custom");
+            LogPrintf(L" \x03B1:Custom");
             break;
         case TEX_ALPHA_MODE_UNKNOWN:
             break;
@@ -716,10 +846,10 @@ namespace
 
         if (isXbox)
         {
-            wprintf(L" Xbox");
+            LogPrintf(L" Xbox");
         }
 
-        wprintf(L")");
+        LogPrintf(L")");
     }
 
     _Success_(return)
@@ -748,6 +878,48 @@ namespace
         return SUCCEEDED(s_CreateDXGIFactory1(IID_PPV_ARGS(pFactory)));
     }
 
+    void PrintBCModeStats(const wchar_t* name, const BCModeStats& stats)
+    {
+        if (!stats.blocks)
+            return;
+
+        wprintf(L"\n %ls: %llu blocks, average error %.2f, max error %.2f\n", name,
+            static_cast<unsigned long long>(stats.blocks), stats.totalError / double(stats.blocks), double(stats.maxError));
+        wprintf(L"   mode     blocks        %%     time (ms)  top shapes\n");
+
+        for (size_t m = 0; m < std::size(stats.modeBlocks); ++m)
+        {
+            if (!stats.modeBlocks[m] && !stats.modeTime[m])
+                continue;
+
+            wprintf(L"   %4zu %10llu  %6.2f  %12.2f ", m, static_cast<unsigned long long>(stats.modeBlocks[m]),
+                100.0 * double(stats.modeBlocks[m]) / double(stats.blocks), double(stats.modeTime[m]) / 1000000.0);
+
+            // List the three most common shapes of the mode
+            bool used[std::extent_v<decltype(BCModeStats::shapeBlocks), 1>] = {};
+            for (size_t k = 0; k < 3; ++k)
+            {
+                size_t best = 0;
+                uint64_t bestCount = 0;
+                for (size_t s = 0; s < std::size(stats.shapeBlocks[m]); ++s)
+                {
+                    if (!used[s] && stats.shapeBlocks[m][s] > bestCount)
+                    {
+                        best = s;
+                        bestCount = stats.shapeBlocks[m][s];
+                    }
+                }
+
+                if (!bestCount)
+                    break;
+
+                used[best] = true;
+                wprintf(L" %zu(%llu)", best, static_cast<unsigned long long>(bestCount));
+            }
+            wprintf(L"\n");
+        }
+    }
+
     void PrintUsage()
     {
         PrintLogo(false, g_ToolName, g_Description);
@@ -839,20 +1011,28 @@ namespace
             L"\n"
             L"   -nologo             suppress copyright message\n"
             L"   --timing            display elapsed processing time\n"
+            L"   --bc-mode-stats     display BC6H/BC7 mode, shape, and error statistics\n"
             L"\n"
         #ifdef _OPENMP
             L"   --single-proc       Do not use multi-threaded compression\n"
         #endif
+            L"   -j <n>, --jobs <n>  Convert up to n files concurrently (0 uses all cores)\n"
+            L"   -maxmem <MB>, --max-memory <MB>\n"
+            L"                       Memory budget for concurrent files (defaults to half of RAM)\n"
             L"   -gpu <adapter>      Select GPU for DirectCompute-based codecs (0 is default)\n"
             L"   -nogpu              Do not use DirectCompute-based codecs\n"
             L"\n"
             L"   -bc <options>, --block-compress <options>\n"
             L"                       Sets options for BC compression\n"
             L"                       options must be one or more of\n"
-            L"                          d, u, q, x\n"
+            L"                          d, u, q, x, b\n"
             L"   -aw <weight>, --alpha-weight <weight>\n"
             L"                       BC7 GPU compressor weighting for alpha error metric\n"
             L"                       (defaults to 1.0)\n"
+            L"   --target-psnr <dB>, --target-ssim <value>\n"
+            L"                       Use the fastest CPU BC settings that reach this quality\n"
+            L"   --target-region <rows>\n"
+            L"                       Choose the BC settings for each band of rows (defaults to whole image)\n"
             L"\n"
             L"   -c <hex-RGB>, --color-key <hex-RGB>    colorkey (a.k.a. chromakey) transparency\n"
             L"   --rotate-color <rot>                   rotates color primaries and/or applies a curve\n"
@@ -1268,6 +1448,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     uint32_t dwRotateColor = 0;
     float paperWhiteNits = 200.f;
     float preserveAlphaCoverageRef = 0.0f;
+    unsigned int jobs = 1;
+    uint64_t maxMemory = 0;
+    TEX_QUALITY_METRIC targetMetric = TEX_QUALITY_PSNR;
+    float targetQuality = -1.f;
+    unsigned int targetRegion = 0;
     bool keepRecursiveDirs = false;
     bool dxt5nm = false;
     bool dxt5rxgb = false;
@@ -1283,11 +1468,13 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     std::locale::global(std::locale(""));
 
     // Initialize COM (needed for WIC)
-    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    if (FAILED(hr))
     {
-        wprintf(L"Failed to initialize COM (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-        return 1;
+        const HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        if (FAILED(hr))
+        {
+            wprintf(L"Failed to initialize COM (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+            return 1;
+        }
     }
 
     // Process command line
@@ -1373,6 +1560,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             case OPT_ROTATE_COLOR:
             case OPT_PAPER_WHITE_NITS:
             case OPT_SWIZZLE:
+            case OPT_JOBS:
+            case OPT_MAX_MEMORY:
+            case OPT_TARGET_PSNR:
+            case OPT_TARGET_SSIM:
+            case OPT_TARGET_REGION:
                 // These don't use flag bits
                 break;
 
@@ -1421,6 +1613,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             case OPT_PAPER_WHITE_NITS:
             case OPT_PRESERVE_ALPHA_COVERAGE:
             case OPT_SWIZZLE:
+            case OPT_JOBS:
+            case OPT_MAX_MEMORY:
+            case OPT_TARGET_PSNR:
+            case OPT_TARGET_SSIM:
+            case OPT_TARGET_REGION:
         #ifdef USE_XBOX_EXTS
             case OPT_XGMODE:
         #endif
@@ -1760,6 +1957,12 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         found = true;
                     }
 
+                    if (wcschr(pValue, L'b'))
+                    {
+                        dwCompress |= TEX_COMPRESS_BC_BATCH;
+                        found = true;
+                    }
+
                     if ((dwCompress & (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS)) == (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS))
                     {
                         wprintf(L"Can't use -bc x (max) and -bc q (quick) at same time\n\n");
@@ -1769,7 +1972,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                     if (!found)
                     {
-                        wprintf(L"Invalid value specified for -bc (%ls), missing d, u, q, or x\n\n", pValue);
+                        wprintf(L"Invalid value specified for -bc (%ls), missing d, u, q, x, or b\n\n", pValue);
                         return 1;
                     }
                 }
@@ -1881,6 +2084,36 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }
                 break;
 
+            case OPT_TARGET_PSNR:
+            case OPT_TARGET_SSIM:
+                if (targetQuality >= 0.f)
+                {
+                    wprintf(L"Only one of --target-psnr or --target-ssim can be used\n\n");
+                    return 1;
+                }
+                else if (swscanf_s(pValue, L"%f", &targetQuality) != 1 || targetQuality < 0.f)
+                {
+                    wprintf(L"Invalid value specified for target quality (%ls)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                else if (dwOption == OPT_TARGET_SSIM && targetQuality > 1.f)
+                {
+                    wprintf(L"--target-ssim (%ls) parameter must be between 0.0 and 1.0\n\n", pValue);
+                    return 1;
+                }
+                targetMetric = (dwOption == OPT_TARGET_SSIM) ? TEX_QUALITY_SSIM : TEX_QUALITY_PSNR;
+                break;
+
+            case OPT_TARGET_REGION:
+                if (swscanf_s(pValue, L"%u", &targetRegion) != 1)
+                {
+                    wprintf(L"Invalid value specified with --target-region (%ls)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                break;
+
             case OPT_SWIZZLE:
                 if (!*pValue || wcslen(pValue) > 4)
                 {
@@ -1895,6 +2128,33 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }
                 break;
 
+            case OPT_JOBS:
+                if (swscanf_s(pValue, L"%u", &jobs) != 1)
+                {
+                    wprintf(L"Invalid value specified with -j (%ls)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                else if (!jobs)
+                {
+                    jobs = std::max(std::thread::hardware_concurrency(), 1u);
+                }
+                break;
+
+            case OPT_MAX_MEMORY:
+                {
+                    unsigned int maxMemoryMB = 0;
+                    if (swscanf_s(pValue, L"%u", &maxMemoryMB) != 1 || !maxMemoryMB)
+                    {
+                        wprintf(L"Invalid value specified with -maxmem (%ls)\n\n", pValue);
+                        PrintUsage();
+                        return 1;
+                    }
+
+                    maxMemory = uint64_t(maxMemoryMB) * 1024 * 1024;
+                }
+                break;
+
         #ifdef USE_XBOX_EXTS
             case OPT_XGMODE:
                 {
@@ -1982,34 +2242,41 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     LARGE_INTEGER qpcStart = {};
     std::ignore = QueryPerformanceCounter(&qpcStart);
 
+    if (dwOptions & (UINT64_C(1) << OPT_BC_MODE_STATS))
+    {
+        ResetBCModeStats();
+        EnableBCModeStats(true);
+    }
+
     // Convert images
-    bool sizewarn = false;
-    bool nonpow2warn = false;
-    bool non4bc = false;
-    bool preserveAlphaCoverage = false;
+    std::atomic<bool> sizewarn(false);
+    std::atomic<bool> nonpow2warn(false);
+    std::atomic<bool> non4bc(false);
     ComPtr<ID3D11Device> pDevice;
+    std::mutex deviceLock;
 
-    int retVal = 0;
-
-    for (auto pConv = conversion.begin(); pConv != conversion.end(); ++pConv)
+    if (jobs > conversion.size())
     {
-        if (pConv != conversion.begin())
-            wprintf(L"\n");
+        jobs = static_cast<unsigned int>(conversion.size());
+    }
 
+    auto convertFile = [&](const SConversion& conv) -> int
+    {
         // --- Load source image -------------------------------------------------------
-        wprintf(L"reading %ls", pConv->szSrc.c_str());
+        LogPrintf(L"reading %ls", conv.szSrc.c_str());
         fflush(stdout);
 
+        HRESULT hr = S_OK;
         TexMetadata info;
         std::unique_ptr<ScratchImage> image(new (std::nothrow) ScratchImage);
 
         if (!image)
         {
-            wprintf(L"\nERROR: Memory allocation failed\n");
-            return 1;
+            LogPrintf(L"\nERROR: Memory allocation failed\n");
+            return CONVERT_FATAL;
         }
 
-        std::filesystem::path curpath(pConv->szSrc);
+        std::filesystem::path curpath(conv.szSrc);
         const auto ext = curpath.extension();
 
     #ifndef USE_XBOX_EXTS
@@ -2022,9 +2289,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = Xbox::GetMetadataFromDDSFile(curpath.c_str(), info, isXbox);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
 
             if (isXbox)
@@ -2056,9 +2322,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
 
             if (IsTypeless(info.format))
@@ -2074,9 +2339,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                 if (IsTypeless(info.format))
                 {
-                    wprintf(L" FAILED due to Typeless format %d\n", info.format);
-                    retVal = 1;
-                    continue;
+                    LogPrintf(L" FAILED due to Typeless format %d\n", info.format);
+                    return CONVERT_FAILED;
                 }
 
                 image->OverrideFormat(info.format);
@@ -2087,9 +2351,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromBMPEx(curpath.c_str(), WIC_FLAGS_NONE | dwFilter, &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
         }
         else if (_wcsicmp(ext.c_str(), L".tga") == 0)
@@ -2107,9 +2370,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromTGAFile(curpath.c_str(), tgaFlags, &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
         }
         else if (_wcsicmp(ext.c_str(), L".hdr") == 0)
@@ -2117,9 +2379,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromHDRFile(curpath.c_str(), &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
         }
         else if (_wcsicmp(ext.c_str(), L".ppm") == 0)
@@ -2127,9 +2388,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromPortablePixMap(curpath.c_str(), &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
         }
         else if (_wcsicmp(ext.c_str(), L".pfm") == 0 || _wcsicmp(ext.c_str(), L".phm") == 0)
@@ -2137,9 +2397,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromPortablePixMapHDR(curpath.c_str(), &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
         }
     #ifdef USE_OPENEXR
@@ -2148,9 +2407,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromEXRFile(curpath.c_str(), &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
         }
     #endif
@@ -2160,9 +2418,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromJPEGFile(curpath.c_str(), &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
         }
     #endif
@@ -2172,9 +2429,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromPNGFile(curpath.c_str(), &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
         }
     #endif
@@ -2201,20 +2457,19 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = LoadFromWICFile(curpath.c_str(), wicFlags, &info, *image);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
                 if (hr == static_cast<HRESULT>(0xc00d5212) /* MF_E_TOPO_CODEC_NOT_FOUND */)
                 {
                     if (_wcsicmp(ext.c_str(), L".heic") == 0 || _wcsicmp(ext.c_str(), L".heif") == 0)
                     {
-                        wprintf(L"INFO: This format requires installing the HEIF Image Extensions - https://aka.ms/heif\n");
+                        LogPrintf(L"INFO: This format requires installing the HEIF Image Extensions - https://aka.ms/heif\n");
                     }
                     else if (_wcsicmp(ext.c_str(), L".webp") == 0)
                     {
-                        wprintf(L"INFO: This format requires installing the WEBP Image Extensions - https://apps.microsoft.com/detail/9PG2DK419DRG\n");
+                        LogPrintf(L"INFO: This format requires installing the WEBP Image Extensions - https://apps.microsoft.com/detail/9PG2DK419DRG\n");
                     }
                 }
-                continue;
+                return CONVERT_FAILED;
             }
         }
 
@@ -2223,7 +2478,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         size_t tMips = (!mipLevels && info.mipLevels > 1) ? info.mipLevels : mipLevels;
 
         // Convert texture
-        wprintf(L" as");
+        LogPrintf(L" as");
         fflush(stdout);
 
         // --- Planar ------------------------------------------------------------------
@@ -2236,17 +2491,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             hr = ConvertToSinglePlane(img, nimg, info, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [converttosingleplane] (%08X%ls)\n",
+                LogPrintf(L" FAILED [converttosingleplane] (%08X%ls)\n",
                     static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                return CONVERT_FAILED;
             }
 
             auto& tinfo = timage->GetMetadata();
@@ -2278,8 +2532,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
                     if (!timage)
                     {
-                        wprintf(L"\nERROR: Memory allocation failed\n");
-                        return 1;
+                        LogPrintf(L"\nERROR: Memory allocation failed\n");
+                        return CONVERT_FATAL;
                     }
 
                     // If we started with < 4x4 then no need to generate mips
@@ -2296,9 +2550,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     hr = timage->Initialize(mdata);
                     if (FAILED(hr))
                     {
-                        wprintf(L" FAILED [BC non-multiple-of-4 fixup] (%08X%ls)\n",
+                        LogPrintf(L" FAILED [BC non-multiple-of-4 fixup] (%08X%ls)\n",
                             static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                        return 1;
+                        return CONVERT_FATAL;
                     }
 
                     if (mdata.dimension == TEX_DIMENSION_TEXTURE3D)
@@ -2340,16 +2594,15 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             hr = Decompress(img, nimg, info, DXGI_FORMAT_UNKNOWN /* picks good default */, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [decompress] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
-                continue;
+                LogPrintf(L" FAILED [decompress] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FAILED;
             }
 
             auto& tinfo = timage->GetMetadata();
@@ -2383,11 +2636,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         {
             if (info.GetAlphaMode() == TEX_ALPHA_MODE_STRAIGHT)
             {
-                printf("\nWARNING: Image is already using straight alpha\n");
+                LogPrintf(L"\nWARNING: Image is already using straight alpha\n");
             }
             else if (!info.IsPMAlpha())
             {
-                printf("\nWARNING: Image is not using premultipled alpha\n");
+                LogPrintf(L"\nWARNING: Image is not using premultipled alpha\n");
             }
             else
             {
@@ -2398,17 +2651,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
                 if (!timage)
                 {
-                    wprintf(L"\nERROR: Memory allocation failed\n");
-                    return 1;
+                    LogPrintf(L"\nERROR: Memory allocation failed\n");
+                    return CONVERT_FATAL;
                 }
 
                 hr = PremultiplyAlpha(img, nimg, info, TEX_PMALPHA_REVERSE | dwSRGB, *timage);
                 if (FAILED(hr))
                 {
-                    wprintf(L" FAILED [demultiply alpha] (%08X%ls)\n",
+                    LogPrintf(L" FAILED [demultiply alpha] (%08X%ls)\n",
                         static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                    retVal = 1;
-                    continue;
+                    return CONVERT_FAILED;
                 }
 
                 auto& tinfo = timage->GetMetadata();
@@ -2433,8 +2685,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             TEX_FR_FLAGS dwFlags = TEX_FR_ROTATE0;
@@ -2450,8 +2702,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = FlipRotate(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwFlags, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [fliprotate] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [fliprotate] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
             auto& tinfo = timage->GetMetadata();
@@ -2499,15 +2751,15 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             hr = Resize(image->GetImages(), image->GetImageCount(), image->GetMetadata(), twidth, theight, dwFilter | dwFilterOpts, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [resize] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [resize] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
             auto& tinfo = timage->GetMetadata();
@@ -2547,8 +2799,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             const XMVECTOR zc = XMVectorSelectControl(zeroElements[0], zeroElements[1], zeroElements[2], zeroElements[3]);
@@ -2569,8 +2821,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [swizzle] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [swizzle] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
         #ifndef NDEBUG
@@ -2598,16 +2850,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
                 if (!timage)
                 {
-                    wprintf(L"\nERROR: Memory allocation failed\n");
-                    return 1;
+                    LogPrintf(L"\nERROR: Memory allocation failed\n");
+                    return CONVERT_FATAL;
                 }
 
                 hr = Convert(image->GetImages(), image->GetImageCount(), image->GetMetadata(), DXGI_FORMAT_R16G16B16A16_FLOAT,
                     dwFilter | dwFilterOpts | dwSRGB | dwConvert, alphaThreshold, *timage);
                 if (FAILED(hr))
                 {
-                    wprintf(L" FAILED [convert] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                    return 1;
+                    LogPrintf(L" FAILED [convert] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                    return CONVERT_FATAL;
                 }
 
             #ifndef NDEBUG
@@ -2632,8 +2884,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             switch (dwRotateColor)
@@ -2838,9 +3090,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [rotate color apply] (%08X%ls)\n",
+                LogPrintf(L" FAILED [rotate color apply] (%08X%ls)\n",
                     static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                return CONVERT_FATAL;
             }
 
         #ifndef NDEBUG
@@ -2866,8 +3118,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             // Compute max luminosity across all images
@@ -2890,8 +3142,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 });
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [tonemap maxlum] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [tonemap maxlum] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
             // Reinhard et al, "Photographic Tone Reproduction for Digital Images"
@@ -2919,8 +3171,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [tonemap apply] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [tonemap apply] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
         #ifndef NDEBUG
@@ -2946,8 +3198,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             DXGI_FORMAT nmfmt = tformat;
@@ -2974,8 +3226,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = ComputeNormalMap(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwNormalMap, nmapAmplitude, nmfmt, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [normalmap] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [normalmap] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
             auto& tinfo = timage->GetMetadata();
@@ -2999,16 +3251,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             hr = Convert(image->GetImages(), image->GetImageCount(), image->GetMetadata(), tformat,
                 dwFilter | dwFilterOpts | dwSRGB | dwConvert, alphaThreshold, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [convert] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [convert] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
             auto& tinfo = timage->GetMetadata();
@@ -3035,8 +3287,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             XMVECTOR colorKeyValue = XMLoadColor(reinterpret_cast<const XMCOLOR*>(&colorKey));
@@ -3066,8 +3318,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [colorkey] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [colorkey] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
         #ifndef NDEBUG
@@ -3093,8 +3345,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
@@ -3115,8 +3367,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [inverty] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [inverty] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
         #ifndef NDEBUG
@@ -3142,8 +3394,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             bool isunorm = (FormatDataType(info.format) == FORMAT_TYPE_UNORM) != 0;
@@ -3176,8 +3428,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }, *timage);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [reconstructz] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [reconstructz] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
         #ifndef NDEBUG
@@ -3198,6 +3450,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
 
         // --- Determine whether preserve alpha coverage is required (if requested) ----
+        bool preserveAlphaCoverage = false;
         if (preserveAlphaCoverageRef > 0.0f && HasAlpha(info.format) && !image->IsAlphaAllOpaque())
         {
             preserveAlphaCoverage = true;
@@ -3219,6 +3472,22 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
         }
 
+        if (info.dimension == TEX_DIMENSION_TEXTURE3D)
+        {
+            switch (dwFilter3D & TEX_FILTER_MODE_MASK)
+            {
+            case TEX_FILTER_LANCZOS:
+            case TEX_FILTER_MITCHELL:
+            case TEX_FILTER_KAISER:
+                // Volume mipmaps do not support the separable resampler filters
+                dwFilter3D = TEX_FILTER_TRIANGLE;
+                break;
+
+            default:
+                break;
+            }
+        }
+
         if ((!tMips || info.mipLevels != tMips || preserveAlphaCoverage) && (info.mipLevels != 1))
         {
             // Mips generation only works on a single base image, so strip off existing mip levels
@@ -3227,8 +3496,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             TexMetadata mdata = info;
@@ -3236,9 +3505,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             hr = timage->Initialize(mdata);
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [copy to single level] (%08X%ls)\n",
+                LogPrintf(L" FAILED [copy to single level] (%08X%ls)\n",
                     static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                return CONVERT_FATAL;
             }
 
             if (info.dimension == TEX_DIMENSION_TEXTURE3D)
@@ -3249,9 +3518,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         *timage->GetImage(0, 0, d), TEX_FILTER_DEFAULT, 0, 0);
                     if (FAILED(hr))
                     {
-                        wprintf(L" FAILED [copy to single level] (%08X%ls)\n",
+                        LogPrintf(L" FAILED [copy to single level] (%08X%ls)\n",
                             static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                        return 1;
+                        return CONVERT_FATAL;
                     }
                 }
             }
@@ -3263,8 +3532,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         *timage->GetImage(0, i, 0), TEX_FILTER_DEFAULT, 0, 0);
                     if (FAILED(hr))
                     {
-                        wprintf(L" FAILED [copy to single level] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                        return 1;
+                        LogPrintf(L" FAILED [copy to single level] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                        return CONVERT_FATAL;
                     }
                 }
             }
@@ -3280,8 +3549,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 hr = timage->Initialize(mdata);
                 if (FAILED(hr))
                 {
-                    wprintf(L" FAILED [copy compressed to single level] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                    return 1;
+                    LogPrintf(L" FAILED [copy compressed to single level] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                    return CONVERT_FATAL;
                 }
 
                 if (mdata.dimension == TEX_DIMENSION_TEXTURE3D)
@@ -3318,8 +3587,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             if (info.dimension == TEX_DIMENSION_TEXTURE3D)
@@ -3332,8 +3601,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [mipmaps] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [mipmaps] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
             auto& tinfo = timage->GetMetadata();
@@ -3357,15 +3626,15 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
+                LogPrintf(L"\nERROR: Memory allocation failed\n");
+                return CONVERT_FATAL;
             }
 
             hr = timage->Initialize(image->GetMetadata());
             if (FAILED(hr))
             {
-                wprintf(L" FAILED [keepcoverage] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
+                LogPrintf(L" FAILED [keepcoverage] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                return CONVERT_FATAL;
             }
 
             const size_t items = image->GetMetadata().arraySize;
@@ -3377,8 +3646,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 hr = ScaleMipMapsAlphaForCoverage(img, info.mipLevels, info, item, preserveAlphaCoverageRef, *timage);
                 if (FAILED(hr))
                 {
-                    wprintf(L" FAILED [keepcoverage] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                    return 1;
+                    LogPrintf(L" FAILED [keepcoverage] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                    return CONVERT_FATAL;
                 }
             }
 
@@ -3405,7 +3674,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         {
             if (info.IsPMAlpha())
             {
-                printf("\nWARNING: Image is already using premultiplied alpha\n");
+                LogPrintf(L"\nWARNING: Image is already using premultiplied alpha\n");
             }
             else
             {
@@ -3416,16 +3685,15 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
                 if (!timage)
                 {
-                    wprintf(L"\nERROR: Memory allocation failed\n");
-                    return 1;
+                    LogPrintf(L"\nERROR: Memory allocation failed\n");
+                    return CONVERT_FATAL;
                 }
 
                 hr = PremultiplyAlpha(img, nimg, info, TEX_PMALPHA_DEFAULT | dwSRGB, *timage);
                 if (FAILED(hr))
                 {
-                    wprintf(L" FAILED [premultiply alpha] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                    retVal = 1;
-                    continue;
+                    LogPrintf(L" FAILED [premultiply alpha] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                    return CONVERT_FAILED;
                 }
 
                 auto& tinfo = timage->GetMetadata();
@@ -3455,8 +3723,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
                 if (!timage)
                 {
-                    wprintf(L"\nERROR: Memory allocation failed\n");
-                    return 1;
+                    LogPrintf(L"\nERROR: Memory allocation failed\n");
+                    return CONVERT_FATAL;
                 }
 
                 if (dxt5nm)
@@ -3473,8 +3741,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         }, *timage);
                     if (FAILED(hr))
                     {
-                        wprintf(L" FAILED [DXT5nm] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                        return 1;
+                        LogPrintf(L" FAILED [DXT5nm] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                        return CONVERT_FATAL;
                     }
                 }
                 else
@@ -3491,8 +3759,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         }, *timage);
                     if (FAILED(hr))
                     {
-                        wprintf(L" FAILED [DXT5 RXGB] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                        return 1;
+                        LogPrintf(L" FAILED [DXT5 RXGB] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                        return CONVERT_FATAL;
                     }
                 }
 
@@ -3547,8 +3815,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
                     if (!timage)
                     {
-                        wprintf(L"\nERROR: Memory allocation failed\n");
-                        return 1;
+                        LogPrintf(L"\nERROR: Memory allocation failed\n");
+                        return CONVERT_FATAL;
                     }
 
                     bool bc6hbc7 = false;
@@ -3563,20 +3831,23 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         bc6hbc7 = true;
 
                         {
+                            std::lock_guard<std::mutex> lock(deviceLock);
+
                             static bool s_tryonce = false;
 
                             if (!s_tryonce)
                             {
                                 s_tryonce = true;
 
-                                if (!(dwOptions & (UINT64_C(1) << OPT_NOGPU)))
+                                // Quality targeting needs the CPU codec's encoder settings
+                                if (!(dwOptions & (UINT64_C(1) << OPT_NOGPU)) && targetQuality < 0.f)
                                 {
                                     if (!CreateDevice(adapter, pDevice.GetAddressOf()))
-                                        wprintf(L"\nWARNING: DirectCompute is not available, using BC6H / BC7 CPU codec\n");
+                                        LogPrintf(L"\nWARNING: DirectCompute is not available, using BC6H / BC7 CPU codec\n");
                                 }
                                 else
                                 {
-                                    wprintf(L"\nWARNING: using BC6H / BC7 CPU codec\n");
+                                    LogPrintf(L"\nWARNING: using BC6H / BC7 CPU codec\n");
                                 }
                             }
                         }
@@ -3588,7 +3859,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                     TEX_COMPRESS_FLAGS cflags = dwCompress;
                 #ifdef _OPENMP
-                    if (!(dwOptions & (UINT64_C(1) << OPT_FORCE_SINGLEPROC)))
+                    // With file-level jobs the cores are already busy, so each file compresses on a single thread
+                    if (!(dwOptions & (UINT64_C(1) << OPT_FORCE_SINGLEPROC)) && jobs <= 1)
                     {
                         cflags |= TEX_COMPRESS_PARALLEL;
                     }
@@ -3601,17 +3873,25 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                     if (bc6hbc7 && pDevice)
                     {
+                        // The device's immediate context is not free-threaded
+                        std::lock_guard<std::mutex> lock(deviceLock);
                         hr = Compress(pDevice.Get(), img, nimg, info, tformat, dwCompress | dwSRGB, alphaWeight, *timage);
                     }
+                    else if (targetQuality >= 0.f)
+                    {
+                        CompressOptions options = {};
+                        options.flags = cflags | dwSRGB;
+                        options.threshold = alphaThreshold;
+                        hr = CompressToQuality(img, nimg, info, tformat, options, targetMetric, targetQuality, targetRegion, *timage);
+                    }
                     else
                     {
                         hr = Compress(img, nimg, info, tformat, cflags | dwSRGB, alphaThreshold, *timage);
                     }
                     if (FAILED(hr))
                     {
-                        wprintf(L" FAILED [compress] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                        retVal = 1;
-                        continue;
+                        LogPrintf(L" FAILED [compress] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                        return CONVERT_FAILED;
                     }
 
                     auto& tinfo = timage->GetMetadata();
@@ -3674,32 +3954,30 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             constexpr bool isXboxOut = false;
         #endif
             PrintInfo(info, isXboxOut);
-            wprintf(L"\n");
+            LogPrintf(L"\n");
 
             // Figure out dest filename
             std::filesystem::path dest(outputDir);
 
-            if (keepRecursiveDirs && !pConv->szFolder.empty())
+            if (keepRecursiveDirs && !conv.szFolder.empty())
             {
-                dest.append(pConv->szFolder.c_str());
+                dest.append(conv.szFolder.c_str());
 
                 std::error_code ec;
                 auto apath = std::filesystem::absolute(dest, ec);
 
                 if (ec)
                 {
-                    wprintf(L" get full path FAILED (%hs)\n", ec.message().c_str());
-                    retVal = 1;
-                    continue;
+                    LogPrintf(L" get full path FAILED (%hs)\n", ec.message().c_str());
+                    return CONVERT_FAILED;
                 }
 
                 const auto err = static_cast<DWORD>(SHCreateDirectoryExW(nullptr, apath.c_str(), nullptr));
                 if (err != ERROR_SUCCESS && err != ERROR_ALREADY_EXISTS)
                 {
-                    wprintf(L" directory creation FAILED (%08X%ls)\n",
+                    LogPrintf(L" directory creation FAILED (%08X%ls)\n",
                         static_cast<unsigned int>(HRESULT_FROM_WIN32(err)), GetErrorDesc(HRESULT_FROM_WIN32(err)));
-                    retVal = 1;
-                    continue;
+                    return CONVERT_FAILED;
                 }
             }
 
@@ -3722,16 +4000,15 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
 
             // Write texture
-            wprintf(L"writing %ls", destName.c_str());
+            LogPrintf(L"writing %ls", destName.c_str());
             fflush(stdout);
 
             if (~dwOptions & (UINT64_C(1) << OPT_OVERWRITE))
             {
                 if (GetFileAttributesW(destName.c_str()) != INVALID_FILE_ATTRIBUTES)
                 {
-                    wprintf(L"\nERROR: Output file already exists, use -y to overwrite:\n");
-                    retVal = 1;
-                    continue;
+                    LogPrintf(L"\nERROR: Output file already exists, use -y to overwrite:\n");
+                    return CONVERT_FAILED;
                 }
             }
 
@@ -3901,15 +4178,179 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
             if (FAILED(hr))
             {
-                wprintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                retVal = 1;
+                LogPrintf(L" FAILED (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
                 if ((hr == static_cast<HRESULT>(0xc00d5212) /* MF_E_TOPO_CODEC_NOT_FOUND */) && (FileType == WIC_CODEC_HEIF))
                 {
-                    wprintf(L"INFO: This format requires installing the HEIF Image Extensions - https://aka.ms/heif\n");
+                    LogPrintf(L"INFO: This format requires installing the HEIF Image Extensions - https://aka.ms/heif\n");
                 }
-                continue;
+                return CONVERT_FAILED;
             }
-            wprintf(L"\n");
+            LogPrintf(L"\n");
+        }
+
+        return CONVERT_OK;
+    };
+
+    int retVal = 0;
+
+    if (jobs <= 1)
+    {
+        for (auto pConv = conversion.begin(); pConv != conversion.end(); ++pConv)
+        {
+            if (pConv != conversion.begin())
+                wprintf(L"\n");
+
+            const int result = convertFile(*pConv);
+            if (result == CONVERT_FATAL)
+                return 1;
+
+            if (result != CONVERT_OK)
+                retVal = 1;
+        }
+    }
+    else
+    {
+        // --- Parallel batch --------------------------------------------------------------
+        // Files are admitted in list order as long as their estimated working set fits the
+        // memory budget; a worker skips ahead to a smaller file rather than sit idle. Output
+        // for each file is buffered and written in list order once all prior files finish.
+        if (!maxMemory)
+        {
+            MEMORYSTATUSEX memStatus = {};
+            memStatus.dwLength = sizeof(memStatus);
+            if (GlobalMemoryStatusEx(&memStatus))
+            {
+                maxMemory = memStatus.ullTotalPhys / 2;
+            }
+            else
+            {
+                maxMemory = UINT64_MAX;
+            }
+        }
+
+        struct SJob
+        {
+            const SConversion*  conv;
+            uint64_t            memory;
+            std::wstring        log;
+            int                 result;
+            bool                started;
+            bool                done;
+        };
+
+        std::vector<SJob> jobList;
+        jobList.reserve(conversion.size());
+        for (const auto& it : conversion)
+        {
+            jobList.push_back({ &it, EstimateMemoryUsage(it.szSrc.c_str(), width, height), {}, CONVERT_OK, false, false });
+        }
+
+        std::mutex jobLock;
+        std::condition_variable jobFinished;
+        uint64_t memoryInUse = 0;
+        size_t running = 0;
+        size_t firstPending = 0;
+        size_t nextToPrint = 0;
+        bool cancelled = false;
+
+        auto worker = [&]()
+        {
+            for (;;)
+            {
+                SJob* job = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(jobLock);
+                    for (;;)
+                    {
+                        while (firstPending < jobList.size() && jobList[firstPending].started)
+                            ++firstPending;
+
+                        if (cancelled || firstPending >= jobList.size())
+                            return;
+
+                        for (size_t j = firstPending; j < jobList.size(); ++j)
+                        {
+                            auto& candidate = jobList[j];
+                            if (candidate.started)
+                                continue;
+
+                            // A file is always admitted if nothing else is running, even when it exceeds the budget on its own
+                            if (!running || (memoryInUse + candidate.memory) <= maxMemory)
+                            {
+                                job = &candidate;
+                                break;
+                            }
+                        }
+
+                        if (job)
+                            break;
+
+                        jobFinished.wait(lock);
+                    }
+
+                    job->started = true;
+                    memoryInUse += job->memory;
+                    ++running;
+                }
+
+                t_log = &job->log;
+                const int result = convertFile(*job->conv);
+                t_log = nullptr;
+
+                {
+                    std::lock_guard<std::mutex> lock(jobLock);
+
+                    job->result = result;
+                    job->done = true;
+                    memoryInUse -= job->memory;
+                    --running;
+
+                    if (result == CONVERT_FATAL)
+                        cancelled = true;
+
+                    for (; nextToPrint < jobList.size() && jobList[nextToPrint].done; ++nextToPrint)
+                    {
+                        if (nextToPrint > 0)
+                            wprintf(L"\n");
+
+                        wprintf(L"%ls", jobList[nextToPrint].log.c_str());
+                        std::wstring().swap(jobList[nextToPrint].log);
+                    }
+                    fflush(stdout);
+                }
+
+                jobFinished.notify_all();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(jobs);
+        for (unsigned int j = 0; j < jobs; ++j)
+        {
+            threads.emplace_back(worker);
+        }
+
+        for (auto& it : threads)
+        {
+            it.join();
+        }
+
+        // Emit any output held back behind a file that never started
+        for (; nextToPrint < jobList.size(); ++nextToPrint)
+        {
+            if (jobList[nextToPrint].done)
+            {
+                wprintf(L"\n%ls", jobList[nextToPrint].log.c_str());
+            }
+        }
+
+        for (const auto& it : jobList)
+        {
+            if (it.result == CONVERT_FATAL)
+                return 1;
+
+            if (it.result != CONVERT_OK)
+                retVal = 1;
         }
     }
 
@@ -3927,6 +4368,17 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     if (non4bc)
         wprintf(L"\nWARNING: Direct3D requires BC image to be multiple of 4 in width & height\n");
 
+    if (dwOptions & (UINT64_C(1) << OPT_BC_MODE_STATS))
+    {
+        EnableBCModeStats(false);
+
+        auto stats = std::make_unique<BCModeStats>();
+        GetBC6HModeStats(*stats);
+        PrintBCModeStats(L"BC6H", *stats);
+        GetBC7ModeStats(*stats);
+        PrintBCModeStats(L"BC7", *stats);
+    }
+
     if (dwOptions & (UINT64_C(1) << OPT_TIMING))
     {
         LARGE_INTEGER qpcEnd = {};
@@ -106,6 +106,7 @@ namespace
         OPT_TYPELESS_UNORM,
         OPT_TYPELESS_FLOAT,
         OPT_EXPAND_LUMINANCE,
+        OPT_IMAGE_QUALITY,
         OPT_FLAGS_MAX,
         OPT_FORMAT,
         OPT_FILTER,
@@ -151,6 +152,7 @@ namespace
         { L"tu",         OPT_TYPELESS_UNORM },
         { L"tf",         OPT_TYPELESS_FLOAT },
         { L"xlum",       OPT_EXPAND_LUMINANCE },
+        { L"q",          OPT_IMAGE_QUALITY },
         { L"c",          OPT_DIFF_COLOR },
         { L"t",          OPT_THRESHOLD },
         { L"flist",      OPT_FILELIST },
@@ -176,6 +178,7 @@ namespace
         { L"help",                  OPT_HELP },
         { L"ignore-mips",           OPT_DDS_IGNORE_MIPS },
         { L"image-filter",          OPT_FILTER },
+        { L"image-quality",         OPT_IMAGE_QUALITY },
         { L"overwrite",             OPT_OVERWRITE },
         { L"permissive",            OPT_DDS_PERMISSIVE },
         { L"target-x",              OPT_TARGET_PIXELX },
@@ -448,6 +451,23 @@ namespace
         { nullptr,  CODEC_DDS      }
     };
 
+    HRESULT PrintImageQuality(const Image& image1, const Image& image2)
+    {
+        ImageQuality quality = {};
+        const HRESULT hr = ComputeImageQuality(image1, image2, quality, CMSE_PARALLEL);
+        if (FAILED(hr))
+            return hr;
+
+        wprintf(L"    SSIM %f (%f %f %f %f) MS-SSIM %f (%f %f %f %f) PSNR-HVS %f dB\n",
+            double(quality.ssimLuminance),
+            double(quality.ssim[0]), double(quality.ssim[1]), double(quality.ssim[2]), double(quality.ssim[3]),
+            double(quality.msssimLuminance),
+            double(quality.msssim[0]), double(quality.msssim[1]), double(quality.msssim[2]), double(quality.msssim[3]),
+            double(quality.psnrHVS));
+
+        return S_OK;
+    }
+
     void PrintUsage()
     {
         PrintLogo(false, g_ToolName, g_Description);
@@ -457,7 +477,7 @@ namespace
             L"\nCOMMANDS\n"
             L"   info                Output image metadata\n"
             L"   analyze             Analyze and summarize image information\n"
-            L"   compare             Compare two images with MSE error metric\n"
+            L"   compare             Compare two images with MSE error metric (and SSIM with -q)\n"
             L"   diff                Generate difference image from two images\n"
             L"   dumpbc              Dump out compressed blocks (DDS BC only)\n"
             L"   dumpdds             Dump out all the images in a complex DDS\n"
@@ -477,6 +497,9 @@ namespace
             L"   --ignore-mips                  Reads just the top-level mip which reads some invalid files\n"
             L"   -xlum, --expand-luminance      Expand legacy L8, L16, and A8P8 formats\n"
             L"\n"
+            L"                                  (compare only)\n"
+            L"   -q, --image-quality            Also report SSIM, MS-SSIM, and PSNR-HVS\n"
+            L"\n"
             L"                                  (diff only)\n"
             L"   -f <format>, --format <format> pixel format for output\n"
             L"   -o <filename>                  output filename for diff\n"
@@ -681,10 +704,35 @@ namespace
         }
     };
 
+    constexpr size_t c_AnalyzeBands = 64;
+
     HRESULT Analyze(const Image& image, _Out_ AnalyzeData& result)
     {
         memset(&result, 0, sizeof(AnalyzeData));
 
+        // Each band accumulates on its own so the rows can be evaluated in parallel, and the bands are combined in order
+        struct BandData
+        {
+            XMVECTOR minv;
+            XMVECTOR maxv;
+            XMVECTOR acc;
+            XMVECTOR luminance;
+            size_t totalPixels;
+            size_t specials[4];
+        };
+
+        const size_t bands = std::min(c_AnalyzeBands, std::max<size_t>(image.height, 1));
+        std::vector<BandData> bandData(bands);
+        for (auto& band : bandData)
+        {
+            band.minv = g_XMFltMax;
+            band.maxv = XMVectorNegate(g_XMFltMax);
+            band.acc = g_XMZero;
+            band.luminance = g_XMZero;
+            band.totalPixels = 0;
+            memset(band.specials, 0, sizeof(band.specials));
+        }
+
         // First pass
         XMVECTOR minv = g_XMFltMax;
         XMVECTOR maxv = XMVectorNegate(g_XMFltMax);
@@ -693,43 +741,74 @@ namespace
 
         size_t totalPixels = 0;
 
-        HRESULT hr = EvaluateImage(image, [&](const XMVECTOR * pixels, size_t width, size_t y)
+        HRESULT hr = EvaluateImage(image, bands,
+            [&](const XMVECTOR * pixels, size_t width, size_t y, size_t band)
             {
                 static const XMVECTORF32 s_luminance = { { {  0.3f, 0.59f, 0.11f, 0.f } } };
 
                 UNREFERENCED_PARAMETER(y);
 
+                // Accumulate the scanline in locals; writing the shared vector per pixel would false-share cache lines
+                BandData& data = bandData[band];
+                XMVECTOR bandMin = data.minv;
+                XMVECTOR bandMax = data.maxv;
+                XMVECTOR bandAcc = data.acc;
+                XMVECTOR bandLuminance = data.luminance;
+                size_t specials[4] = {};
+
                 for (size_t x = 0; x < width; ++x)
                 {
                     const XMVECTOR v = *pixels++;
-                    luminance = XMVectorMax(luminance, XMVector3Dot(v, s_luminance));
-                    minv = XMVectorMin(minv, v);
-                    maxv = XMVectorMax(maxv, v);
-                    acc = XMVectorAdd(v, acc);
-                    ++totalPixels;
+                    bandLuminance = XMVectorMax(bandLuminance, XMVector3Dot(v, s_luminance));
+                    bandMin = XMVectorMin(bandMin, v);
+                    bandMax = XMVectorMax(bandMax, v);
+                    bandAcc = XMVectorAdd(v, bandAcc);
 
                     XMFLOAT4 f;
                     XMStoreFloat4(&f, v);
                     if (!isfinite(f.x))
                     {
-                        ++result.specials_x;
+                        ++specials[0];
                     }
 
                     if (!isfinite(f.y))
                     {
-                        ++result.specials_y;
+                        ++specials[1];
                     }
 
                     if (!isfinite(f.z))
                     {
-                        ++result.specials_z;
+                        ++specials[2];
                     }
 
                     if (!isfinite(f.w))
                     {
-                        ++result.specials_w;
+                        ++specials[3];
                     }
                 }
+
+                data.minv = bandMin;
+                data.maxv = bandMax;
+                data.acc = bandAcc;
+                data.luminance = bandLuminance;
+                data.totalPixels += width;
+                for (size_t j = 0; j < 4; ++j)
+                {
+                    data.specials[j] += specials[j];
+                }
+            },
+            [&](size_t band)
+            {
+                const BandData& data = bandData[band];
+                luminance = XMVectorMax(luminance, data.luminance);
+                minv = XMVectorMin(minv, data.minv);
+                maxv = XMVectorMax(maxv, data.maxv);
+                acc = XMVectorAdd(data.acc, acc);
+                totalPixels += data.totalPixels;
+                result.specials_x += data.specials[0];
+                result.specials_y += data.specials[1];
+                result.specials_z += data.specials[2];
+                result.specials_w += data.specials[3];
             });
         if (FAILED(hr))
             return hr;
@@ -748,17 +827,31 @@ namespace
         // Second pass
         acc = g_XMZero;
 
-        hr = EvaluateImage(image, [&](const XMVECTOR * pixels, size_t width, size_t y)
+        for (auto& band : bandData)
+        {
+            band.acc = g_XMZero;
+        }
+
+        hr = EvaluateImage(image, bands,
+            [&](const XMVECTOR * pixels, size_t width, size_t y, size_t band)
             {
                 UNREFERENCED_PARAMETER(y);
 
+                XMVECTOR bandAcc = bandData[band].acc;
+
                 for (size_t x = 0; x < width; ++x)
                 {
                     const XMVECTOR v = *pixels++;
 
                     const XMVECTOR diff = XMVectorSubtract(v, avgv);
-                    acc = XMVectorMultiplyAdd(diff, diff, acc);
+                    bandAcc = XMVectorMultiplyAdd(diff, diff, bandAcc);
                 }
+
+                bandData[band].acc = bandAcc;
+            },
+            [&](size_t band)
+            {
+                acc = XMVectorAdd(bandData[band].acc, acc);
             });
         if (FAILED(hr))
             return hr;
@@ -3501,6 +3594,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                 wprintf(L"Result: %f (%f %f %f %f) PSNR %f dB\n", mse, mseV[0], mseV[1], mseV[2], mseV[3],
                     10.0 * log10(3.0 / (double(mseV[0]) + double(mseV[1]) + double(mseV[2]))));
+
+                if (dwOptions & (UINT32_C(1) << OPT_IMAGE_QUALITY))
+                {
+                    hr = PrintImageQuality(*image1->GetImage(0, 0, 0), *image2->GetImage(0, 0, 0));
+                    if (FAILED(hr))
+                    {
+                        wprintf(L"Failed computing image quality (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                        return 1;
+                    }
+                }
             }
             else
             {
@@ -3561,6 +3664,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                                 wprintf(L"[%3zu,%3zu]: %f (%f %f %f %f) PSNR %f dB\n", mip, slice, mse, mseV[0], mseV[1], mseV[2], mseV[3],
                                     10.0 * log10(3.0 / (double(mseV[0]) + double(mseV[1]) + double(mseV[2]))));
+
+                                if (dwOptions & (UINT32_C(1) << OPT_IMAGE_QUALITY))
+                                {
+                                    hr = PrintImageQuality(*img1, *img2);
+                                    if (FAILED(hr))
+                                    {
+                                        wprintf(L"Failed computing image quality at slice %3zu, mip %3zu (%08X%ls)\n", slice, mip, static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                                        return 1;
+                                    }
+                                }
                             }
                         }
 
@@ -3612,6 +3725,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                                 wprintf(L"[%3zu,%3zu]: %f (%f %f %f %f) PSNR %f dB\n", item, mip, mse, mseV[0], mseV[1], mseV[2], mseV[3],
                                     10.0 * log10(3.0 / (double(mseV[0]) + double(mseV[1]) + double(mseV[2]))));
+
+                                if (dwOptions & (UINT32_C(1) << OPT_IMAGE_QUALITY))
+                                {
+                                    hr = PrintImageQuality(*img1, *img2);
+                                    if (FAILED(hr))
+                                    {
+                                        wprintf(L"Failed computing image quality at item %3zu, mip %3zu (%08X%ls)\n", item, mip, static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                                        return 1;
+                                    }
+                                }
                             }
                         }
                     }